@@ -0,0 +1,309 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdlib>
+#include <chrono>
+#include <charconv>
+#include <cstring>
+#include "core/kline_io.h"
+#include "core/candle_store.h"
+#include "core/output_records.h"
+#include "core/data_quality.h"
+
+using namespace tradecheck;
+
+// Kߴ洢ߣKCSVƷִΪʽѹļ<Ŀ¼>/<Ʒ>.tcsɰʱֱӼ֧λ
+// checkɨKCSV洢ļ
+
+void printUsage() {
+    std::cout << "÷" << std::endl;
+    std::cout << "  Kߴ洢 pack <KCSV> <Ŀ¼> [--price-digits λ] [--volume-digits λ] [--clean mask|repair]"
+              << std::endl;
+    std::cout << "  Kߴ洢 info <洢ļ>" << std::endl;
+    std::cout << "  Kߴ洢 unpack <洢ļ> [--from ] [--to ] [--output KCSV]" << std::endl;
+    std::cout << "  Kߴ洢 levels <洢ļ> [--from ] [--to ] [--window K] [--timeframe daily|4h]"
+                 " [--format text|ndjson|binary] [--output ļ]" << std::endl;
+    std::cout << "  Kߴ洢 check <KCSV洢ļ> [--interval ] [--spike-sigma ] [--zero-volume-run ]"
+                 " [--threads N] [--format text|ndjson] [--output ļ]" << std::endl;
+    std::cout << "δָλʱԶѡλԭССλ" << std::endl;
+    std::cout << "--cleanȰɨɾmask޸repairKٴ" << std::endl;
+}
+
+struct RangeOptions {
+    int64_t from = INT64_MIN;
+    int64_t to = INT64_MAX;
+    int window = 0;
+    TimeFrame tf = TimeFrame::DAILY;
+    OutputFormat format = OutputFormat::TEXT;
+    std::string output = "-";
+    int priceDigits = -2; // -2ʾԶѡ
+    int volumeDigits = -2;
+    QualityOptions quality;
+    CleanMode clean = CleanMode::NONE;
+};
+
+RangeOptions parseOptions(int argc, char* argv[], int first) {
+    RangeOptions o;
+    for (int i = first; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) throw std::invalid_argument("ȱȡֵ" + arg);
+        std::string value = argv[++i];
+        if (arg == "--from") o.from = std::strtoll(value.c_str(), nullptr, 10);
+        else if (arg == "--to") o.to = std::strtoll(value.c_str(), nullptr, 10);
+        else if (arg == "--window") o.window = std::atoi(value.c_str());
+        else if (arg == "--format") o.format = parseOutputFormat(value);
+        else if (arg == "--output") o.output = value;
+        else if (arg == "--price-digits") o.priceDigits = std::atoi(value.c_str());
+        else if (arg == "--volume-digits") o.volumeDigits = std::atoi(value.c_str());
+        else if (arg == "--interval") o.quality.interval = std::strtoll(value.c_str(), nullptr, 10);
+        else if (arg == "--spike-sigma") o.quality.spikeSigma = std::atof(value.c_str());
+        else if (arg == "--zero-volume-run") o.quality.minZeroVolumeRun = std::atoi(value.c_str());
+        else if (arg == "--threads") o.quality.threads = static_cast<unsigned>(std::atoi(value.c_str()));
+        else if (arg == "--clean") o.clean = parseCleanMode(value);
+        else if (arg == "--timeframe") {
+            if (value == "daily") o.tf = TimeFrame::DAILY;
+            else if (value == "4h") o.tf = TimeFrame::FOUR_HOUR;
+            else throw std::invalid_argument("ʱΪdaily4h");
+        } else throw std::invalid_argument("δ֪" + arg);
+    }
+    return o;
+}
+
+int runPack(const std::string& csvPath, const std::string& dir, const RangeOptions& o) {
+    std::vector<KlineRow> rows = loadKlineCsv(csvPath);
+    if (o.clean != CleanMode::NONE) {
+        CleanStats s = cleanKlineRows(rows, o.clean, o.quality);
+        std::cout << "ϴɾ" << s.dropped << "" << s.repaired << "" << s.filled << "" << std::endl;
+    }
+    std::map<std::string, std::vector<size_t>> bySymbol;
+    for (size_t i = 0; i < rows.size(); ++i) bySymbol[rows[i].symbol].push_back(i);
+
+    uint64_t totalBars = 0, totalBytes = 0;
+    std::cout << std::left << std::setw(14) << "Ʒ" << std::right << std::setw(12) << "K" << std::setw(8) << "۸λ"
+              << std::setw(8) << "λ" << std::setw(14) << "ֽ" << std::setw(12) << "ֽ/" << std::endl;
+    for (auto& entry : bySymbol) {
+        std::vector<size_t>& idx = entry.second;
+        std::stable_sort(idx.begin(), idx.end(), [&](size_t a, size_t b) { return rows[a].openTime < rows[b].openTime; });
+        std::vector<KlineData> bars;
+        bars.reserve(idx.size());
+        for (size_t i : idx) bars.push_back(rows[i].kline);
+        const size_t stride = sizeof(KlineData) / sizeof(double);
+        int priceDigits = o.priceDigits;
+        if (priceDigits == -2) {
+            // ///չһλ
+            priceDigits = 0;
+            for (size_t column = 0; column < 4 && priceDigits >= 0; ++column) {
+                int d = detectDecimalDigits(&bars[0].open + column, bars.size(), stride);
+                priceDigits = d < 0 ? -1 : std::max(priceDigits, d);
+            }
+        }
+        int volumeDigits = o.volumeDigits;
+        if (volumeDigits == -2) volumeDigits = detectDecimalDigits(&bars[0].volume, bars.size(), stride);
+
+        std::string path = dir + "/" + entry.first + ".tcs";
+        CandleStoreWriter writer(path, entry.first, priceDigits, volumeDigits);
+        for (size_t k = 0; k < idx.size(); ++k) writer.append(rows[idx[k]].openTime, bars[k]);
+        writer.close();
+        CandleStoreReader reader(path);
+        totalBars += bars.size();
+        totalBytes += reader.fileSize();
+        std::cout << std::left << std::setw(14) << entry.first << std::right << std::setw(12) << bars.size()
+                  << std::setw(8) << priceDigits << std::setw(8) << volumeDigits << std::setw(14) << reader.fileSize()
+                  << std::setw(12) << std::fixed << std::setprecision(2)
+                  << static_cast<double>(reader.fileSize()) / bars.size() << std::endl;
+    }
+    if (totalBars > 0) {
+        std::cout << "ϼ" << totalBars << "Kߣ" << totalBytes << "ֽڣѹ"
+                  << std::setprecision(1) << static_cast<double>(totalBars * sizeof(KlineData)) / totalBytes
+                  << "xÿ" << sizeof(KlineData) << "ֽڵԭʼdouble" << std::endl;
+    }
+    return 0;
+}
+
+int runInfo(const std::string& path) {
+    CandleStoreReader reader(path);
+    const CandleStoreHeader& h = reader.header();
+    std::cout << "Ʒ֣" << h.symbol << std::endl;
+    std::cout << "K" << h.barCount << "ݿ飺" << h.chunkCount << std::endl;
+    std::cout << "۸λ" << static_cast<int>(h.priceDigits) << "ɽλ"
+              << static_cast<int>(h.volumeDigits) << std::endl;
+    if (h.chunkCount > 0) {
+        std::cout << "ʱ䷶Χ" << reader.chunk(0).firstTime << " ~ " << reader.chunk(reader.chunkCount() - 1).lastTime
+                  << std::endl;
+    }
+    std::cout << "ļС" << reader.fileSize() << "ֽ";
+    if (h.barCount > 0) {
+        std::cout << "ÿ" << std::fixed << std::setprecision(2)
+                  << static_cast<double>(reader.fileSize()) / h.barCount << "ֽڣ";
+    }
+    std::cout << std::endl;
+    std::cout << "·" << (reader.simdEnabled() ? "AVX2" : "") << std::endl;
+    return 0;
+}
+
+int runUnpack(const std::string& path, const RangeOptions& o) {
+    CandleStoreReader reader(path);
+    std::vector<int64_t> times;
+    std::vector<KlineData> bars;
+    auto start = std::chrono::steady_clock::now();
+    reader.readRange(o.from, o.to, times, bars);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cerr << "" << bars.size() << "Kߣʱ" << std::fixed << std::setprecision(3) << seconds * 1e3 << ""
+              << std::endl;
+    // KCSVʽдֵʾԭʼλһ
+    BufferedWriter out(o.output);
+    out.write("symbol,openTime,open,high,low,close,volume\n");
+    const std::string symbol = reader.header().symbol;
+    for (size_t i = 0; i < bars.size(); ++i) {
+        char* p = out.reserve(256);
+        char* q = p;
+        std::memcpy(q, symbol.data(), symbol.size());
+        q += symbol.size();
+        *q++ = ',';
+        q = std::to_chars(q, p + 256, times[i]).ptr;
+        for (double v : {bars[i].open, bars[i].high, bars[i].low, bars[i].close, bars[i].volume}) {
+            *q++ = ',';
+            q = std::to_chars(q, p + 256, v).ptr;
+        }
+        *q++ = '\n';
+        out.commit(q - p);
+    }
+    return 0;
+}
+
+int runLevels(const std::string& path, const RangeOptions& o) {
+    if (o.window < 0) throw std::invalid_argument("ڳȲΪ");
+    CandleStoreReader reader(path);
+    std::vector<int64_t> times;
+    std::vector<KlineData> bars;
+    reader.readRange(o.from, o.to, times, bars);
+    if (bars.empty()) throw std::invalid_argument("ûK");
+    std::string symbol = reader.header().symbol;
+
+    BufferedWriter out(o.output);
+    JsonLineWriter json(out);
+    if (o.format == OutputFormat::BINARY) writeRecordStreamHeader(out, RecordType::SUPPORT_RESISTANCE, sizeof(LevelsRecord));
+    auto emit = [&](size_t last, const SupportResistanceLevels& l) {
+        LevelsRecord record = makeLevelsRecord(symbol, times[last], o.tf, l);
+        if (o.format == OutputFormat::BINARY) {
+            out.write(&record, sizeof(record));
+        } else if (o.format == OutputFormat::NDJSON) {
+            writeLevelsJson(json, record);
+        } else {
+            out.flush();
+            std::cout << symbol << " " << times[last] << " " << l.highestHigh << " " << l.lowestLow << " P="
+                      << l.pivotPoint << " ܼ֧" << l.denseSupport << " ܼ" << l.denseResist << std::endl;
+        }
+    };
+    if (o.window == 0) {
+        emit(bars.size() - 1, computeSupportResistance(bars.data(), bars.size()));
+    } else {
+        // ÿKβĴڽ
+        for (size_t end = static_cast<size_t>(o.window); end <= bars.size(); ++end) {
+            emit(end - 1, computeSupportResistance(bars.data() + end - o.window, o.window));
+        }
+    }
+    return 0;
+}
+
+void printQualityReport(const std::string& symbol, const std::vector<int64_t>& times, const QualityReport& r) {
+    std::cout << "Ʒ֣" << symbol << "" << r.bars << "Kߣ" << r.interval << "룬Ƚ׼" << std::fixed
+              << std::setprecision(4) << r.returnSigma * 100 << "%" << r.ranges.size() << "" << std::endl;
+    for (int b = 0; b < QUALITY_ISSUE_COUNT; ++b) {
+        if (r.rows[b]) std::cout << "  " << qualityIssueName(static_cast<QualityIssue>(b)) << "" << r.rows[b] << "" << std::endl;
+    }
+    for (const auto& range : r.ranges) {
+        std::cout << "  [" << range.first << ", " << range.last << "] " << times[range.first] << " ~ " << times[range.last]
+                  << " " << qualityIssueName(range.issue) << " " << range.rows() << "";
+        if (range.issue == QualityIssue::GAP) std::cout << "ȱ" << range.missingBars << "";
+        std::cout << std::endl;
+    }
+}
+
+void writeQualityJson(JsonLineWriter& json, const std::string& symbol, const std::vector<int64_t>& times,
+                      const QualityRange& range) {
+    json.begin();
+    json.string("symbol", symbol)
+        .string("issue", qualityIssueName(range.issue))
+        .integer("first", static_cast<int64_t>(range.first))
+        .integer("last", static_cast<int64_t>(range.last))
+        .integer("firstTime", times[range.first])
+        .integer("lastTime", times[range.last])
+        .integer("rows", static_cast<int64_t>(range.rows()))
+        .integer("missingBars", static_cast<int64_t>(range.missingBars));
+    json.end();
+}
+
+// ɨһƷ֣CSVƷַ顢ļе˳򣻴洢ļʱȫKߣʱ2
+int runCheck(const std::string& path, const RangeOptions& o) {
+    if (o.format == OutputFormat::BINARY) throw std::invalid_argument("checkֻ֧textndjson");
+    std::vector<std::string> symbols;
+    std::vector<std::vector<int64_t>> times;
+    std::vector<std::vector<KlineData>> bars;
+    if (path.size() > 4 && path.compare(path.size() - 4, 4, ".tcs") == 0) {
+        CandleStoreReader reader(path);
+        symbols.push_back(reader.header().symbol);
+        times.emplace_back();
+        bars.emplace_back();
+        reader.readRange(o.from, o.to, times[0], bars[0]);
+    } else {
+        std::map<std::string, size_t> index;
+        for (const auto& row : loadKlineCsv(path)) {
+            auto it = index.find(row.symbol);
+            if (it == index.end()) {
+                it = index.emplace(row.symbol, symbols.size()).first;
+                symbols.push_back(row.symbol);
+                times.emplace_back();
+                bars.emplace_back();
+            }
+            if (row.openTime < o.from || row.openTime > o.to) continue;
+            times[it->second].push_back(row.openTime);
+            bars[it->second].push_back(row.kline);
+        }
+    }
+
+    BufferedWriter out(o.output);
+    JsonLineWriter json(out);
+    size_t totalBars = 0, totalRanges = 0;
+    double seconds = 0;
+    for (size_t id = 0; id < symbols.size(); ++id) {
+        auto start = std::chrono::steady_clock::now();
+        QualityReport r = scanKlineQuality(times[id].data(), bars[id].data(), bars[id].size(), o.quality);
+        seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        totalBars += r.bars;
+        totalRanges += r.ranges.size();
+        if (o.format == OutputFormat::NDJSON) {
+            for (const auto& range : r.ranges) writeQualityJson(json, symbols[id], times[id], range);
+        } else {
+            printQualityReport(symbols[id], times[id], r);
+        }
+    }
+    std::cerr << "ɨ" << totalBars << "Kߣ" << totalRanges << "ʱ" << std::fixed << std::setprecision(3)
+              << seconds * 1e3 << "루" << (dataQualitySimdSupported() && o.quality.simd ? "AVX2" : "") << ""
+              << std::endl;
+    return totalRanges ? 2 : 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        printUsage();
+        return 1;
+    }
+    std::string command = argv[1];
+    try {
+        if (command == "pack" && argc >= 4) return runPack(argv[2], argv[3], parseOptions(argc, argv, 4));
+        if (command == "info") return runInfo(argv[2]);
+        if (command == "unpack") return runUnpack(argv[2], parseOptions(argc, argv, 3));
+        if (command == "levels") return runLevels(argv[2], parseOptions(argc, argv, 3));
+        if (command == "check") return runCheck(argv[2], parseOptions(argc, argv, 3));
+    } catch (const std::exception& e) {
+        std::cerr << "" << e.what() << std::endl;
+        return 1;
+    }
+    printUsage();
+    return 1;
+}
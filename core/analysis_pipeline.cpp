@@ -0,0 +1,414 @@
+#include "analysis_pipeline.h"
+#include "latency_stats.h"
+#include "spsc_queue.h"
+#include "volatility.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace tradecheck {
+
+namespace {
+
+// ȡ
+int64_t bucketStartOf(int64_t time, int tf) {
+    int64_t origin = tf == static_cast<int>(Timeframe::TF_WEEK) ? RESAMPLE_WEEK_ORIGIN_MS : 0;
+    int64_t period = RESAMPLE_PERIOD_MS[tf];
+    int64_t d = time - origin;
+    int64_t q = d / period;
+    if (d % period < 0) q--;
+    return origin + q * period;
+}
+
+}  // namespace
+
+void TimeframeResampler::reset(int64_t knownInterval) {
+    if (knownInterval < 0) throw std::invalid_argument("K߼Ϊ");
+    interval = knownInterval;
+    lastTime = 0;
+    hasLast = false;
+    fixedInterval = knownInterval > 0;
+    for (int t = 0; t < INDICATOR_TIMEFRAME_COUNT; ++t) {
+        open[t] = false;
+        bucketStart[t] = 0;
+        bucket[t] = KlineData{};
+    }
+}
+
+int TimeframeResampler::update(int64_t openTime, const KlineData& kd, ResampledBar out[MAX_RESAMPLED_PER_BAR]) {
+    if (hasLast && openTime <= lastTime) return -1;
+    if (hasLast && !fixedInterval) {
+        int64_t gap = openTime - lastTime;
+        if (interval == 0 || gap < interval) interval = gap;
+    }
+    lastTime = openTime;
+    hasLast = true;
+
+    int n = 0;
+    for (int t = 0; t < INDICATOR_TIMEFRAME_COUNT; ++t) {
+        int64_t period = RESAMPLE_PERIOD_MS[t];
+        Timeframe tf = static_cast<Timeframe>(t);
+        if (interval > 0 && (interval > period || period % interval != 0)) {
+            open[t] = false;
+            continue;
+        }
+        int64_t start = bucketStartOf(openTime, t);
+        // ʱһ伴ʹûȱKߣҲ
+        if (open[t] && start != bucketStart[t]) {
+            out[n++] = {bucketStart[t], bucket[t], tf};
+            open[t] = false;
+        }
+        KlineData& b = bucket[t];
+        if (!open[t]) {
+            b = kd;
+            bucketStart[t] = start;
+            open[t] = true;
+        } else {
+            b.high = std::max(b.high, kd.high);
+            b.low = std::min(b.low, kd.low);
+            b.close = kd.close;
+            b.volume += kd.volume;
+        }
+        if (interval > 0 && openTime + interval >= start + period) {
+            out[n++] = {start, b, tf};
+            open[t] = false;
+        }
+    }
+    return n;
+}
+
+std::vector<TradePlan> loadTradePlans(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) throw std::invalid_argument("޷򿪿ƻļ" + path);
+    std::vector<TradePlan> plans;
+    std::string line;
+    int lineNo = 0;
+    while (std::getline(in, line)) {
+        lineNo++;
+        if (line.empty() || line[0] == '#' || line[0] == '\r') continue;
+        std::istringstream ss(line);
+        std::string dir;
+        TradePlan p;
+        if (!(ss >> p.symbol >> dir >> p.leverage >> p.openPrice >> p.stopLoss)) {
+            throw std::invalid_argument("ƻļ" + std::to_string(lineNo) + "иʽ");
+        }
+        if (!(ss >> p.liquidPrice)) p.liquidPrice = 0;
+        if (dir != "" && dir != "") throw std::invalid_argument("ƻļ" + std::to_string(lineNo) + "зΪ/");
+        if (p.leverage <= 0 || !(p.openPrice > 0) || !(p.stopLoss > 0) || p.liquidPrice < 0) {
+            throw std::invalid_argument("ƻļ" + std::to_string(lineNo) + "иܸ۸Ϊ");
+        }
+        p.direction = dir == "" ? TradeDirection::LONG : TradeDirection::SHORT;
+        plans.push_back(p);
+    }
+    return plans;
+}
+
+// һˮߣ׶εƷ״̬Ʒֱֻɸý׶ε̷߳ʣ׶μ
+struct AnalysisPipeline::Lane {
+    std::vector<std::unique_ptr<TimeframeResampler>> resamplers;
+    std::vector<std::unique_ptr<MultiTimeframeIndicators>> indicators;
+    std::vector<std::unique_ptr<StreamingSupportResistance>> levels;
+    AnalysisArena arena;
+
+    SpscQueue<PipelineBar> input;
+    SpscQueue<PipelineBar> resampled;
+    SpscQueue<PipelineBar> withIndicators;
+    SpscQueue<PipelineBar> withLevels;
+    SpscQueue<PipelineResult> results;
+
+    // ֻɶӦ׶ε߳д룬
+    uint64_t dropped = 0;
+    uint64_t resampledBars = 0;
+    uint64_t scored = 0;
+    uint64_t truncatedNotes = 0;
+
+    // ִʱݴ
+    PipelineBar scratch;
+    PipelineResult result;
+
+    explicit Lane(size_t capacity)
+        : input(capacity), resampled(capacity), withIndicators(capacity), withLevels(capacity), results(capacity) {}
+
+    template <typename State>
+    static State& stateOf(std::vector<std::unique_ptr<State>>& states, uint32_t id, bool& created) {
+        if (id >= states.size()) states.resize(id + 1);
+        created = !states[id];
+        if (created) states[id].reset(new State());
+        return *states[id];
+    }
+
+    bool resample(const PipelineOptions& opt, PipelineBar& b) {
+        TRADECHECK_LATENCY_SCOPE(LatencyStage::RESAMPLE);
+        bool created;
+        TimeframeResampler& r = stateOf(resamplers, b.symbolId, created);
+        if (created) r.reset(opt.interval);
+        int n = r.update(b.openTime, b.bar, b.closed);
+        if (n < 0) {
+            dropped++;
+            return false;
+        }
+        b.closedCount = n;
+        resampledBars += n;
+        return true;
+    }
+
+    void updateIndicators(const PipelineOptions& opt, PipelineBar& b) {
+        TRADECHECK_LATENCY_SCOPE(LatencyStage::INDICATORS);
+        bool created;
+        MultiTimeframeIndicators& m = stateOf(indicators, b.symbolId, created);
+        if (created) m.reset(opt.atrPeriod);
+        for (int i = 0; i < b.closedCount; ++i) m.update(b.closed[i].tf, b.closed[i].bar);
+        b.indicators = m.reading();
+    }
+
+    void updateLevels(const PipelineOptions& opt, PipelineBar& b) {
+        TRADECHECK_LATENCY_SCOPE(LatencyStage::LEVELS);
+        bool created;
+        StreamingSupportResistance& s = stateOf(levels, b.symbolId, created);
+        if (created) s.reset(opt.window);
+        s.update(b.bar);
+        b.levels = s.levels();
+    }
+
+    void score(const std::vector<TradePlan>& plans, const PipelineBar& b, PipelineResult& out) {
+        out.bar = b;
+        out.noteCount = 0;
+        out.noteBytes = 0;
+        out.scored = b.plan >= 0;
+        if (!out.scored) return;
+        const TradePlan& plan = plans[b.plan];
+        {
+            TradeAnalysis ta(arena.allocator());
+            ta.coinType = plan.symbol;
+            ta.openDir = plan.direction == TradeDirection::LONG ? "" : "";
+            ta.leverage = plan.leverage;
+            ta.openPrice = plan.openPrice;
+            ta.liquidPrice = plan.liquidPrice;
+            ta.stopLoss = plan.stopLoss;
+            updateStopLossRates(ta);
+            fillIndicatorAnalysis(b.indicators, ta);
+            {
+                TRADECHECK_LATENCY_SCOPE(LatencyStage::SCORING);
+                out.score = makeScoreRecord(ta, 0);
+            }
+            ContradictionList contradictions(arena.allocator());
+            {
+                TRADECHECK_LATENCY_SCOPE(LatencyStage::CONTRADICTIONS);
+                analyzeContradictions(ta, out.score.highLeverRisk != 0, contradictions);
+            }
+            out.score.contradictionCount = static_cast<int32_t>(contradictions.size());
+            for (const auto& text : contradictions) {
+                if (out.noteBytes + text.size() + 1 > static_cast<size_t>(PIPELINE_NOTE_BYTES)) {
+                    truncatedNotes++;
+                    continue;
+                }
+                std::memcpy(out.notes + out.noteBytes, text.data(), text.size());
+                out.noteBytes += static_cast<int32_t>(text.size());
+                out.notes[out.noteBytes++] = '\0';
+                out.noteCount++;
+            }
+        }
+        arena.reset();
+        scored++;
+    }
+};
+
+namespace {
+
+// ׶̣߳ȡһ͵дβλstepfalseʱø
+// ˮʧʱȡΣοڱѹϣر
+template <typename In, typename Out, typename Step, typename Fail>
+void runStage(SpscQueue<In>& in, SpscQueue<Out>& out, const std::atomic<bool>& failed, Fail fail, Step step) {
+    try {
+        while (In* item = in.front()) {
+            if (!failed.load(std::memory_order_relaxed)) {
+                Out* slot = out.claim();
+                if (step(*item, *slot)) out.publish();
+            }
+            in.release();
+        }
+    } catch (...) {
+        fail();
+        in.release();
+        while (in.front()) in.release();
+    }
+    out.close();
+}
+
+}  // namespace
+
+AnalysisPipeline::AnalysisPipeline(const PipelineOptions& options, std::vector<TradePlan> tradePlans, Sink resultSink)
+    : opt(options), plans(std::move(tradePlans)), sink(std::move(resultSink)) {
+    if (opt.window <= 0 || opt.window > MAX_STREAM_WINDOW) throw std::invalid_argument("ʽڳ1~512֮");
+    if (opt.atrPeriod <= 0) throw std::invalid_argument("ATRڱ0");
+    if (opt.interval < 0) throw std::invalid_argument("K߼Ϊ");
+    if (opt.lanes == 0) opt.lanes = 1;
+    if (!opt.staged) opt.lanes = 1;
+    for (unsigned i = 0; i < opt.lanes; ++i) lanes.emplace_back(new Lane(opt.staged ? opt.queueCapacity : 2));
+    if (!opt.staged) return;
+
+    auto onError = [this] { fail(); };
+    for (auto& lanePtr : lanes) {
+        Lane& lane = *lanePtr;
+        threads.emplace_back([this, &lane, onError] {
+            runStage(lane.input, lane.resampled, failed, onError,
+                     [this, &lane](PipelineBar& in, PipelineBar& out) {
+                         out = in;
+                         return lane.resample(opt, out);
+                     });
+        });
+        threads.emplace_back([this, &lane, onError] {
+            runStage(lane.resampled, lane.withIndicators, failed, onError,
+                     [this, &lane](PipelineBar& in, PipelineBar& out) {
+                         out = in;
+                         lane.updateIndicators(opt, out);
+                         return true;
+                     });
+        });
+        threads.emplace_back([this, &lane, onError] {
+            runStage(lane.withIndicators, lane.withLevels, failed, onError,
+                     [this, &lane](PipelineBar& in, PipelineBar& out) {
+                         out = in;
+                         lane.updateLevels(opt, out);
+                         return true;
+                     });
+        });
+        threads.emplace_back([this, &lane, onError] {
+            runStage(lane.withLevels, lane.results, failed, onError,
+                     [this, &lane](PipelineBar& in, PipelineResult& out) {
+                         lane.score(plans, in, out);
+                         return true;
+                     });
+        });
+    }
+    threads.emplace_back([this] { runOutput(); });
+}
+
+AnalysisPipeline::~AnalysisPipeline() {
+    if (finished) return;
+    try {
+        finish();
+    } catch (...) {
+    }
+}
+
+void AnalysisPipeline::fail() {
+    std::lock_guard<std::mutex> lock(errorMutex);
+    if (!error) error = std::current_exception();
+    failed.store(true, std::memory_order_relaxed);
+}
+
+uint32_t AnalysisPipeline::symbolId(const std::string& symbol) {
+    auto it = ids.find(symbol);
+    if (it != ids.end()) return it->second;
+    uint32_t id = static_cast<uint32_t>(names.size());
+    ids.emplace(symbol, id);
+    names.push_back(symbol);
+    int32_t plan = -1;
+    std::string key = normalizeSymbol(symbol);
+    for (size_t i = 0; i < plans.size(); ++i) {
+        if (normalizeSymbol(plans[i].symbol) == key) plan = static_cast<int32_t>(i);
+    }
+    planOf.push_back(plan);
+    return id;
+}
+
+void AnalysisPipeline::push(uint32_t id, int64_t openTime, const KlineData& kd) {
+    if (id >= names.size()) throw std::invalid_argument("δǼǵƷֱ");
+    if (finished) throw std::invalid_argument("ˮѽ");
+    summary.bars++;
+    Lane& lane = *lanes[id % lanes.size()];
+    if (opt.staged && failed.load(std::memory_order_relaxed)) return;
+    PipelineBar* b = opt.staged ? lane.input.claim() : &lane.scratch;
+    copyRecordSymbol(b->symbol, names[id]);
+    b->symbolId = id;
+    b->plan = planOf[id];
+    b->openTime = openTime;
+    b->bar = kd;
+    b->closedCount = 0;
+    if (opt.staged) {
+        lane.input.publish();
+        return;
+    }
+    // ִУֽ׶еͬһ׶κ
+    if (!lane.resample(opt, *b)) return;
+    lane.updateIndicators(opt, *b);
+    lane.updateLevels(opt, *b);
+    lane.score(plans, *b, lane.result);
+    TRADECHECK_LATENCY_SCOPE(LatencyStage::OUTPUT);
+    sink(lane.result);
+    summary.results++;
+}
+
+// ̣߳Ӹˮȡÿһȡһĳռȫرղȡպ
+void AnalysisPipeline::runOutput() {
+    const int BATCH = 64;
+    std::vector<bool> done(lanes.size(), false);
+    size_t remaining = lanes.size();
+    SpinWait idle;
+    while (remaining > 0) {
+        bool progress = false;
+        for (size_t i = 0; i < lanes.size(); ++i) {
+            if (done[i]) continue;
+            SpscQueue<PipelineResult>& q = lanes[i]->results;
+            for (int k = 0; k < BATCH; ++k) {
+                PipelineResult* r = q.tryFront();
+                if (!r) break;
+                if (!failed.load(std::memory_order_relaxed)) {
+                    try {
+                        TRADECHECK_LATENCY_SCOPE(LatencyStage::OUTPUT);
+                        sink(*r);
+                        summary.results++;
+                    } catch (...) {
+                        fail();
+                    }
+                }
+                q.release();
+                progress = true;
+            }
+            if (q.drained()) {
+                done[i] = true;
+                remaining--;
+            }
+        }
+        if (progress) {
+            idle = SpinWait();
+        } else {
+            summary.waits[PIPELINE_QUEUE_COUNT - 1]++;
+            idle.wait();
+        }
+    }
+}
+
+void AnalysisPipeline::finish() {
+    if (finished) return;
+    finished = true;
+    if (opt.staged) {
+        for (auto& lane : lanes) lane->input.close();
+        for (auto& t : threads) t.join();
+        threads.clear();
+    }
+    for (auto& lanePtr : lanes) {
+        Lane& lane = *lanePtr;
+        summary.dropped += lane.dropped;
+        summary.resampled += lane.resampledBars;
+        summary.scored += lane.scored;
+        summary.truncatedNotes += lane.truncatedNotes;
+        if (!opt.staged) continue;
+        summary.stalls[0] += lane.input.producerStalls();
+        summary.stalls[1] += lane.resampled.producerStalls();
+        summary.stalls[2] += lane.withIndicators.producerStalls();
+        summary.stalls[3] += lane.withLevels.producerStalls();
+        summary.stalls[4] += lane.results.producerStalls();
+        summary.waits[0] += lane.input.consumerWaits();
+        summary.waits[1] += lane.resampled.consumerWaits();
+        summary.waits[2] += lane.withIndicators.consumerWaits();
+        summary.waits[3] += lane.withLevels.consumerWaits();
+    }
+    if (error) std::rethrow_exception(error);
+}
+
+}  // namespace tradecheck
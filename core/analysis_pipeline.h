@@ -0,0 +1,172 @@
+#pragma once
+
+#include "crypto_risk.h"
+#include "indicator_analysis.h"
+#include "output_records.h"
+#include "streaming_levels.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace tradecheck {
+
+// ֽ׶ηˮߣ  ز  ָ  ֧λ  ۺìܵ  
+// ÿ׶һ̣߳׶֮н/߶Уθʱڶȴѹ
+// ׶ͬʱͬKߣĽ׶ξǸ׶κʱ֮
+// ƷְŹ̶ֵһˮߣlanesУͬһƷֵKÿ׶ζ˳
+// ˮߵĽͬһ߳νص
+// ÿ׶ֻάԼƷ״̬׶֮ⲻ
+
+// زڣ룩ߴһ0㣨UTC
+const int64_t RESAMPLE_PERIOD_MS[INDICATOR_TIMEFRAME_COUNT] = {4 * 3600000LL, 86400000LL, 7 * 86400000LL};
+const int64_t RESAMPLE_WEEK_ORIGIN_MS = 4 * 86400000LL; // 1970-01-05
+
+// زõһK
+struct ResampledBar {
+    int64_t openTime;
+    KlineData bar;
+    Timeframe tf;
+};
+
+// һKʹͬһһȱKδǡ
+const int MAX_RESAMPLED_PER_BAR = 2 * INDICATOR_TIMEFRAME_COUNT;
+
+// Ʒز״̬PODK߰ʱ4Сʱ//䣬
+// һKߵʱ̣ȡѼСڼĳڻʱɸ
+struct TimeframeResampler {
+    int64_t interval;    // K߼0ʾδȷ
+    int64_t lastTime;
+    bool hasLast;
+    bool fixedInterval;  // ɵ÷
+    bool open[INDICATOR_TIMEFRAME_COUNT];
+    int64_t bucketStart[INDICATOR_TIMEFRAME_COUNT];
+    KlineData bucket[INDICATOR_TIMEFRAME_COUNT];
+
+    void reset(int64_t knownInterval = 0);
+
+    // ׷һKߣ̵Kдout̸ʱ䲻һʱ-1
+    int update(int64_t openTime, const KlineData& kd, ResampledBar out[MAX_RESAMPLED_PER_BAR]);
+};
+
+// ƻֽ׶ζԸƷֵÿKͬһ鿪ָ겿ȡʱĶ
+struct TradePlan {
+    std::string symbol;
+    TradeDirection direction;
+    int leverage;
+    double openPrice;
+    double stopLoss;
+    double liquidPrice; // 0ʾδṩ
+};
+
+// ȡƻļÿ Ʒ (/) ܸ  ֹ [ǿƽ]#ͷΪע
+std::vector<TradePlan> loadTradePlans(const std::string& path);
+
+struct PipelineOptions {
+    int64_t interval = 0;         // K߼룩0ʾƷѼСڼ
+    int window = 200;             // ֧λڣK߸
+    int atrPeriod = 14;           // ATR
+    unsigned lanes = 1;           // ˮ
+    size_t queueCapacity = 1024;  // ׶μ2ݣ
+    bool staged = true;           // falseʱڵִ߳и׶Σֽ׶λһ£
+};
+
+// ׶εһKߣ׶ξ͵дԼĲ֣
+struct PipelineBar {
+    char symbol[16];
+    uint32_t symbolId;
+    int32_t plan;             // ƻ±꣬-1ʾƷûмƻ
+    int64_t openTime;
+    KlineData bar;
+    // ز
+    int32_t closedCount;
+    ResampledBar closed[MAX_RESAMPLED_PER_BAR];
+    // ָ
+    IndicatorReading indicators;
+    // ֧λڻڣ
+    SupportResistanceLevels levels;
+};
+
+const int PIPELINE_NOTE_BYTES = 1024;
+
+// ׶յĽ
+struct PipelineResult {
+    PipelineBar bar;
+    bool scored;                     // пƻʱΪtrue
+    ScoreRecord score;
+    int32_t noteCount;               // notesеìܵŲµĽضϣ룩
+    int32_t noteBytes;
+    char notes[PIPELINE_NOTE_BYTES]; // ìܵı'\0'βδ
+};
+
+// ׶μУززָꡢָ֧֧֡֡
+const int PIPELINE_QUEUE_COUNT = 5;
+const char* const PIPELINE_QUEUE_NAMES[PIPELINE_QUEUE_COUNT] = {
+    "ز", "زָ", "ָ֧", "֧", "֡"
+};
+
+struct PipelineStats {
+    uint64_t bars = 0;           // K
+    uint64_t dropped = 0;        // ʱ䲻һK
+    uint64_t resampled = 0;      // زõK
+    uint64_t results = 0;        // صĽ
+    uint64_t scored = 0;         // ֵĽ
+    uint64_t truncatedNotes = 0; // Ų¶ضϵìܵ
+    uint64_t stalls[PIPELINE_QUEUE_COUNT] = {}; // ʱεȴĴѹ
+    uint64_t waits[PIPELINE_QUEUE_COUNT] = {};  // пʱεȴĴ
+};
+
+class AnalysisPipeline {
+public:
+    using Sink = std::function<void(const PipelineResult&)>;
+
+    // ص߳ϵãstaged=falseʱڵ߳ϣƷֱ˳
+    AnalysisPipeline(const PipelineOptions& options, std::vector<TradePlan> plans, Sink sink);
+    ~AnalysisPipeline();
+
+    AnalysisPipeline(const AnalysisPipeline&) = delete;
+    AnalysisPipeline& operator=(const AnalysisPipeline&) = delete;
+
+    // ¾ֻͬһ߳ʹ
+
+    // Ʒֱţ״γʱǼǣ
+    uint32_t symbolId(const std::string& symbol);
+
+    // һKߣͬһƷ밴ʱ˳򣩣θʱȴ
+    void push(uint32_t symbolId, int64_t openTime, const KlineData& kd);
+
+    // 벢ȴ׶δꣻһ׶γʱ׳ȳֵ쳣
+    void finish();
+
+    // finish()֮Ч
+    const PipelineStats& stats() const { return summary; }
+
+private:
+    struct Lane;
+
+    PipelineOptions opt;
+    std::vector<TradePlan> plans;
+    Sink sink;
+    std::unordered_map<std::string, uint32_t> ids;
+    std::vector<int32_t> planOf;
+    std::vector<std::string> names;
+    std::vector<std::unique_ptr<Lane>> lanes;
+    std::vector<std::thread> threads;
+    std::mutex errorMutex;
+    std::exception_ptr error;
+    std::atomic<bool> failed{false};
+    PipelineStats summary;
+    bool finished = false;
+
+    void fail();
+    void runOutput();
+};
+
+}  // namespace tradecheck
@@ -0,0 +1,638 @@
+#include "candle_store.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define TRADECHECK_CANDLE_AVX2 1
+#endif
+
+namespace tradecheck {
+
+namespace {
+
+// б뷽ʽ
+const uint8_t COLUMN_FOR = 0;    // FORλѹ
+const uint8_t COLUMN_XOR = 1;    // ǰֵԭʼdoubleλ
+const uint8_t COLUMN_VARINT = 2; // 䳤
+
+// ʱб뷽ʽ
+const uint8_t TIME_CONSTANT_STEP = 0; // ̶
+const uint8_t TIME_DELTA_OF_DELTA = 1; // ײ
+
+// ľֵޣ֤doubleתȷҿħint64doubleת
+const int64_t QUANT_LIMIT = int64_t(1) << 51;
+
+const double POW10[CANDLE_MAX_DIGITS + 1] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12};
+
+// FORλĩβֽʱ8ֽڶȡ
+const size_t PACK_PADDING = 8;
+
+inline uint64_t zigzag(int64_t v) {
+    return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+inline int64_t unzigzag(uint64_t v) {
+    return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+}
+
+inline uint64_t doubleBits(double v) {
+    uint64_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    return bits;
+}
+
+template <typename T>
+inline T loadAs(const uint8_t* p) {
+    T v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+[[noreturn]] void corrupt(const char* what) {
+    throw std::invalid_argument(std::string("Kߴ洢ļ𻵣") + what);
+}
+
+void putVarint(std::vector<uint8_t>& out, uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<uint8_t>(v) | 0x80);
+        v >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(v));
+}
+
+inline uint64_t getVarint(const uint8_t*& p, const uint8_t* end) {
+    uint64_t v = 0;
+    for (int shift = 0; p < end && shift < 64; shift += 7) {
+        uint8_t b = *p++;
+        v |= static_cast<uint64_t>(b & 0x7F) << shift;
+        if (!(b & 0x80)) return v;
+    }
+    corrupt("䳤Խ");
+}
+
+// 䳤·ʣ಻8ֽʱһζȡֹλλȺƴӸֽڵĵ7λ
+inline uint64_t getVarintFast(const uint8_t*& p, const uint8_t* end) {
+    if (end - p >= 8) {
+        uint64_t w = loadAs<uint64_t>(p);
+        uint64_t stops = ~w & 0x8080808080808080ULL;
+        if (stops != 0) {
+            int bits = __builtin_ctzll(stops) + 1;
+            uint64_t v = bits == 64 ? w : (w & ((uint64_t(1) << bits) - 1));
+            p += bits >> 3;
+            return (v & 0x7FULL) | ((v & 0x7F00ULL) >> 1) | ((v & 0x7F0000ULL) >> 2) | ((v & 0x7F000000ULL) >> 3) |
+                   ((v & 0x7F00000000ULL) >> 4) | ((v & 0x7F0000000000ULL) >> 5) | ((v & 0x7F000000000000ULL) >> 6) |
+                   ((v & 0x7F00000000000000ULL) >> 7);
+        }
+    }
+    return getVarint(p, end);
+}
+
+void putBytes(std::vector<uint8_t>& out, const void* data, size_t n) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    out.insert(out.end(), p, p + n);
+}
+
+// Ϊ10^-digitsλԭʱtrue
+inline bool quantize(double v, double scale, int64_t& q) {
+    if (!std::isfinite(v)) return false;
+    double scaled = v * scale;
+    if (!(std::fabs(scaled) < static_cast<double>(QUANT_LIMIT))) return false;
+    q = std::llround(scaled);
+    return doubleBits(static_cast<double>(q) / scale) == doubleBits(v);
+}
+
+// Σ뷽ʽ(1ֽ) + ݳ(4ֽ) + 
+size_t beginSection(std::vector<uint8_t>& out, uint8_t encoding) {
+    out.push_back(encoding);
+    size_t pos = out.size();
+    out.resize(pos + 4);
+    return pos;
+}
+
+void endSection(std::vector<uint8_t>& out, size_t pos) {
+    uint32_t length = static_cast<uint32_t>(out.size() - pos - 4);
+    std::memcpy(out.data() + pos, &length, 4);
+}
+
+struct Section {
+    uint8_t encoding;
+    const uint8_t* data;
+    const uint8_t* end;
+};
+
+Section readSection(const uint8_t*& p, const uint8_t* end) {
+    if (end - p < 5) corrupt("ݶͷԽ");
+    Section s;
+    s.encoding = p[0];
+    uint32_t length = loadAs<uint32_t>(p + 1);
+    p += 5;
+    if (static_cast<size_t>(end - p) < length) corrupt("ݶԽ");
+    s.data = p;
+    s.end = p + length;
+    p += length;
+    return s;
+}
+
+// FORλѹ׼ֵ(8ֽ) + λ(1ֽ) + λ
+void encodeFor(std::vector<uint8_t>& out, const int64_t* values, size_t n) {
+    int64_t lo = *std::min_element(values, values + n);
+    int64_t hi = *std::max_element(values, values + n);
+    uint64_t range = static_cast<uint64_t>(hi - lo);
+    int width = range == 0 ? 0 : 64 - __builtin_clzll(range);
+    putBytes(out, &lo, sizeof(lo));
+    out.push_back(static_cast<uint8_t>(width));
+    size_t start = out.size();
+    out.resize(start + (n * width + 7) / 8 + PACK_PADDING, 0);
+    uint8_t* packed = out.data() + start;
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t bit = static_cast<uint64_t>(i) * width;
+        uint8_t* p = packed + (bit >> 3);
+        uint64_t word = loadAs<uint64_t>(p) | (static_cast<uint64_t>(values[i] - lo) << (bit & 7));
+        std::memcpy(p, &word, sizeof(word));
+    }
+}
+
+// 룺ÿֵһֽڣ4λǰֽ4λĩβֽ+ мķֽ
+void encodeXor(std::vector<uint8_t>& out, const double* values, size_t n, size_t stride) {
+    uint64_t prev = 0;
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t bits = doubleBits(values[i * stride]);
+        uint64_t x = bits ^ prev;
+        prev = bits;
+        if (x == 0) {
+            out.push_back(0x80);
+            continue;
+        }
+        int lead = __builtin_clzll(x) / 8;
+        int trail = __builtin_ctzll(x) / 8;
+        out.push_back(static_cast<uint8_t>((lead << 4) | trail));
+        for (int b = trail; b < 8 - lead; ++b) out.push_back(static_cast<uint8_t>(x >> (8 * b)));
+    }
+}
+
+void decodeXor(const Section& s, size_t n, double* out, size_t stride) {
+    const uint8_t* p = s.data;
+    uint64_t prev = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (p >= s.end) corrupt("Խ");
+        uint8_t control = *p++;
+        int lead = control >> 4;
+        int trail = control & 0xF;
+        if (lead + trail > 8) corrupt("ֽЧ");
+        int bytes = 8 - lead - trail;
+        if (s.end - p < bytes) corrupt("Խ");
+        uint64_t x = 0;
+        for (int b = 0; b < bytes; ++b) x |= static_cast<uint64_t>(p[b]) << (8 * (trail + b));
+        p += bytes;
+        prev ^= x;
+        std::memcpy(&out[i * stride], &prev, sizeof(prev));
+    }
+}
+
+// FOR
+struct PackedColumn {
+    const uint8_t* packed;
+    int64_t base;
+    int width;
+};
+
+PackedColumn readPackedColumn(const Section& s, size_t n) {
+    if (s.end - s.data < 9) corrupt("λѹͷԽ");
+    PackedColumn c;
+    c.base = loadAs<int64_t>(s.data);
+    c.width = s.data[8];
+    c.packed = s.data + 9;
+    if (c.width > 52) corrupt("λЧ");
+    if (static_cast<size_t>(s.end - c.packed) < (n * c.width + 7) / 8 + PACK_PADDING) corrupt("λѹԽ");
+    return c;
+}
+
+inline int64_t unpackAt(const PackedColumn& c, uint64_t mask, size_t i) {
+    uint64_t bit = static_cast<uint64_t>(i) * c.width;
+    return c.base + static_cast<int64_t>((loadAs<uint64_t>(c.packed + (bit >> 3)) >> (bit & 7)) & mask);
+}
+
+inline uint64_t widthMask(int width) {
+    return width == 0 ? 0 : (~uint64_t(0) >> (64 - width));
+}
+
+// н룺q = base + λֵ (+ add[i])q/scaleout[i*stride]
+void unpackColumn(const PackedColumn& c, size_t n, const int64_t* add, int64_t* qOut, double scale, double* out,
+                  size_t stride) {
+    const uint64_t mask = widthMask(c.width);
+    for (size_t i = 0; i < n; ++i) {
+        int64_t q = unpackAt(c, mask, i);
+        if (add) q += add[i];
+        if (qOut) qOut[i] = q;
+        out[i * stride] = static_cast<double>(q) / scale;
+    }
+}
+
+// ///оΪFORʱ루ĸ۸KlineDataţ
+void decodePricesScalar(const PackedColumn (&cols)[4], size_t n, double scale, KlineData* bars) {
+    const uint64_t masks[4] = {widthMask(cols[0].width), widthMask(cols[1].width), widthMask(cols[2].width),
+                               widthMask(cols[3].width)};
+    for (size_t i = 0; i < n; ++i) {
+        int64_t close = unpackAt(cols[3], masks[3], i);
+        bars[i].open = static_cast<double>(unpackAt(cols[0], masks[0], i) + close) / scale;
+        bars[i].high = static_cast<double>(unpackAt(cols[1], masks[1], i) + close) / scale;
+        bars[i].low = static_cast<double>(unpackAt(cols[2], masks[2], i) + close) / scale;
+        bars[i].close = static_cast<double>(close) / scale;
+    }
+}
+
+#ifdef TRADECHECK_CANDLE_AVX2
+// AVX2ÿKߵĸ۸ռһint64תdoubleħ|q| < 2^51һ
+__attribute__((target("avx2"))) void decodePricesAvx2(const PackedColumn (&cols)[4], size_t n, double scale,
+                                                       KlineData* bars) {
+    const uint64_t masks[4] = {widthMask(cols[0].width), widthMask(cols[1].width), widthMask(cols[2].width),
+                               widthMask(cols[3].width)};
+    const __m256i magicI = _mm256_set1_epi64x(0x4338000000000000LL);
+    const __m256d magicD = _mm256_set1_pd(6755399441055744.0); // 2^52 + 2^51
+    const __m256d scaleV = _mm256_set1_pd(scale);
+    for (size_t i = 0; i < n; ++i) {
+        int64_t close = unpackAt(cols[3], masks[3], i);
+        __m256i q = _mm256_add_epi64(_mm256_set_epi64x(0, unpackAt(cols[2], masks[2], i), unpackAt(cols[1], masks[1], i),
+                                                       unpackAt(cols[0], masks[0], i)),
+                                     _mm256_set1_epi64x(close));
+        __m256d d = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_add_epi64(q, magicI)), magicD);
+        _mm256_storeu_pd(&bars[i].open, _mm256_div_pd(d, scaleV));
+    }
+}
+#endif
+
+// ֵתdoubleout[i*stride] = q[i] / scale
+void dequantizeScalar(const int64_t* q, size_t n, double scale, double* out, size_t stride) {
+    for (size_t i = 0; i < n; ++i) out[i * stride] = static_cast<double>(q[i]) / scale;
+}
+
+#ifdef TRADECHECK_CANDLE_AVX2
+__attribute__((target("avx2"))) void dequantizeAvx2(const int64_t* q, size_t n, double scale, double* out, size_t stride) {
+    const __m256i magicI = _mm256_set1_epi64x(0x4338000000000000LL);
+    const __m256d magicD = _mm256_set1_pd(6755399441055744.0);
+    const __m256d scaleV = _mm256_set1_pd(scale);
+    alignas(32) double lanes[4];
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(q + i));
+        __m256d d = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_add_epi64(v, magicI)), magicD);
+        _mm256_store_pd(lanes, _mm256_div_pd(d, scaleV));
+        out[i * stride] = lanes[0];
+        out[(i + 1) * stride] = lanes[1];
+        out[(i + 2) * stride] = lanes[2];
+        out[(i + 3) * stride] = lanes[3];
+    }
+    dequantizeScalar(q + i, n - i, scale, out + i * stride, stride);
+}
+#endif
+
+void dequantize(bool simd, const int64_t* q, size_t n, double scale, double* out, size_t stride) {
+#ifdef TRADECHECK_CANDLE_AVX2
+    if (simd) return dequantizeAvx2(q, n, scale, out, stride);
+#endif
+    (void)simd;
+    dequantizeScalar(q, n, scale, out, stride);
+}
+
+void decodePrices(bool simd, const PackedColumn (&cols)[4], size_t n, double scale, KlineData* bars) {
+#ifdef TRADECHECK_CANDLE_AVX2
+    if (simd) return decodePricesAvx2(cols, n, scale, bars);
+#endif
+    (void)simd;
+    decodePricesScalar(cols, n, scale, bars);
+}
+
+bool detectSimd() {
+#ifdef TRADECHECK_CANDLE_AVX2
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+}  // namespace
+
+bool candleStoreSimdSupported() {
+    static const bool supported = detectSimd();
+    return supported;
+}
+
+int detectDecimalDigits(const double* values, size_t count, size_t stride, int maxDigits) {
+    maxDigits = std::min(maxDigits, CANDLE_MAX_DIGITS);
+    for (int d = 0; d <= maxDigits; ++d) {
+        bool ok = true;
+        int64_t q;
+        for (size_t i = 0; i < count && ok; ++i) ok = quantize(values[i * stride], POW10[d], q);
+        if (ok) return d;
+    }
+    return -1;
+}
+
+// ===== д =====
+
+CandleStoreWriter::CandleStoreWriter(const std::string& filePath, const std::string& symbol, int priceDigits,
+                                     int volumeDigits)
+    : file(nullptr), path(filePath), header(), offset(sizeof(CandleStoreHeader)) {
+    if (priceDigits < -1 || priceDigits > CANDLE_MAX_DIGITS || volumeDigits < -1 || volumeDigits > CANDLE_MAX_DIGITS) {
+        throw std::invalid_argument("Сλ-1~12֮");
+    }
+    if (symbol.empty() || symbol.size() >= sizeof(header.symbol)) throw std::invalid_argument("Ʒ1~15֮");
+    header.magic = CANDLE_STORE_MAGIC;
+    header.version = CANDLE_STORE_VERSION;
+    header.priceDigits = static_cast<int8_t>(priceDigits);
+    header.volumeDigits = static_cast<int8_t>(volumeDigits);
+    std::memcpy(header.symbol, symbol.data(), symbol.size());
+    file = std::fopen(path.c_str(), "wb");
+    if (!file) throw std::invalid_argument("޷дKߴ洢ļ" + path);
+    // дռλļͷclose()ʱ
+    if (std::fwrite(&header, sizeof(header), 1, file) != 1) {
+        std::fclose(file);
+        file = nullptr;
+        throw std::runtime_error("Kߴ洢ļдʧܣ" + path);
+    }
+    times.reserve(CANDLE_CHUNK_BARS);
+    bars.reserve(CANDLE_CHUNK_BARS);
+}
+
+CandleStoreWriter::~CandleStoreWriter() {
+    if (!file) return;
+    try {
+        close();
+    } catch (...) {
+    }
+}
+
+void CandleStoreWriter::append(int64_t openTime, const KlineData& bar) {
+    if (!file) throw std::invalid_argument("Kߴ洢ļѹر");
+    int64_t last = !times.empty() ? times.back() : (!index.empty() ? index.back().lastTime : 0);
+    if ((!times.empty() || !index.empty()) && openTime <= last) {
+        throw std::invalid_argument("K߿ʱϸ" + std::to_string(openTime) + "");
+    }
+    times.push_back(openTime);
+    bars.push_back(bar);
+    header.barCount++;
+    if (times.size() == CANDLE_CHUNK_BARS) flushChunk();
+}
+
+void CandleStoreWriter::flushChunk() {
+    const size_t n = times.size();
+    if (n == 0) return;
+    buffer.clear();
+
+    // ʱ
+    bool constantStep = true;
+    int64_t step = n > 1 ? times[1] - times[0] : 0;
+    for (size_t i = 2; i < n && constantStep; ++i) constantStep = times[i] - times[i - 1] == step;
+    size_t pos = beginSection(buffer, constantStep ? TIME_CONSTANT_STEP : TIME_DELTA_OF_DELTA);
+    if (constantStep) {
+        putVarint(buffer, zigzag(step));
+    } else {
+        int64_t prevDelta = 0;
+        for (size_t i = 1; i < n; ++i) {
+            int64_t delta = times[i] - times[i - 1];
+            putVarint(buffer, zigzag(delta - prevDelta));
+            prevDelta = delta;
+        }
+    }
+    endSection(buffer, pos);
+
+    // ̼ۣ//ͼۣ̼ۣ
+    const double* base = &bars[0].open;
+    const size_t stride = sizeof(KlineData) / sizeof(double);
+    std::vector<int64_t> closeQ(n), q(n);
+    double priceScale = header.priceDigits >= 0 ? POW10[header.priceDigits] : 0.0;
+    bool closeFor = header.priceDigits >= 0;
+    for (size_t i = 0; i < n && closeFor; ++i) closeFor = quantize(bars[i].close, priceScale, closeQ[i]);
+    pos = beginSection(buffer, closeFor ? COLUMN_FOR : COLUMN_XOR);
+    if (closeFor) encodeFor(buffer, closeQ.data(), n);
+    else encodeXor(buffer, &bars[0].close, n, stride);
+    endSection(buffer, pos);
+
+    for (size_t column = 0; column < 3; ++column) {
+        const double* values = base + column;
+        bool useFor = closeFor;
+        for (size_t i = 0; i < n && useFor; ++i) {
+            useFor = quantize(values[i * stride], priceScale, q[i]);
+            q[i] -= closeQ[i];
+        }
+        pos = beginSection(buffer, useFor ? COLUMN_FOR : COLUMN_XOR);
+        if (useFor) encodeFor(buffer, q.data(), n);
+        else encodeXor(buffer, values, n, stride);
+        endSection(buffer, pos);
+    }
+
+    // ɽ
+    double volumeScale = header.volumeDigits >= 0 ? POW10[header.volumeDigits] : 0.0;
+    bool useVarint = header.volumeDigits >= 0;
+    for (size_t i = 0; i < n && useVarint; ++i) useVarint = quantize(bars[i].volume, volumeScale, q[i]) && q[i] >= 0;
+    pos = beginSection(buffer, useVarint ? COLUMN_VARINT : COLUMN_XOR);
+    if (useVarint) {
+        for (size_t i = 0; i < n; ++i) putVarint(buffer, static_cast<uint64_t>(q[i]));
+    } else {
+        encodeXor(buffer, &bars[0].volume, n, stride);
+    }
+    endSection(buffer, pos);
+
+    if (std::fwrite(buffer.data(), 1, buffer.size(), file) != buffer.size()) {
+        throw std::runtime_error("Kߴ洢ļдʧܣ" + path);
+    }
+    index.push_back({times.front(), times.back(), offset, static_cast<uint32_t>(buffer.size()), static_cast<uint32_t>(n)});
+    offset += buffer.size();
+    times.clear();
+    bars.clear();
+}
+
+void CandleStoreWriter::close() {
+    if (!file) return;
+    bool ok = false;
+    try {
+        flushChunk();
+        // 8ֽڶ룬ȡʱֱӳΪṹ
+        static const uint8_t zeros[8] = {0};
+        size_t padding = (8 - offset % 8) % 8;
+        header.indexOffset = offset + padding;
+        header.chunkCount = index.size();
+        ok = std::fwrite(zeros, 1, padding, file) == padding &&
+             std::fwrite(index.data(), sizeof(CandleChunkIndex), index.size(), file) == index.size() &&
+             std::fseek(file, 0, SEEK_SET) == 0 && std::fwrite(&header, sizeof(header), 1, file) == 1;
+    } catch (...) {
+        std::fclose(file);
+        file = nullptr;
+        throw;
+    }
+    ok = std::fclose(file) == 0 && ok;
+    file = nullptr;
+    if (!ok) throw std::runtime_error("Kߴ洢ļдʧܣ" + path);
+}
+
+// ===== ȡ =====
+
+CandleStoreReader::CandleStoreReader(const std::string& path)
+    : mapped(nullptr), mappedSize(0), fileHeader(nullptr), chunkIndex(nullptr), useSimd(candleStoreSimdSupported()) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::invalid_argument("޷Kߴ洢ļ" + path);
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(CandleStoreHeader)) {
+        ::close(fd);
+        throw std::invalid_argument("ЧKߴ洢ļ" + path);
+    }
+    mappedSize = static_cast<size_t>(st.st_size);
+    void* p = ::mmap(nullptr, mappedSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) throw std::invalid_argument("޷ӳKߴ洢ļ" + path);
+    mapped = static_cast<const uint8_t*>(p);
+    fileHeader = reinterpret_cast<const CandleStoreHeader*>(mapped);
+
+    const char* error = nullptr;
+    const CandleStoreHeader& h = *fileHeader;
+    if (h.magic != CANDLE_STORE_MAGIC) error = "ļʶ";
+    else if (h.version != CANDLE_STORE_VERSION) error = "汾֧";
+    else if (h.priceDigits < -1 || h.priceDigits > CANDLE_MAX_DIGITS || h.volumeDigits < -1 ||
+             h.volumeDigits > CANDLE_MAX_DIGITS) error = "λЧ";
+    else if (h.indexOffset % 8 != 0 || h.indexOffset > mappedSize ||
+             h.chunkCount > (mappedSize - h.indexOffset) / sizeof(CandleChunkIndex)) error = "Խ";
+    if (!error) {
+        chunkIndex = reinterpret_cast<const CandleChunkIndex*>(mapped + h.indexOffset);
+        uint64_t bars = 0;
+        for (size_t i = 0; i < h.chunkCount && !error; ++i) {
+            const CandleChunkIndex& c = chunkIndex[i];
+            if (c.offset < sizeof(CandleStoreHeader) || c.offset > h.indexOffset || c.size > h.indexOffset - c.offset) {
+                error = "ݿԽ";
+            } else if (c.barCount == 0 || c.barCount > CANDLE_CHUNK_BARS || c.lastTime < c.firstTime) {
+                error = "ݿЧ";
+            } else if (i > 0 && c.firstTime <= chunkIndex[i - 1].lastTime) {
+                error = "ݿʱδ";
+            }
+            bars += c.barCount;
+        }
+        if (!error && bars != h.barCount) error = "K";
+    }
+    if (error) {
+        ::munmap(const_cast<uint8_t*>(mapped), mappedSize);
+        throw std::invalid_argument("Kߴ洢ļ" + path + "Ч" + error);
+    }
+}
+
+CandleStoreReader::~CandleStoreReader() {
+    ::munmap(const_cast<uint8_t*>(mapped), mappedSize);
+}
+
+void CandleStoreReader::setSimdEnabled(bool enabled) {
+    useSimd = enabled && candleStoreSimdSupported();
+}
+
+size_t CandleStoreReader::decodeChunk(size_t chunk, int64_t* times, KlineData* bars) const {
+    if (chunk >= chunkCount()) throw std::invalid_argument("ݿԽ");
+    const CandleChunkIndex& ci = chunkIndex[chunk];
+    const size_t n = ci.barCount;
+    const uint8_t* p = mapped + ci.offset;
+    const uint8_t* end = p + ci.size;
+    const size_t stride = sizeof(KlineData) / sizeof(double);
+
+    // ʱ
+    Section s = readSection(p, end);
+    const uint8_t* q = s.data;
+    times[0] = ci.firstTime;
+    if (s.encoding == TIME_CONSTANT_STEP) {
+        int64_t step = unzigzag(getVarint(q, s.end));
+        for (size_t i = 1; i < n; ++i) times[i] = ci.firstTime + static_cast<int64_t>(i) * step;
+    } else if (s.encoding == TIME_DELTA_OF_DELTA) {
+        int64_t delta = 0;
+        for (size_t i = 1; i < n; ++i) {
+            delta += unzigzag(getVarint(q, s.end));
+            times[i] = times[i - 1] + delta;
+        }
+    } else {
+        corrupt("ʱбЧ");
+    }
+    if (times[n - 1] != ci.lastTime) corrupt("ʱ");
+
+    // ۸У̼ǰ//ͼΪֵ̼֮
+    double priceScale = fileHeader->priceDigits >= 0 ? POW10[fileHeader->priceDigits] : 0.0;
+    Section priceSections[4];
+    for (int column : {3, 0, 1, 2}) {
+        priceSections[column] = readSection(p, end);
+        uint8_t encoding = priceSections[column].encoding;
+        if (encoding != COLUMN_FOR && encoding != COLUMN_XOR) corrupt("۸бЧ");
+        if (encoding == COLUMN_FOR && (fileHeader->priceDigits < 0 || priceSections[3].encoding != COLUMN_FOR)) {
+            corrupt("۸бļͷ̼۲");
+        }
+    }
+    if (priceSections[3].encoding == COLUMN_FOR) {
+        PackedColumn cols[4];
+        bool allFor = true;
+        for (int column = 0; column < 4; ++column) {
+            if (priceSections[column].encoding == COLUMN_FOR) cols[column] = readPackedColumn(priceSections[column], n);
+            else allFor = false;
+        }
+        if (allFor) {
+            decodePrices(useSimd, cols, n, priceScale, bars);
+        } else {
+            int64_t closeQ[CANDLE_CHUNK_BARS];
+            unpackColumn(cols[3], n, nullptr, closeQ, priceScale, &bars[0].close, stride);
+            for (int column = 0; column < 3; ++column) {
+                double* out = &bars[0].open + column;
+                if (priceSections[column].encoding == COLUMN_FOR) unpackColumn(cols[column], n, closeQ, nullptr, priceScale, out, stride);
+                else decodeXor(priceSections[column], n, out, stride);
+            }
+        }
+    } else {
+        for (int column = 0; column < 4; ++column) decodeXor(priceSections[column], n, &bars[0].open + column, stride);
+    }
+
+    // ɽ
+    s = readSection(p, end);
+    if (s.encoding == COLUMN_VARINT) {
+        if (fileHeader->volumeDigits < 0) corrupt("ɽбļͷ");
+        // ˳ת䳤Ĵ
+        int64_t volumeQ[CANDLE_CHUNK_BARS];
+        q = s.data;
+        for (size_t i = 0; i < n; ++i) volumeQ[i] = static_cast<int64_t>(getVarintFast(q, s.end));
+        dequantize(useSimd, volumeQ, n, POW10[fileHeader->volumeDigits], &bars[0].volume, stride);
+    } else if (s.encoding == COLUMN_XOR) {
+        decodeXor(s, n, &bars[0].volume, stride);
+    } else {
+        corrupt("ɽбЧ");
+    }
+    return n;
+}
+
+size_t CandleStoreReader::readRange(int64_t from, int64_t to, std::vector<int64_t>& times,
+                                    std::vector<KlineData>& bars) const {
+    if (times.size() != bars.size()) throw std::invalid_argument("ʱKȲһ");
+    const size_t start = bars.size();
+    const CandleChunkIndex* first = std::lower_bound(chunkIndex, chunkIndex + chunkCount(), from,
+                                                     [](const CandleChunkIndex& c, int64_t t) { return c.lastTime < t; });
+    const CandleChunkIndex* last = first;
+    size_t capacity = 0;
+    for (; last < chunkIndex + chunkCount() && last->firstTime <= to; ++last) capacity += last->barCount;
+    // һݺԭؽ룬ֻβܲ⣬ҪصK
+    times.resize(start + capacity);
+    bars.resize(start + capacity);
+    size_t used = start;
+    for (const CandleChunkIndex* c = first; c < last; ++c) {
+        int64_t* t = times.data() + used;
+        KlineData* b = bars.data() + used;
+        size_t n = decodeChunk(static_cast<size_t>(c - chunkIndex), t, b);
+        size_t lo = 0, hi = n;
+        if (c->firstTime < from) lo = std::lower_bound(t, t + n, from) - t;
+        if (c->lastTime > to) hi = std::upper_bound(t, t + n, to) - t;
+        if (lo > 0) {
+            std::memmove(t, t + lo, (hi - lo) * sizeof(int64_t));
+            std::memmove(b, b + lo, (hi - lo) * sizeof(KlineData));
+        }
+        used += hi - lo;
+    }
+    times.resize(used);
+    bars.resize(used);
+    return bars.size() - start;
+}
+
+}  // namespace tradecheck
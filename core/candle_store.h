@@ -0,0 +1,113 @@
+#pragma once
+
+#include "support_resistance.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace tradecheck {
+
+// ʽѹKߴ洢ÿƷһļ
+// ļṹļͷ | ݿ... | ʱ
+// ÿݿCANDLE_CHUNK_BARSKߣзֱ룺
+//   ʱ䣺̶ʱֻײ֣zigzag䳤
+//   ̼ۣСλΪڲϵλѹFOR
+//   //ͼۣ̼֮ͬFORλѹ
+//   ɽı䳤
+// ޷λԭУλ㡢ֵȣ˻Ϊǰֵ룬֤дֵλһ
+const uint32_t CANDLE_STORE_MAGIC = 0x53434354; // "TCCS"
+const uint16_t CANDLE_STORE_VERSION = 1;
+const size_t CANDLE_CHUNK_BARS = 4096;
+
+// Сλޣʱʹ룩
+const int CANDLE_MAX_DIGITS = 12;
+
+struct CandleStoreHeader {
+    uint32_t magic;
+    uint16_t version;
+    int8_t priceDigits;  // ۸Сλ-1ʾ
+    int8_t volumeDigits; // ɽСλ-1ʾ
+    char symbol[16];
+    uint64_t barCount;
+    uint64_t chunkCount;
+    uint64_t indexOffset; // ļеƫ
+};
+static_assert(sizeof(CandleStoreHeader) == 48, "CandleStoreHeaderѱ仯");
+
+struct CandleChunkIndex {
+    int64_t firstTime; // ڵһK߿ʱ
+    int64_t lastTime;  // һK߿ʱ
+    uint64_t offset;   // ļеƫ
+    uint32_t size;     // ֽ
+    uint32_t barCount; // K
+};
+static_assert(sizeof(CandleChunkIndex) == 32, "CandleChunkIndexѱ仯");
+
+// ҳȫֵ10^-dλԭССλdҲʱ-1
+int detectDecimalDigits(const double* values, size_t count, size_t stride = 1, int maxDigits = CANDLE_MAX_DIGITS);
+
+// ˳д루ʱϸclose()ʱдһ顢ļͷ
+class CandleStoreWriter {
+public:
+    CandleStoreWriter(const std::string& path, const std::string& symbol, int priceDigits, int volumeDigits);
+    ~CandleStoreWriter();
+
+    CandleStoreWriter(const CandleStoreWriter&) = delete;
+    CandleStoreWriter& operator=(const CandleStoreWriter&) = delete;
+
+    void append(int64_t openTime, const KlineData& bar);
+    void close();
+
+    uint64_t barCount() const { return header.barCount; }
+
+private:
+    FILE* file;
+    std::string path;
+    CandleStoreHeader header;
+    uint64_t offset;
+    std::vector<CandleChunkIndex> index;
+    std::vector<int64_t> times;
+    std::vector<KlineData> bars;
+    std::vector<uint8_t> buffer;
+
+    void flushChunk();
+};
+
+// ֻʣmmapļɰʱ룻벻޸Ķ״̬ɶ̹߳
+class CandleStoreReader {
+public:
+    explicit CandleStoreReader(const std::string& path);
+    ~CandleStoreReader();
+
+    CandleStoreReader(const CandleStoreReader&) = delete;
+    CandleStoreReader& operator=(const CandleStoreReader&) = delete;
+
+    const CandleStoreHeader& header() const { return *fileHeader; }
+    size_t chunkCount() const { return static_cast<size_t>(fileHeader->chunkCount); }
+    const CandleChunkIndex& chunk(size_t i) const { return chunkIndex[i]; }
+    size_t fileSize() const { return mappedSize; }
+
+    // 뵥鵽÷CANDLE_CHUNK_BARSԪأK
+    size_t decodeChunk(size_t chunk, int64_t* times, KlineData* bars) const;
+
+    // 뿪ʱ[from, to]ڵȫKߣ׷ӵ׷ӵK
+    size_t readRange(int64_t from, int64_t to, std::vector<int64_t>& times, std::vector<KlineData>& bars) const;
+
+    // ǷʹAVX2루ĬϰCPU֧رպ߱·λһ£
+    bool simdEnabled() const { return useSimd; }
+    void setSimdEnabled(bool enabled);
+
+private:
+    const uint8_t* mapped;
+    size_t mappedSize;
+    const CandleStoreHeader* fileHeader;
+    const CandleChunkIndex* chunkIndex;
+    bool useSimd;
+};
+
+// ǰCPUǷ֧AVX2·
+bool candleStoreSimdSupported();
+
+}  // namespace tradecheck
@@ -0,0 +1,290 @@
+#include "consistency_score.h"
+#include <cmath>
+#include <algorithm>
+#include <cstdio>
+
+namespace tradecheck {
+
+// תKΪַ
+std::string timeframeToString(Timeframe tf) {
+    switch (tf) {
+        case Timeframe::TF_4H: return "4Сʱ";
+        case Timeframe::TF_DAY: return "";
+        case Timeframe::TF_WEEK: return "";
+        default: return "δ֪";
+    }
+}
+
+// ̬ʱƣ̬ı
+static const char* patternTfName(PatternTimeframe ptf) {
+    switch (ptf) {
+        case PatternTimeframe::SHORT: return "ڣ1ܣ";
+        case PatternTimeframe::MEDIUM: return "ڣ1-4ܣ";
+        case PatternTimeframe::LONG: return "ڣ4ܣ";
+        default: return "δ֪";
+    }
+}
+
+// ת̬ʱΪַ
+std::string patternTfToString(PatternTimeframe ptf) {
+    return patternTfName(ptf);
+}
+
+// תͻƷΪַ
+std::string triangleBreakDirToString(TriangleBreakDir dir) {
+    switch (dir) {
+        case TriangleBreakDir::UP: return "ͻ";
+        case TriangleBreakDir::DOWN: return "ͻ";
+        case TriangleBreakDir::NONE: return "δͻ";
+        default: return "δ֪ͻƷ";
+    }
+}
+
+// ֹֹܸʣ
+void updateStopLossRates(TradeAnalysis& ta) {
+    if (ta.openDir == "") {
+        ta.stopLossRate = std::fabs((ta.openPrice - ta.stopLoss) / ta.openPrice) * 100;
+    } else {
+        ta.stopLossRate = std::fabs((ta.stopLoss - ta.openPrice) / ta.openPrice) * 100;
+    }
+    ta.leverStopLossRisk = ta.stopLossRate * ta.leverage;
+}
+
+// ִбֻмԪأȽϼɣ䣩
+template <typename List, typename Key>
+static int maxEqualCount(const List& list, Key key) {
+    int maxCount = 0;
+    for (size_t i = 0; i < list.size(); ++i) {
+        int count = 0;
+        for (size_t j = 0; j < list.size(); ++j) {
+            if (key(list[j]) == key(list[i])) count++;
+        }
+        maxCount = std::max(maxCount, count);
+    }
+    return maxCount;
+}
+
+// EMAźһԵ÷
+int calculateEMAConsistency(const std::pmr::vector<EMAData>& emaList) {
+    if (emaList.empty()) return 0;
+    int maxCount = maxEqualCount(emaList, [](const EMAData& e) -> const std::pmr::string& { return e.trend; });
+    return (maxCount * 100) / emaList.size();
+}
+
+// KSTźһԵ÷
+int calculateKSTConsistency(const std::pmr::vector<KSTData>& kstList) {
+    if (kstList.empty()) return 0;
+    int maxCount = maxEqualCount(kstList, [](const KSTData& k) -> const std::pmr::string& { return k.cross; });
+    return (maxCount * 100) / kstList.size();
+}
+
+// ֹʺԵ÷
+int calculateBaseStopLossScore(const TradeAnalysis& ta) {
+    return calculateBaseStopLossScore(ta.stopLossRate, ta.atrRate, ScoreWeights());
+}
+
+// ֹܸյ÷
+int calculateLeverStopLossScore(const TradeAnalysis& ta, bool& isHighRisk) {
+    return calculateLeverStopLossScore(ta.leverStopLossRisk, ScoreWeights(), isHighRisk);
+}
+
+// 㿪ƥȵ÷֣ͻƴӰ죩
+int calculateDirTrendMatchScore(const TradeAnalysis& ta) {
+    int matchCount = 0;
+    if (ta.openDir == "") {
+        if (ta.longTrend == "") matchCount++;
+        if (ta.midTrend == "") matchCount++;
+        if (ta.shortTrend == "") matchCount++;
+    } else {
+        if (ta.longTrend == "½") matchCount++;
+        if (ta.midTrend == "½") matchCount++;
+        if (ta.shortTrend == "½") matchCount++;
+    }
+    int baseScore = 0;
+    if (matchCount == 3) baseScore = 20;
+    else if (matchCount == 2) baseScore = 15;
+    else if (matchCount == 1) baseScore = 5;
+    else baseScore = 0;
+
+    // ͻƴ۷
+    int breakTimes = ta.shortTrendLineBreakTimes;
+    int penalty = 0;
+    if (breakTimes == 3) penalty = 3;
+    else if (breakTimes == 5) penalty = 8;
+    else if (breakTimes >= 7) penalty = 15;
+
+    return std::max(baseScore - penalty, 0);
+}
+
+// ȡۺ
+ScoreFeatures extractScoreFeatures(const TradeAnalysis& ta) {
+    return {calculateEMAConsistency(ta.emaList), calculateKSTConsistency(ta.kstList),
+            ta.stopLossRate, ta.leverStopLossRisk, calculateDirTrendMatchScore(ta), ta.atrRate};
+}
+
+// ۺһָ֣Ȩأ
+int calculateTotalConsistency(const TradeAnalysis& ta, bool& isHighLeverRisk, const ScoreWeights& w) {
+    return static_cast<int>(calculateWeightedConsistency(extractScoreFeatures(ta), w, isHighLeverRisk));
+}
+
+// ۺһ
+int calculateTotalConsistency(const TradeAnalysis& ta, bool& isHighLeverRisk) {
+    return calculateTotalConsistency(ta, isHighLeverRisk, ScoreWeights());
+}
+
+// ׷һƬƴӵìܵ㣨ֱбԪƴӣʱַ
+template <typename List>
+static void addContradiction(List& out, std::initializer_list<std::string_view> parts) {
+    size_t total = 0;
+    for (std::string_view p : parts) total += p.size();
+    auto& text = out.emplace_back();
+    text.reserve(total);
+    for (std::string_view p : parts) text.append(p.data(), p.size());
+}
+
+// ֵдìܵıջϸʽ䣩
+struct ThresholdText {
+    char buf[32];
+    std::string_view text;
+    explicit ThresholdText(double value) {
+        int n = std::snprintf(buf, sizeof(buf), "%g", value);
+        text = std::string_view(buf, n > 0 ? static_cast<size_t>(n) : 0);
+    }
+};
+
+// ָìܵ㣨бͿΪstd::vector<std::string>ContradictionList
+template <typename List>
+static void collectContradictions(const TradeAnalysis& ta, bool isHighLeverRisk, const ScoreWeights& w,
+                                  List& contradictions) {
+    int emaScore = calculateEMAConsistency(ta.emaList);
+    int kstScore = calculateKSTConsistency(ta.kstList);
+    double baseSLRate = ta.stopLossRate;
+    double leverSLRisk = ta.leverStopLossRisk;
+    int shortBreakTimes = ta.shortTrendLineBreakTimes;
+
+    // RSIì
+    if ((ta.longTrend == "" || ta.midTrend == "") && ta.rsiLevel == "") {
+        addContradiction(contradictions, {"/ϣRSIԴ"});
+    }
+    if ((ta.longTrend == "½" || ta.midTrend == "½") && ta.rsiLevel == "") {
+        addContradiction(contradictions, {"/£RSIԴ"});
+    }
+
+    // ͻƴì
+    if (shortBreakTimes >= 2) {
+        addContradiction(contradictions, {"ͻƴ2ΣЧԼ߼һ½"});
+    }
+    if (shortBreakTimes >= 3) {
+        addContradiction(contradictions, {"߷ѡͻƴ3ΣʧЧ߼ȱ֧"});
+    }
+
+    // ۸̬ìܣͻƷ
+    for (const auto& pat : ta.pricePatterns) {
+        if (pat.name == PRICE_PATTERN_NAMES[PATTERN_NONE]) continue;
+        std::string_view patTf = patternTfName(pat.tf);
+        std::string_view trendTf = pat.tf == PatternTimeframe::LONG ? "" : (pat.tf == PatternTimeframe::MEDIUM ? "" : "");
+
+        // ̬µì
+        if ((pat.name == PRICE_PATTERN_NAMES[PATTERN_HEAD_SHOULDERS_BOTTOM] || pat.name == PRICE_PATTERN_NAMES[PATTERN_FLAG_UP] ||
+             pat.name == PRICE_PATTERN_NAMES[PATTERN_DOUBLE_BOTTOM]) &&
+            ((pat.tf == PatternTimeframe::LONG && ta.longTrend == "½") ||
+             (pat.tf == PatternTimeframe::MEDIUM && ta.midTrend == "½") ||
+             (pat.tf == PatternTimeframe::SHORT && ta.shortTrend == "½"))) {
+            addContradiction(contradictions, {patTf, "", pat.name, "̬Ӧ", trendTf, "½Ƴͻ"});
+        }
+
+        // ̬ì
+        if ((pat.name == PRICE_PATTERN_NAMES[PATTERN_HEAD_SHOULDERS_TOP] || pat.name == PRICE_PATTERN_NAMES[PATTERN_FLAG_DOWN] ||
+             pat.name == PRICE_PATTERN_NAMES[PATTERN_DOUBLE_TOP]) &&
+            ((pat.tf == PatternTimeframe::LONG && ta.longTrend == "") ||
+             (pat.tf == PatternTimeframe::MEDIUM && ta.midTrend == "") ||
+             (pat.tf == PatternTimeframe::SHORT && ta.shortTrend == ""))) {
+            addContradiction(contradictions, {patTf, "", pat.name, "̬Ӧ", trendTf, "Ƴͻ"});
+        }
+
+        // ̬ì
+        if (pat.name == PRICE_PATTERN_NAMES[PATTERN_TRIANGLE_CONVERGING]) {
+            if (ta.longTrend == "") {
+                addContradiction(contradictions, {patTf, "Ρȷƣں̬ЧԴ"});
+            }
+            if (ta.shortTrend == "" && pat.breakDir == TriangleBreakDir::DOWN) {
+                addContradiction(contradictions, {patTf, "Ρϣͻأì"});
+            }
+            if (ta.shortTrend == "½" && pat.breakDir == TriangleBreakDir::UP) {
+                addContradiction(contradictions, {patTf, "Ρ£ͻأì"});
+            }
+        }
+        if (pat.name == PRICE_PATTERN_NAMES[PATTERN_TRIANGLE_DIVERGING]) {
+            if (ta.longTrend != "" && pat.breakDir == TriangleBreakDir::NONE) {
+                addContradiction(contradictions, {patTf, "ɢΡԤʾƷתδͻƣ̬źЧ"});
+            }
+            if (pat.breakDir == TriangleBreakDir::UP && ta.openDir == "") {
+                addContradiction(contradictions, {patTf, "ɢΡͻƣյͻ"});
+            }
+            if (pat.breakDir == TriangleBreakDir::DOWN && ta.openDir == "") {
+                addContradiction(contradictions, {patTf, "ɢΡͻƣ൥ͻ"});
+            }
+        }
+    }
+
+    // EMA/KSTһԵì
+    if (emaScore < 60) addContradiction(contradictions, {"EMAʱźһԵͣ<60֣жϻ"});
+    if (kstScore < 60) addContradiction(contradictions, {"KSTʱźһԵͣ<60֣ԽźŻ"});
+
+    // ֹìܣATRʱжϣ򰴹̶ٷֱȣ
+    if (ta.atrRate > 0) {
+        double multiple = baseSLRate / ta.atrRate;
+        if (multiple > w.slAcceptHighAtr) {
+            ThresholdText high(w.slAcceptHighAtr);
+            addContradiction(contradictions, {"ֹ볬", high.text, "ATRԶʿƫ"});
+        }
+        if (multiple < w.slAcceptLowAtr) {
+            ThresholdText low(w.slAcceptLowAtr);
+            addContradiction(contradictions, {"ֹ벻", low.text, "ATRΧڣױɨ"});
+        }
+    } else {
+        if (baseSLRate > w.slAcceptHigh) {
+            ThresholdText high(w.slAcceptHigh);
+            addContradiction(contradictions, {"ֹʳ", high.text, "%޸ܸʱƫ"});
+        }
+        if (baseSLRate < w.slAcceptLow) {
+            ThresholdText low(w.slAcceptLow);
+            addContradiction(contradictions, {"ֹʵ", low.text, "%ױСɨ"});
+        }
+    }
+
+    // ֹܸì
+    ThresholdText safe(w.leverSafe), warn(w.leverWarn);
+    if (leverSLRisk > w.leverWarn) {
+        addContradiction(contradictions, {"߷ѡֹܸʣ", warn.text, "%ֹ𽫿", warn.text,
+                                          "%֤𣬼˷գ"});
+    } else if (leverSLRisk > w.leverSafe) {
+        addContradiction(contradictions, {"ֹܸ", safe.text, "%-", warn.text, "%ֹƫߣ"});
+    }
+
+    // ì
+    int dirMatch = calculateDirTrendMatchScore(ta);
+    if (dirMatch == 0) addContradiction(contradictions, {"ƥΪ0ҶͻƵ߼Ч"});
+}
+
+// ָìܵ
+std::vector<std::string> analyzeContradictions(const TradeAnalysis& ta, bool isHighLeverRisk, const ScoreWeights& w) {
+    std::vector<std::string> contradictions;
+    collectContradictions(ta, isHighLeverRisk, w, contradictions);
+    return contradictions;
+}
+
+std::vector<std::string> analyzeContradictions(const TradeAnalysis& ta, bool isHighLeverRisk) {
+    return analyzeContradictions(ta, isHighLeverRisk, ScoreWeights());
+}
+
+// ָìܵ㣬׷ӵout
+void analyzeContradictions(const TradeAnalysis& ta, bool isHighLeverRisk, ContradictionList& out, const ScoreWeights& w) {
+    collectContradictions(ta, isHighLeverRisk, w, out);
+}
+
+void analyzeContradictions(const TradeAnalysis& ta, bool isHighLeverRisk, ContradictionList& out) {
+    collectContradictions(ta, isHighLeverRisk, ScoreWeights(), out);
+}
+
+}  // namespace tradecheck
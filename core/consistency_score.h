@@ -0,0 +1,334 @@
+#pragma once
+
+#include <cstddef>
+#include <initializer_list>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tradecheck {
+
+// ʱö٣Kڣ
+enum class Timeframe {
+    TF_4H,
+    TF_DAY,
+    TF_WEEK,
+};
+
+// ۸̬ʱö٣̬ڣ
+enum class PatternTimeframe {
+    SHORT,  // ڣ1ܣ
+    MEDIUM, // ڣ1-4ܣ
+    LONG,   // ڣ4ܣ
+};
+
+// ͻƷö
+enum class TriangleBreakDir {
+    UP,    // ͻ
+    DOWN,  // ͻ
+    NONE   // δͻ
+};
+
+// תKΪַ
+std::string timeframeToString(Timeframe tf);
+
+// ת̬ʱΪַ
+std::string patternTfToString(PatternTimeframe ptf);
+
+// תͻƷΪַ
+std::string triangleBreakDirToString(TriangleBreakDir dir);
+
+// ṹķĬʹȫֶѣʱָAnalysisArena
+// ͬһеԪػԶø÷uses-allocator죩
+using AnalysisAllocator = std::pmr::polymorphic_allocator<char>;
+
+// EMAʱ
+struct EMAData {
+    using allocator_type = AnalysisAllocator;
+
+    Timeframe tf = Timeframe::TF_4H;
+    int period = 0;
+    std::pmr::string trend;
+    bool isTurn = false;
+
+    EMAData() = default;
+    explicit EMAData(const allocator_type& a) : trend(a) {}
+    EMAData(Timeframe t, int p, std::string_view tr, bool turn, const allocator_type& a = {})
+        : tf(t), period(p), trend(tr, a), isTurn(turn) {}
+    EMAData(const EMAData&) = default;
+    EMAData(EMAData&&) = default;
+    EMAData(const EMAData& o, const allocator_type& a) : EMAData(a) { *this = o; }
+    EMAData(EMAData&& o, const allocator_type& a) : EMAData(a) { *this = std::move(o); }
+    EMAData& operator=(const EMAData&) = default;
+    EMAData& operator=(EMAData&&) = default;
+};
+
+// KSTʱ
+struct KSTData {
+    using allocator_type = AnalysisAllocator;
+
+    Timeframe tf = Timeframe::TF_4H;
+    std::pmr::vector<int> periods;
+    std::pmr::string cross;
+
+    KSTData() = default;
+    explicit KSTData(const allocator_type& a) : periods(a), cross(a) {}
+    KSTData(Timeframe t, std::initializer_list<int> p, std::string_view c, const allocator_type& a = {})
+        : tf(t), periods(p, a), cross(c, a) {}
+    KSTData(const KSTData&) = default;
+    KSTData(KSTData&&) = default;
+    KSTData(const KSTData& o, const allocator_type& a) : KSTData(a) { *this = o; }
+    KSTData(KSTData&& o, const allocator_type& a) : KSTData(a) { *this = std::move(o); }
+    KSTData& operator=(const KSTData&) = default;
+    KSTData& operator=(KSTData&&) = default;
+};
+
+// ۸̬±꼴Э/Cӿе̬룬ƼPricePattern::nameǰ˶ȡдƣ
+enum PricePatternCode {
+    PATTERN_HEAD_SHOULDERS_TOP = 0,
+    PATTERN_HEAD_SHOULDERS_BOTTOM,
+    PATTERN_FLAG_UP,
+    PATTERN_FLAG_DOWN,
+    PATTERN_TRIANGLE_CONVERGING,
+    PATTERN_TRIANGLE_DIVERGING,
+    PATTERN_DOUBLE_TOP,
+    PATTERN_DOUBLE_BOTTOM,
+    PATTERN_NONE,
+    PRICE_PATTERN_COUNT
+};
+const char* const PRICE_PATTERN_NAMES[PRICE_PATTERN_COUNT] = {
+    "ͷ綥", "ͷ", "", "", "Σ", "Σɢ", "˫ض", "˫ص", ""
+};
+// ʾƣ˵PRICE_PATTERN_NAMES±Ӧ
+const char* const PRICE_PATTERN_LABELS[PRICE_PATTERN_COUNT] = {
+    "ͷ綥", "ͷףǣ", "Σǣ", "Σ",
+    "Σƣ", "Σɢתƣ", "˫ض", "˫صףǣ", ""
+};
+
+// ۸̬ṹ壨+ͻƷ
+struct PricePattern {
+    using allocator_type = AnalysisAllocator;
+
+    std::pmr::string name;                                // ̬ƣ"Σ"
+    PatternTimeframe tf = PatternTimeframe::SHORT;        // ̬ʱ
+    TriangleBreakDir breakDir = TriangleBreakDir::NONE;   // ͻƷ򣨷̬ĬNONE
+
+    PricePattern() = default;
+    explicit PricePattern(const allocator_type& a) : name(a) {}
+    PricePattern(std::string_view n, PatternTimeframe t, TriangleBreakDir d, const allocator_type& a = {})
+        : name(n, a), tf(t), breakDir(d) {}
+    PricePattern(const PricePattern&) = default;
+    PricePattern(PricePattern&&) = default;
+    PricePattern(const PricePattern& o, const allocator_type& a) : PricePattern(a) { *this = o; }
+    PricePattern(PricePattern&& o, const allocator_type& a) : PricePattern(a) { *this = std::move(o); }
+    PricePattern& operator=(const PricePattern&) = default;
+    PricePattern& operator=(PricePattern&&) = default;
+};
+
+// Ľ׷ṹ壨ַбʹùʱָķ
+struct TradeAnalysis {
+    using allocator_type = AnalysisAllocator;
+
+    std::pmr::string coinType;   // ױ
+    std::pmr::string openDir;    // 򣨶/գ
+    int leverage = 0;            // ܸ˱
+    double openPrice = 0;        // Ŀ꿪
+    double liquidPrice = 0;      // ǿƽ
+    double stopLoss = 0;         // ֹ
+    double stopLossRate = 0;     // ֹ
+    double leverStopLossRisk = 0; // ֹܸ
+    double atrRate = 0;          // ATR/ۣ%0ʾδṩKߣֹʰ̶
+
+    // 
+    std::pmr::string longTrend;
+    std::pmr::string midTrend;
+    std::pmr::string shortTrend;
+    int shortTrendLineBreakTimes = 0; // ͻƴ0
+
+    // RSIָ
+    std::pmr::string rsiLevel;
+    int rsiDuration = 0;
+    std::pmr::string rsiUnit;
+
+    // ۸̬
+    std::pmr::vector<PricePattern> pricePatterns;
+
+    // EMA/KSTʱ
+    std::pmr::vector<EMAData> emaList;
+    std::pmr::vector<KSTData> kstList;
+
+    TradeAnalysis() = default;
+    explicit TradeAnalysis(const allocator_type& a)
+        : coinType(a), openDir(a), longTrend(a), midTrend(a), shortTrend(a), rsiLevel(a), rsiUnit(a),
+          pricePatterns(a), emaList(a), kstList(a) {}
+    TradeAnalysis(const TradeAnalysis&) = default;
+    TradeAnalysis(TradeAnalysis&&) = default;
+    // ֵƵһʱԪؿĿ
+    TradeAnalysis(const TradeAnalysis& o, const allocator_type& a) : TradeAnalysis(a) { *this = o; }
+    TradeAnalysis(TradeAnalysis&& o, const allocator_type& a) : TradeAnalysis(a) { *this = std::move(o); }
+    TradeAnalysis& operator=(const TradeAnalysis&) = default;
+    TradeAnalysis& operator=(TradeAnalysis&&) = default;
+
+    allocator_type get_allocator() const { return coinType.get_allocator(); }
+};
+
+// ìܵбԪб÷
+using ContradictionList = std::pmr::vector<std::pmr::string>;
+
+// õĵڴֻƶָ룬reset()һͷ
+// ĳǰʱ룬´reset()ʱл֮ͬȹģβٵmalloc
+class AnalysisArena {
+public:
+    explicit AnalysisArena(size_t initialBytes = 64 * 1024) : block(initialBytes) { rebuild(); }
+
+    AnalysisArena(const AnalysisArena&) = delete;
+    AnalysisArena& operator=(const AnalysisArena&) = delete;
+
+    std::pmr::memory_resource* resource() { return &*pool; }
+    AnalysisAllocator allocator() { return AnalysisAllocator(&*pool); }
+
+    void reset() {
+        size_t overflow = upstream.bytes;
+        pool->release();
+        upstream.bytes = 0;
+        if (overflow > 0) {
+            block.resize(block.size() + overflow);
+            rebuild();
+        }
+    }
+
+    size_t capacity() const { return block.size(); }
+
+private:
+    // ͳѵֽ
+    class CountingResource : public std::pmr::memory_resource {
+    public:
+        size_t bytes = 0;
+
+    private:
+        void* do_allocate(size_t n, size_t align) override {
+            bytes += n;
+            return std::pmr::new_delete_resource()->allocate(n, align);
+        }
+        void do_deallocate(void* p, size_t n, size_t align) override {
+            std::pmr::new_delete_resource()->deallocate(p, n, align);
+        }
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+    };
+
+    std::vector<std::byte> block;
+    CountingResource upstream;
+    std::optional<std::pmr::monotonic_buffer_resource> pool;
+
+    void rebuild() {
+        pool.reset();
+        pool.emplace(block.data(), block.size(), &upstream);
+    }
+};
+
+// ۺһֵȨֵĬֵԭӲȨУ׼
+struct ScoreWeights {
+    double emaWeight = 0.3;       // EMAһԵ÷Ȩ
+    double kstWeight = 0.3;       // KSTһԵ÷Ȩ
+    double baseSLWeight = 1.0;    // ֹʵ÷Ȩ
+    double leverSLWeight = 1.0;   // ֹܸյ÷Ȩ
+    double dirMatchWeight = 1.0;  // ƥȵ÷Ȩ
+    // ֹ䣨%[slIdealLow, slIdealHigh]֣[slAcceptLow, slAcceptHigh]
+    double slIdealLow = 3.0;
+    double slIdealHigh = 8.0;
+    double slAcceptLow = 1.0;
+    double slAcceptHigh = 10.0;
+    // ṩATRʱİֹATR֣[slIdealLowAtr, slIdealHighAtr]֣[slAcceptLowAtr, slAcceptHighAtr]
+    double slIdealLowAtr = 1.5;
+    double slIdealHighAtr = 3.0;
+    double slAcceptLowAtr = 1.0;
+    double slAcceptHighAtr = 4.0;
+    // ֹܸ䣨%leverSafe֣leverWarn֣0
+    double leverSafe = 40.0;
+    double leverWarn = 60.0;
+};
+
+// ֹֹܸʣ
+void updateStopLossRates(TradeAnalysis& ta);
+
+// EMAźһԵ÷
+int calculateEMAConsistency(const std::pmr::vector<EMAData>& emaList);
+
+// KSTźһԵ÷
+int calculateKSTConsistency(const std::pmr::vector<KSTData>& kstList);
+
+// ֹʺԵ÷
+inline int calculateBaseStopLossScore(double rate, const ScoreWeights& w) {
+    if (rate >= w.slIdealLow && rate <= w.slIdealHigh) return 10;
+    else if ((rate >= w.slAcceptLow && rate < w.slIdealLow) || (rate > w.slIdealHigh && rate <= w.slAcceptHigh)) return 5;
+    else return 0;
+}
+
+// ʹһֹʺԵ÷֣atrRate0ʱ˻ع̶䣩
+inline int calculateBaseStopLossScore(double rate, double atrRate, const ScoreWeights& w) {
+    if (!(atrRate > 0)) return calculateBaseStopLossScore(rate, w);
+    double multiple = rate / atrRate;
+    if (multiple >= w.slIdealLowAtr && multiple <= w.slIdealHighAtr) return 10;
+    else if ((multiple >= w.slAcceptLowAtr && multiple < w.slIdealLowAtr) ||
+             (multiple > w.slIdealHighAtr && multiple <= w.slAcceptHighAtr)) return 5;
+    else return 0;
+}
+
+// ֹʺԵ÷
+int calculateBaseStopLossScore(const TradeAnalysis& ta);
+
+// ֹܸյ÷
+inline int calculateLeverStopLossScore(double leverRisk, const ScoreWeights& w, bool& isHighRisk) {
+    isHighRisk = false;
+    if (leverRisk <= w.leverSafe) return 10;
+    else if (leverRisk > w.leverSafe && leverRisk <= w.leverWarn) return 5;
+    else {
+        isHighRisk = true;
+        return 0;
+    }
+}
+
+// ֹܸյ÷
+int calculateLeverStopLossScore(const TradeAnalysis& ta, bool& isHighRisk);
+
+// 㿪ƥȵ÷֣ͻƴӰ죩
+int calculateDirTrendMatchScore(const TradeAnalysis& ta);
+
+// ۺȨ޹أԤȼ󷴸ͬȨأ
+struct ScoreFeatures {
+    int emaScore;             // EMAһԵ÷
+    int kstScore;             // KSTһԵ÷
+    double stopLossRate;      // ֹʣ%
+    double leverStopLossRisk; // ֹܸʣ%
+    int dirMatchScore;        // ƥȵ÷
+    double atrRate;           // ATR/ۣ%0ʾ̶
+};
+
+// ȡۺ
+ScoreFeatures extractScoreFeatures(const TradeAnalysis& ta);
+
+// Ȩؼۺϵ÷֣δȡ
+inline double calculateWeightedConsistency(const ScoreFeatures& f, const ScoreWeights& w, bool& isHighLeverRisk) {
+    int baseSLScore = calculateBaseStopLossScore(f.stopLossRate, f.atrRate, w);
+    int leverSLScore = calculateLeverStopLossScore(f.leverStopLossRisk, w, isHighLeverRisk);
+    return (f.emaScore * w.emaWeight) + (f.kstScore * w.kstWeight) + baseSLScore * w.baseSLWeight +
+           leverSLScore * w.leverSLWeight + f.dirMatchScore * w.dirMatchWeight;
+}
+
+// ۺһָ֣Ȩأ
+int calculateTotalConsistency(const TradeAnalysis& ta, bool& isHighLeverRisk, const ScoreWeights& w);
+
+// ۺһ
+int calculateTotalConsistency(const TradeAnalysis& ta, bool& isHighLeverRisk);
+
+// ָìܵ㣨ֹֹܸյֵıȡȨأĬȨؼԭӲֵ
+std::vector<std::string> analyzeContradictions(const TradeAnalysis& ta, bool isHighLeverRisk, const ScoreWeights& w);
+std::vector<std::string> analyzeContradictions(const TradeAnalysis& ta, bool isHighLeverRisk);
+
+// ָìܵ㣬׷ӵoutıoutķ䣬AnalysisArenaʱѷ䣩
+void analyzeContradictions(const TradeAnalysis& ta, bool isHighLeverRisk, ContradictionList& out, const ScoreWeights& w);
+void analyzeContradictions(const TradeAnalysis& ta, bool isHighLeverRisk, ContradictionList& out);
+
+}  // namespace tradecheck
@@ -0,0 +1,310 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace tradecheck {
+
+// ԼעԼO(1)ңÿ
+// Լ֮䱣ֲ䣨ƳĺԼŲΪͣã÷ɻ
+
+const int CONTRACT_SYMBOL_LENGTH = 16;
+const uint32_t INVALID_CONTRACT_ID = UINT32_MAX;
+
+// Լͣռԭֽڣ־еĺԼUSDTλ룩
+enum class ContractType : uint8_t {
+    LINEAR_USDT = 0,  // USDTλ֤ӯUSDT
+    INVERSE_COIN = 1  // ұλԼUSDƼ֤ۡӯԱҼ
+};
+
+// Լ
+struct ContractSpec {
+    char symbol[CONTRACT_SYMBOL_LENGTH]; // Լ루BTCUSDT\0β
+    double riskThreshold;                // ϵֵܸˡλռȣ
+    double maintenanceMarginRate;        // άֱ֤
+    double tickSize;                     // С۸䶯λ
+    bool enabled;                        // Ƿڵǰ
+    ContractType type;                   // Լ
+};
+static_assert(sizeof(ContractSpec) == 48, "ContractSpecѱ仯־ֽڱ棩");
+
+// 첢УԼ
+inline ContractSpec makeContractSpec(const std::string& symbol, double threshold, double mmr, double tickSize) {
+    if (symbol.empty() || symbol.size() >= static_cast<size_t>(CONTRACT_SYMBOL_LENGTH)) {
+        throw std::invalid_argument("Լ볤1~15ַ֮䣺" + symbol);
+    }
+    if (threshold <= 0) throw std::invalid_argument("ֵ0" + symbol);
+    if (mmr < 0 || mmr >= 1) throw std::invalid_argument("άֱ֤0~1֮䣺" + symbol);
+    if (tickSize <= 0) throw std::invalid_argument("С۸䶯0" + symbol);
+    ContractSpec spec{};
+    std::memcpy(spec.symbol, symbol.data(), symbol.size());
+    spec.riskThreshold = threshold;
+    spec.maintenanceMarginRate = mmr;
+    spec.tickSize = tickSize;
+    spec.enabled = true;
+    spec.type = ContractType::LINEAR_USDT;
+    return spec;
+}
+
+inline ContractSpec makeContractSpec(const std::string& symbol, double threshold, double mmr, double tickSize,
+                                     ContractType type) {
+    ContractSpec spec = makeContractSpec(symbol, threshold, mmr, tickSize);
+    spec.type = type;
+    return spec;
+}
+
+inline const char* contractTypeName(ContractType type) {
+    return type == ContractType::INVERSE_COIN ? "inverse" : "linear";
+}
+
+// ֤֣USDTλΪUSDTұλȡԼȥĩβUSDBTCUSDΪBTC
+inline std::string marginAsset(const ContractSpec& spec) {
+    if (spec.type == ContractType::LINEAR_USDT) return "USDT";
+    std::string symbol(spec.symbol);
+    if (symbol.size() > 3 && symbol.compare(symbol.size() - 3, 3, "USD") == 0) return symbol.substr(0, symbol.size() - 3);
+    return "";
+}
+
+// ĬϺԼδṩļʱʹãֵͳһΪ1000άֱ֤0.5%
+inline std::vector<ContractSpec> defaultContracts() {
+    return {
+        makeContractSpec("BTCUSDT", 1000.0, 0.005, 0.1),
+        makeContractSpec("ETHUSDT", 1000.0, 0.005, 0.01),
+        makeContractSpec("SOLUSDT", 1000.0, 0.005, 0.001),
+        makeContractSpec("DOGEUSDT", 1000.0, 0.005, 0.00001),
+    };
+}
+
+// Լãÿ Լ ֵ άֱ֤ С۸䶯 [linear|inverse]#ͷΪעͣĬlinear
+inline std::vector<ContractSpec> parseContractConfig(std::istream& in) {
+    std::vector<ContractSpec> specs;
+    std::string line;
+    int lineNo = 0;
+    while (std::getline(in, line)) {
+        lineNo++;
+        size_t start = line.find_first_not_of(" \t\r");
+        if (start == std::string::npos || line[start] == '#') continue;
+        std::istringstream ss(line);
+        std::string symbol;
+        double threshold, mmr, tick;
+        if (!(ss >> symbol >> threshold >> mmr >> tick)) {
+            throw std::invalid_argument("Լõ" + std::to_string(lineNo) + "иʽ");
+        }
+        ContractType type = ContractType::LINEAR_USDT;
+        std::string kind;
+        if (ss >> kind) {
+            if (kind == "inverse") type = ContractType::INVERSE_COIN;
+            else if (kind != "linear") throw std::invalid_argument("Լõ" + std::to_string(lineNo) + "кԼΪlinear/inverse");
+        }
+        specs.push_back(makeContractSpec(symbol, threshold, mmr, tick, type));
+    }
+    return specs;
+}
+
+inline std::vector<ContractSpec> loadContractConfig(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) throw std::invalid_argument("޷򿪺Լļ" + path);
+    return parseContractConfig(in);
+}
+
+// ԼϣFNV-1a
+inline uint64_t hashSymbol(const char* s, size_t len) {
+    uint64_t h = 1469598103934665603ULL;
+    for (size_t i = 0; i < len; ++i) {
+        h ^= static_cast<unsigned char>(s[i]);
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+// ɱԼѰַϣӡ0.5
+class ContractTable {
+private:
+    std::vector<ContractSpec> specs; // ±꼴Լ
+    std::vector<uint32_t> slots;     // Լ+10Ϊղ
+    uint64_t mask = 0;
+
+    uint32_t findSlot(const char* symbol, size_t len, uint64_t& slot) const {
+        slot = hashSymbol(symbol, len) & mask;
+        while (slots[slot] != 0) {
+            const ContractSpec& s = specs[slots[slot] - 1];
+            if (std::strncmp(s.symbol, symbol, len) == 0 && s.symbol[len] == '\0') return slots[slot] - 1;
+            slot = (slot + 1) & mask;
+        }
+        return INVALID_CONTRACT_ID;
+    }
+
+public:
+    // previousǿʱԼţвٳֵĺԼΪͣ״̬
+    explicit ContractTable(const std::vector<ContractSpec>& list, const ContractTable* previous = nullptr) {
+        if (previous) {
+            specs = previous->specs;
+            for (auto& s : specs) s.enabled = false;
+        }
+        uint64_t capacity = 16;
+        while (capacity < 2 * (specs.size() + list.size())) capacity <<= 1;
+        slots.assign(capacity, 0);
+        mask = capacity - 1;
+        for (size_t i = 0; i < specs.size(); ++i) {
+            uint64_t slot;
+            findSlot(specs[i].symbol, std::strlen(specs[i].symbol), slot);
+            slots[slot] = static_cast<uint32_t>(i + 1);
+        }
+        for (const auto& spec : list) {
+            size_t len = strnlen(spec.symbol, CONTRACT_SYMBOL_LENGTH);
+            if (len == 0 || len == static_cast<size_t>(CONTRACT_SYMBOL_LENGTH)) throw std::invalid_argument("ԼЧ");
+            uint64_t slot;
+            uint32_t id = findSlot(spec.symbol, len, slot);
+            if (id == INVALID_CONTRACT_ID) {
+                specs.push_back(spec);
+                slots[slot] = static_cast<uint32_t>(specs.size());
+                id = static_cast<uint32_t>(specs.size() - 1);
+            } else if (specs[id].enabled) {
+                throw std::invalid_argument(std::string("ԼдظԼ") + spec.symbol);
+            } else {
+                specs[id] = spec;
+            }
+            specs[id].enabled = true;
+        }
+    }
+
+    // ҺԼţڻͣ÷INVALID_CONTRACT_ID
+    uint32_t find(const char* symbol, size_t len) const {
+        if (len == 0 || len >= static_cast<size_t>(CONTRACT_SYMBOL_LENGTH)) return INVALID_CONTRACT_ID;
+        uint64_t slot;
+        uint32_t id = findSlot(symbol, len, slot);
+        return id != INVALID_CONTRACT_ID && specs[id].enabled ? id : INVALID_CONTRACT_ID;
+    }
+
+    uint32_t find(const std::string& symbol) const {
+        return find(symbol.data(), symbol.size());
+    }
+
+    // ҺԼڷnullptr
+    const ContractSpec* lookup(const std::string& symbol) const {
+        uint32_t id = find(symbol);
+        return id == INVALID_CONTRACT_ID ? nullptr : &specs[id];
+    }
+
+    // ȡԼ׳쳣
+    const ContractSpec& at(const std::string& symbol) const {
+        const ContractSpec* spec = lookup(symbol);
+        if (!spec) throw std::invalid_argument("δõĺԼ" + symbol);
+        return *spec;
+    }
+
+    const ContractSpec& spec(uint32_t id) const { return specs[id]; }
+    size_t size() const { return specs.size(); }
+};
+
+// 󲢷
+const int MAX_REGISTRY_READERS = 128;
+
+// صĺԼעRCUʽ
+// ߣʱѵǰԪдԼĲλٶȡָ룻ȫȴ
+// дߣԭ滻ָ벢ƽԪԴھɼԪĶ뿪ͷžɱ
+class ContractRegistry {
+private:
+    struct alignas(64) ReaderSlot {
+        std::atomic<uint64_t> epoch{0}; // 0ʾڶ
+        std::atomic<bool> used{false};
+    };
+
+    std::atomic<const ContractTable*> current;
+    std::atomic<uint64_t> epoch{1};
+    std::atomic<uint64_t> reloads{0};
+    ReaderSlot readers[MAX_REGISTRY_READERS];
+    std::mutex writerMutex; // ֻлд
+
+public:
+    explicit ContractRegistry(const std::vector<ContractSpec>& initial = defaultContracts())
+        : current(new ContractTable(initial)) {}
+
+    ~ContractRegistry() {
+        delete current.load();
+    }
+
+    ContractRegistry(const ContractRegistry&) = delete;
+    ContractRegistry& operator=(const ContractRegistry&) = delete;
+
+    // ڼõĺԼᱻͷ
+    class Snapshot {
+    private:
+        std::atomic<uint64_t>* slot;
+        const ContractTable* table;
+
+    public:
+        Snapshot(std::atomic<uint64_t>* s, const std::atomic<uint64_t>& epoch, const std::atomic<const ContractTable*>& cur)
+            : slot(s) {
+            slot->store(epoch.load(std::memory_order_acquire), std::memory_order_seq_cst);
+            table = cur.load(std::memory_order_seq_cst);
+        }
+        ~Snapshot() { slot->store(0, std::memory_order_release); }
+        Snapshot(const Snapshot&) = delete;
+        Snapshot& operator=(const Snapshot&) = delete;
+
+        const ContractTable& operator*() const { return *table; }
+        const ContractTable* operator->() const { return table; }
+    };
+
+    // ߾ÿ߳һͬһͬһʱֻܳһSnapshot
+    class Reader {
+    private:
+        ContractRegistry* registry;
+        int index = -1;
+
+    public:
+        explicit Reader(ContractRegistry& r) : registry(&r) {
+            for (int i = 0; i < MAX_REGISTRY_READERS; ++i) {
+                bool expected = false;
+                if (r.readers[i].used.compare_exchange_strong(expected, true)) {
+                    index = i;
+                    return;
+                }
+            }
+            throw std::runtime_error("Լע");
+        }
+        ~Reader() { registry->readers[index].used.store(false, std::memory_order_release); }
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+
+        Snapshot lock() const {
+            return Snapshot(&registry->readers[index].epoch, registry->epoch, registry->current);
+        }
+    };
+
+    // 滻źԼд߲֮Ӱ죩
+    void replace(const std::vector<ContractSpec>& specs) {
+        std::lock_guard<std::mutex> guard(writerMutex);
+        const ContractTable* next = new ContractTable(specs, current.load(std::memory_order_relaxed));
+        const ContractTable* old = current.exchange(next, std::memory_order_seq_cst);
+        uint64_t newEpoch = epoch.fetch_add(1, std::memory_order_seq_cst) + 1;
+        // ȴԿܳоɱĶ뿪
+        for (auto& r : readers) {
+            while (true) {
+                uint64_t e = r.epoch.load(std::memory_order_seq_cst);
+                if (e == 0 || e >= newEpoch) break;
+                std::this_thread::yield();
+            }
+        }
+        delete old;
+        reloads.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // ļأʧʱ׳쳣ԭֲ䣩
+    void reloadFromFile(const std::string& path) {
+        replace(loadContractConfig(path));
+    }
+
+    uint64_t reloadCount() const { return reloads.load(std::memory_order_relaxed); }
+};
+
+}  // namespace tradecheck
@@ -0,0 +1,225 @@
+#include "correlation_matrix.h"
+#include "volatility.h"
+#include "risk_kernels.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+namespace tradecheck {
+
+int ReturnMatrix::find(const std::string& symbol) const {
+    std::string key = normalizeSymbol(symbol);
+    for (size_t i = 0; i < symbols.size(); ++i) {
+        if (symbols[i] == key) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+ReturnMatrix buildReturnMatrix(const std::vector<KlineRow>& rows) {
+    ReturnMatrix m;
+    std::unordered_map<std::string, size_t> ids;
+    std::vector<std::vector<std::pair<int64_t, double>>> closes;
+    std::vector<int64_t> times;
+    times.reserve(rows.size());
+    for (const auto& r : rows) {
+        if (!(r.kline.close > 0)) throw std::invalid_argument(r.symbol + "̼۷K");
+        std::string key = normalizeSymbol(r.symbol);
+        auto it = ids.find(key);
+        if (it == ids.end()) {
+            it = ids.emplace(key, m.symbols.size()).first;
+            m.symbols.push_back(key);
+            closes.emplace_back();
+        }
+        closes[it->second].emplace_back(r.openTime, r.kline.close);
+        times.push_back(r.openTime);
+    }
+    std::sort(times.begin(), times.end());
+    times.erase(std::unique(times.begin(), times.end()), times.end());
+
+    size_t n = m.symbols.size();
+    size_t bars = times.size() > 1 ? times.size() - 1 : 0;
+    m.times.assign(times.begin() + (bars ? 1 : 0), times.end());
+    m.returns.assign(bars * n, 0.0);
+    m.lastClose.assign(n, 0.0);
+    for (size_t s = 0; s < n; ++s) {
+        auto& c = closes[s];
+        std::stable_sort(c.begin(), c.end(),
+                         [](const std::pair<int64_t, double>& a, const std::pair<int64_t, double>& b) { return a.first < b.first; });
+        for (size_t k = 0; k < c.size(); ++k) {
+            if (k > 0 && c[k].first == c[k - 1].first) throw std::invalid_argument(m.symbols[s] + "ڿʱظK");
+            if (k == 0) continue;
+            // ȱKߵʱ̼۸񲻱䣬֮ı䶯ȫںһ
+            size_t idx = static_cast<size_t>(std::lower_bound(times.begin(), times.end(), c[k].first) - times.begin());
+            m.returns[(idx - 1) * n + s] = std::log(c[k].second / c[k - 1].second);
+        }
+        m.lastClose[s] = c.back().second;
+    }
+    return m;
+}
+
+RollingCorrelation::RollingCorrelation(size_t symbols, int window, unsigned threads)
+    : n(symbols), win(window), threadCount(threads ? threads : std::max(1u, std::thread::hardware_concurrency())) {
+    if (symbols == 0) throw std::invalid_argument("Ʒ0");
+    if (window < 2) throw std::invalid_argument("ԴΪ2K");
+    ring.assign(static_cast<size_t>(win) * n, 0.0);
+    sums.assign(n, 0.0);
+    cross.assign(n * n, 0.0);
+}
+
+void RollingCorrelation::update(const double* returns) {
+    double* slot = &ring[static_cast<size_t>(next) * n];
+    if (cnt < win) {
+        for (size_t i = 0; i < n; ++i) {
+            double ri = returns[i];
+            sums[i] += ri;
+            double* c = &cross[i * n];
+            for (size_t j = i; j < n; ++j) c[j] += ri * returns[j];
+        }
+        cnt++;
+    } else {
+        // һСƳͬһλɵһ
+        for (size_t i = 0; i < n; ++i) {
+            double ri = returns[i], oi = slot[i];
+            sums[i] += ri - oi;
+            double* c = &cross[i * n];
+            for (size_t j = i; j < n; ++j) c[j] += ri * returns[j] - oi * slot[j];
+        }
+        sinceRebuild++;
+    }
+    std::copy(returns, returns + n, slot);
+    next = next + 1 == win ? 0 : next + 1;
+    if (sinceRebuild >= win) rebuild();
+}
+
+void RollingCorrelation::assign(const double* returns, size_t bars) {
+    size_t keep = std::min(bars, static_cast<size_t>(win));
+    const double* first = returns + (bars - keep) * n;
+    std::copy(first, first + keep * n, ring.begin());
+    cnt = static_cast<int>(keep);
+    next = cnt == win ? 0 : cnt;
+    rebuild();
+}
+
+void RollingCorrelation::rebuild() {
+    sinceRebuild = 0;
+    // ڸеȺ޹أֱӰλĴ˳ۼ
+    std::fill(sums.begin(), sums.end(), 0.0);
+    for (int t = 0; t < cnt; ++t) {
+        const double* row = &ring[static_cast<size_t>(t) * n];
+        for (size_t i = 0; i < n; ++i) sums[i] += row[i];
+    }
+
+    size_t blocks = (n + CORRELATION_TILE - 1) / CORRELATION_TILE;
+    std::vector<std::pair<size_t, size_t>> tiles;
+    tiles.reserve(blocks * (blocks + 1) / 2);
+    for (size_t bi = 0; bi < blocks; ++bi) {
+        for (size_t bj = bi; bj < blocks; ++bj) tiles.emplace_back(bi, bj);
+    }
+    unsigned tc = threadCount;
+    if (tc > tiles.size()) tc = static_cast<unsigned>(tiles.size());
+
+    // ÿջϵ3232ﰴۼӣڲjһд
+    auto worker = [&](unsigned t) {
+        double acc[CORRELATION_TILE][CORRELATION_TILE];
+        size_t begin = tiles.size() * t / tc;
+        size_t end = tiles.size() * (t + 1) / tc;
+        for (size_t p = begin; p < end; ++p) {
+            size_t i0 = tiles[p].first * CORRELATION_TILE, j0 = tiles[p].second * CORRELATION_TILE;
+            size_t ni = std::min(CORRELATION_TILE, n - i0), nj = std::min(CORRELATION_TILE, n - j0);
+            for (size_t ii = 0; ii < ni; ++ii) std::fill(acc[ii], acc[ii] + nj, 0.0);
+            for (int r = 0; r < cnt; ++r) {
+                const double* row = &ring[static_cast<size_t>(r) * n];
+                const double* xj = row + j0;
+                for (size_t ii = 0; ii < ni; ++ii) {
+                    double a = row[i0 + ii];
+                    double* out = acc[ii];
+                    for (size_t jj = 0; jj < nj; ++jj) out[jj] += a * xj[jj];
+                }
+            }
+            for (size_t ii = 0; ii < ni; ++ii) std::copy(acc[ii], acc[ii] + nj, &cross[(i0 + ii) * n + j0]);
+        }
+    };
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < tc; ++t) pool.emplace_back(worker, t);
+    worker(0);
+    for (auto& th : pool) th.join();
+}
+
+double RollingCorrelation::covariance(size_t i, size_t j) const {
+    if (cnt < 2) return 0.0;
+    if (i > j) std::swap(i, j);
+    return (cross[i * n + j] - sums[i] * sums[j] / cnt) / (cnt - 1);
+}
+
+double RollingCorrelation::volatility(size_t i) const {
+    double v = covariance(i, i);
+    return v > 0 ? std::sqrt(v) : 0.0;
+}
+
+double RollingCorrelation::correlation(size_t i, size_t j) const {
+    double si = volatility(i), sj = volatility(j);
+    if (si <= 0 || sj <= 0) return 0.0;
+    double r = covariance(i, j) / (si * sj);
+    return std::max(-1.0, std::min(1.0, r));
+}
+
+double RollingCorrelation::beta(size_t i, size_t reference) const {
+    double v = covariance(reference, reference);
+    return v > 0 ? covariance(i, reference) / v : 0.0;
+}
+
+std::vector<double> RollingCorrelation::correlationMatrix() const {
+    std::vector<double> sigma(n), out(n * n);
+    for (size_t i = 0; i < n; ++i) sigma[i] = volatility(i);
+    for (size_t i = 0; i < n; ++i) {
+        out[i * n + i] = sigma[i] > 0 ? 1.0 : 0.0;
+        for (size_t j = i + 1; j < n; ++j) {
+            double r = sigma[i] > 0 && sigma[j] > 0 ? covariance(i, j) / (sigma[i] * sigma[j]) : 0.0;
+            r = std::max(-1.0, std::min(1.0, r));
+            out[i * n + j] = out[j * n + i] = r;
+        }
+    }
+    return out;
+}
+
+StressResult stressBook(const RollingCorrelation& corr, size_t reference, const std::vector<BookPosition>& book,
+                        const StressScenario& scenario) {
+    if (!(scenario.referenceShock > -1)) throw std::invalid_argument("׼ƷֵС100%");
+    double refVol = corr.volatility(reference);
+    if (refVol <= 0) throw std::invalid_argument("׼ƷԴûв");
+    double logShock = std::log1p(scenario.referenceShock);
+
+    StressResult result;
+    result.scenario = scenario;
+    result.positions.reserve(book.size());
+    RiskBook risk;
+    for (const auto& p : book) {
+        StressPositionResult r;
+        double rho = p.symbolIndex == reference ? 1.0 : std::max(corr.correlation(p.symbolIndex, reference),
+                                                                  scenario.correlationFloor);
+        double logMove = rho * corr.volatility(p.symbolIndex) / refVol * logShock;
+        r.move = std::expm1(logMove);
+        r.markPrice = p.markPrice * std::exp(logMove);
+        risk.add(p.risk, r.markPrice);
+        result.positions.push_back(r);
+    }
+
+    // ۸µ貹䱣֤𰴣Լ, 򣩷ػں
+    std::vector<double> liquidationPrice, marginToAdd;
+    risk.compute(liquidationPrice, marginToAdd);
+    for (size_t i = 0; i < book.size(); ++i) {
+        StressPositionResult& r = result.positions[i];
+        r.marginToAdd = marginToAdd[i];
+        // ұλֲֵı֤ԱҼƣ۸ΪUSDTֲ
+        if (book[i].risk.getContract().type == ContractType::INVERSE_COIN) r.marginToAdd *= r.markPrice;
+        result.marginToAdd += r.marginToAdd;
+        if (r.marginToAdd > 0) result.marginCalls++;
+        if (book[i].symbolIndex == reference) result.isolatedMarginToAdd += r.marginToAdd;
+    }
+    return result;
+}
+
+}  // namespace tradecheck
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "crypto_risk.h"
+#include "kline_io.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tradecheck {
+
+// ƷԣƷֶʵĹЭϵͶԻ׼Ʒ֣BTCbeta
+// ֲϵı֤ѹԡͬDOGE/SOL/ETH൥BTCµʱһ𣬲ʵ
+
+// ֿʱÿƷƬ3232ĽͬʱL1/L2
+const size_t CORRELATION_TILE = 32;
+
+// ƷK߰ʱʾʱΪbarssymbols
+// ĳƷĳʱûKʱһ̼Ϊ0׸K֮ǰͬΪ0
+struct ReturnMatrix {
+    std::vector<std::string> symbols; // ͳһдƷnormalizeSymbol״γ˳
+    std::vector<int64_t> times;       // ÿʶӦK߿ʱ
+    std::vector<double> returns;      // times.size()  symbols.size()
+    std::vector<double> lastClose;    // Ʒ̼
+
+    size_t bars() const { return times.size(); }
+    const double* row(size_t t) const { return returns.data() + t * symbols.size(); }
+    // Ʒ±꣨ͳһдңʱ-1
+    int find(const std::string& symbol) const;
+};
+
+// ̼۷ʱ׳invalid_argument
+ReturnMatrix buildReturnMatrix(const std::vector<KlineRow>& rows);
+
+// ڸƷ֮˻ֻ֮ͣάǣݴ˸Э/ϵ/beta
+// ÿK߼һСƳһУΪO(N^2)ÿһڰݷֿ鲢һΣӼۻ
+class RollingCorrelation {
+public:
+    // symbolsƷ֡windowʵĴڣthreadsΪ0ʱ㰴CPU
+    RollingCorrelation(size_t symbols, int window, unsigned threads = 0);
+
+    // ׷һKϸƷֵʣΪsymbols
+    void update(const double* returns);
+
+    // һװʣʱΪ򣩣ֻwindowвֿ
+    void assign(const double* returns, size_t bars);
+
+    // ȫ˻ͣƷְCORRELATION_TILEֿ飬Էָ߳
+    void rebuild();
+
+    size_t symbols() const { return n; }
+    int window() const { return win; }
+    int count() const { return cnt; }
+
+    // ЭʱΪ0
+    double covariance(size_t i, size_t j) const;
+    // ϵһƷַΪ0ʱΪ0
+    double correlation(size_t i, size_t j) const;
+    // ƷiԻ׼Ʒֵbeta = cov(i, ׼) / var(׼)׼Ϊ0ʱΪ0
+    double beta(size_t i, size_t reference) const;
+    // ÿKʵı׼
+    double volatility(size_t i) const;
+
+    // ϵNN
+    std::vector<double> correlationMatrix() const;
+
+private:
+    size_t n;
+    int win;
+    unsigned threadCount;
+    std::vector<double> ring;  // winnʱΪĻλ
+    std::vector<double> sums;  // Ʒ֮
+    std::vector<double> cross; // nn˻ֻͣjiĲЧ
+    int cnt = 0;
+    int next = 0;              // һдλ
+    int sinceRebuild = 0;      // ϴ
+};
+
+// еһʳֲ
+struct BookPosition {
+    size_t symbolIndex;        // ʾеƷ±
+    double markPrice;          // ǰ۸һȡ̼ۣ
+    CryptoRiskCalculator risk;
+};
+
+// ѹ龰׼Ʒּ۸䶯referenceShock-0.2ʾµ20%Ʒְbetaͬ䶯
+// 䶯 = max(ϵ, correlationFloor)  /׼  ln(1+referenceShock)
+// correlationFloorĬ-1ʷbeta߱ʾ1
+struct StressScenario {
+    double referenceShock;
+    double correlationFloor = -1;
+};
+
+struct StressPositionResult {
+    double move;        // ۸䶯
+    double markPrice;   // ۸
+    double marginToAdd; // 貹䱣֤USDTұλְֲ۸㣩
+};
+
+struct StressResult {
+    StressScenario scenario;
+    double marginToAdd = 0;          // ȫֲ貹䱣֤֮
+    double isolatedMarginToAdd = 0;  // ֻ׼Ʒֲʱ֮ͣʵƷֻصļ裩
+    int marginCalls = 0;             // 貹䱣֤ĳֲ
+    std::vector<StressPositionResult> positions; // bookһһӦ
+};
+
+// referenceShock-1׼Ʒв׳invalid_argument
+StressResult stressBook(const RollingCorrelation& corr, size_t reference, const std::vector<BookPosition>& book,
+                        const StressScenario& scenario);
+
+}  // namespace tradecheck
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace tradecheck {
+
+// CRC32CCastagnoliʽ֧SSE4.2ʱʹcrc32ָcrcΪһεĽ׶δ0
+uint32_t crc32c(uint32_t crc, const void* data, size_t length);
+
+}  // namespace tradecheck
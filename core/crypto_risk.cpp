@@ -0,0 +1,109 @@
+#include "crypto_risk.h"
+#include "risk_kernels.h"
+
+namespace tradecheck {
+
+// 캯
+CryptoRiskCalculator::CryptoRiskCalculator(const ContractSpec& spec, double lev, double posRatio, double entryP, TradeDirection dir, double totalCap)
+    : contract(spec), leverage(lev), positionRatio(posRatio), entryPrice(entryP), direction(dir), totalCapital(totalCap) {
+    if (leverage < 1) throw std::invalid_argument("ܸ˱С11x");
+    if (positionRatio < 0 || positionRatio > 100) throw std::invalid_argument("λռ0~100֮䣨ٷֱȣ");
+    if (entryPrice <= 0) throw std::invalid_argument("볡۸0");
+    if (totalCapital <= 0) throw std::invalid_argument("ʽ0");
+}
+
+// жյȼö٣
+RiskLevel CryptoRiskCalculator::classifyRiskLevel() const {
+    double riskCoeff = calculateRiskCoefficient();
+    double threshold = getRiskThreshold();
+
+    if (riskCoeff == 0) return RiskLevel::NONE;
+    else if (riskCoeff <= threshold * 0.8) return RiskLevel::SAFE;
+    else if (riskCoeff <= threshold) return RiskLevel::WARNING;
+    else return RiskLevel::EXCEEDED;
+}
+
+// жյȼ
+std::string CryptoRiskCalculator::judgeRiskLevel() const {
+    switch (classifyRiskLevel()) {
+        case RiskLevel::NONE: return "޷գδ/޸ܸˣ";
+        case RiskLevel::SAFE: return "ȫϵֵ80%ڣ";
+        case RiskLevel::WARNING: return "Ԥϵӽֵ";
+        default: return "꣨ϵֵֹף";
+    }
+}
+
+// 貹䱣֤ = άֱ֤ - ʣౣ֤ʣౣ֤򷵻زֵ0Ϊ0
+double CryptoRiskCalculator::calculateMarginToAdd() const {
+    if (contract.type == ContractType::INVERSE_COIN) return calculateMarginToAddAt(calculateLiquidationPrice());
+    double im = getInitialMargin();
+    double surplusMargin = im - getUnrealizedLoss(); // ʣౣ֤=ʼ֤-δʵֿ
+    double needAdd = getMaintenanceMargin() - surplusMargin;
+    return needAdd > MARGIN_TO_ADD_EPSILON * im ? needAdd : 0.0;
+}
+
+// δʵֿǿƽۺͱ֤㣬򻯰棺ǰ۸=ǿƽʱĿ
+double CryptoRiskCalculator::getUnrealizedLoss() const {
+    double liqPrice = calculateLiquidationPrice();
+    if (contract.type == ContractType::INVERSE_COIN) return getUnrealizedLossAt(liqPrice);
+    double amount = getPositionAmount();
+    if (direction == TradeDirection::LONG) {
+        // ൥۸볡 = (볡 - ǿƽ)  ֲ
+        return (entryPrice - liqPrice) * amount;
+    } else {
+        // յ۸볡 = (ǿƽ - 볡)  ֲ
+        return (liqPrice - entryPrice) * amount;
+    }
+}
+
+// ۸δʵֿӯʱΪ
+double CryptoRiskCalculator::getUnrealizedLossAt(double markPrice) const {
+    if (contract.type == ContractType::INVERSE_COIN) {
+        double size = InverseCoin::positionSize(getInitialMargin(), leverage, entryPrice);
+        return direction == TradeDirection::LONG
+                   ? InverseCoin::unrealizedLoss<TradeDirection::LONG>(entryPrice, markPrice, size)
+                   : InverseCoin::unrealizedLoss<TradeDirection::SHORT>(entryPrice, markPrice, size);
+    }
+    double amount = getPositionAmount();
+    return direction == TradeDirection::LONG ? (entryPrice - markPrice) * amount : (markPrice - entryPrice) * amount;
+}
+
+// ۸貹䱣֤άֱ֤ - (ʼ֤ - ü۸µδʵֿ)
+double CryptoRiskCalculator::calculateMarginToAddAt(double markPrice) const {
+    if (contract.type == ContractType::INVERSE_COIN) {
+        double im = getInitialMargin();
+        double size = InverseCoin::positionSize(im, leverage, entryPrice);
+        double mmr = contract.maintenanceMarginRate;
+        return direction == TradeDirection::LONG
+                   ? kernelMarginToAdd<InverseCoin, TradeDirection::LONG>(entryPrice, markPrice, size, im, mmr)
+                   : kernelMarginToAdd<InverseCoin, TradeDirection::SHORT>(entryPrice, markPrice, size, im, mmr);
+    }
+    double im = getInitialMargin();
+    double needAdd = getMaintenanceMargin() - (im - getUnrealizedLossAt(markPrice));
+    return needAdd > MARGIN_TO_ADD_EPSILON * im ? needAdd : 0.0;
+}
+
+// ǿƽۣģʽͨùʽұλԼrisk_kernels.hеInverseCoin
+double CryptoRiskCalculator::calculateLiquidationPrice() const {
+    if (contract.type == ContractType::INVERSE_COIN) {
+        return direction == TradeDirection::LONG
+                   ? InverseCoin::liquidationPrice<TradeDirection::LONG>(entryPrice, leverage, contract.maintenanceMarginRate)
+                   : InverseCoin::liquidationPrice<TradeDirection::SHORT>(entryPrice, leverage, contract.maintenanceMarginRate);
+    }
+    double im = getInitialMargin(); // ʼ֤
+    double pv = getPositionValue();  // ֲֵּ
+    double mmr = contract.maintenanceMarginRate; // άֱ֤
+    double amount = getPositionAmount(); // ֲ
+
+    if (direction == TradeDirection::LONG) {
+        // ൥ǿƽ = (entryPrice * (im + pv * mmr) - im * entryPrice) / (im + pv * mmr)
+        // 򻯺
+        return entryPrice - (im - pv * mmr) / amount;
+    } else {
+        // յǿƽ = (entryPrice * (im + pv * mmr) + im * entryPrice) / (im + pv * mmr)
+        // 򻯺
+        return entryPrice + (im - pv * mmr) / amount;
+    }
+}
+
+}  // namespace tradecheck
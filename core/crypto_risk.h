@@ -0,0 +1,113 @@
+#pragma once
+
+#include <string>
+#include <stdexcept>
+#include "contract_registry.h"
+
+namespace tradecheck {
+
+// 彻׷ö
+enum class TradeDirection {
+    LONG,  // ൥
+    SHORT  // յ
+};
+
+// յȼö
+enum class RiskLevel {
+    NONE,     // ޷
+    SAFE,     // ȫ
+    WARNING,  // Ԥ
+    EXCEEDED  // 
+};
+
+// ϵ+ǿƽ+֤
+class CryptoRiskCalculator {
+private:
+    ContractSpec contract;      // ׺Լֵάֱ֤ʣ
+    double leverage;            // ܸ˱
+    double positionRatio;       // Ҳλռʽ0~100ٷֱȣ
+    double entryPrice;          // 볡۸USDTλұλUSDƼۣ
+    TradeDirection direction;   // ׷򣨶/գ
+    double totalCapital;        // ʽUSDTλΪUSDTұλΪңmarginAsset()
+
+    // ȡԼֵ
+    double getRiskThreshold() const {
+        return contract.riskThreshold;
+    }
+
+    // ֲֵּUSDT= ռñ֤  ܸ
+    double getPositionValue() const {
+        return getInitialMargin() * leverage;
+    }
+
+    // ֲң= ֲֵּ / 볡۸
+    double getPositionAmount() const {
+        return getPositionValue() / entryPrice;
+    }
+
+public:
+    // 캯
+    CryptoRiskCalculator(const ContractSpec& spec, double lev, double posRatio, double entryP, TradeDirection dir, double totalCap);
+
+    // ϵܸ  λռ
+    double calculateRiskCoefficient() const {
+        return leverage * positionRatio;
+    }
+
+    // жյȼö٣
+    RiskLevel classifyRiskLevel() const;
+
+    // жյȼ
+    std::string judgeRiskLevel() const;
+
+    // ʼ֤ռñ֤= ʽ  λռ
+    double getInitialMargin() const {
+        return totalCapital * (positionRatio / 100.0);
+    }
+
+    // άֱ֤ = ֲֵּ  άֱ֤
+    double getMaintenanceMargin() const {
+        return getPositionValue() * contract.maintenanceMarginRate;
+    }
+
+    // 貹䱣֤ = άֱ֤ - ʣౣ֤ʣౣ֤򷵻زֵ0
+    double calculateMarginToAdd() const;
+
+    // δʵֿǿƽۺͱ֤㣬򻯰棺ǰ۸=ǿƽʱĿ
+    double getUnrealizedLoss() const;
+
+    // ۸δʵֿӯʱΪ
+    double getUnrealizedLossAt(double markPrice) const;
+
+    // ۸貹䱣֤𣨼۸δԽǿƽʱΪ0ѹ԰ļ۸ʼ㣩
+    double calculateMarginToAddAt(double markPrice) const;
+
+    // ǿƽۣģʽUSDTλұλԼcontract.typeֱ㣩
+    double calculateLiquidationPrice() const;
+
+    // ȡǰֵ
+    double getThreshold() const {
+        return getRiskThreshold();
+    }
+
+    // ȡԼ
+    const ContractSpec& getContract() const {
+        return contract;
+    }
+
+    // ȡֲ
+    double getLeverage() const { return leverage; }
+    double getPositionRatio() const { return positionRatio; }
+    double getEntryPrice() const { return entryPrice; }
+    TradeDirection getDirection() const { return direction; }
+    double getTotalCapital() const { return totalCapital; }
+};
+
+// ǿƽ볡֮ȣcalculateLiquidationPriceλռȡʽ޹أ
+// ൥ = 1 - 1/ܸ + άֱ֤ʣյ = 1 + 1/ܸ - άֱ֤ʣͬһܸ˵Ĵֲʱֻһγ˷
+inline double liquidationPriceFactor(TradeDirection direction, double leverage, double maintenanceMarginRate) {
+    double distance = 1.0 / leverage - maintenanceMarginRate;
+    return direction == TradeDirection::LONG ? 1.0 - distance : 1.0 + distance;
+}
+
+}  // namespace tradecheck
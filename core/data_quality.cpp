@@ -0,0 +1,403 @@
+#include "data_quality.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define TRADECHECK_QUALITY_AVX2 1
+#endif
+
+namespace tradecheck {
+
+namespace {
+
+// ̶СĿ黮߳
+const size_t SCAN_BLOCK = 1 << 16;
+// ʾֱֵͼȡdoubleָ5λβԷֱԼ3%
+const int RETURN_KEY_SHIFT = 47;
+const size_t RETURN_BINS = size_t(1) << (63 - RETURN_KEY_SHIFT);
+// ƶK߼ʱ࿴ڼ
+const size_t INTERVAL_SAMPLE = 4096;
+
+uint8_t issueBit(QualityIssue issue) {
+    return static_cast<uint8_t>(1u << static_cast<int>(issue));
+}
+
+const uint8_t GAP_BIT = 1u << static_cast<int>(QualityIssue::GAP);
+
+struct ScanParams {
+    int64_t interval;  // δ֪ʱΪint64ֵȱڣ
+    double threshold;  // ֵ޷Ʊ׼ʱΪ
+};
+
+// ʱ޷򼫶ֵʱзAVX264λһ£
+int64_t timeDelta(const int64_t* times, size_t i) {
+    return static_cast<int64_t>(static_cast<uint64_t>(times[i]) - static_cast<uint64_t>(times[i - 1]));
+}
+
+uint8_t scanRow(const int64_t* times, const KlineData* bars, size_t count, size_t i, const ScanParams& p) {
+    const double inf = std::numeric_limits<double>::infinity();
+    const KlineData& k = bars[i];
+    uint8_t f = 0;
+    bool valid = k.low > 0 && k.high < inf && k.open > 0 && k.open < inf && k.close > 0 && k.close < inf &&
+                 k.volume >= 0 && k.volume < inf;
+    if (!valid) f |= issueBit(QualityIssue::BAD_VALUE);
+    if (k.high < k.low) f |= issueBit(QualityIssue::HIGH_BELOW_LOW);
+    if (k.open > k.high || k.open < k.low || k.close > k.high || k.close < k.low) {
+        f |= issueBit(QualityIssue::OPEN_CLOSE_OUTSIDE);
+    }
+    if (k.volume == 0) f |= issueBit(QualityIssue::ZERO_VOLUME);
+    if (i == 0) return f;
+    int64_t d = timeDelta(times, i);
+    if (d > p.interval) f |= GAP_BIT;
+    if (d == 0) f |= issueBit(QualityIssue::DUPLICATE_TIME);
+    if (d < 0) f |= issueBit(QualityIssue::OUT_OF_ORDER);
+    if (i + 1 < count) {
+        double in = k.close / bars[i - 1].close - 1.0;
+        double out = bars[i + 1].close / k.close - 1.0;
+        if ((in > p.threshold && out < -p.threshold) || (in < -p.threshold && out > p.threshold)) {
+            f |= issueBit(QualityIssue::PRICE_SPIKE);
+        }
+    }
+    return f;
+}
+
+#ifdef TRADECHECK_QUALITY_AVX2
+// 4λչΪ4ֽڸԵλ
+const uint32_t SPREAD_LANES[16] = {
+    0x00000000, 0x00000001, 0x00000100, 0x00000101, 0x00010000, 0x00010001, 0x00010100, 0x00010101,
+    0x01000000, 0x01000001, 0x01000100, 0x01000101, 0x01010000, 0x01010001, 0x01010100, 0x01010101};
+
+uint32_t laneBits(int mask, QualityIssue issue) {
+    return SPREAD_LANES[mask] << static_cast<int>(issue);
+}
+
+// ÿж4KߣK߰ṹţֶò5gatherȽϾȽϣNaNĽ·ͬ
+// [begin, end)һڵǰ׺begin1صһδ±
+__attribute__((target("avx2"))) size_t scanAvx2(const int64_t* times, const KlineData* bars, size_t count,
+                                                size_t begin, size_t end, const ScanParams& p, uint8_t* flags) {
+    const __m256i stride = _mm256_setr_epi64x(0, 5, 10, 15);
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d inf = _mm256_set1_pd(std::numeric_limits<double>::infinity());
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d upper = _mm256_set1_pd(p.threshold);
+    const __m256d lower = _mm256_set1_pd(-p.threshold);
+    const __m256i interval = _mm256_set1_epi64x(p.interval);
+    const __m256i zeroTime = _mm256_setzero_si256();
+    size_t i = begin;
+    for (; i + 4 <= end && i + 4 < count; i += 4) {
+        const double* base = reinterpret_cast<const double*>(bars + i);
+        __m256d open = _mm256_i64gather_pd(base, stride, 8);
+        __m256d high = _mm256_i64gather_pd(base + 1, stride, 8);
+        __m256d low = _mm256_i64gather_pd(base + 2, stride, 8);
+        __m256d close = _mm256_i64gather_pd(base + 3, stride, 8);
+        __m256d volume = _mm256_i64gather_pd(base + 4, stride, 8);
+        __m256d prevClose = _mm256_i64gather_pd(reinterpret_cast<const double*>(bars + i - 1) + 3, stride, 8);
+        __m256d nextClose = _mm256_i64gather_pd(reinterpret_cast<const double*>(bars + i + 1) + 3, stride, 8);
+
+        __m256d valid = _mm256_and_pd(_mm256_cmp_pd(low, zero, _CMP_GT_OQ), _mm256_cmp_pd(high, inf, _CMP_LT_OQ));
+        valid = _mm256_and_pd(valid, _mm256_and_pd(_mm256_cmp_pd(open, zero, _CMP_GT_OQ), _mm256_cmp_pd(open, inf, _CMP_LT_OQ)));
+        valid = _mm256_and_pd(valid, _mm256_and_pd(_mm256_cmp_pd(close, zero, _CMP_GT_OQ), _mm256_cmp_pd(close, inf, _CMP_LT_OQ)));
+        valid = _mm256_and_pd(valid, _mm256_and_pd(_mm256_cmp_pd(volume, zero, _CMP_GE_OQ), _mm256_cmp_pd(volume, inf, _CMP_LT_OQ)));
+        __m256d outside = _mm256_or_pd(_mm256_cmp_pd(open, high, _CMP_GT_OQ), _mm256_cmp_pd(open, low, _CMP_LT_OQ));
+        outside = _mm256_or_pd(outside, _mm256_or_pd(_mm256_cmp_pd(close, high, _CMP_GT_OQ), _mm256_cmp_pd(close, low, _CMP_LT_OQ)));
+
+        __m256d in = _mm256_sub_pd(_mm256_div_pd(close, prevClose), one);
+        __m256d out = _mm256_sub_pd(_mm256_div_pd(nextClose, close), one);
+        __m256d spike = _mm256_or_pd(_mm256_and_pd(_mm256_cmp_pd(in, upper, _CMP_GT_OQ), _mm256_cmp_pd(out, lower, _CMP_LT_OQ)),
+                                     _mm256_and_pd(_mm256_cmp_pd(in, lower, _CMP_LT_OQ), _mm256_cmp_pd(out, upper, _CMP_GT_OQ)));
+
+        __m256i d = _mm256_sub_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(times + i)),
+                                     _mm256_loadu_si256(reinterpret_cast<const __m256i*>(times + i - 1)));
+        int gap = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(d, interval)));
+        int duplicate = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(d, zeroTime)));
+        int outOfOrder = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(zeroTime, d)));
+
+        uint32_t word = laneBits(gap, QualityIssue::GAP) | laneBits(duplicate, QualityIssue::DUPLICATE_TIME) |
+                        laneBits(outOfOrder, QualityIssue::OUT_OF_ORDER) |
+                        laneBits(~_mm256_movemask_pd(valid) & 0xF, QualityIssue::BAD_VALUE) |
+                        laneBits(_mm256_movemask_pd(_mm256_cmp_pd(high, low, _CMP_LT_OQ)), QualityIssue::HIGH_BELOW_LOW) |
+                        laneBits(_mm256_movemask_pd(outside), QualityIssue::OPEN_CLOSE_OUTSIDE) |
+                        laneBits(_mm256_movemask_pd(_mm256_cmp_pd(volume, zero, _CMP_EQ_OQ)), QualityIssue::ZERO_VOLUME) |
+                        laneBits(_mm256_movemask_pd(spike), QualityIssue::PRICE_SPIKE);
+        std::memcpy(flags + i, &word, sizeof(word));
+    }
+    return i;
+}
+#endif
+
+bool detectSimd() {
+#ifdef TRADECHECK_QUALITY_AVX2
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+// ȡǰɸгһȡСߣûʱ0
+int64_t inferInterval(const int64_t* times, size_t count) {
+    std::vector<int64_t> deltas;
+    size_t limit = std::min(count, INTERVAL_SAMPLE + 1);
+    for (size_t i = 1; i < limit; ++i) {
+        int64_t d = timeDelta(times, i);
+        if (d > 0) deltas.push_back(d);
+    }
+    std::sort(deltas.begin(), deltas.end());
+    int64_t best = 0;
+    size_t bestRun = 0;
+    for (size_t i = 0; i < deltas.size();) {
+        size_t j = i;
+        while (j < deltas.size() && deltas[j] == deltas[i]) ++j;
+        if (j - i > bestRun) {
+            bestRun = j - i;
+            best = deltas[i];
+        }
+        i = j;
+    }
+    return best;
+}
+
+// ֶڵ䣺ͬһλKߺϲ
+void collectRanges(const uint8_t* flags, const int64_t* times, size_t begin, size_t end, int64_t interval,
+                   std::vector<QualityRange>& out) {
+    size_t open[QUALITY_ISSUE_COUNT] = {};
+    uint64_t missing = 0;
+    uint8_t prev = 0;
+    for (size_t i = begin; i < end; ++i) {
+        uint8_t f = flags[i];
+        if (f & GAP_BIT) missing += static_cast<uint64_t>(timeDelta(times, i) - 1) / static_cast<uint64_t>(interval);
+        if (f == prev) continue;
+        uint8_t changed = f ^ prev;
+        for (int b = 0; b < QUALITY_ISSUE_COUNT; ++b) {
+            if (!(changed & (1u << b))) continue;
+            if (f & (1u << b)) {
+                open[b] = i;
+            } else {
+                out.push_back({static_cast<QualityIssue>(b), open[b], i - 1, b == 0 ? missing : 0});
+                if (b == 0) missing = 0;
+            }
+        }
+        prev = f;
+    }
+    for (int b = 0; b < QUALITY_ISSUE_COUNT; ++b) {
+        if (prev & (1u << b)) out.push_back({static_cast<QualityIssue>(b), open[b], end - 1, b == 0 ? missing : 0});
+    }
+}
+
+}  // namespace
+
+const char* qualityIssueName(QualityIssue issue) {
+    switch (issue) {
+        case QualityIssue::GAP: return "ȱK";
+        case QualityIssue::DUPLICATE_TIME: return "ʱظ";
+        case QualityIssue::OUT_OF_ORDER: return "ʱ䵹";
+        case QualityIssue::BAD_VALUE: return "Чֵ";
+        case QualityIssue::HIGH_BELOW_LOW: return "߼۵ͼ";
+        case QualityIssue::OPEN_CLOSE_OUTSIDE: return "̼Խ";
+        case QualityIssue::ZERO_VOLUME: return "ɽ";
+        case QualityIssue::PRICE_SPIKE: return "۸";
+    }
+    return "δ֪";
+}
+
+bool dataQualitySimdSupported() {
+    static const bool supported = detectSimd();
+    return supported;
+}
+
+QualityReport scanKlineQuality(const int64_t* times, const KlineData* bars, size_t count, const QualityOptions& opt) {
+    if (opt.interval < 0) throw std::invalid_argument("K߼Ϊ");
+    if (!(opt.spikeSigma > 0)) throw std::invalid_argument("ֵ0");
+    if (opt.minZeroVolumeRun < 1) throw std::invalid_argument("ɽٸС1");
+    QualityReport report;
+    report.bars = count;
+    if (count == 0) return report;
+    report.interval = opt.interval ? opt.interval : inferInterval(times, count);
+
+    bool simd = opt.simd && dataQualitySimdSupported();
+    size_t blocks = (count + SCAN_BLOCK - 1) / SCAN_BLOCK;
+    unsigned threadCount = opt.threads ? opt.threads : std::max(1u, std::thread::hardware_concurrency());
+    if (threadCount > blocks) threadCount = static_cast<unsigned>(blocks);
+    auto runThreads = [&](auto&& worker) {
+        std::vector<std::thread> pool;
+        for (unsigned t = 1; t < threadCount; ++t) pool.emplace_back(worker, t);
+        worker(0);
+        for (auto& th : pool) th.join();
+    };
+
+    // һ飺ʾֱֵͼ߳޹أ
+    std::vector<std::vector<uint64_t>> histograms(threadCount);
+    runThreads([&](unsigned t) {
+        std::vector<uint64_t>& hist = histograms[t];
+        hist.assign(RETURN_BINS, 0);
+        size_t begin = std::max<size_t>(blocks * t / threadCount * SCAN_BLOCK, 1);
+        size_t end = std::min(count, blocks * (t + 1) / threadCount * SCAN_BLOCK);
+        for (size_t i = begin; i < end; ++i) {
+            double r = std::fabs(bars[i].close / bars[i - 1].close - 1.0);
+            if (!(r > 0) || !std::isfinite(r)) continue;  // 棨ͣ/޳ɽʱΪ0
+            uint64_t bits;
+            std::memcpy(&bits, &r, sizeof(bits));
+            hist[bits >> RETURN_KEY_SHIFT]++;
+        }
+    });
+    uint64_t total = 0;
+    for (size_t k = 1; k < histograms.size(); ++k) {
+        for (size_t b = 0; b < RETURN_BINS; ++b) histograms[0][b] += histograms[k][b];
+    }
+    for (uint64_t c : histograms[0]) total += c;
+    if (total > 0) {
+        // λڷȡе
+        uint64_t seen = 0;
+        size_t key = 0;
+        while (seen + histograms[0][key] <= total / 2) seen += histograms[0][key++];
+        uint64_t bits = (static_cast<uint64_t>(key) << RETURN_KEY_SHIFT) | (uint64_t(1) << (RETURN_KEY_SHIFT - 1));
+        double median;
+        std::memcpy(&median, &bits, sizeof(median));
+        report.returnSigma = 1.4826 * median;
+    }
+    double threshold = opt.spikeSigma * report.returnSigma;
+    ScanParams params{report.interval > 0 ? report.interval : std::numeric_limits<int64_t>::max(),
+                      threshold > 0 && std::isfinite(threshold) ? threshold : std::numeric_limits<double>::infinity()};
+
+    // ڶ飺λѱ̷ֶ߳ڵKߺϲ
+    std::vector<uint8_t> flags(count);
+    std::vector<std::vector<QualityRange>> partial(threadCount);
+    runThreads([&](unsigned t) {
+        size_t begin = blocks * t / threadCount * SCAN_BLOCK;
+        size_t end = std::min(count, blocks * (t + 1) / threadCount * SCAN_BLOCK);
+        size_t i = begin;
+        if (i == 0) flags[i++] = scanRow(times, bars, count, 0, params);
+#ifdef TRADECHECK_QUALITY_AVX2
+        if (simd) i = scanAvx2(times, bars, count, i, end, params, flags.data());
+#endif
+        for (; i < end; ++i) flags[i] = scanRow(times, bars, count, i, params);
+        collectRanges(flags.data(), times, begin, end, params.interval, partial[t]);
+    });
+    (void)simd;
+
+    // ϲֶα߽βӵͬ
+    int lastOf[QUALITY_ISSUE_COUNT];
+    std::fill(std::begin(lastOf), std::end(lastOf), -1);
+    std::vector<QualityRange> merged;
+    for (const auto& part : partial) {
+        for (const auto& r : part) {
+            int b = static_cast<int>(r.issue);
+            if (lastOf[b] >= 0 && merged[lastOf[b]].last + 1 == r.first) {
+                merged[lastOf[b]].last = r.last;
+                merged[lastOf[b]].missingBars += r.missingBars;
+                continue;
+            }
+            lastOf[b] = static_cast<int>(merged.size());
+            merged.push_back(r);
+        }
+    }
+    for (const auto& r : merged) {
+        if (r.issue == QualityIssue::ZERO_VOLUME && r.rows() < static_cast<size_t>(opt.minZeroVolumeRun)) continue;
+        report.rows[static_cast<int>(r.issue)] += r.rows();
+        report.ranges.push_back(r);
+    }
+    std::stable_sort(report.ranges.begin(), report.ranges.end(), [](const QualityRange& a, const QualityRange& b) {
+        return a.first != b.first ? a.first < b.first : a.issue < b.issue;
+    });
+    return report;
+}
+
+CleanMode parseCleanMode(const std::string& name) {
+    if (name == "none") return CleanMode::NONE;
+    if (name == "mask") return CleanMode::MASK;
+    if (name == "repair") return CleanMode::REPAIR;
+    throw std::invalid_argument("ϴʽΪnonemaskrepair");
+}
+
+CleanStats cleanKlines(std::vector<int64_t>& times, std::vector<KlineData>& bars, const QualityReport& report,
+                       CleanMode mode, size_t maxGapFill) {
+    CleanStats stats;
+    if (mode == CleanMode::NONE) return stats;
+    size_t n = bars.size();
+    if (times.size() != n || report.bars != n) throw std::invalid_argument("ɨKһ");
+    std::vector<uint8_t> flags(n, 0);
+    for (const auto& r : report.ranges) {
+        for (size_t i = r.first; i <= r.last; ++i) flags[i] |= issueBit(r.issue);
+    }
+    const uint8_t dropBits = issueBit(QualityIssue::DUPLICATE_TIME) | issueBit(QualityIssue::OUT_OF_ORDER) |
+                             issueBit(QualityIssue::BAD_VALUE) | issueBit(QualityIssue::PRICE_SPIKE);
+    const uint8_t priceBits = issueBit(QualityIssue::HIGH_BELOW_LOW) | issueBit(QualityIssue::OPEN_CLOSE_OUTSIDE);
+
+    std::vector<int64_t> outTimes;
+    std::vector<KlineData> outBars;
+    outTimes.reserve(n);
+    outBars.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        uint8_t f = flags[i];
+        bool drop = (f & dropBits) || (mode == CleanMode::MASK && (f & priceBits));
+        // ɾɸ뱣һȽϸ
+        if (drop || (!outTimes.empty() && times[i] <= outTimes.back())) {
+            stats.dropped++;
+            continue;
+        }
+        KlineData k = bars[i];
+        if (f & priceBits) {
+            if (k.high < k.low) std::swap(k.high, k.low);
+            k.high = std::max({k.high, k.open, k.close});
+            k.low = std::min({k.low, k.open, k.close});
+            stats.repaired++;
+        }
+        if (mode == CleanMode::REPAIR && report.interval > 0 && !outTimes.empty()) {
+            int64_t prev = outTimes.back();
+            uint64_t missing = static_cast<uint64_t>(times[i] - prev - 1) / static_cast<uint64_t>(report.interval);
+            if (missing > 0 && missing <= maxGapFill) {
+                double c = outBars.back().close;
+                for (uint64_t m = 1; m <= missing; ++m) {
+                    outTimes.push_back(prev + static_cast<int64_t>(m) * report.interval);
+                    outBars.push_back({c, c, c, c, 0.0});
+                }
+                stats.filled += missing;
+            }
+        }
+        outTimes.push_back(times[i]);
+        outBars.push_back(k);
+    }
+    times.swap(outTimes);
+    bars.swap(outBars);
+    return stats;
+}
+
+CleanStats cleanKlineRows(std::vector<KlineRow>& rows, CleanMode mode, const QualityOptions& opt) {
+    CleanStats total;
+    if (mode == CleanMode::NONE) return total;
+    std::vector<std::string> symbols;
+    std::unordered_map<std::string, std::vector<size_t>> bySymbol;
+    for (size_t i = 0; i < rows.size(); ++i) {
+        auto& idx = bySymbol[rows[i].symbol];
+        if (idx.empty()) symbols.push_back(rows[i].symbol);
+        idx.push_back(i);
+    }
+    std::vector<KlineRow> out;
+    out.reserve(rows.size());
+    for (const auto& symbol : symbols) {
+        const std::vector<size_t>& idx = bySymbol[symbol];
+        std::vector<int64_t> times;
+        std::vector<KlineData> bars;
+        times.reserve(idx.size());
+        bars.reserve(idx.size());
+        for (size_t i : idx) {
+            times.push_back(rows[i].openTime);
+            bars.push_back(rows[i].kline);
+        }
+        QualityReport report = scanKlineQuality(times.data(), bars.data(), bars.size(), opt);
+        CleanStats s = cleanKlines(times, bars, report, mode);
+        total.dropped += s.dropped;
+        total.repaired += s.repaired;
+        total.filled += s.filled;
+        for (size_t i = 0; i < bars.size(); ++i) out.push_back({symbol, times[i], bars[i]});
+    }
+    rows.swap(out);
+    return total;
+}
+
+}  // namespace tradecheck
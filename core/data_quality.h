@@ -0,0 +1,91 @@
+#pragma once
+
+#include "kline_io.h"
+#include "support_resistance.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tradecheck {
+
+// Kɨ裺һɨҳȫ⣬ڵһKߴж
+// 1. ̼ʵĲʾֵλֱ߳ͼӣ
+//    ȡλ1.4826ΪȽ׼ֵ̧̲
+// 2. жϸ⣬дÿKһֽڵλAVX2ÿ4̷ֶ߳Σ
+// 3. ͬһKߺϲΪһ䣬̷ֶ߳εβ
+// ۸ָʳkȽ׼һ򳬹ͬȵĹKߣ󱨼ۣ
+// ĴΪʵ飬
+
+enum class QualityIssue : uint8_t {
+    GAP,                // һʱK߼ȱKߣ
+    DUPLICATE_TIME,     // һʱͬ
+    OUT_OF_ORDER,       // ʱһ
+    BAD_VALUE,          // ۸ֵɽΪֵ
+    HIGH_BELOW_LOW,     // ߼۵ͼ
+    OPEN_CLOSE_OUTSIDE, // ̼ۻ̼/ͼ֮
+    ZERO_VOLUME,        // ɽΪ0
+    PRICE_SPIKE         // ļ۸
+};
+const int QUALITY_ISSUE_COUNT = 8;
+
+const char* qualityIssueName(QualityIssue issue);
+
+struct QualityOptions {
+    int64_t interval = 0;      // K߼룩0ʾȡڼ
+    int minZeroVolumeRun = 3;  // ɽﵽ˸ű
+    double spikeSigma = 8.0;   // ֵȽ׼
+    unsigned threads = 0;      // ߳0ʾCPU
+    bool simd = true;          // CPU֧ʱʹAVX2·λһ£
+};
+
+// ͬһK[first, last]±꣩
+struct QualityRange {
+    QualityIssue issue;
+    size_t first;
+    size_t last;
+    uint64_t missingBars; // GAPȱٵK
+
+    size_t rows() const { return last - first + 1; }
+};
+
+struct QualityReport {
+    size_t bars = 0;
+    int64_t interval = 0;                   // ʵʹõK߼
+    double returnSigma = 0;                 // ̼ʵȽ׼
+    size_t rows[QUALITY_ISSUE_COUNT] = {};  // 漰K
+    std::vector<QualityRange> ranges;       // ʼ±
+
+    bool clean() const { return ranges.empty(); }
+};
+
+// ɨһƷֵKߣļе˳򣬲Ԥ
+QualityReport scanKlineQuality(const int64_t* times, const KlineData* bars, size_t count, const QualityOptions& opt);
+
+// ϴʽ
+enum class CleanMode {
+    NONE,
+    MASK,   // ɾKߣȱɽ
+    REPAIR  // ޵ޣߵͼۻ/̼ۣȱһ̼۲ƽKߣ޲˵ɾ
+};
+
+// ϴʽnone/mask/repair
+CleanMode parseCleanMode(const std::string& name);
+
+struct CleanStats {
+    size_t dropped = 0;  // ɾK
+    size_t repaired = 0; // ˼۸K
+    size_t filled = 0;   // K
+};
+
+// ɨϴַʽ֤ĿʱϸmaxGapFillȱڲ
+CleanStats cleanKlines(std::vector<int64_t>& times, std::vector<KlineData>& bars, const QualityReport& report,
+                       CleanMode mode, size_t maxGapFill = 1000);
+
+// Ʒַɨ貢ϴƷ״γֵ˳
+CleanStats cleanKlineRows(std::vector<KlineRow>& rows, CleanMode mode, const QualityOptions& opt);
+
+// ǰCPUǷ֧AVX2ɨ·
+bool dataQualitySimdSupported();
+
+}  // namespace tradecheck
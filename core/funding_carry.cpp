@@ -0,0 +1,275 @@
+#include "funding_carry.h"
+#include "volatility.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define TRADECHECK_CARRY_AVX2 1
+#endif
+
+namespace tradecheck {
+
+namespace {
+
+// ÿĳֲһĸL1ڣȫֲʱ
+const size_t CARRY_BLOCK = 512;
+
+// ְֲдţйصԤã
+struct CarryColumns {
+    std::vector<double> sign;      // ൥+1յ-1
+    std::vector<double> entry;
+    std::vector<double> notional;  // ֲֵּּۣ
+    std::vector<double> amount;    // ֲ
+    std::vector<double> base;      // ʼ֤ - 
+    std::vector<double> threshold; // ֲֵּ άֱ֤ + ƽʣ
+    std::vector<double> restore;   // ʼ֤ + ƽѣǿƽۻصԭֵı֤
+    std::vector<int32_t> symbol;
+};
+
+// һֲʱ
+struct CarryOutput {
+    double* fundingPaid;
+    double* margin;
+    double* liquidationPrice;
+    double* marginToAdd;
+};
+
+void carryScalar(const CarryColumns& c, const double* cum, size_t begin, size_t end, const CarryOutput& out) {
+    for (size_t i = begin; i < end; ++i) {
+        double paid = c.sign[i] * c.notional[i] * cum[c.symbol[i]];
+        double margin = c.base[i] - paid;
+        double add = c.restore[i] - margin;
+        out.fundingPaid[i] = paid;
+        out.margin[i] = margin;
+        out.liquidationPrice[i] = c.entry[i] - c.sign[i] * ((margin - c.threshold[i]) / c.amount[i]);
+        out.marginToAdd[i] = add > 0 ? add : 0.0;
+    }
+}
+
+#ifdef TRADECHECK_CARRY_AVX2
+// 4ʳֲֲУƷۼʽʰƷ±gather˳·ͬ
+__attribute__((target("avx2"))) void carryAvx2(const CarryColumns& c, const double* cum, size_t begin, size_t end,
+                                               const CarryOutput& out) {
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d all = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+    size_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        __m128i idx = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&c.symbol[i]));
+        __m256d rate = _mm256_mask_i32gather_pd(zero, cum, idx, all, 8);
+        __m256d sign = _mm256_loadu_pd(&c.sign[i]);
+        __m256d paid = _mm256_mul_pd(_mm256_mul_pd(sign, _mm256_loadu_pd(&c.notional[i])), rate);
+        __m256d margin = _mm256_sub_pd(_mm256_loadu_pd(&c.base[i]), paid);
+        __m256d add = _mm256_sub_pd(_mm256_loadu_pd(&c.restore[i]), margin);
+        __m256d room = _mm256_div_pd(_mm256_sub_pd(margin, _mm256_loadu_pd(&c.threshold[i])),
+                                     _mm256_loadu_pd(&c.amount[i]));
+        _mm256_storeu_pd(out.fundingPaid + i, paid);
+        _mm256_storeu_pd(out.margin + i, margin);
+        _mm256_storeu_pd(out.liquidationPrice + i, _mm256_sub_pd(_mm256_loadu_pd(&c.entry[i]), _mm256_mul_pd(sign, room)));
+        _mm256_storeu_pd(out.marginToAdd + i, _mm256_max_pd(add, zero));
+    }
+    carryScalar(c, cum, i, end, out);
+}
+#endif
+
+bool detectSimd() {
+#ifdef TRADECHECK_CARRY_AVX2
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+CarryColumns buildColumns(const std::vector<CarryPosition>& book, size_t symbols, const FeeSchedule& fees) {
+    CarryColumns c;
+    size_t n = book.size();
+    c.sign.resize(n);
+    c.entry.resize(n);
+    c.notional.resize(n);
+    c.amount.resize(n);
+    c.base.resize(n);
+    c.threshold.resize(n);
+    c.restore.resize(n);
+    c.symbol.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        const CryptoRiskCalculator& r = book[i].risk;
+        if (book[i].fundingIndex >= symbols) throw std::invalid_argument("ֲֵʽƷ±Խ");
+        if (r.getContract().type != ContractType::LINEAR_USDT) {
+            throw std::invalid_argument(std::string(r.getContract().symbol) + "ΪұλԼֲֳɱģֻ֧USDTλԼ");
+        }
+        double im = r.getInitialMargin();
+        double pv = im * r.getLeverage();
+        c.sign[i] = r.getDirection() == TradeDirection::LONG ? 1.0 : -1.0;
+        c.entry[i] = r.getEntryPrice();
+        c.notional[i] = pv;
+        c.amount[i] = pv / r.getEntryPrice();
+        c.base[i] = im - pv * fees.openFeeRate;
+        c.threshold[i] = pv * (r.getContract().maintenanceMarginRate + fees.closeFeeRate);
+        c.restore[i] = im + pv * fees.closeFeeRate;
+        c.symbol[i] = static_cast<int32_t>(book[i].fundingIndex);
+    }
+    return c;
+}
+
+}  // namespace
+
+int FundingTable::find(const std::string& symbol) const {
+    std::string key = normalizeSymbol(symbol);
+    for (size_t i = 0; i < series.size(); ++i) {
+        if (series[i].symbol == key) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+int64_t FundingTable::lastTime() const {
+    int64_t last = 0;
+    for (const auto& s : series) {
+        if (!s.times.empty()) last = std::max(last, s.times.back());
+    }
+    return last;
+}
+
+FundingTable loadFundingCsv(const std::string& path) {
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) throw std::invalid_argument("޷ʽļ" + path);
+    FundingTable table;
+    std::unordered_map<std::string, size_t> ids;
+    std::vector<std::vector<std::pair<int64_t, double>>> rows;
+    char line[512];
+    int lineNo = 0;
+    try {
+        while (std::fgets(line, sizeof(line), file)) {
+            lineNo++;
+            if (line[0] == '#' || line[0] == '\n' || line[0] == '\r') continue;
+            const char* comma = std::strchr(line, ',');
+            if (!comma) throw std::invalid_argument("ʽļ" + std::to_string(lineNo) + "ȱٶŷָ");
+            char* end = nullptr;
+            int64_t time = std::strtoll(comma + 1, &end, 10);
+            if (end == comma + 1) {
+                if (lineNo == 1) continue; // ͷ
+                throw std::invalid_argument("ʽļ" + std::to_string(lineNo) + "ʱʽ");
+            }
+            if (*end != ',') throw std::invalid_argument("ʽļ" + std::to_string(lineNo) + "ֶβ");
+            const char* p = end + 1;
+            double rate = std::strtod(p, &end);
+            if (end == p) throw std::invalid_argument("ʽļ" + std::to_string(lineNo) + "ֵʽ");
+            std::string key = normalizeSymbol(std::string(line, comma - line));
+            auto it = ids.find(key);
+            if (it == ids.end()) {
+                it = ids.emplace(key, table.series.size()).first;
+                table.series.emplace_back();
+                table.series.back().symbol = key;
+                rows.emplace_back();
+            }
+            rows[it->second].emplace_back(time, rate);
+        }
+    } catch (...) {
+        std::fclose(file);
+        throw;
+    }
+    std::fclose(file);
+    for (size_t s = 0; s < rows.size(); ++s) {
+        auto& r = rows[s];
+        std::stable_sort(r.begin(), r.end(),
+                         [](const std::pair<int64_t, double>& a, const std::pair<int64_t, double>& b) { return a.first < b.first; });
+        FundingSeries& out = table.series[s];
+        for (size_t k = 0; k < r.size(); ++k) {
+            if (k > 0 && r[k].first == r[k - 1].first) throw std::invalid_argument(out.symbol + "ڽʱظʽ");
+            out.times.push_back(r[k].first);
+            out.rates.push_back(r[k].second);
+        }
+    }
+    return table;
+}
+
+bool carrySimdSupported() {
+    static const bool supported = detectSimd();
+    return supported;
+}
+
+void simulateCarry(const FundingTable& funding, const std::vector<CarryPosition>& book, const CarryOptions& opt,
+                   CarrySimulation& sim) {
+    if (opt.horizons.empty()) throw std::invalid_argument("Ҫһֲʱ");
+    for (int64_t h : opt.horizons) {
+        if (h <= 0) throw std::invalid_argument("ֲʱ0");
+    }
+    sim.horizons = opt.horizons;
+    sim.positions = book.size();
+    sim.symbols = funding.series.size();
+    sim.start = opt.start ? opt.start
+                          : funding.lastTime() - *std::max_element(opt.horizons.begin(), opt.horizons.end());
+
+    // ʱڸƷֵۼʽʱӶ̵νۼӣÿƷֵֻɨһ
+    size_t hc = opt.horizons.size();
+    std::vector<size_t> order(hc);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return opt.horizons[a] < opt.horizons[b]; });
+    std::vector<double> cum(hc * sim.symbols, 0.0);
+    sim.fundingEvents.assign(hc * sim.symbols, 0);
+    for (size_t s = 0; s < sim.symbols; ++s) {
+        const FundingSeries& fs = funding.series[s];
+        size_t first = static_cast<size_t>(std::upper_bound(fs.times.begin(), fs.times.end(), sim.start) - fs.times.begin());
+        size_t k = first;
+        double sum = 0;
+        for (size_t h : order) {
+            int64_t until = sim.start + opt.horizons[h];
+            for (; k < fs.times.size() && fs.times[k] <= until; ++k) sum += fs.rates[k];
+            cum[h * sim.symbols + s] = sum;
+            sim.fundingEvents[h * sim.symbols + s] = static_cast<int>(k - first);
+        }
+    }
+
+    CarryColumns c = buildColumns(book, sim.symbols, opt.fees);
+    size_t n = book.size();
+    sim.feesPaid.resize(n);
+    for (size_t i = 0; i < n; ++i) sim.feesPaid[i] = c.notional[i] * opt.fees.openFeeRate;
+    sim.fundingPaid.resize(hc * n);
+    sim.margin.resize(hc * n);
+    sim.liquidationPrice.resize(hc * n);
+    sim.marginToAdd.resize(hc * n);
+    if (n == 0) return;
+
+    bool simd = opt.simd && carrySimdSupported();
+    unsigned threadCount = opt.threads ? opt.threads : std::max(1u, std::thread::hardware_concurrency());
+    size_t blocks = (n + CARRY_BLOCK - 1) / CARRY_BLOCK;
+    if (threadCount > blocks) threadCount = static_cast<unsigned>(blocks);
+    auto worker = [&](unsigned t) {
+        size_t begin = blocks * t / threadCount * CARRY_BLOCK;
+        size_t end = std::min(n, blocks * (t + 1) / threadCount * CARRY_BLOCK);
+        for (size_t b = begin; b < end; b += CARRY_BLOCK) {
+            size_t e = std::min(end, b + CARRY_BLOCK);
+            for (size_t h = 0; h < hc; ++h) {
+                CarryOutput out{&sim.fundingPaid[h * n], &sim.margin[h * n], &sim.liquidationPrice[h * n],
+                                &sim.marginToAdd[h * n]};
+                const double* rates = &cum[h * sim.symbols];
+#ifdef TRADECHECK_CARRY_AVX2
+                if (simd) {
+                    carryAvx2(c, rates, b, e, out);
+                    continue;
+                }
+#endif
+                carryScalar(c, rates, b, e, out);
+            }
+        }
+    };
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threadCount; ++t) pool.emplace_back(worker, t);
+    worker(0);
+    for (auto& th : pool) th.join();
+    (void)simd;
+}
+
+CarrySimulation simulateCarry(const FundingTable& funding, const std::vector<CarryPosition>& book,
+                              const CarryOptions& opt) {
+    CarrySimulation sim;
+    simulateCarry(funding, book, opt, sim);
+    return sim;
+}
+
+}  // namespace tradecheck
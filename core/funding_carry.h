@@ -0,0 +1,84 @@
+#pragma once
+
+#include "crypto_risk.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tradecheck {
+
+// ʽѵĳֲֳɱģ⣺calculateLiquidationPriceֱ֤𲻱䣬
+// ʵԼÿʽѺͿƽѶֱ֤ۣǿƽֲʱ𽥿ּ
+// ʷʽаֲڶֲʱһ꣬ÿʱʣౣ֤ǿƽ貹䱣֤
+
+// ʽCSVļʽÿһڣɴͷ#ͷΪעͣ
+// symbol,fundingTime,fundingRate
+// fundingTimeΪʱ䣨ʱfundingRateΪС0.00010.01%ֵ൥յ
+
+// һƷֵʽУʱ
+struct FundingSeries {
+    std::string symbol; // ͳһдnormalizeSymbol
+    std::vector<int64_t> times;
+    std::vector<double> rates;
+};
+
+struct FundingTable {
+    std::vector<FundingSeries> series;
+
+    // Ʒ±꣨ͳһдңʱ-1
+    int find(const std::string& symbol) const;
+    // ȫƷһڵĽʱ
+    int64_t lastTime() const;
+};
+
+// ȡʽCSVͬһƷֽʱظʱ׳invalid_argument
+FundingTable loadFundingCsv(const std::string& path);
+
+// ʣСʱֱ֤۳ƽǿƽжԤ
+struct FeeSchedule {
+    double openFeeRate = 0.0005;
+    double closeFeeRate = 0.0005;
+};
+
+struct CarryPosition {
+    size_t fundingIndex;        // FundingTableеƷ±
+    CryptoRiskCalculator risk;
+};
+
+struct CarryOptions {
+    int64_t start = 0;              // ʱ̣룩0ʾһڽʱȥֲʱ
+    std::vector<int64_t> horizons;  // ֲʱ룩(ʱ, ʱ+ʱ]ڽʽ
+    FeeSchedule fees;
+    unsigned threads = 0;           // 0ʾCPU
+    bool simd = true;               // CPU֧ʱʹAVX2·λһ£
+};
+
+// ģдţhֲʱiʳֲ±hpositions+i
+struct CarrySimulation {
+    int64_t start = 0;
+    size_t positions = 0;
+    size_t symbols = 0;
+    std::vector<int64_t> horizons;
+    std::vector<int> fundingEvents;       // ʱڸƷֽhsymbols+Ʒ±꣩
+    std::vector<double> feesPaid;         // ÿʳֲֵĿѣpositions
+    std::vector<double> fundingPaid;      // ۼ֧ʽѣUSDTյΪ
+    std::vector<double> margin;           // ۳ʽѺʣֱ֤
+    std::vector<double> liquidationPrice; // ʣౣ֤ԤƽѺǿƽ
+    std::vector<double> marginToAdd;      // ǿƽۻصcalculateLiquidationPrice貹ı֤
+
+    double at(const std::vector<double>& column, size_t h, size_t i) const { return column[h * positions + i]; }
+    int events(size_t h, size_t symbol) const { return fundingEvents[h * symbols + symbol]; }
+};
+
+// ֲʱΪաƷ±Խ򺬱ұλԼʱ׳invalid_argument
+CarrySimulation simulateCarry(const FundingTable& funding, const std::vector<CarryPosition>& book,
+                              const CarryOptions& opt);
+// ͬϣдsimѷУģͬһʱٷڴ棩
+void simulateCarry(const FundingTable& funding, const std::vector<CarryPosition>& book, const CarryOptions& opt,
+                   CarrySimulation& sim);
+
+// ǰCPUǷ֧AVX2·
+bool carrySimdSupported();
+
+}  // namespace tradecheck
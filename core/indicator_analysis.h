@@ -0,0 +1,128 @@
+#pragma once
+
+#include "consistency_score.h"
+#include "streaming_indicators.h"
+#include "support_resistance.h"
+#include <cstdint>
+#include <initializer_list>
+
+namespace tradecheck {
+
+// ָ꣺4Сʱ//߸һʽָ꣨زõK߸£ATR
+// ֱ뿪/RSI/EMA/KSTֹ֣¼
+
+const int INDICATOR_TIMEFRAME_COUNT = 3; // TimeframeţTF_4H/TF_DAY/TF_WEEK
+
+const char* const INDICATOR_TREND_NAMES[3] = {"", "½", ""};
+const char* const INDICATOR_RSI_NAMES[3] = {"", "", ""};
+const char* const INDICATOR_CROSS_NAMES[3] = {"ϴԽ", "´Խ", "δԽ"};
+
+// KSTԽ֮ôKΪǰź
+const int KST_CROSS_HOLD_BARS = KST_SIGNAL_PERIOD;
+
+// ĳһʱ̵ָδΪ-1
+struct IndicatorReading {
+    int8_t emaTrend[INDICATOR_TIMEFRAME_COUNT][3]; // EMAƱ
+    uint8_t emaTurn[INDICATOR_TIMEFRAME_COUNT][3];
+    int16_t emaPeriod[3];
+    int8_t kstCross[INDICATOR_TIMEFRAME_COUNT];    // KSTԽ
+    int8_t rsiLevel;                               // RSI
+    int32_t rsiBars;                               // ǰRSIѳ߸
+    double rsi;
+    double atr;                                    // ATRδΪ0
+};
+
+// POD״ֱ̬Ӱֽڱ/ָ
+struct MultiTimeframeIndicators {
+    StreamingIndicatorSet sets[INDICATOR_TIMEFRAME_COUNT];
+    StreamingATR atr;
+    int kstCross[INDICATOR_TIMEFRAME_COUNT];    // һKSTԽ루2ʾޣ
+    int kstCrossAge[INDICATOR_TIMEFRAME_COUNT]; // һδԽK
+    int rsiLevel;
+    int rsiBars;
+
+    void reset(int atrPeriod = 14) {
+        for (int i = 0; i < INDICATOR_TIMEFRAME_COUNT; ++i) {
+            sets[i].reset();
+            kstCross[i] = 2;
+            kstCrossAge[i] = 0;
+        }
+        atr.reset(atrPeriod);
+        rsiLevel = 2;
+        rsiBars = 0;
+    }
+
+    // ĳһK
+    void update(Timeframe tf, const KlineData& kd) {
+        int t = static_cast<int>(tf);
+        StreamingIndicatorSet& s = sets[t];
+        s.update(kd.close);
+        if (s.kst.cross != 2) {
+            kstCross[t] = s.kst.cross;
+            kstCrossAge[t] = 0;
+        } else {
+            kstCrossAge[t]++;
+        }
+        if (tf != Timeframe::TF_DAY) return;
+        atr.update(kd.high, kd.low, kd.close);
+        if (!s.rsi.ready()) return;
+        int level = s.rsi.level();
+        rsiBars = level == rsiLevel ? rsiBars + 1 : 1;
+        rsiLevel = level;
+    }
+
+    IndicatorReading reading() const {
+        IndicatorReading r;
+        for (int t = 0; t < INDICATOR_TIMEFRAME_COUNT; ++t) {
+            const StreamingIndicatorSet& s = sets[t];
+            for (int i = 0; i < 3; ++i) {
+                r.emaTrend[t][i] = static_cast<int8_t>(s.ema[i].ready() ? s.ema[i].trend : -1);
+                r.emaTurn[t][i] = s.ema[i].isTurn ? 1 : 0;
+            }
+            if (!s.kst.ready()) r.kstCross[t] = -1;
+            else r.kstCross[t] = static_cast<int8_t>(kstCrossAge[t] < KST_CROSS_HOLD_BARS ? kstCross[t] : 2);
+        }
+        for (int i = 0; i < 3; ++i) r.emaPeriod[i] = static_cast<int16_t>(sets[0].ema[i].period);
+        const StreamingRSI& rsi = sets[static_cast<int>(Timeframe::TF_DAY)].rsi;
+        r.rsiLevel = static_cast<int8_t>(rsi.ready() ? rsiLevel : -1);
+        r.rsiBars = rsi.ready() ? rsiBars : 0;
+        r.rsi = rsi.ready() ? rsi.value() : 0.0;
+        r.atr = atr.ready() ? atr.value() : 0.0;
+        return r;
+    }
+};
+
+// ȡһEMAķ򣨳=ߣ=ߣ=4Сʱδ
+inline const char* readingTrendName(const IndicatorReading& r, Timeframe tf) {
+    int trend = r.emaTrend[static_cast<int>(tf)][0];
+    return INDICATOR_TREND_NAMES[trend < 0 ? 2 : trend];
+}
+
+// д׷/RSI/EMA/KST֣δָ겻б
+// дATRʱݴ˻atrRate
+inline void fillIndicatorAnalysis(const IndicatorReading& r, TradeAnalysis& ta) {
+    ta.longTrend = readingTrendName(r, Timeframe::TF_WEEK);
+    ta.midTrend = readingTrendName(r, Timeframe::TF_DAY);
+    ta.shortTrend = readingTrendName(r, Timeframe::TF_4H);
+    ta.rsiLevel = INDICATOR_RSI_NAMES[r.rsiLevel < 0 ? 2 : r.rsiLevel];
+    ta.rsiDuration = r.rsiBars;
+    ta.rsiUnit = "";
+    ta.emaList.clear();
+    ta.kstList.clear();
+    for (int t = 0; t < INDICATOR_TIMEFRAME_COUNT; ++t) {
+        Timeframe tf = static_cast<Timeframe>(t);
+        for (int i = 0; i < 3; ++i) {
+            if (r.emaTrend[t][i] < 0) continue;
+            ta.emaList.emplace_back(tf, r.emaPeriod[i], INDICATOR_TREND_NAMES[r.emaTrend[t][i]], r.emaTurn[t][i] != 0);
+        }
+        if (r.kstCross[t] >= 0) {
+            ta.kstList.emplace_back(tf,
+                                    std::initializer_list<int>{KST_ROC_PERIODS[0], KST_ROC_PERIODS[1], KST_ROC_PERIODS[2],
+                                                               KST_ROC_PERIODS[3]},
+                                    INDICATOR_CROSS_NAMES[r.kstCross[t]]);
+        }
+    }
+    ta.atrRate = r.atr > 0 && ta.openPrice > 0 ? r.atr / ta.openPrice * 100 : 0;
+}
+
+}  // namespace tradecheck
@@ -0,0 +1,215 @@
+#include "input_journal.h"
+#include "risk_protocol.h"
+#include <cstring>
+#include <ctime>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace tradecheck {
+
+namespace {
+
+int64_t realtimeNs() {
+    timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+size_t paddedLength(uint32_t length) {
+    return (static_cast<size_t>(length) + 7) & ~static_cast<size_t>(7);
+}
+
+// ¼ͷвУĲִlengthֶοʼ
+uint32_t entryCrc(const JournalEntryHeader& h, const uint8_t* payload) {
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(&h) + sizeof(h.crc);
+    uint32_t crc = crc32c(0, p, sizeof(h) - sizeof(h.crc));
+    return crc32c(crc, payload, h.length);
+}
+
+template <typename T>
+void appendBytes(std::vector<uint8_t>& out, const T& value) {
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(&value);
+    out.insert(out.end(), p, p + sizeof(T));
+}
+
+}  // namespace
+
+// ===== д =====
+
+JournalWriter::JournalWriter(const std::string& journalPath)
+    : file(nullptr), path(journalPath), sequence(0), truncated(0) {
+    struct stat st;
+    bool exists = ::stat(path.c_str(), &st) == 0 && st.st_size > 0;
+    if (exists) {
+        // Ум¼ţĩβļ¼д;˳ص
+        uint64_t valid = 0;
+        {
+            JournalReader reader(path);
+            JournalReader::Entry e;
+            while (reader.next(e)) sequence = e.header->sequence;
+            if (!reader.error().empty() && !reader.incompleteTail()) {
+                throw std::invalid_argument("־" + path + "𻵣" + reader.error() + "ûطų");
+            }
+            valid = reader.validBytes();
+            truncated = reader.fileSize() - valid;
+        }
+        if (truncated > 0 && ::truncate(path.c_str(), static_cast<off_t>(valid)) != 0) {
+            throw std::runtime_error("־ضʧܣ" + path);
+        }
+        file = std::fopen(path.c_str(), "ab");
+        if (!file) throw std::invalid_argument("޷д־" + path);
+        return;
+    }
+    file = std::fopen(path.c_str(), "wb");
+    if (!file) throw std::invalid_argument("޷д־" + path);
+    JournalFileHeader h{JOURNAL_MAGIC, JOURNAL_VERSION, 0, realtimeNs()};
+    if (std::fwrite(&h, sizeof(h), 1, file) != 1 || std::fflush(file) != 0) {
+        std::fclose(file);
+        throw std::runtime_error("־дʧܣ" + path);
+    }
+}
+
+JournalWriter::~JournalWriter() {
+    if (file) std::fclose(file);
+}
+
+uint64_t JournalWriter::append(JournalEntryType type, const void* payload, uint32_t length) {
+    if (length > JOURNAL_MAX_ENTRY) throw std::invalid_argument("־¼");
+    JournalEntryHeader h{};
+    h.length = length;
+    h.sequence = sequence + 1;
+    h.timestampNs = realtimeNs();
+    h.type = static_cast<uint16_t>(type);
+    h.crc = entryCrc(h, static_cast<const uint8_t*>(payload));
+
+    // ¼ͷغͲһд
+    size_t total = sizeof(h) + paddedLength(length);
+    buffer.assign(total, 0);
+    std::memcpy(buffer.data(), &h, sizeof(h));
+    if (length) std::memcpy(buffer.data() + sizeof(h), payload, length);
+    if (std::fwrite(buffer.data(), 1, total, file) != total || std::fflush(file) != 0) {
+        throw std::runtime_error("־дʧܣ" + path);
+    }
+    return ++sequence;
+}
+
+uint64_t JournalWriter::appendSession(const std::string& commandLine) {
+    return append(JournalEntryType::SESSION, commandLine.data(), static_cast<uint32_t>(commandLine.size()));
+}
+
+uint64_t JournalWriter::appendContracts(const std::vector<ContractSpec>& specs) {
+    return append(JournalEntryType::CONTRACTS, specs.data(), static_cast<uint32_t>(specs.size() * sizeof(ContractSpec)));
+}
+
+uint64_t JournalWriter::appendPosition(const RiskRecord& record) {
+    return append(JournalEntryType::POSITION, &record, sizeof(record));
+}
+
+uint64_t JournalWriter::appendCandles(const LevelsRecord& result, bool hasResult, const KlineData* bars, uint32_t count,
+                                      uint32_t window) {
+    JournalCandles c{};
+    c.result = result;
+    c.barCount = count;
+    c.window = window;
+    c.hasResult = hasResult ? 1 : 0;
+    std::vector<uint8_t> payload;
+    payload.reserve(sizeof(c) + count * sizeof(KlineData));
+    appendBytes(payload, c);
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(bars);
+    payload.insert(payload.end(), p, p + count * sizeof(KlineData));
+    return append(JournalEntryType::CANDLES, payload.data(), static_cast<uint32_t>(payload.size()));
+}
+
+uint64_t JournalWriter::appendAnalysis(const TradeAnalysis& ta, const ScoreRecord& result,
+                                       const std::vector<std::string>& contradictions) {
+    std::vector<char> request;
+    if (!encodeScoreRequest(ta, request)) throw std::invalid_argument("д޷Ĵ𰸣δд־");
+    std::vector<uint8_t> text;
+    for (const auto& c : contradictions) {
+        // ֶΪuint16ıضϺطűȶԱȻһ£ܾ
+        if (c.size() > UINT16_MAX) throw std::invalid_argument("ìܵı65535ֽڣδд־");
+        uint16_t len = static_cast<uint16_t>(c.size());
+        appendBytes(text, len);
+        text.insert(text.end(), c.begin(), c.begin() + len);
+    }
+    JournalAnalysis a{};
+    a.result = result;
+    a.requestLength = static_cast<uint32_t>(request.size());
+    a.textLength = static_cast<uint32_t>(text.size());
+    std::vector<uint8_t> payload;
+    payload.reserve(sizeof(a) + request.size() + text.size());
+    appendBytes(payload, a);
+    payload.insert(payload.end(), request.begin(), request.end());
+    payload.insert(payload.end(), text.begin(), text.end());
+    return append(JournalEntryType::ANALYSIS, payload.data(), static_cast<uint32_t>(payload.size()));
+}
+
+// ===== ȡ =====
+
+JournalReader::JournalReader(const std::string& path)
+    : mapped(nullptr), mappedSize(0), fileHeader(nullptr), offset(sizeof(JournalFileHeader)), expectedSequence(1),
+      incomplete(false) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::invalid_argument("޷־" + path);
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(JournalFileHeader)) {
+        ::close(fd);
+        throw std::invalid_argument("Ч־" + path);
+    }
+    mappedSize = static_cast<size_t>(st.st_size);
+    void* p = ::mmap(nullptr, mappedSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) throw std::invalid_argument("޷ӳ־" + path);
+    mapped = static_cast<const uint8_t*>(p);
+    fileHeader = reinterpret_cast<const JournalFileHeader*>(mapped);
+    if (fileHeader->magic != JOURNAL_MAGIC || fileHeader->version != JOURNAL_VERSION) {
+        ::munmap(const_cast<uint8_t*>(mapped), mappedSize);
+        throw std::invalid_argument("־" + path + "Чļʶ汾");
+    }
+}
+
+JournalReader::~JournalReader() {
+    ::munmap(const_cast<uint8_t*>(mapped), mappedSize);
+}
+
+bool JournalReader::next(Entry& entry) {
+    if (offset == mappedSize) return false;
+    if (!lastError.empty()) return false;
+    const char* error = nullptr;
+    const JournalEntryHeader* h = reinterpret_cast<const JournalEntryHeader*>(mapped + offset);
+    size_t remaining = mappedSize - offset;
+    if (remaining < sizeof(JournalEntryHeader)) {
+        error = "¼ͷ";
+        incomplete = true;
+    } else if (h->length > JOURNAL_MAX_ENTRY) {
+        error = "¼Ч";
+    } else if (paddedLength(h->length) > remaining - sizeof(*h)) {
+        error = "¼";
+        incomplete = true;
+    } else if (entryCrc(*h, mapped + offset + sizeof(*h)) != h->crc) {
+        error = "УͲ";
+    } else if (h->sequence != expectedSequence) {
+        error = "Ų";
+    }
+    if (error) {
+        lastError = "ƫ" + std::to_string(offset) + "" + error;
+        return false;
+    }
+    entry.header = h;
+    entry.payload = mapped + offset + sizeof(*h);
+    expectedSequence = h->sequence + 1;
+    offset += sizeof(*h) + paddedLength(h->length);
+    return true;
+}
+
+void JournalReader::rewind() {
+    offset = sizeof(JournalFileHeader);
+    expectedSequence = 1;
+    incomplete = false;
+    lastError.clear();
+}
+
+}  // namespace tradecheck
@@ -0,0 +1,142 @@
+#pragma once
+
+#include "output_records.h"
+#include "contract_registry.h"
+#include "crc32c.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace tradecheck {
+
+// ־루Լáֲ֡Kߡ𰸣ͬ׷дļ
+// طųԭ˳¼㲢¼λȶԣͬһ־ǻعҲ²
+// ļṹ16ֽļͷ | ¼... ÿ¼Ϊ32ֽڼ¼ͷ + أذ8ֽڶ벹㣩
+// ¼ͷеCRC32CǼ¼ͷֶ븺أŴ1ʼн
+const uint32_t JOURNAL_MAGIC = 0x314A4354; // "TCJ1"
+const uint16_t JOURNAL_VERSION = 1;
+const uint32_t JOURNAL_MAX_ENTRY = 64 * 1024 * 1024;
+
+enum class JournalEntryType : uint16_t {
+    SESSION = 1,    // һγеĿʼΪıطʱúԼ뻬״̬
+    CONTRACTS = 2,  // ԼãContractSpec
+    POSITION = 3,   // ֲֲǿƽ/֤RiskRecordͬʱ
+    CANDLES = 4,    // K֧λ
+    ANALYSIS = 5    // ۺ֡ìܵ
+};
+
+struct JournalFileHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t reserved;
+    int64_t createdNs; // ʱ䣨CLOCK_REALTIME룩
+};
+static_assert(sizeof(JournalFileHeader) == 16, "JournalFileHeaderѱ仯");
+
+struct JournalEntryHeader {
+    uint32_t crc;        // CRC32Clengthֶεĩβ
+    uint32_t length;     // ֽ벹㣩
+    uint64_t sequence;
+    int64_t timestampNs; // дʱ䣨CLOCK_REALTIME룩
+    uint16_t type;       // JournalEntryType
+    uint16_t reserved[3];
+};
+static_assert(sizeof(JournalEntryHeader) == 32, "JournalEntryHeaderѱ仯");
+
+// CANDLESأṹ + barCountKlineData
+// windowΪ0ʱΪЩK֧λ
+// window0ʱЩK׷ӵƷ֣result.symbolĻڣhasResultʾ׷Ӻ󴰿˽
+struct JournalCandles {
+    LevelsRecord result;
+    uint32_t barCount;
+    uint32_t window;
+    uint8_t hasResult;
+    uint8_t reserved[7];
+};
+static_assert(sizeof(JournalCandles) == 136, "JournalCandlesѱ仯");
+
+// ANALYSISأṹ + SCORE루risk_protocol.h + contradictionCount[uint16+ı]
+// ֻеֶΣƷǿƽ۴resultлԭ
+struct JournalAnalysis {
+    ScoreRecord result;
+    uint32_t requestLength;
+    uint32_t textLength;
+};
+static_assert(sizeof(JournalAnalysis) == 104, "JournalAnalysisѱ仯");
+
+// ־SESSION¼б
+inline std::string journalCommandLine(int argc, char* argv[]) {
+    std::string line;
+    for (int i = 0; i < argc; ++i) {
+        if (i > 0) line += ' ';
+        line += argv[i];
+    }
+    return line;
+}
+
+// ׷д룺ļѴʱУ飬صĩβļ¼ţмܾ򿪣ÿ¼д꼴ˢں
+class JournalWriter {
+public:
+    explicit JournalWriter(const std::string& path);
+    ~JournalWriter();
+
+    JournalWriter(const JournalWriter&) = delete;
+    JournalWriter& operator=(const JournalWriter&) = delete;
+
+    uint64_t append(JournalEntryType type, const void* payload, uint32_t length);
+
+    uint64_t appendSession(const std::string& commandLine);
+    uint64_t appendContracts(const std::vector<ContractSpec>& specs);
+    uint64_t appendPosition(const RiskRecord& record);
+    // hasResultΪfalseʱresultֻṩƷ֡ʱ
+    uint64_t appendCandles(const LevelsRecord& result, bool hasResult, const KlineData* bars, uint32_t count, uint32_t window);
+    uint64_t appendAnalysis(const TradeAnalysis& ta, const ScoreRecord& result, const std::vector<std::string>& contradictions);
+
+    uint64_t lastSequence() const { return sequence; }
+    uint64_t truncatedBytes() const { return truncated; } // ʱصĲβֽ
+
+private:
+    FILE* file;
+    std::string path;
+    uint64_t sequence;
+    uint64_t truncated;
+    std::vector<uint8_t> buffer;
+};
+
+// ֻʣmmapļ˳¼𻵻ļ¼ֹͣ
+class JournalReader {
+public:
+    struct Entry {
+        const JournalEntryHeader* header;
+        const uint8_t* payload;
+    };
+
+    explicit JournalReader(const std::string& path);
+    ~JournalReader();
+
+    JournalReader(const JournalReader&) = delete;
+    JournalReader& operator=(const JournalReader&) = delete;
+
+    // ȡһ¼βЧ¼ʱfalseʱerror()ǿձʾߣ
+    bool next(Entry& entry);
+    void rewind();
+
+    const JournalFileHeader& header() const { return *fileHeader; }
+    size_t fileSize() const { return mappedSize; }
+    size_t validBytes() const { return offset; }  // Уֽͨ
+    const std::string& error() const { return lastError; }
+    bool incompleteTail() const { return incomplete; }  // ֹͣԭĩβ¼дһ
+
+private:
+    const uint8_t* mapped;
+    size_t mappedSize;
+    const JournalFileHeader* fileHeader;
+    size_t offset;
+    uint64_t expectedSequence;
+    bool incomplete;
+    std::string lastError;
+};
+
+}  // namespace tradecheck
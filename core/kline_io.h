@@ -0,0 +1,81 @@
+#pragma once
+
+#include "support_resistance.h"
+#include <cstdint>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+namespace tradecheck {
+
+// KCSVļʽÿһKߣɴͷ#ͷΪעͣ
+// symbol,openTime,open,high,low,close,volume
+// openTimeΪʱ䣨ʱ
+
+// ƷֺʱK
+struct KlineRow {
+    std::string symbol;
+    int64_t openTime;
+    KlineData kline;
+};
+
+// Уɹtrueͷfalseʽ׳쳣
+inline bool parseKlineCsvLine(const char* line, int lineNo, KlineRow& row) {
+    const char* comma = std::strchr(line, ',');
+    if (!comma) throw std::invalid_argument("Kļ" + std::to_string(lineNo) + "ȱٶŷָ");
+    row.symbol.assign(line, comma - line);
+    const char* p = comma + 1;
+    char* end = nullptr;
+    row.openTime = std::strtoll(p, &end, 10);
+    if (end == p) {
+        if (lineNo == 1) return false; // ͷ
+        throw std::invalid_argument("Kļ" + std::to_string(lineNo) + "ʱʽ");
+    }
+    double* fields[5] = {&row.kline.open, &row.kline.high, &row.kline.low, &row.kline.close, &row.kline.volume};
+    for (double* f : fields) {
+        if (*end != ',') throw std::invalid_argument("Kļ" + std::to_string(lineNo) + "ֶβ");
+        p = end + 1;
+        *f = std::strtod(p, &end);
+        if (end == p) throw std::invalid_argument("Kļ" + std::to_string(lineNo) + "ֵʽ");
+    }
+    return true;
+}
+
+// ȡKCSVļ
+inline std::vector<KlineRow> loadKlineCsv(const std::string& path) {
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) throw std::invalid_argument("޷Kļ" + path);
+    std::vector<KlineRow> rows;
+    char line[1024];
+    int lineNo = 0;
+    KlineRow row;
+    try {
+        while (std::fgets(line, sizeof(line), file)) {
+            lineNo++;
+            if (line[0] == '#' || line[0] == '\n' || line[0] == '\r') continue;
+            if (parseKlineCsvLine(line, lineNo, row)) rows.push_back(row);
+        }
+    } catch (...) {
+        std::fclose(file);
+        throw;
+    }
+    std::fclose(file);
+    return rows;
+}
+
+// дKCSVļ
+inline void saveKlineCsv(const std::string& path, const std::vector<KlineRow>& rows) {
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) throw std::invalid_argument("޷дKļ" + path);
+    std::fprintf(file, "symbol,openTime,open,high,low,close,volume\n");
+    for (const auto& r : rows) {
+        std::fprintf(file, "%s,%lld,%.12g,%.12g,%.12g,%.12g,%.12g\n", r.symbol.c_str(), static_cast<long long>(r.openTime),
+                     r.kline.open, r.kline.high, r.kline.low, r.kline.close, r.kline.volume);
+    }
+    std::fclose(file);
+}
+
+}  // namespace tradecheck
@@ -0,0 +1,342 @@
+#pragma once
+
+#include "record_writer.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace tradecheck {
+
+// ·ֽ׶ӳͳƣʱ¼ÿ̵߳HDRֱͼҪʱϲ
+// TRADECHECK_NO_INSTRUMENTATIONCMakeѡTRADECHECK_INSTRUMENTATION=OFFʱչΪգκο
+
+// ԷͰֱͼС64ֵÿ1룬ÿ2641/64
+class HdrHistogram {
+public:
+    static const int SUB_BITS = 6;
+    static const int SUB_COUNT = 1 << SUB_BITS;
+    static const int BUCKET_COUNT = (64 - SUB_BITS + 1) * SUB_COUNT;
+
+    static int bucketOf(uint64_t v) {
+        if (v < static_cast<uint64_t>(SUB_COUNT)) return static_cast<int>(v);
+        int shift = 63 - __builtin_clzll(v) - SUB_BITS;
+        return (shift + 1) * SUB_COUNT + static_cast<int>(v >> shift) - SUB_COUNT;
+    }
+
+    // ֵڵֵٷλϽ籨棬͹
+    static uint64_t bucketHighest(int bucket) {
+        if (bucket < SUB_COUNT) return static_cast<uint64_t>(bucket);
+        int shift = bucket / SUB_COUNT - 1;
+        uint64_t low = static_cast<uint64_t>(bucket % SUB_COUNT + SUB_COUNT) << shift;
+        return low + ((1ULL << shift) - 1);
+    }
+
+    HdrHistogram() : counts(BUCKET_COUNT, 0) {}
+
+    void record(int64_t ns) {
+        uint64_t v = ns < 0 ? 0 : static_cast<uint64_t>(ns);
+        counts[bucketOf(v)]++;
+        if (total == 0 || v < minValue) minValue = v;
+        if (v > maxValue) maxValue = v;
+        sum += v;
+        total++;
+    }
+
+    void merge(const HdrHistogram& other) {
+        if (other.total == 0) return;
+        for (int i = 0; i < BUCKET_COUNT; ++i) counts[i] += other.counts[i];
+        if (total == 0 || other.minValue < minValue) minValue = other.minValue;
+        maxValue = std::max(maxValue, other.maxValue);
+        sum += other.sum;
+        total += other.total;
+    }
+
+    // pȡ0~1
+    uint64_t percentile(double p) const {
+        if (total == 0) return 0;
+        uint64_t target = static_cast<uint64_t>(p * total);
+        if (target >= total) target = total - 1;
+        uint64_t seen = 0;
+        for (int i = 0; i < BUCKET_COUNT; ++i) {
+            seen += counts[i];
+            if (seen > target) return std::min(bucketHighest(i), maxValue);
+        }
+        return maxValue;
+    }
+
+    void clear() {
+        std::fill(counts.begin(), counts.end(), 0);
+        total = sum = minValue = maxValue = 0;
+    }
+
+    uint64_t count() const { return total; }
+    uint64_t min() const { return minValue; }
+    uint64_t max() const { return maxValue; }
+    double mean() const { return total ? static_cast<double>(sum) / total : 0.0; }
+
+private:
+    friend class LatencyRecorder;
+    std::vector<uint64_t> counts;
+    uint64_t total = 0;
+    uint64_t sum = 0;
+    uint64_t minValue = 0;
+    uint64_t maxValue = 0;
+};
+
+// ʱ׶
+enum class LatencyStage {
+    INGEST,          // /Kд
+    RESAMPLE,        // Kز
+    INDICATORS,      // ʽָ
+    LEVELS,          // ֧λ/
+    SCORING,         // һ
+    CONTRADICTIONS,  // ìܵ
+    OUTPUT,          // д
+    RISK             // ǿƽ/֤
+};
+const int LATENCY_STAGE_COUNT = 8;
+const char* const LATENCY_STAGE_NAMES[LATENCY_STAGE_COUNT] = {
+    "ingest", "resample", "indicators", "levels", "scoring", "contradictions", "output", "risk"
+};
+
+// ̵߳ĸ׶μֻ߳д룬relaxedԭԱ̺߳ϲʱȡ
+class LatencyRecorder {
+public:
+    LatencyRecorder();
+    ~LatencyRecorder();
+
+    LatencyRecorder(const LatencyRecorder&) = delete;
+    LatencyRecorder& operator=(const LatencyRecorder&) = delete;
+
+    void record(LatencyStage stage, int64_t ns) {
+        Stage& s = stages[static_cast<int>(stage)];
+        uint64_t v = ns < 0 ? 0 : static_cast<uint64_t>(ns);
+        bump(s.counts[HdrHistogram::bucketOf(v)], 1);
+        bump(s.sum, v);
+        if (v > s.maxValue.load(std::memory_order_relaxed)) s.maxValue.store(v, std::memory_order_relaxed);
+        if (v < s.minValue.load(std::memory_order_relaxed)) s.minValue.store(v, std::memory_order_relaxed);
+    }
+
+    void mergeInto(std::vector<HdrHistogram>& out) const {
+        for (int i = 0; i < LATENCY_STAGE_COUNT; ++i) {
+            const Stage& s = stages[i];
+            HdrHistogram& h = out[i];
+            uint64_t total = 0;
+            for (int b = 0; b < HdrHistogram::BUCKET_COUNT; ++b) {
+                uint64_t c = s.counts[b].load(std::memory_order_relaxed);
+                h.counts[b] += c;
+                total += c;
+            }
+            if (total == 0) continue;
+            uint64_t minValue = s.minValue.load(std::memory_order_relaxed);
+            if (h.total == 0 || minValue < h.minValue) h.minValue = minValue;
+            h.maxValue = std::max(h.maxValue, s.maxValue.load(std::memory_order_relaxed));
+            h.sum += s.sum.load(std::memory_order_relaxed);
+            h.total += total;
+        }
+    }
+
+    // ̵߳д벢ʱ©
+    void clear() {
+        for (int i = 0; i < LATENCY_STAGE_COUNT; ++i) {
+            Stage& s = stages[i];
+            for (auto& c : s.counts) c.store(0, std::memory_order_relaxed);
+            s.sum.store(0, std::memory_order_relaxed);
+            s.minValue.store(UINT64_MAX, std::memory_order_relaxed);
+            s.maxValue.store(0, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    struct Stage {
+        std::atomic<uint64_t> counts[HdrHistogram::BUCKET_COUNT] = {};
+        std::atomic<uint64_t> sum{0};
+        std::atomic<uint64_t> minValue{UINT64_MAX};
+        std::atomic<uint64_t> maxValue{0};
+    };
+    std::unique_ptr<Stage[]> stages; // Լ240KBڶÿ̵߳TLS鶼
+
+    // дߣдҪָ
+    static void bump(std::atomic<uint64_t>& a, uint64_t n) {
+        a.store(a.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+};
+
+// ȫ̼߳¼ĵǼǱ߳˳ʱretired
+class LatencyRegistry {
+public:
+    static LatencyRegistry& instance() {
+        static LatencyRegistry registry;
+        return registry;
+    }
+
+    void attach(LatencyRecorder* r) {
+        std::lock_guard<std::mutex> lock(mutex);
+        recorders.push_back(r);
+    }
+
+    void detach(LatencyRecorder* r) {
+        std::lock_guard<std::mutex> lock(mutex);
+        r->mergeInto(retired);
+        recorders.erase(std::remove(recorders.begin(), recorders.end(), r), recorders.end());
+    }
+
+    // ϲ̣߳˳̣߳ĵǰ
+    std::vector<HdrHistogram> snapshot() {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::vector<HdrHistogram> merged(retired);
+        for (const LatencyRecorder* r : recorders) r->mergeInto(merged);
+        return merged;
+    }
+
+    void reset() {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto& h : retired) h.clear();
+        for (LatencyRecorder* r : recorders) r->clear();
+    }
+
+private:
+    LatencyRegistry() : retired(LATENCY_STAGE_COUNT) {}
+
+    std::mutex mutex;
+    std::vector<LatencyRecorder*> recorders;
+    std::vector<HdrHistogram> retired;
+};
+
+inline LatencyRecorder::LatencyRecorder() : stages(new Stage[LATENCY_STAGE_COUNT]) {
+    LatencyRegistry::instance().attach(this);
+}
+
+inline LatencyRecorder::~LatencyRecorder() {
+    LatencyRegistry::instance().detach(this);
+}
+
+// ǰ̵߳ļ¼״ʹʱǼǣ
+inline LatencyRecorder& threadLatencyRecorder() {
+    thread_local LatencyRecorder recorder;
+    return recorder;
+}
+
+inline std::vector<HdrHistogram> latencySnapshot() {
+    return LatencyRegistry::instance().snapshot();
+}
+
+inline void resetLatencyStats() {
+    LatencyRegistry::instance().reset();
+}
+
+// ʱʱѾ뵱ǰ̵߳ĶӦ׶
+class ScopedLatency {
+public:
+    explicit ScopedLatency(LatencyStage s) : stage(s), start(std::chrono::steady_clock::now()) {}
+    ~ScopedLatency() {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        threadLatencyRecorder().record(stage, ns);
+    }
+
+    ScopedLatency(const ScopedLatency&) = delete;
+    ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+private:
+    LatencyStage stage;
+    std::chrono::steady_clock::time_point start;
+};
+
+#define TRADECHECK_LATENCY_CONCAT_(a, b) a##b
+#define TRADECHECK_LATENCY_CONCAT(a, b) TRADECHECK_LATENCY_CONCAT_(a, b)
+#ifdef TRADECHECK_NO_INSTRUMENTATION
+#define TRADECHECK_LATENCY_SCOPE(stage) ((void)0)
+#define TRADECHECK_LATENCY_RECORD(stage, ns) ((void)0)
+const bool LATENCY_INSTRUMENTATION_ENABLED = false;
+#else
+// ʱ
+#define TRADECHECK_LATENCY_SCOPE(stage) \
+    ::tradecheck::ScopedLatency TRADECHECK_LATENCY_CONCAT(latencyScope_, __LINE__)(stage)
+// ¼Ѳõ
+#define TRADECHECK_LATENCY_RECORD(stage, ns) ::tradecheck::threadLatencyRecorder().record(stage, ns)
+const bool LATENCY_INSTRUMENTATION_ENABLED = true;
+#endif
+
+// ׶εĻܣ΢룩
+struct LatencyStageSummary {
+    char stage[16];
+    uint64_t count;
+    double p50Us;
+    double p99Us;
+    double p999Us;
+    double maxUs;
+    double meanUs;
+};
+static_assert(sizeof(LatencyStageSummary) == 64, "LatencyStageSummaryѱ仯");
+
+// м¼Ľ׶
+inline std::vector<LatencyStageSummary> summarizeLatency(const std::vector<HdrHistogram>& stages) {
+    std::vector<LatencyStageSummary> out;
+    for (size_t i = 0; i < stages.size() && i < static_cast<size_t>(LATENCY_STAGE_COUNT); ++i) {
+        const HdrHistogram& h = stages[i];
+        if (h.count() == 0) continue;
+        LatencyStageSummary s{};
+        copyRecordSymbol(s.stage, LATENCY_STAGE_NAMES[i]);
+        s.count = h.count();
+        s.p50Us = h.percentile(0.5) / 1000.0;
+        s.p99Us = h.percentile(0.99) / 1000.0;
+        s.p999Us = h.percentile(0.999) / 1000.0;
+        s.maxUs = h.max() / 1000.0;
+        s.meanUs = h.mean() / 1000.0;
+        out.push_back(s);
+    }
+    return out;
+}
+
+// ÿ׶һNDJSON
+inline void writeLatencyJson(BufferedWriter& out, const std::vector<LatencyStageSummary>& stages) {
+    JsonLineWriter json(out);
+    for (const auto& s : stages) {
+        json.begin();
+        json.string("stage", s.stage)
+            .integer("count", static_cast<int64_t>(s.count))
+            .number("p50Us", s.p50Us)
+            .number("p99Us", s.p99Us)
+            .number("p999Us", s.p999Us)
+            .number("maxUs", s.maxUs)
+            .number("meanUs", s.meanUs);
+        json.end();
+    }
+}
+
+// ı
+inline void printLatencyTable(FILE* out, const std::vector<LatencyStageSummary>& stages) {
+    if (stages.empty()) {
+        std::fprintf(out, "޷ֽ׶ӳټ¼%s\n", LATENCY_INSTRUMENTATION_ENABLED ? "" : "ʱѹرռʱ");
+        return;
+    }
+    // ͷʾȶ루ַռУ
+    std::fprintf(out, "׶                         p50(us)    p99(us)  p99.9(us)    max(us)   ƽ(us)\n");
+    for (const auto& s : stages) {
+        std::fprintf(out, "%-16s %12llu %10.2f %10.2f %10.2f %10.2f %10.2f\n", s.stage,
+                     static_cast<unsigned long long>(s.count), s.p50Us, s.p99Us, s.p999Us, s.maxUs, s.meanUs);
+    }
+}
+
+// չд棺.json/.ndjsonΪNDJSONΪı
+inline void writeLatencyReport(const std::string& path, const std::vector<LatencyStageSummary>& stages) {
+    bool json = (path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0) ||
+                (path.size() >= 7 && path.compare(path.size() - 7, 7, ".ndjson") == 0);
+    if (json) {
+        BufferedWriter out(path);
+        writeLatencyJson(out, stages);
+        return;
+    }
+    FILE* f = std::fopen(path.c_str(), "w");
+    if (!f) throw std::invalid_argument("޷дӳٱ棺" + path);
+    printLatencyTable(f, stages);
+    std::fclose(f);
+}
+
+}  // namespace tradecheck
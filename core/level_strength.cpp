@@ -0,0 +1,192 @@
+#include "level_strength.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+namespace tradecheck {
+
+namespace {
+
+// Kߣi1ĸȽֵλֵȽϼжϴ/סȥλ˷
+struct BarThresholds {
+    double touchLow;    // λݴֵKͼ۽ݲ
+    double touchHigh;   // λֵܴK߼۽ݲ
+    double fromAbove;   // λ<ֵһݲϷ
+    double fromBelow;   // λ>ֵһݲ·
+    double supportHeld; // λֵܴδݲ
+    double resistHeld;  // λݴֵδͻݲ
+};
+
+BarThresholds barThresholds(const KlineData& prev, const KlineData& bar, double tolerance) {
+    double up = 1 + tolerance, down = 1 - tolerance;
+    return {bar.low / up, bar.high / down, prev.close / up, prev.close / down, bar.close / down, bar.close / up};
+}
+
+void validate(const KlineData* klines, size_t count, double tolerance) {
+    if (!(tolerance >= 0 && tolerance < 1)) throw std::invalid_argument("ݲ0~1֮");
+    for (size_t i = 0; i < count; ++i) {
+        if (klines[i].high < klines[i].low) throw std::invalid_argument("߼۵ͼ۵ЧK");
+    }
+}
+
+void finishScores(std::vector<LevelStrength>& out) {
+    for (auto& s : out) {
+        double touches = s.touches();
+        s.score = (s.holds() + 1.0) / (touches + 2.0) * std::log1p(touches);
+    }
+    std::stable_sort(out.begin(), out.end(),
+                     [](const LevelStrength& a, const LevelStrength& b) { return a.score > b.score; });
+}
+
+LevelStrength emptyStrength(const LevelCandidate& c) {
+    return {c.price, c.source, 0, 0, 0, 0, 0.0};
+}
+
+}  // namespace
+
+const char* levelSourceName(LevelSource source) {
+    switch (source) {
+        case LevelSource::HIGHEST_HIGH: return "߼";
+        case LevelSource::LOWEST_LOW: return "ͼ";
+        case LevelSource::PIVOT: return "";
+        case LevelSource::S1: return "S1";
+        case LevelSource::S2: return "S2";
+        case LevelSource::S3: return "S3";
+        case LevelSource::R1: return "R1";
+        case LevelSource::R2: return "R2";
+        case LevelSource::R3: return "R3";
+        case LevelSource::DENSE_SUPPORT: return "ܼ֧";
+        case LevelSource::DENSE_RESIST: return "ܼ";
+        case LevelSource::VOLUME_NODE: return "ɽ";
+        case LevelSource::DEPTH_WALL: return "ҵǽ";
+    }
+    return "δ֪";
+}
+
+std::vector<LevelCandidate> collectLevelCandidates(const SupportResistanceLevels& l, const KlineData* klines,
+                                                   size_t count, size_t volumeNodes, int profileBins) {
+    std::vector<LevelCandidate> out;
+    const LevelCandidate fixed[] = {
+        {l.highestHigh, LevelSource::HIGHEST_HIGH}, {l.lowestLow, LevelSource::LOWEST_LOW},
+        {l.pivotPoint, LevelSource::PIVOT},         {l.s1, LevelSource::S1},
+        {l.s2, LevelSource::S2},                    {l.s3, LevelSource::S3},
+        {l.r1, LevelSource::R1},                    {l.r2, LevelSource::R2},
+        {l.r3, LevelSource::R3},                    {l.denseSupport, LevelSource::DENSE_SUPPORT},
+        {l.denseResist, LevelSource::DENSE_RESIST}};
+    for (const auto& c : fixed) {
+        if (std::isfinite(c.price) && c.price > 0) out.push_back(c);
+    }
+    if (volumeNodes == 0 || count == 0) return out;
+    if (profileBins < 3) throw std::invalid_argument("ɽֲС3");
+
+    // ۸ɽֵK߲ɽֲNaN/תintʱδ壩
+    double lo = std::numeric_limits<double>::infinity(), hi = -std::numeric_limits<double>::infinity();
+    for (size_t i = 0; i < count; ++i) {
+        const KlineData& k = klines[i];
+        if (!(std::isfinite(k.low) && std::isfinite(k.high))) continue;
+        lo = std::min(lo, k.low);
+        hi = std::max(hi, k.high);
+    }
+    if (!(hi > lo)) return out;
+    double width = (hi - lo) / profileBins;
+    std::vector<double> profile(profileBins, 0.0);
+    for (size_t i = 0; i < count; ++i) {
+        const KlineData& k = klines[i];
+        if (!(k.volume > 0 && std::isfinite(k.volume))) continue;
+        double typical = (k.high + k.low + k.close) / 3.0;
+        if (!std::isfinite(typical)) continue;
+        int b = static_cast<int>(std::min(std::max((typical - lo) / width, 0.0), static_cast<double>(profileBins - 1)));
+        profile[b] += k.volume;
+    }
+    // ֲֵϸҲҲࣨƽֻ̨ȡһ
+    std::vector<int> peaks;
+    for (int b = 0; b < profileBins; ++b) {
+        double left = b > 0 ? profile[b - 1] : 0.0;
+        double right = b + 1 < profileBins ? profile[b + 1] : 0.0;
+        if (profile[b] > left && profile[b] >= right) peaks.push_back(b);
+    }
+    size_t n = std::min(volumeNodes, peaks.size());
+    std::partial_sort(peaks.begin(), peaks.begin() + n, peaks.end(),
+                      [&](int a, int b) { return profile[a] > profile[b] || (profile[a] == profile[b] && a < b); });
+    for (size_t i = 0; i < n; ++i) out.push_back({lo + (peaks[i] + 0.5) * width, LevelSource::VOLUME_NODE});
+    return out;
+}
+
+std::vector<LevelStrength> rankLevelStrength(const std::vector<LevelCandidate>& candidates, const KlineData* klines,
+                                             size_t count, double tolerance) {
+    validate(klines, count, tolerance);
+    size_t m = candidates.size();
+    std::vector<size_t> order(m);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [&](size_t a, size_t b) { return candidates[a].price < candidates[b].price; });
+    std::vector<double> prices(m);
+    for (size_t i = 0; i < m; ++i) prices[i] = candidates[order[i]].price;
+
+    // ĸ飺֧Ų/ס/סÿK߶ԸԵ[, ֹ)1
+    std::vector<int64_t> diff[4];
+    for (auto& d : diff) d.assign(m + 1, 0);
+    auto addRange = [&](std::vector<int64_t>& d, size_t begin, size_t end) {
+        if (begin >= end) return;
+        d[begin] += 1;
+        d[end] -= 1;
+    };
+    const double* first = prices.data();
+    const double* last = prices.data() + m;
+    auto lower = [&](double x) { return static_cast<size_t>(std::lower_bound(first, last, x) - first); };
+    auto upper = [&](double x) { return static_cast<size_t>(std::upper_bound(first, last, x) - first); };
+    for (size_t i = 1; i < count && m > 0; ++i) {
+        BarThresholds t = barThresholds(klines[i - 1], klines[i], tolerance);
+        size_t a = lower(t.touchLow);
+        size_t b = upper(t.touchHigh);
+        if (a >= b) continue;
+        size_t supportEnd = std::min(b, lower(t.fromAbove));
+        addRange(diff[0], a, supportEnd);
+        addRange(diff[1], a, std::min(supportEnd, upper(t.supportHeld)));
+        size_t resistBegin = std::max(a, upper(t.fromBelow));
+        addRange(diff[2], resistBegin, b);
+        addRange(diff[3], std::max(resistBegin, lower(t.resistHeld)), b);
+    }
+
+    std::vector<LevelStrength> out(m);
+    int64_t running[4] = {0, 0, 0, 0};
+    for (size_t i = 0; i < m; ++i) {
+        for (int k = 0; k < 4; ++k) running[k] += diff[k][i];
+        LevelStrength s = emptyStrength(candidates[order[i]]);
+        s.supportTests = static_cast<uint32_t>(running[0]);
+        s.supportHolds = static_cast<uint32_t>(running[1]);
+        s.resistTests = static_cast<uint32_t>(running[2]);
+        s.resistHolds = static_cast<uint32_t>(running[3]);
+        out[order[i]] = s;
+    }
+    finishScores(out);
+    return out;
+}
+
+std::vector<LevelStrength> rankLevelStrengthNaive(const std::vector<LevelCandidate>& candidates, const KlineData* klines,
+                                                  size_t count, double tolerance) {
+    validate(klines, count, tolerance);
+    std::vector<LevelStrength> out;
+    out.reserve(candidates.size());
+    for (const auto& c : candidates) out.push_back(emptyStrength(c));
+    for (size_t i = 1; i < count; ++i) {
+        BarThresholds t = barThresholds(klines[i - 1], klines[i], tolerance);
+        for (auto& s : out) {
+            double p = s.price;
+            if (!(p >= t.touchLow && p <= t.touchHigh)) continue;
+            if (p < t.fromAbove) {
+                ++s.supportTests;
+                if (p <= t.supportHeld) ++s.supportHolds;
+            } else if (p > t.fromBelow) {
+                ++s.resistTests;
+                if (p >= t.resistHeld) ++s.resistHolds;
+            }
+        }
+    }
+    finishScores(out);
+    return out;
+}
+
+}  // namespace tradecheck
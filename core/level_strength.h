@@ -0,0 +1,64 @@
+#pragma once
+
+#include "support_resistance.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace tradecheck {
+
+// ֧λǿȣͳʷϼ۸񴥼λݲڣǷת
+// һKλݲ[λ(1-ݲ), λ(1+ݲ)]ཻһڴ⣬Ϊһδ
+//   һڴϷ  ֧ŲԣδƴΪס
+//   һڴ·  ԣδͻƴΪס
+// λ۸ÿKߵĴ/סΧ䣬öֲ+ͳƣ
+// ܺʱO(Klogλ + λ)ÿKߴټλ޹
+
+// ѡλԴ
+enum class LevelSource : uint8_t {
+    HIGHEST_HIGH,
+    LOWEST_LOW,
+    PIVOT,
+    S1, S2, S3,
+    R1, R2, R3,
+    DENSE_SUPPORT,
+    DENSE_RESIST,
+    VOLUME_NODE, // ɽֲľֲֵ
+    DEPTH_WALL   // ҵǽorder_book_depth.h
+};
+
+const char* levelSourceName(LevelSource source);
+
+struct LevelCandidate {
+    double price;
+    LevelSource source;
+};
+
+struct LevelStrength {
+    double price;
+    LevelSource source;
+    uint32_t supportTests;
+    uint32_t supportHolds;
+    uint32_t resistTests;
+    uint32_t resistHolds;
+    double score;
+
+    uint32_t touches() const { return supportTests + resistTests; }
+    uint32_t holds() const { return supportHolds + resistHolds; }
+};
+
+// ֧λֵϳɽֲгɽvolumeNodesֲֵ
+// ɽֲͼۣ(++)/3profileBinsȿ۸ۼ
+std::vector<LevelCandidate> collectLevelCandidates(const SupportResistanceLevels& levels, const KlineData* klines,
+                                                   size_t count, size_t volumeNodes, int profileBins = 200);
+
+// ͳƺѡλKϵĴס÷ֽ򷵻
+// ÷ = ƽס(ס+1)/(+2)  ln(1+)ԽסԽԽǿ
+std::vector<LevelStrength> rankLevelStrength(const std::vector<LevelCandidate>& candidates, const KlineData* klines,
+                                             size_t count, double tolerance);
+
+// λKжϵĲοʵ֣rankLevelStrengthһ£У׼Աȣ
+std::vector<LevelStrength> rankLevelStrengthNaive(const std::vector<LevelCandidate>& candidates, const KlineData* klines,
+                                                  size_t count, double tolerance);
+
+}  // namespace tradecheck
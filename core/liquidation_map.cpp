@@ -0,0 +1,265 @@
+#include "liquidation_map.h"
+#include "risk_kernels.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define TRADECHECK_LIQUIDATION_AVX2 1
+#endif
+
+namespace tradecheck {
+
+namespace {
+
+// ÿĿּ۸һĸL1ڣȫܸ˵λ
+const size_t LIQUIDATION_BLOCK = 1024;
+
+// ϳɳְֲдţ±Ϊּţܸ뷽ڼʱչ
+struct EntryColumns {
+    std::vector<double> entry;    // ּ
+    std::vector<double> notional; // ÿּϵ¿ֵUSDTδ˸ܸ˵λȨأ
+    std::vector<double> floor;    // ֮Kߵͼۣ൥ǿƽδǿƽ
+    std::vector<double> ceiling;  // ֮Kߵ߼ۣյǿƽδǿƽ
+};
+
+// һܸ˵λ+
+struct LiquidationSlice {
+    double factor; // ǿƽ/ּ
+    double weight; // ֵȨأܸ˵λȨء
+    bool isLong;
+};
+
+struct HistogramRange {
+    double low;
+    double scale; // /۸
+    int bins;
+};
+
+void accumulateScalar(const EntryColumns& c, size_t begin, size_t end, const LiquidationSlice& s,
+                      const HistogramRange& r, double* hist) {
+    const double* limit = s.isLong ? c.floor.data() : c.ceiling.data();
+    for (size_t i = begin; i < end; ++i) {
+        double liq = c.entry[i] * s.factor;
+        bool alive = s.isLong ? liq < limit[i] : liq > limit[i];
+        double b = (liq - r.low) * r.scale;
+        if (alive && b >= 0 && b < r.bins) hist[static_cast<int>(b)] += c.notional[i] * s.weight;
+    }
+}
+
+#ifdef TRADECHECK_LIQUIDATION_AVX2
+// ǿƽۡж±4·Уۼ԰±˳У·˳ͬ
+__attribute__((target("avx2"))) void accumulateAvx2(const EntryColumns& c, size_t begin, size_t end,
+                                                     const LiquidationSlice& s, const HistogramRange& r, double* hist) {
+    const double* limit = s.isLong ? c.floor.data() : c.ceiling.data();
+    const __m256d factor = _mm256_set1_pd(s.factor);
+    const __m256d weight = _mm256_set1_pd(s.weight);
+    const __m256d low = _mm256_set1_pd(r.low);
+    const __m256d scale = _mm256_set1_pd(r.scale);
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d bins = _mm256_set1_pd(static_cast<double>(r.bins));
+    alignas(32) int32_t index[4];
+    alignas(32) double value[4];
+    size_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        __m256d liq = _mm256_mul_pd(_mm256_loadu_pd(&c.entry[i]), factor);
+        __m256d lim = _mm256_loadu_pd(limit + i);
+        __m256d alive = s.isLong ? _mm256_cmp_pd(liq, lim, _CMP_LT_OQ) : _mm256_cmp_pd(liq, lim, _CMP_GT_OQ);
+        __m256d b = _mm256_mul_pd(_mm256_sub_pd(liq, low), scale);
+        __m256d inRange = _mm256_and_pd(_mm256_cmp_pd(b, zero, _CMP_GE_OQ), _mm256_cmp_pd(b, bins, _CMP_LT_OQ));
+        int mask = _mm256_movemask_pd(_mm256_and_pd(alive, inRange));
+        if (mask == 0) continue;
+        _mm_store_si128(reinterpret_cast<__m128i*>(index), _mm256_cvttpd_epi32(b));
+        _mm256_store_pd(value, _mm256_mul_pd(_mm256_loadu_pd(&c.notional[i]), weight));
+        for (int k = 0; k < 4; ++k) {
+            if (mask & (1 << k)) hist[index[k]] += value[k];
+        }
+    }
+    accumulateScalar(c, i, end, s, r, hist);
+}
+#endif
+
+// ǿƽ뿪ּ֮ȣUSDTλliquidationPriceFactorұλInverseCoinĹʽֻܸͬˡάֱ֤й
+// 1յûǿƽֵۣΪ+inf䲻κη䣩
+double sliceFactor(ContractType type, TradeDirection direction, double leverage, double mmr) {
+    if (type != ContractType::INVERSE_COIN) return liquidationPriceFactor(direction, leverage, mmr);
+    return direction == TradeDirection::LONG ? InverseCoin::liquidationPrice<TradeDirection::LONG>(1.0, leverage, mmr)
+                                             : InverseCoin::liquidationPrice<TradeDirection::SHORT>(1.0, leverage, mmr);
+}
+
+bool detectSimd() {
+#ifdef TRADECHECK_LIQUIDATION_AVX2
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+EntryColumns buildEntries(const KlineData* bars, size_t count, int points, bool keepLiquidated) {
+    const double inf = std::numeric_limits<double>::infinity();
+    EntryColumns c;
+    size_t total = count * static_cast<size_t>(points);
+    c.entry.reserve(total);
+    c.notional.reserve(total);
+    c.floor.reserve(total);
+    c.ceiling.reserve(total);
+    // ɨõ֮Kߵ/߼
+    std::vector<double> laterLow(count, inf), laterHigh(count, -inf);
+    if (!keepLiquidated) {
+        for (size_t i = count - 1; i > 0; --i) {
+            laterLow[i - 1] = std::min(laterLow[i], bars[i].low);
+            laterHigh[i - 1] = std::max(laterHigh[i], bars[i].high);
+        }
+    }
+    for (size_t i = 0; i < count; ++i) {
+        const KlineData& k = bars[i];
+        if (!(k.volume > 0) || !std::isfinite(k.volume)) continue;
+        double step = (k.high - k.low) / points;
+        double volume = k.volume / points;
+        for (int j = 0; j < points; ++j) {
+            double entry = k.low + (j + 0.5) * step;
+            c.entry.push_back(entry);
+            c.notional.push_back(volume * entry);
+            c.floor.push_back(laterLow[i]);
+            c.ceiling.push_back(laterHigh[i]);
+        }
+    }
+    return c;
+}
+
+}  // namespace
+
+bool liquidationMapSimdSupported() {
+    static const bool supported = detectSimd();
+    return supported;
+}
+
+int LiquidationMap::binOf(double price) const {
+    if (!(binWidth > 0)) return -1;
+    double b = (price - low) / binWidth;
+    if (!(b >= 0 && b < static_cast<double>(longNotional.size()))) return -1;
+    return static_cast<int>(b);
+}
+
+LiquidationMap computeLiquidationMap(const KlineData* bars, size_t count, double maintenanceMarginRate,
+                                     const LiquidationMapOptions& opt, ContractType contractType) {
+    if (count == 0) throw std::invalid_argument("ǿƽֲҪ1K");
+    if (opt.leverages.empty()) throw std::invalid_argument("ܸ˷ֲΪ");
+    if (opt.pricePoints < 1 || opt.pricePoints > 1024) throw std::invalid_argument("ÿK߿ּ۸1~1024֮");
+    if (opt.binCount < 1 || opt.binCount > 1000000) throw std::invalid_argument("۸1~1000000֮");
+    if (!(opt.longShare >= 0 && opt.longShare <= 1)) throw std::invalid_argument("൥0~1֮");
+    double weightSum = 0;
+    for (const auto& b : opt.leverages) {
+        if (!(b.leverage >= 1)) throw std::invalid_argument("ܸ˱С1");
+        if (!(b.weight >= 0)) throw std::invalid_argument("ܸȨزΪ");
+        weightSum += b.weight;
+    }
+    if (!(weightSum > 0)) throw std::invalid_argument("ܸȨغϼƱ0");
+
+    LiquidationMap map;
+    double low = opt.rangeLow, high = opt.rangeHigh;
+    if (low == 0 && high == 0) {
+        double last = bars[count - 1].close;
+        low = last * (1 - opt.rangePercent / 100.0);
+        high = last * (1 + opt.rangePercent / 100.0);
+    }
+    if (!(high > low)) throw std::invalid_argument("ǿƽֲ۸Ч");
+    map.low = low;
+    map.binWidth = (high - low) / opt.binCount;
+    map.longNotional.assign(opt.binCount, 0.0);
+    map.shortNotional.assign(opt.binCount, 0.0);
+    HistogramRange range{low, opt.binCount / (high - low), opt.binCount};
+
+    std::vector<LiquidationSlice> slices;
+    for (const auto& b : opt.leverages) {
+        double w = b.weight / weightSum;
+        slices.push_back({sliceFactor(contractType, TradeDirection::LONG, b.leverage, maintenanceMarginRate),
+                          w * opt.longShare, true});
+        slices.push_back({sliceFactor(contractType, TradeDirection::SHORT, b.leverage, maintenanceMarginRate),
+                          w * (1 - opt.longShare), false});
+    }
+
+    EntryColumns entries = buildEntries(bars, count, opt.pricePoints, opt.keepLiquidated);
+    size_t n = entries.entry.size();
+    map.positions = static_cast<uint64_t>(n) * slices.size();
+    if (n == 0) return map;
+
+    bool simd = opt.simd && liquidationMapSimdSupported();
+    unsigned threadCount = opt.threads ? opt.threads : std::max(1u, std::thread::hardware_concurrency());
+    size_t blocks = (n + LIQUIDATION_BLOCK - 1) / LIQUIDATION_BLOCK;
+    if (threadCount > blocks) threadCount = static_cast<unsigned>(blocks);
+
+    // ÿ̶߳Ķ/ֱͼ߳˳ϲ
+    std::vector<std::vector<double>> partial(threadCount, std::vector<double>(2 * opt.binCount, 0.0));
+    auto worker = [&](unsigned t) {
+        size_t begin = blocks * t / threadCount * LIQUIDATION_BLOCK;
+        size_t end = std::min(n, blocks * (t + 1) / threadCount * LIQUIDATION_BLOCK);
+        double* longHist = partial[t].data();
+        double* shortHist = longHist + opt.binCount;
+        for (size_t b = begin; b < end; b += LIQUIDATION_BLOCK) {
+            size_t e = std::min(end, b + LIQUIDATION_BLOCK);
+            for (const auto& s : slices) {
+                double* hist = s.isLong ? longHist : shortHist;
+#ifdef TRADECHECK_LIQUIDATION_AVX2
+                if (simd) {
+                    accumulateAvx2(entries, b, e, s, range, hist);
+                    continue;
+                }
+#endif
+                accumulateScalar(entries, b, e, s, range, hist);
+            }
+        }
+    };
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threadCount; ++t) pool.emplace_back(worker, t);
+    worker(0);
+    for (auto& th : pool) th.join();
+    (void)simd;
+
+    for (const auto& p : partial) {
+        for (int i = 0; i < opt.binCount; ++i) {
+            map.longNotional[i] += p[i];
+            map.shortNotional[i] += p[opt.binCount + i];
+        }
+    }
+    for (int i = 0; i < opt.binCount; ++i) map.totalNotional += map.longNotional[i] + map.shortNotional[i];
+    return map;
+}
+
+std::vector<LiquidationCluster> topLiquidationClusters(const LiquidationMap& map, size_t n) {
+    std::vector<LiquidationCluster> all;
+    for (size_t i = 0; i < map.longNotional.size(); ++i) {
+        if (map.longNotional[i] > 0) all.push_back({i, TradeDirection::LONG, map.longNotional[i]});
+        if (map.shortNotional[i] > 0) all.push_back({i, TradeDirection::SHORT, map.shortNotional[i]});
+    }
+    n = std::min(n, all.size());
+    std::partial_sort(all.begin(), all.begin() + n, all.end(),
+                      [](const LiquidationCluster& a, const LiquidationCluster& b) { return a.notional > b.notional; });
+    all.resize(n);
+    return all;
+}
+
+std::vector<LeverageBucket> parseLeverageBuckets(const std::string& text) {
+    std::vector<LeverageBucket> buckets;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        size_t colon = item.find(':');
+        try {
+            LeverageBucket b;
+            b.leverage = std::stod(item.substr(0, colon));
+            b.weight = colon == std::string::npos ? 1.0 : std::stod(item.substr(colon + 1));
+            buckets.push_back(b);
+        } catch (const std::logic_error&) {
+            throw std::invalid_argument("ܸ˷ֲʽ" + item + "ӦΪ ܸ:Ȩ,ܸ:Ȩ...");
+        }
+    }
+    if (buckets.empty()) throw std::invalid_argument("ܸ˷ֲΪ");
+    return buckets;
+}
+
+}  // namespace tradecheck
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "crypto_risk.h"
+#include "support_resistance.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tradecheck {
+
+// ǿƽֲͼÿKߵĳɽ[ͼ, ߼]ھȳɽȫγ¿λ
+// ܸ˷ֲձɴϳɳֲ֣ǿƽֵۣUSDTۼƵ۸ֱͼ
+// ֮KѴǿƽ۵ĳֲΪѱǿƽټ
+
+// ܸ˵λռֲֵȨ
+struct LeverageBucket {
+    double leverage;
+    double weight;
+};
+
+struct LiquidationMapOptions {
+    std::vector<LeverageBucket> leverages = {{5, 0.15}, {10, 0.3}, {20, 0.25}, {50, 0.2}, {100, 0.1}};
+    double longShare = 0.5;        // ൥ռ¿ֵı
+    int pricePoints = 16;          // ÿKڼ۸ȡĿּ۸
+    int binCount = 100;            // ֱͼ۸
+    double rangeLow = 0;           // ֱͼ۸䣬߾Ϊ0ʱȡ̼rangePercent
+    double rangeHigh = 0;
+    double rangePercent = 30;
+    bool keepLiquidated = false;   // ѱ֮Kߴǿƽ۵ĳֲ
+    unsigned threads = 0;          // 0ʾCPU
+    bool simd = true;              // CPU֧ʱʹAVX2·λһ£
+};
+
+struct LiquidationMap {
+    double low = 0;       // 0
+    double binWidth = 0;
+    std::vector<double> longNotional;  // ൥ǿƽֵ۸÷ʱ
+    std::vector<double> shortNotional; // յǿƽֵ۸ǵ÷ʱ
+    uint64_t positions = 0;            // ĺϳɳֲּ۸ܸ˵λ
+    double totalNotional = 0;          // ֱͼֵϼ
+
+    double binLow(size_t i) const { return low + binWidth * static_cast<double>(i); }
+    double binHigh(size_t i) const { return low + binWidth * static_cast<double>(i + 1); }
+    // ۸ڷ䣨䷵-1
+    int binOf(double price) const;
+};
+
+// һKߣʱ򣩵ǿƽֲάֱ֤ԼȡԺԼұλԼԼʽǿƽۣ
+LiquidationMap computeLiquidationMap(const KlineData* bars, size_t count, double maintenanceMarginRate,
+                                     const LiquidationMapOptions& opt,
+                                     ContractType contractType = ContractType::LINEAR_USDT);
+
+// ֵķ䣨ֵnշ䣩
+struct LiquidationCluster {
+    size_t bin;
+    TradeDirection direction;
+    double notional;
+};
+std::vector<LiquidationCluster> topLiquidationClusters(const LiquidationMap& map, size_t n);
+
+// ܸ˷ֲ"5:0.15,10:0.3,20:0.25"Ȩڼʱһ
+std::vector<LeverageBucket> parseLeverageBuckets(const std::string& text);
+
+// ǰCPUǷ֧AVX2·
+bool liquidationMapSimdSupported();
+
+}  // namespace tradecheck
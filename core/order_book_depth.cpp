@@ -0,0 +1,355 @@
+#include "order_book_depth.h"
+#include "volatility.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace tradecheck {
+
+const char* depthSideName(DepthSide side) {
+    return side == DepthSide::BID ? "bid" : "ask";
+}
+
+DepthAggregator::DepthAggregator(double tickSize, const DepthOptions& opt) : options(opt), tick(tickSize) {
+    if (!(tickSize > 0)) throw std::invalid_argument("С۸䶯0");
+    if (!(opt.bucketPercent > 0) || !(opt.rangePercent > 0) || !(opt.ladderPercent > 0)) {
+        throw std::invalid_argument("ȡΧ붩Χ0");
+    }
+    if (opt.sampleInterval <= 0) throw std::invalid_argument("0");
+    invTick = 1.0 / tickSize;
+}
+
+double DepthAggregator::midTicks() const {
+    if (best[0] >= 0 && best[1] >= 0) return static_cast<double>(base) + (best[0] + best[1]) * 0.5;
+    if (best[0] >= 0) return static_cast<double>(base + best[0]);
+    if (best[1] >= 0) return static_cast<double>(base + best[1]);
+    return std::numeric_limits<double>::quiet_NaN();
+}
+
+double DepthAggregator::bestBid() const {
+    return best[0] >= 0 ? (base + best[0]) * tick : std::numeric_limits<double>::quiet_NaN();
+}
+
+double DepthAggregator::bestAsk() const {
+    return best[1] >= 0 ? (base + best[1]) * tick : std::numeric_limits<double>::quiet_NaN();
+}
+
+double DepthAggregator::midPrice() const {
+    return midTicks() * tick;
+}
+
+double DepthAggregator::depthAt(DepthSide side, double price) const {
+    int64_t i = std::llround(price * invTick) - base;
+    const std::vector<double>& l = ladder[static_cast<int>(side)];
+    return i >= 0 && i < static_cast<int64_t>(l.size()) ? l[i] : 0.0;
+}
+
+bool DepthAggregator::ensure(int64_t level, double price) {
+    int64_t size = static_cast<int64_t>(ladder[0].size());
+    if (level >= base && level < base + size) return true;
+    // мΪοΪʱԸü۸ΪοԶļλ
+    double mid = midTicks();
+    double ref = std::isnan(mid) ? price : mid * tick;
+    if (std::fabs(price - ref) > ref * options.ladderPercent / 100) return false;
+
+    // ȱһгȣ״Ϊ1024ݾ̯O(1)
+    int64_t slack = std::max<int64_t>(std::max<int64_t>(size, 1024), bucketTicks * 16);
+    int64_t lo = size ? base : level - slack / 2;
+    int64_t hi = size ? base + size : level + slack / 2;
+    if (level < lo) lo = level - slack;
+    if (level >= hi) hi = level + 1 + slack;
+    lo = std::max<int64_t>(0, lo) / bucketTicks * bucketTicks;
+    hi = (hi + bucketTicks - 1) / bucketTicks * bucketTicks;
+
+    int64_t shift = size ? base - lo : 0;
+    for (int s = 0; s < 2; ++s) {
+        std::vector<double> grown(hi - lo, 0.0);
+        std::copy(ladder[s].begin(), ladder[s].end(), grown.begin() + shift);
+        ladder[s].swap(grown);
+        std::vector<double> depth((hi - lo) / bucketTicks, 0.0);
+        std::copy(bucketDepth[s].begin(), bucketDepth[s].end(), depth.begin() + shift / bucketTicks);
+        bucketDepth[s].swap(depth);
+        std::vector<BucketStats> st((hi - lo) / bucketTicks, BucketStats{0, 0, 0.0});
+        std::copy(stats[s].begin(), stats[s].end(), st.begin() + shift / bucketTicks);
+        stats[s].swap(st);
+        if (best[s] >= 0) best[s] += shift;
+    }
+    base = lo;
+    return true;
+}
+
+void DepthAggregator::apply(int64_t time, DepthSide side, double price, double quantity) {
+    if (!(price > 0) || !std::isfinite(price)) throw std::invalid_argument("ȼ۸0");
+    if (!(quantity >= 0) || !std::isfinite(quantity)) throw std::invalid_argument("ҵΪ");
+    if (!started) {
+        started = true;
+        nextSample = time + options.sampleInterval;
+    } else if (time < lastTime) {
+        throw std::invalid_argument("ȸʱ");
+    } else if (time >= nextSample) {
+        advance(time);
+    }
+    lastTime = time;
+    updateCount++;
+
+    int64_t level = std::llround(price * invTick);
+    if (bucketTicks == 0) {
+        bucketTicks = std::max<int64_t>(1, std::llround(price * options.bucketPercent / 100 * invTick));
+    }
+    int64_t size = static_cast<int64_t>(ladder[0].size());
+    if (quantity == 0 && (level < base || level >= base + size)) return; // ڶڵļλ
+    if (!ensure(level, price)) return;
+
+    int s = static_cast<int>(side);
+    int64_t i = level - base;
+    double& slot = ladder[s][i];
+    bucketDepth[s][i / bucketTicks] += quantity - slot;
+    slot = quantity;
+
+    // żۣҵʱֱӱȽϣż۱ʱԶ̿ڵķһйҵĵλ
+    int64_t& top = best[s];
+    const std::vector<double>& l = ladder[s];
+    if (side == DepthSide::BID) {
+        if (quantity > 0) {
+            if (top < 0 || i > top) top = i;
+        } else if (i == top) {
+            while (top >= 0 && l[top] == 0) --top;
+        }
+    } else {
+        if (quantity > 0) {
+            if (top < 0 || i < top) top = i;
+        } else if (i == top) {
+            int64_t n = static_cast<int64_t>(l.size());
+            while (top < n && l[top] == 0) ++top;
+            if (top == n) top = -1;
+        }
+    }
+}
+
+void DepthAggregator::reset(int64_t time) {
+    if (started && time < lastTime) throw std::invalid_argument("ȸʱ");
+    if (!started) {
+        started = true;
+        nextSample = time + options.sampleInterval;
+    } else {
+        advance(time);
+    }
+    lastTime = time;
+    for (int s = 0; s < 2; ++s) {
+        std::fill(ladder[s].begin(), ladder[s].end(), 0.0);
+        std::fill(bucketDepth[s].begin(), bucketDepth[s].end(), 0.0);
+        best[s] = -1;
+    }
+}
+
+void DepthAggregator::advance(int64_t time) {
+    if (!started || time < nextSample) return;
+    // θ֮䶩䣬Ķʱ̺ϲΪһδȨ
+    int64_t k = (time - nextSample) / options.sampleInterval + 1;
+    sample(static_cast<uint64_t>(k));
+    nextSample += k * options.sampleInterval;
+}
+
+void DepthAggregator::sample(uint64_t weight) {
+    double mid = midTicks();
+    if (std::isnan(mid)) return;
+    totalSamples += weight;
+    int64_t size = static_cast<int64_t>(ladder[0].size());
+    double r = options.rangePercent / 100;
+    auto bucketOf = [&](double ticks) {
+        int64_t i = std::llround(ticks) - base;
+        return std::min(std::max<int64_t>(i, 0), size - 1) / bucketTicks;
+    };
+    int64_t lo = bucketOf(mid * (1 - r));
+    int64_t hi = bucketOf(mid * (1 + r));
+    for (int s = 0; s < 2; ++s) {
+        if (best[s] < 0) continue;
+        // ̿Χصۣ̿۵Χ
+        int64_t from = s == 0 ? lo : best[1] / bucketTicks;
+        int64_t to = s == 0 ? best[0] / bucketTicks : hi;
+        if (from > to) continue;
+        const double* depth = bucketDepth[s].data();
+        // ƽֵֻйҵķ䣬ϡĶͨҵΪյɹҵǽ
+        double sum = 0;
+        int64_t filled = 0;
+        for (int64_t b = from; b <= to; ++b) {
+            sum += depth[b];
+            filled += depth[b] > 0;
+        }
+        if (filled == 0 || !(sum > 0)) continue;
+        double mean = sum / static_cast<double>(filled);
+        double threshold = options.wallMultiple * mean;
+        BucketStats* st = stats[s].data();
+        for (int64_t b = from; b <= to; ++b) {
+            st[b].inRange += weight;
+            if (depth[b] >= threshold) {
+                st[b].wall += weight;
+                st[b].wallDepth += depth[b] * static_cast<double>(weight);
+            }
+        }
+    }
+}
+
+std::vector<DepthWall> DepthAggregator::walls() const {
+    std::vector<DepthWall> out;
+    if (totalSamples == 0) return out;
+    double total = static_cast<double>(totalSamples);
+    for (int s = 0; s < 2; ++s) {
+        const std::vector<BucketStats>& st = stats[s];
+        auto qualifies = [&](size_t b) {
+            const BucketStats& x = st[b];
+            return x.wall > 0 && x.inRange >= options.minPresence * total &&
+                   x.wall >= options.minPersistence * static_cast<double>(x.inRange);
+        };
+        size_t b = 0;
+        while (b < st.size()) {
+            if (!qualifies(b)) {
+                ++b;
+                continue;
+            }
+            DepthWall w{};
+            w.side = static_cast<DepthSide>(s);
+            w.low = (base + static_cast<int64_t>(b) * bucketTicks) * tick;
+            double depthSum = 0, wallSum = 0, centerSum = 0;
+            for (; b < st.size() && qualifies(b); ++b) {
+                const BucketStats& x = st[b];
+                double center = (base + static_cast<int64_t>(b) * bucketTicks + (bucketTicks - 1) * 0.5) * tick;
+                depthSum += x.wallDepth;
+                wallSum += static_cast<double>(x.wall);
+                centerSum += center * x.wallDepth;
+                w.persistence = std::max(w.persistence, static_cast<double>(x.wall) / static_cast<double>(x.inRange));
+                w.samples = std::max(w.samples, x.wall);
+                w.high = (base + static_cast<int64_t>(b + 1) * bucketTicks - 1) * tick;
+            }
+            w.price = depthSum > 0 ? centerSum / depthSum : (w.low + w.high) / 2;
+            w.averageDepth = depthSum / wallSum;
+            w.strength = depthSum / total;
+            out.push_back(w);
+        }
+    }
+    std::stable_sort(out.begin(), out.end(), [](const DepthWall& a, const DepthWall& b) { return a.strength > b.strength; });
+    if (options.maxWalls > 0 && out.size() > options.maxWalls) out.resize(options.maxWalls);
+    return out;
+}
+
+std::vector<SymbolDepth> loadDepthFile(const std::string& path, const ContractTable& contracts, const DepthOptions& opt) {
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) throw std::invalid_argument("޷ļ" + path);
+    std::vector<SymbolDepth> out;
+    std::unordered_map<std::string, size_t> ids;
+    std::string lastSymbol; // һеƷԭģļͨͬһƷУʡȥͳһдϣ
+    size_t lastId = 0;
+    int64_t lastTime = 0;
+    char line[512];
+    int lineNo = 0;
+    auto fail = [&](const std::string& what) {
+        throw std::invalid_argument("ļ" + std::to_string(lineNo) + "" + what);
+    };
+    try {
+        while (std::fgets(line, sizeof(line), file)) {
+            lineNo++;
+            if (line[0] == '#' || line[0] == '\n' || line[0] == '\r') continue;
+            const char* comma = std::strchr(line, ',');
+            if (!comma) fail("ȱٶŷָ");
+            char* end = nullptr;
+            int64_t time = std::strtoll(comma + 1, &end, 10);
+            if (end == comma + 1) {
+                if (lineNo == 1) continue; // ͷ
+                fail("ʱʽ");
+            }
+            if (*end != ',') fail("ֶβ");
+            const char* side = end + 1;
+            size_t sideLen = std::strcspn(side, ",\r\n");
+
+            size_t symbolLen = static_cast<size_t>(comma - line);
+            if (out.empty() || lastSymbol.size() != symbolLen || std::memcmp(lastSymbol.data(), line, symbolLen) != 0) {
+                lastSymbol.assign(line, symbolLen);
+                std::string key = normalizeSymbol(lastSymbol);
+                auto it = ids.find(key);
+                if (it == ids.end()) {
+                    const ContractSpec* spec = contracts.lookup(key);
+                    if (!spec) fail("Ʒ" + key + "ںԼУ޷ȷС۸䶯");
+                    it = ids.emplace(key, out.size()).first;
+                    out.push_back(SymbolDepth{key, DepthAggregator(spec->tickSize, opt)});
+                }
+                lastId = it->second;
+            }
+            DepthAggregator& depth = out[lastId].depth;
+            lastTime = std::max(lastTime, time);
+
+            DepthSide s;
+            if ((sideLen == 3 && std::memcmp(side, "bid", 3) == 0) || (sideLen == 1 && side[0] == 'b')) {
+                s = DepthSide::BID;
+            } else if ((sideLen == 3 && std::memcmp(side, "ask", 3) == 0) || (sideLen == 1 && side[0] == 'a')) {
+                s = DepthSide::ASK;
+            } else if (sideLen == 5 && std::memcmp(side, "reset", 5) == 0) {
+                try {
+                    depth.reset(time);
+                } catch (const std::invalid_argument& e) {
+                    fail(std::string("") + e.what());
+                }
+                continue;
+            } else {
+                fail("Ϊbid/ask/reset");
+            }
+            if (side[sideLen] != ',') fail("ֶβ");
+            const char* p = side + sideLen + 1;
+            double price = std::strtod(p, &end);
+            if (end == p || *end != ',') fail("۸ʽ");
+            p = end + 1;
+            double quantity = std::strtod(p, &end);
+            if (end == p) fail("ҵʽ");
+            try {
+                depth.apply(time, s, price, quantity);
+            } catch (const std::invalid_argument& e) {
+                fail(std::string("") + e.what());
+            }
+        }
+    } catch (...) {
+        std::fclose(file);
+        throw;
+    }
+    std::fclose(file);
+    // Ʒֶ״̬뵽ļʱ
+    for (auto& d : out) d.depth.advance(lastTime);
+    return out;
+}
+
+const SymbolDepth* findDepth(const std::vector<SymbolDepth>& depths, const std::string& symbol) {
+    std::string key = normalizeSymbol(symbol);
+    for (const auto& d : depths) {
+        if (d.symbol == key) return &d;
+    }
+    return nullptr;
+}
+
+std::vector<DepthLevel> mergeDepthLevels(const std::vector<LevelCandidate>& candidates,
+                                         const std::vector<DepthWall>& walls, double tolerance) {
+    std::vector<DepthLevel> out;
+    std::vector<char> matched(walls.size(), 0);
+    for (const auto& c : candidates) {
+        int wall = -1;
+        for (size_t w = 0; w < walls.size(); ++w) {
+            if (c.price < walls[w].low * (1 - tolerance) || c.price > walls[w].high * (1 + tolerance)) continue;
+            if (wall < 0 || walls[w].strength > walls[wall].strength) wall = static_cast<int>(w);
+        }
+        if (wall >= 0) matched[wall] = 1;
+        out.push_back(DepthLevel{c.price, c.source, wall, wall >= 0 ? walls[wall].strength : 0.0});
+    }
+    for (size_t w = 0; w < walls.size(); ++w) {
+        if (!matched[w]) out.push_back(DepthLevel{walls[w].price, LevelSource::DEPTH_WALL, static_cast<int>(w), walls[w].strength});
+    }
+    std::stable_sort(out.begin(), out.end(), [](const DepthLevel& a, const DepthLevel& b) {
+        if ((a.wall >= 0) != (b.wall >= 0)) return a.wall >= 0;
+        if (a.wall >= 0) return a.strength > b.strength;
+        return a.price < b.price;
+    });
+    return out;
+}
+
+}  // namespace tradecheck
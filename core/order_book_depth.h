@@ -0,0 +1,134 @@
+#pragma once
+
+#include "contract_registry.h"
+#include "level_strength.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tradecheck {
+
+// ֧KֻOHLCV̿ڵԣL2ȸά
+// ʱۼƸ۸ĹҵʱԸͬ฽ƽҵķ伴ҵǽ
+// ǽΪ֧šǽΪ/ܼɽKļλպϲ
+
+// ļʽCSVÿһλ£ɴͷ#ͷΪעͣ
+// symbol,time,side,price,quantity
+// timeΪʱͬһƷְʱǵݼsideΪbid/askb/aquantityΪüλºĹҵ0ʾգ
+// sideΪresetʱոƷֶȫļÿοǰдһresetprice/quantityգ
+
+enum class DepthSide : uint8_t {
+    BID = 0,  // ̣֧ţ
+    ASK = 1   // ̣
+};
+
+const char* depthSideName(DepthSide side);
+
+struct DepthOptions {
+    double bucketPercent = 0.05;   // ۸ȣ׸۸İٷֱȣȡС۸䶯
+    double rangePercent = 3;       // ʱֻм¸ðٷֱڵķ
+    double ladderPercent = 30;     // ֻΪм¸ðٷֱڵ¼λݣԶļλ
+    int64_t sampleInterval = 1000; // 룩
+    double wallMultiple = 3;       // ҵﵽͬ෶ΧйҵƽֵıΪҵǽ
+    double minPersistence = 0.3;   // 䴦ڷΧڵĲΪҵǽı
+    double minPresence = 0.1;      // 䴦ڷΧڵĲռȫı
+    size_t maxWalls = 10;          // ǿȱĹҵǽ0ʾޣ
+};
+
+// ڵĹҵǽϲΪһ۸
+struct DepthWall {
+    DepthSide side;
+    double low;           // 
+    double high;          // 
+    double price;         // ҵȨķļ
+    double persistence;   // ڷ䴦ڷΧʱΪҵǽ߱
+    double averageDepth;  // Ϊҵǽʱƽҵ
+    double strength;      // ΪҵǽʱĹҵ֮ / ȫʱƽǽҵ
+    uint64_t samples;     // ڷΪҵǽ
+};
+
+// һƷֵĶۼ
+// С۸䶯չ飨±꼴۸λÿθO(1)ͬά䵱ǰҵ
+// ֻɨм۸ķ䣬붩λ޹
+class DepthAggregator {
+public:
+    // tickSizeʱ׳invalid_argument
+    explicit DepthAggregator(double tickSize, const DepthOptions& opt = DepthOptions());
+
+    // ʱˡ۸Ϊ/ֵʱ׳invalid_argument
+    void apply(int64_t time, DepthSide side, double price, double quantity);
+    // նȫ֮ǰãtime֮ǰĲǰĶ
+    void reset(int64_t time);
+    // time֮ǰĲݽʱ״̬뵽timeΪֹ
+    void advance(int64_t time);
+
+    // ʱΪNaN
+    double bestBid() const;
+    double bestAsk() const;
+    double midPrice() const;
+    double depthAt(DepthSide side, double price) const;
+
+    uint64_t updates() const { return updateCount; }
+    uint64_t samples() const { return totalSamples; }
+    double tickSize() const { return tick; }
+    double bucketWidth() const { return static_cast<double>(bucketTicks) * tick; }
+
+    // ǿȽĹҵǽ
+    std::vector<DepthWall> walls() const;
+
+private:
+    struct BucketStats {
+        uint64_t inRange;  // ڷΧڵĲ
+        uint64_t wall;     // ΪҵǽĲ
+        double wallDepth;  // Ϊҵǽʱҵ֮
+    };
+
+    DepthOptions options;
+    double tick;
+    double invTick;
+    int64_t bucketTicks = 0;            // ÿĵλ״θʱȷ
+    int64_t base = 0;                   // ladder[0]ļ۸λbucketTicks
+    std::vector<double> ladder[2];      // λҵ
+    std::vector<double> bucketDepth[2]; // 䵱ǰҵ
+    std::vector<BucketStats> stats[2];
+    int64_t best[2] = {-1, -1};         // /۵±꣬-1ʾòΪ
+    bool started = false;
+    int64_t lastTime = 0;
+    int64_t nextSample = 0;
+    uint64_t updateCount = 0;
+    uint64_t totalSamples = 0;
+
+    // ֤۸λڣݷΧʱfalse
+    bool ensure(int64_t level, double price);
+    void sample(uint64_t weight);
+    double midTicks() const;
+};
+
+// һƷֵۼƽ
+struct SymbolDepth {
+    std::string symbol; // ͳһдnormalizeSymbol
+    DepthAggregator depth;
+};
+
+// ȡļƷְԼеС۸䶯չԼûеƷ׳invalid_argument
+std::vector<SymbolDepth> loadDepthFile(const std::string& path, const ContractTable& contracts,
+                                       const DepthOptions& opt = DepthOptions());
+
+// Ʒͳһд󣩲ңʱnullptr
+const SymbolDepth* findDepth(const std::vector<SymbolDepth>& depths, const std::string& symbol);
+
+// K߼λҵǽϲĽ
+struct DepthLevel {
+    double price;
+    LevelSource source; // K߼λԴûжӦK߼λĹҵǽΪDEPTH_WALL
+    int wall;           // Ӧҵǽwallsе±꣬-1ʾûйҵǽ
+    double strength;    // ӦҵǽǿȣûʱΪ0
+};
+
+// K߼λcollectLevelCandidatesĽڹҵǽtoleranceڼΪҵȷϣ
+// ûжӦκK߼λĹҵǽгйҵǽİǿȽǰఴ۸ں
+std::vector<DepthLevel> mergeDepthLevels(const std::vector<LevelCandidate>& candidates,
+                                         const std::vector<DepthWall>& walls, double tolerance);
+
+}  // namespace tradecheck
@@ -0,0 +1,216 @@
+#pragma once
+
+#include "record_writer.h"
+#include "crypto_risk.h"
+#include "support_resistance.h"
+#include "consistency_score.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tradecheck {
+
+// ǰ˵Ľṹ¼ƸʽֱӰֽдNDJSONֶԱһ£
+
+inline const char* directionName(TradeDirection dir) {
+    return dir == TradeDirection::LONG ? "LONG" : "SHORT";
+}
+
+inline const char* riskLevelName(RiskLevel level) {
+    switch (level) {
+        case RiskLevel::SAFE: return "SAFE";
+        case RiskLevel::WARNING: return "WARNING";
+        case RiskLevel::EXCEEDED: return "EXCEEDED";
+        default: return "NONE";
+    }
+}
+
+// ǿƽ/֤
+struct RiskRecord {
+    char symbol[16];
+    uint8_t direction;  // 0= 1=
+    uint8_t riskLevel;  // RiskLevel
+    uint8_t contractType; // ContractType¼汾2𣻴ǰΪֽڣΪ0USDTλ
+    uint8_t reserved[5];
+    double leverage;
+    double positionRatio;
+    double entryPrice;
+    double totalCapital;
+    double threshold;
+    double riskCoefficient;
+    double initialMargin;
+    double maintenanceMargin;
+    double marginToAdd;
+    double liquidationPrice;
+};
+static_assert(sizeof(RiskRecord) == 104, "RiskRecordѱ仯");
+
+inline RiskRecord makeRiskRecord(const CryptoRiskCalculator& calc) {
+    RiskRecord r{};
+    copyRecordSymbol(r.symbol, calc.getContract().symbol);
+    r.direction = calc.getDirection() == TradeDirection::LONG ? 0 : 1;
+    r.riskLevel = static_cast<uint8_t>(calc.classifyRiskLevel());
+    r.contractType = static_cast<uint8_t>(calc.getContract().type);
+    r.leverage = calc.getLeverage();
+    r.positionRatio = calc.getPositionRatio();
+    r.entryPrice = calc.getEntryPrice();
+    r.totalCapital = calc.getTotalCapital();
+    r.threshold = calc.getThreshold();
+    r.riskCoefficient = calc.calculateRiskCoefficient();
+    r.initialMargin = calc.getInitialMargin();
+    r.maintenanceMargin = calc.getMaintenanceMargin();
+    r.marginToAdd = calc.calculateMarginToAdd();
+    r.liquidationPrice = calc.calculateLiquidationPrice();
+    return r;
+}
+
+inline void writeRiskJson(JsonLineWriter& json, const RiskRecord& r) {
+    json.begin();
+    json.string("symbol", r.symbol)
+        .string("direction", r.direction == 0 ? "LONG" : "SHORT")
+        .string("contractType", contractTypeName(static_cast<ContractType>(r.contractType)))
+        .number("leverage", r.leverage)
+        .number("positionRatio", r.positionRatio)
+        .number("entryPrice", r.entryPrice)
+        .number("totalCapital", r.totalCapital)
+        .number("threshold", r.threshold)
+        .number("riskCoefficient", r.riskCoefficient)
+        .string("riskLevel", riskLevelName(static_cast<RiskLevel>(r.riskLevel)))
+        .number("initialMargin", r.initialMargin)
+        .number("maintenanceMargin", r.maintenanceMargin)
+        .number("marginToAdd", r.marginToAdd)
+        .number("liquidationPrice", r.liquidationPrice);
+    json.end();
+}
+
+// ֧λopenTimeΪһKߵĿʱ䣬ʱΪ0
+struct LevelsRecord {
+    char symbol[16];
+    int64_t openTime;
+    uint8_t timeframe;  // 0= 1=4Сʱ
+    uint8_t reserved[3];
+    int32_t klineCount;
+    double highestHigh;
+    double lowestLow;
+    double pivotPoint;
+    double s1, s2, s3;
+    double r1, r2, r3;
+    double denseSupport;
+    double denseResist;
+};
+static_assert(sizeof(LevelsRecord) == 120, "LevelsRecordѱ仯");
+
+inline LevelsRecord makeLevelsRecord(const std::string& symbol, int64_t openTime, TimeFrame tf,
+                                     const SupportResistanceLevels& l) {
+    LevelsRecord r{};
+    copyRecordSymbol(r.symbol, symbol);
+    r.openTime = openTime;
+    r.timeframe = tf == TimeFrame::DAILY ? 0 : 1;
+    r.klineCount = l.klineCount;
+    r.highestHigh = l.highestHigh;
+    r.lowestLow = l.lowestLow;
+    r.pivotPoint = l.pivotPoint;
+    r.s1 = l.s1;
+    r.s2 = l.s2;
+    r.s3 = l.s3;
+    r.r1 = l.r1;
+    r.r2 = l.r2;
+    r.r3 = l.r3;
+    r.denseSupport = l.denseSupport;
+    r.denseResist = l.denseResist;
+    return r;
+}
+
+inline void writeLevelsJson(JsonLineWriter& json, const LevelsRecord& r) {
+    json.begin();
+    json.string("symbol", r.symbol)
+        .integer("openTime", r.openTime)
+        .string("timeframe", r.timeframe == 0 ? "DAILY" : "FOUR_HOUR")
+        .integer("klineCount", r.klineCount)
+        .number("highestHigh", r.highestHigh)
+        .number("lowestLow", r.lowestLow)
+        .number("pivotPoint", r.pivotPoint)
+        .number("s1", r.s1)
+        .number("s2", r.s2)
+        .number("s3", r.s3)
+        .number("r1", r.r1)
+        .number("r2", r.r2)
+        .number("r3", r.r3)
+        .number("denseSupport", r.denseSupport)
+        .number("denseResist", r.denseResist);
+    json.end();
+}
+
+// ߼ۺ֣ìܵıֻNDJSONУֻ
+struct ScoreRecord {
+    char symbol[16];
+    uint8_t openDir;        // 0= 1=
+    uint8_t highLeverRisk;  // ֹܸǷ񳬹
+    uint8_t reserved[2];
+    int32_t leverage;
+    double openPrice;
+    double liquidPrice;
+    double stopLoss;
+    double stopLossRate;
+    double leverStopLossRisk;
+    int32_t emaScore;
+    int32_t kstScore;
+    int32_t baseStopLossScore;
+    int32_t leverStopLossScore;
+    int32_t dirMatchScore;
+    int32_t totalScore;
+    int32_t contradictionCount;
+    int32_t reserved2;
+};
+static_assert(sizeof(ScoreRecord) == 96, "ScoreRecordѱ仯");
+
+inline ScoreRecord makeScoreRecord(const TradeAnalysis& ta, size_t contradictionCount) {
+    ScoreRecord r{};
+    copyRecordSymbol(r.symbol, ta.coinType);
+    r.openDir = ta.openDir == "" ? 0 : 1;
+    r.leverage = ta.leverage;
+    r.openPrice = ta.openPrice;
+    r.liquidPrice = ta.liquidPrice;
+    r.stopLoss = ta.stopLoss;
+    r.stopLossRate = ta.stopLossRate;
+    r.leverStopLossRisk = ta.leverStopLossRisk;
+    r.emaScore = calculateEMAConsistency(ta.emaList);
+    r.kstScore = calculateKSTConsistency(ta.kstList);
+    r.baseStopLossScore = calculateBaseStopLossScore(ta);
+    bool highRisk = false;
+    r.leverStopLossScore = calculateLeverStopLossScore(ta, highRisk);
+    r.highLeverRisk = highRisk ? 1 : 0;
+    r.dirMatchScore = calculateDirTrendMatchScore(ta);
+    r.totalScore = calculateTotalConsistency(ta, highRisk);
+    r.contradictionCount = static_cast<int32_t>(contradictionCount);
+    return r;
+}
+
+inline ScoreRecord makeScoreRecord(const TradeAnalysis& ta, const std::vector<std::string>& contradictions) {
+    return makeScoreRecord(ta, contradictions.size());
+}
+
+inline void writeScoreJson(JsonLineWriter& json, const ScoreRecord& r, const std::vector<std::string>& contradictions) {
+    json.begin();
+    json.string("symbol", r.symbol)
+        .string("openDir", r.openDir == 0 ? "LONG" : "SHORT")
+        .integer("leverage", r.leverage)
+        .number("openPrice", r.openPrice)
+        .number("liquidPrice", r.liquidPrice)
+        .number("stopLoss", r.stopLoss)
+        .number("stopLossRate", r.stopLossRate)
+        .number("leverStopLossRisk", r.leverStopLossRisk)
+        .integer("emaScore", r.emaScore)
+        .integer("kstScore", r.kstScore)
+        .integer("baseStopLossScore", r.baseStopLossScore)
+        .integer("leverStopLossScore", r.leverStopLossScore)
+        .integer("dirMatchScore", r.dirMatchScore)
+        .integer("totalScore", r.totalScore)
+        .boolean("highLeverRisk", r.highLeverRisk != 0);
+    json.beginArray("contradictions");
+    for (const auto& c : contradictions) json.element(c);
+    json.endArray();
+    json.end();
+}
+
+}  // namespace tradecheck
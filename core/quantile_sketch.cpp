@@ -0,0 +1,168 @@
+#include "quantile_sketch.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+
+namespace tradecheck {
+
+namespace {
+
+const double PI = 3.14159265358979323846;
+
+bool byMean(const TDigestCentroid& a, const TDigestCentroid& b) {
+    return a.mean < b.mean;
+}
+
+}  // namespace
+
+void TDigest::reset(double c) {
+    if (!(c >= 10 && c <= TDIGEST_MAX_COMPRESSION)) throw std::invalid_argument("t-digestѹ10~100֮");
+    compression = c;
+    totalWeight = 0;
+    minValue = std::numeric_limits<double>::infinity();
+    maxValue = -std::numeric_limits<double>::infinity();
+    centroidCount = 0;
+    bufferCount = 0;
+}
+
+void TDigest::add(double value, double weight) {
+    if (!std::isfinite(value) || !(weight > 0) || !std::isfinite(weight)) return;
+    if (bufferCount == TDIGEST_BUFFER) flush();
+    buffer[bufferCount++] = {value, weight};
+    totalWeight += weight;
+    minValue = std::min(minValue, value);
+    maxValue = std::max(maxValue, value);
+}
+
+void TDigest::merge(const TDigest& other) {
+    for (int i = 0; i < other.centroidCount; ++i) add(other.centroids[i].mean, other.centroids[i].weight);
+    for (int i = 0; i < other.bufferCount; ++i) add(other.buffer[i].mean, other.buffer[i].weight);
+    // ľֵڼֵ֮ڣֵ赥ϲ
+    if (!other.empty()) {
+        minValue = std::min(minValue, other.minValue);
+        maxValue = std::max(maxValue, other.maxValue);
+    }
+}
+
+void TDigest::flush() {
+    if (bufferCount == 0) return;
+    std::sort(buffer, buffer + bufferCount, byMean);
+    TDigestCentroid merged[TDIGEST_CAPACITY + TDIGEST_BUFFER];
+    int n = static_cast<int>(std::merge(centroids, centroids + centroidCount, buffer, buffer + bufferCount, merged, byMean) -
+                             merged);
+
+    // k1(q) = /(2)asin(2q-1)ÿĸǵkֵȲ1
+    double normalizer = compression / (2 * PI);
+    double kMax = compression / 4;
+    auto limitAfter = [&](double soFar) {
+        double k = normalizer * std::asin(2 * std::min(1.0, soFar / totalWeight) - 1) + 1;
+        if (k >= kMax) return totalWeight;
+        return (std::sin(k / normalizer) + 1) / 2 * totalWeight;
+    };
+    int out = 0;
+    TDigestCentroid current = merged[0];
+    double soFar = 0;
+    double limit = limitAfter(0);
+    for (int i = 1; i < n; ++i) {
+        const TDigestCentroid& x = merged[i];
+        // ֻһʱǿƲ루뵼µļ֤Խ
+        if (soFar + current.weight + x.weight <= limit || out == TDIGEST_CAPACITY - 1) {
+            current.weight += x.weight;
+            current.mean += (x.mean - current.mean) * x.weight / current.weight;
+        } else {
+            centroids[out++] = current;
+            soFar += current.weight;
+            limit = limitAfter(soFar);
+            current = x;
+        }
+    }
+    centroids[out++] = current;
+    centroidCount = out;
+    bufferCount = 0;
+}
+
+double TDigest::quantile(double q) const {
+    if (bufferCount == 0) return quantileFlushed(q);
+    TDigest copy = *this;
+    copy.flush();
+    return copy.quantileFlushed(q);
+}
+
+// ֮䰴ۼȨԲֵ˲ֵС/ֵ
+double TDigest::quantileFlushed(double q) const {
+    if (empty()) return std::numeric_limits<double>::quiet_NaN();
+    if (centroidCount == 1) return centroids[0].mean;
+    double index = std::min(std::max(q, 0.0), 1.0) * totalWeight;
+    const TDigestCentroid& first = centroids[0];
+    if (index < first.weight / 2) return minValue + (first.mean - minValue) * index / (first.weight / 2);
+    double soFar = first.weight / 2;
+    for (int i = 0; i + 1 < centroidCount; ++i) {
+        double step = (centroids[i].weight + centroids[i + 1].weight) / 2;
+        if (soFar + step > index) {
+            double z = (index - soFar) / step;
+            return centroids[i].mean + z * (centroids[i + 1].mean - centroids[i].mean);
+        }
+        soFar += step;
+    }
+    const TDigestCentroid& last = centroids[centroidCount - 1];
+    double z = std::min(1.0, (index - soFar) / (last.weight / 2));
+    return last.mean + (maxValue - last.mean) * z;
+}
+
+void StreamingQuantileBands::reset(double compression) {
+    price.reset(compression);
+    volumePrice.reset(compression);
+    bars = 0;
+}
+
+void StreamingQuantileBands::update(const KlineData& kd) {
+    if (kd.high < kd.low) throw std::invalid_argument("߼۵ͼ۵ЧK");
+    double typical = (kd.high + kd.low + kd.close) / 3.0;
+    price.add(typical);
+    volumePrice.add(typical, kd.volume);
+    bars++;
+}
+
+void StreamingQuantileBands::merge(const StreamingQuantileBands& other) {
+    price.merge(other.price);
+    volumePrice.merge(other.volumePrice);
+    bars += other.bars;
+}
+
+QuantileBands StreamingQuantileBands::bands() const {
+    TDigest p = price, v = volumePrice;
+    p.flush();
+    v.flush();
+    QuantileBands b;
+    for (int i = 0; i < 3; ++i) {
+        b.price[i] = p.quantile(QUANTILE_BAND_LEVELS[i]);
+        b.volumePrice[i] = v.quantile(QUANTILE_BAND_LEVELS[i]);
+    }
+    b.bars = bars;
+    return b;
+}
+
+QuantileBands computeQuantileBands(const KlineData* klines, size_t count, unsigned threads, double compression) {
+    unsigned threadCount = threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+    if (threadCount > count) threadCount = static_cast<unsigned>(std::max<size_t>(count, 1));
+    std::vector<StreamingQuantileBands> shards(threadCount);
+    for (auto& s : shards) s.reset(compression);
+    for (size_t i = 0; i < count; ++i) {
+        if (klines[i].high < klines[i].low) throw std::invalid_argument("߼۵ͼ۵ЧK");
+    }
+    auto worker = [&](unsigned t) {
+        size_t begin = count * t / threadCount;
+        size_t end = count * (t + 1) / threadCount;
+        for (size_t i = begin; i < end; ++i) shards[t].update(klines[i]);
+    };
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threadCount; ++t) pool.emplace_back(worker, t);
+    worker(0);
+    for (auto& th : pool) th.join();
+    for (unsigned t = 1; t < threadCount; ++t) shards[0].merge(shards[t]);
+    return shards[0].bands();
+}
+
+}  // namespace tradecheck
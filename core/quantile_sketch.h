@@ -0,0 +1,80 @@
+#pragma once
+
+#include "support_resistance.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace tradecheck {
+
+// ɺϲķλͼϲʽt-digestPOD״ֱ̬Ӱֽڱ/ָ
+// ֵȽʱİk1߶Ⱥңϲ
+// ˵СмĴβλ׼ѹ+1
+// ͼϲֻѶԷĵȨֵ룬˿ɰʱƬ/̷߳Ƭֱͳƺϲ
+// ҲɰСڵĲͼϲɴڵ
+
+const int TDIGEST_MAX_COMPRESSION = 100;
+const int TDIGEST_CAPACITY = TDIGEST_MAX_COMPRESSION + 4; // ϲ
+const int TDIGEST_BUFFER = 152;                           // ϲ
+
+struct TDigestCentroid {
+    double mean;
+    double weight;
+};
+
+struct TDigest {
+    double compression;     // ѹԽԽ׼Խࣩ
+    double totalWeight;     // ȫֵȨ֮ͣ
+    double minValue;
+    double maxValue;
+    int centroidCount;
+    int bufferCount;
+    TDigestCentroid centroids[TDIGEST_CAPACITY]; // ֵ
+    TDigestCentroid buffer[TDIGEST_BUFFER];
+
+    void reset(double compression = TDIGEST_MAX_COMPRESSION);
+
+    // һȨֵֵȨء0ʱԣ
+    void add(double value, double weight = 1.0);
+
+    // ϲһͼѹԲͬͼĲϲ
+    void merge(const TDigest& other);
+
+    // ѻģѯǰÿɱÿβѯʱϲ
+    void flush();
+
+    bool empty() const { return totalWeight <= 0; }
+
+    // qλ0~1ղͼNaN
+    double quantile(double q) const;
+
+private:
+    double quantileFlushed(double q) const;
+};
+
+// ۸λĬȡ20/50/80λ
+const double QUANTILE_BAND_LEVELS[3] = {0.2, 0.5, 0.8};
+
+struct QuantileBands {
+    double price[3];         // ͼۣ(++)/3ķλÿKȨͬ
+    double volumePrice[3];   // ɽȨĵͼ۷λ
+    uint64_t bars;
+};
+
+// ÿƷͼԼ8KBÿKO(1)̯
+struct StreamingQuantileBands {
+    TDigest price;
+    TDigest volumePrice;
+    uint64_t bars;
+
+    void reset(double compression = TDIGEST_MAX_COMPRESSION);
+    void update(const KlineData& kd);
+    void merge(const StreamingQuantileBands& other);
+    QuantileBands bands() const;
+};
+
+// һKߵķλ߳гƬͳƺϲthreadsΪ0ʱCPU
+QuantileBands computeQuantileBands(const KlineData* klines, size_t count, unsigned threads = 0,
+                                   double compression = TDIGEST_MAX_COMPRESSION);
+
+}  // namespace tradecheck
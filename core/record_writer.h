@@ -0,0 +1,237 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace tradecheck {
+
+// ʽı / ÿһJSONNDJSON / Ƽ¼
+enum class OutputFormat {
+    TEXT,
+    NDJSON,
+    BINARY
+};
+
+inline OutputFormat parseOutputFormat(const std::string& name) {
+    if (name == "text") return OutputFormat::TEXT;
+    if (name == "ndjson" || name == "json") return OutputFormat::NDJSON;
+    if (name == "binary" || name == "bin") return OutputFormat::BINARY;
+    throw std::invalid_argument("δ֪ʽ" + name + "ѡtext/ndjson/binary");
+}
+
+// ̶дʱдд·ѷ
+class BufferedWriter {
+public:
+    static const size_t BUFFER_SIZE = 64 * 1024;
+
+    explicit BufferedWriter(FILE* f) : file(f), owned(false) {}
+
+    // "-"ʾ׼
+    explicit BufferedWriter(const std::string& path) : file(stdout), owned(false) {
+        if (path != "-") {
+            file = std::fopen(path.c_str(), "wb");
+            if (!file) throw std::invalid_argument("޷дļ" + path);
+            owned = true;
+        }
+    }
+
+    ~BufferedWriter() {
+        std::fwrite(buffer, 1, used, file);
+        if (owned) std::fclose(file);
+        else std::fflush(file);
+    }
+
+    BufferedWriter(const BufferedWriter&) = delete;
+    BufferedWriter& operator=(const BufferedWriter&) = delete;
+
+    // ֤nֽռ䣨nСдλãдcommit
+    char* reserve(size_t n) {
+        if (BUFFER_SIZE - used < n) flush();
+        return buffer + used;
+    }
+    void commit(size_t n) { used += n; }
+
+    void put(char c) {
+        if (used == BUFFER_SIZE) flush();
+        buffer[used++] = c;
+    }
+
+    void write(const void* data, size_t n) {
+        const char* p = static_cast<const char*>(data);
+        while (n > 0) {
+            if (used == BUFFER_SIZE) flush();
+            size_t chunk = std::min(n, BUFFER_SIZE - used);
+            std::memcpy(buffer + used, p, chunk);
+            used += chunk;
+            p += chunk;
+            n -= chunk;
+        }
+    }
+
+    void write(const char* text) { write(text, std::strlen(text)); }
+
+    void flush() {
+        if (used > 0 && std::fwrite(buffer, 1, used, file) != used) {
+            throw std::runtime_error("дʧ");
+        }
+        used = 0;
+    }
+
+private:
+    FILE* file;
+    bool owned;
+    size_t used = 0;
+    char buffer[BUFFER_SIZE];
+};
+
+// NDJSONдֵto_charsʾֵдΪnull
+class JsonLineWriter {
+public:
+    explicit JsonLineWriter(BufferedWriter& w) : out(w) {}
+
+    void begin() {
+        out.put('{');
+        first = true;
+    }
+    void end() {
+        out.put('}');
+        out.put('\n');
+    }
+
+    JsonLineWriter& number(const char* name, double value) {
+        key(name);
+        if (!std::isfinite(value)) {
+            out.write("null", 4);
+            return *this;
+        }
+        char* p = out.reserve(32);
+        out.commit(std::to_chars(p, p + 32, value).ptr - p);
+        return *this;
+    }
+
+    JsonLineWriter& integer(const char* name, int64_t value) {
+        key(name);
+        char* p = out.reserve(24);
+        out.commit(std::to_chars(p, p + 24, value).ptr - p);
+        return *this;
+    }
+
+    JsonLineWriter& boolean(const char* name, bool value) {
+        key(name);
+        if (value) out.write("true", 4);
+        else out.write("false", 5);
+        return *this;
+    }
+
+    JsonLineWriter& string(const char* name, const char* value, size_t length) {
+        key(name);
+        quoted(value, length);
+        return *this;
+    }
+    JsonLineWriter& string(const char* name, const char* value) { return string(name, value, std::strlen(value)); }
+    JsonLineWriter& string(const char* name, const std::string& value) { return string(name, value.data(), value.size()); }
+
+    // 飨ֵַԪأ
+    void beginArray(const char* name) {
+        key(name);
+        out.put('[');
+        first = true;
+    }
+    void element(const char* value, size_t length) {
+        if (!first) out.put(',');
+        first = false;
+        quoted(value, length);
+    }
+    void element(const std::string& value) { element(value.data(), value.size()); }
+    void element(double value) {
+        if (!first) out.put(',');
+        first = false;
+        if (!std::isfinite(value)) {
+            out.write("null", 4);
+            return;
+        }
+        char* p = out.reserve(32);
+        out.commit(std::to_chars(p, p + 32, value).ptr - p);
+    }
+    void endArray() {
+        out.put(']');
+        first = false;
+    }
+
+private:
+    BufferedWriter& out;
+    bool first = true;
+
+    void key(const char* name) {
+        if (!first) out.put(',');
+        first = false;
+        out.put('"');
+        out.write(name);
+        out.put('"');
+        out.put(':');
+    }
+
+    // תšбܺͿַUTF-8ֽԭд
+    void quoted(const char* s, size_t n) {
+        static const char HEX[] = "0123456789abcdef";
+        out.put('"');
+        size_t start = 0;
+        for (size_t i = 0; i < n; ++i) {
+            unsigned char c = static_cast<unsigned char>(s[i]);
+            if (c >= 0x20 && c != '"' && c != '\\') continue;
+            out.write(s + start, i - start);
+            start = i + 1;
+            char esc[6] = {'\\', 'u', '0', '0', HEX[c >> 4], HEX[c & 0xF]};
+            if (c == '"' || c == '\\') {
+                esc[1] = static_cast<char>(c);
+                out.write(esc, 2);
+            } else if (c == '\n') {
+                out.write("\\n", 2);
+            } else {
+                out.write(esc, 6);
+            }
+        }
+        out.write(s + start, n - start);
+        out.put('"');
+    }
+};
+
+// Ƽ¼16ֽͷ + ͬͶ¼ֽ򣬼Сˣ
+// 汾2RiskRecordԭֽcontractType汾1иֽΪ0USDTλȡɰ0ݣ
+const uint32_t RECORD_STREAM_MAGIC = 0x31524354; // "TCR1"
+const uint16_t RECORD_STREAM_VERSION = 2;
+
+enum class RecordType : uint16_t {
+    RISK = 1,
+    SUPPORT_RESISTANCE = 2,
+    SCORE = 3
+};
+
+struct RecordStreamHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t type;       // RecordType
+    uint32_t recordSize; // ¼ֽ
+    uint32_t reserved;
+};
+static_assert(sizeof(RecordStreamHeader) == 16, "RecordStreamHeaderѱ仯");
+
+inline void writeRecordStreamHeader(BufferedWriter& out, RecordType type, uint32_t recordSize) {
+    RecordStreamHeader h{RECORD_STREAM_MAGIC, RECORD_STREAM_VERSION, static_cast<uint16_t>(type), recordSize, 0};
+    out.write(&h, sizeof(h));
+}
+
+// \0βƶƷضϣ
+inline void copyRecordSymbol(char (&dst)[16], std::string_view symbol) {
+    std::memset(dst, 0, sizeof(dst));
+    std::memcpy(dst, symbol.data(), std::min(symbol.size(), sizeof(dst) - 1));
+}
+
+}  // namespace tradecheck
@@ -0,0 +1,129 @@
+#include "risk_kernels.h"
+#include <algorithm>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define TRADECHECK_KERNEL_AVX2 1
+#endif
+
+// ѭAVX2汾Żᰴָ룻GNU˻ͨinline
+#ifdef __GNUC__
+#define TRADECHECK_KERNEL_INLINE inline __attribute__((always_inline))
+#else
+#define TRADECHECK_KERNEL_INLINE inline
+#endif
+
+namespace tradecheck {
+
+namespace {
+
+// һֲֵѭ壺ػ޷֧Ŀָ
+template <typename Contract, TradeDirection D>
+TRADECHECK_KERNEL_INLINE void groupLoop(const RiskBook::Group& g, double* liq, double* add) {
+    size_t n = g.entry.size();
+    const double* entry = g.entry.data();
+    const double* leverage = g.leverage.data();
+    const double* mmr = g.mmr.data();
+    const double* size = g.size.data();
+    const double* margin = g.margin.data();
+    const double* mark = g.mark.data();
+    for (size_t i = 0; i < n; ++i) {
+        liq[i] = Contract::template liquidationPrice<D>(entry[i], leverage[i], mmr[i]);
+        add[i] = kernelMarginToAdd<Contract, D>(entry[i], mark[i], size[i], margin[i], mmr[i]);
+    }
+}
+
+template <typename Contract, TradeDirection D>
+void groupScalar(const RiskBook::Group& g, double* liq, double* add) {
+    groupLoop<Contract, D>(g, liq, add);
+}
+
+#ifdef TRADECHECK_KERNEL_AVX2
+// ͬһѭ尴AVX2루FMA˳·ͬλһ£
+template <typename Contract, TradeDirection D>
+__attribute__((target("avx2"))) void groupAvx2(const RiskBook::Group& g, double* liq, double* add) {
+    groupLoop<Contract, D>(g, liq, add);
+}
+#endif
+
+using GroupKernel = void (*)(const RiskBook::Group&, double*, double*);
+
+const GroupKernel SCALAR_KERNELS[RiskBook::GROUP_COUNT] = {
+    groupScalar<LinearUsdt, TradeDirection::LONG>, groupScalar<LinearUsdt, TradeDirection::SHORT>,
+    groupScalar<InverseCoin, TradeDirection::LONG>, groupScalar<InverseCoin, TradeDirection::SHORT>,
+};
+
+#ifdef TRADECHECK_KERNEL_AVX2
+const GroupKernel AVX2_KERNELS[RiskBook::GROUP_COUNT] = {
+    groupAvx2<LinearUsdt, TradeDirection::LONG>, groupAvx2<LinearUsdt, TradeDirection::SHORT>,
+    groupAvx2<InverseCoin, TradeDirection::LONG>, groupAvx2<InverseCoin, TradeDirection::SHORT>,
+};
+#endif
+
+bool detectSimd() {
+#ifdef TRADECHECK_KERNEL_AVX2
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+}  // namespace
+
+bool riskKernelSimdSupported() {
+    static const bool supported = detectSimd();
+    return supported;
+}
+
+size_t RiskBook::add(const CryptoRiskCalculator& calc, double markPrice) {
+    const ContractSpec& spec = calc.getContract();
+    bool inverse = spec.type == ContractType::INVERSE_COIN;
+    Group& g = groups[(inverse ? 2 : 0) + (calc.getDirection() == TradeDirection::LONG ? 0 : 1)];
+    double margin = calc.getInitialMargin();
+    double lev = calc.getLeverage();
+    double entry = calc.getEntryPrice();
+    g.entry.push_back(entry);
+    g.leverage.push_back(lev);
+    g.mmr.push_back(spec.maintenanceMarginRate);
+    g.size.push_back(inverse ? InverseCoin::positionSize(margin, lev, entry) : LinearUsdt::positionSize(margin, lev, entry));
+    g.margin.push_back(margin);
+    g.mark.push_back(markPrice);
+    g.index.push_back(static_cast<uint32_t>(count));
+    return count++;
+}
+
+void RiskBook::clear() {
+    for (auto& g : groups) {
+        g.entry.clear();
+        g.leverage.clear();
+        g.mmr.clear();
+        g.size.clear();
+        g.margin.clear();
+        g.mark.clear();
+        g.index.clear();
+    }
+    count = 0;
+}
+
+void RiskBook::compute(std::vector<double>& liquidationPrice, std::vector<double>& marginToAdd, bool simd) const {
+    liquidationPrice.resize(count);
+    marginToAdd.resize(count);
+    const GroupKernel* kernels = SCALAR_KERNELS;
+#ifdef TRADECHECK_KERNEL_AVX2
+    if (simd && riskKernelSimdSupported()) kernels = AVX2_KERNELS;
+#endif
+    (void)simd;
+    size_t largest = 0;
+    for (const auto& g : groups) largest = std::max(largest, g.entry.size());
+    std::vector<double> liq(largest), add(largest);
+    for (int k = 0; k < GROUP_COUNT; ++k) {
+        const Group& g = groups[k];
+        if (g.entry.empty()) continue;
+        kernels[k](g, liq.data(), add.data());
+        for (size_t i = 0; i < g.index.size(); ++i) {
+            liquidationPrice[g.index[i]] = liq[i];
+            marginToAdd[g.index[i]] = add[i];
+        }
+    }
+}
+
+}  // namespace tradecheck
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "crypto_risk.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace tradecheck {
+
+// ػķռںˣԼ뽻׷ģʽ֧뷽ڱȷ
+// ѭ޷֧ʱְֲ(Լ, )ֳ飬鰴дš
+
+// ֲֹģUSDTλΪұλΪUSDֵֵ֤貹䱣֤ĵλmarginAsset()
+
+// USDTλԺԼӯ =   (۸ - ּ)  
+struct LinearUsdt {
+    static constexpr ContractType type = ContractType::LINEAR_USDT;
+
+    // ּۼĳֲֹģ
+    static double positionSize(double margin, double leverage, double entry) { return margin * leverage / entry; }
+
+    // ǿƽ = ּ  (1 -   (1/ܸ - άֱ֤))൥Ϊ1յΪ-1
+    template <TradeDirection D>
+    static double liquidationPrice(double entry, double leverage, double mmr) {
+        constexpr double sign = D == TradeDirection::LONG ? 1.0 : -1.0;
+        return entry * (1.0 - sign * (1.0 / leverage - mmr));
+    }
+
+    template <TradeDirection D>
+    static double unrealizedLoss(double entry, double mark, double size) {
+        constexpr double sign = D == TradeDirection::LONG ? 1.0 : -1.0;
+        return sign * (entry - mark) * size;
+    }
+
+    // άֱ֤𰴿ֵּƣCryptoRiskCalculator::getMaintenanceMarginһ£
+    static double maintenanceMargin(double entry, double mark, double size, double mmr) {
+        (void)mark;
+        return entry * size * mmr;
+    }
+};
+
+// ұλԼӯң=   ֵ  (1/ּ - 1/۸)
+struct InverseCoin {
+    static constexpr ContractType type = ContractType::INVERSE_COIN;
+
+    static double positionSize(double margin, double leverage, double entry) { return margin * leverage * entry; }
+
+    // ֤𣨱ң+ ӯ = άֱ֤  ֵ/ǿƽۣ
+    // ൥ = (1+άֱ֤)ּܸۡ/(ܸ+1)յ = (1-άֱ֤)ּܸۡ/(ܸ-1)1յǿƽۣΪ+inf
+    template <TradeDirection D>
+    static double liquidationPrice(double entry, double leverage, double mmr) {
+        constexpr double sign = D == TradeDirection::LONG ? 1.0 : -1.0;
+        return entry * leverage * (1.0 + sign * mmr) / (leverage + sign);
+    }
+
+    template <TradeDirection D>
+    static double unrealizedLoss(double entry, double mark, double size) {
+        constexpr double sign = D == TradeDirection::LONG ? 1.0 : -1.0;
+        return sign * size * (1.0 / mark - 1.0 / entry);
+    }
+
+    // άֱ֤𣨱ңǰ۸
+    static double maintenanceMargin(double entry, double mark, double size, double mmr) {
+        (void)entry;
+        return mmr * size / mark;
+    }
+};
+
+// 貹䱣֤ݲԱ֤𣩣ǿƽֻʣӦ׷ӱ֤
+const double MARGIN_TO_ADD_EPSILON = 1e-9;
+
+// ۸貹䱣֤ = άֱ֤ - (֤ - δʵֿ)ݲʱΪ0
+template <typename Contract, TradeDirection D>
+inline double kernelMarginToAdd(double entry, double mark, double size, double margin, double mmr) {
+    double need = Contract::maintenanceMargin(entry, mark, size, mmr) -
+                  (margin - Contract::template unrealizedLoss<D>(entry, mark, size));
+    return need > MARGIN_TO_ADD_EPSILON * margin ? need : 0.0;
+}
+
+// (Լ, )ĳֲϣadd()Ǽǳֲ뵱ǰ۸compute()ػںˣǼ˳д
+class RiskBook {
+public:
+    // سֲţ±꣩
+    size_t add(const CryptoRiskCalculator& calc, double markPrice);
+    void clear();
+    size_t size() const { return count; }
+
+    // ȫֲֵǿƽ밴ǼǼ۸貹䱣֤simdΪtrueCPU֧ʱAVX2·λһ£
+    void compute(std::vector<double>& liquidationPrice, std::vector<double>& marginToAdd, bool simd = true) const;
+
+    // ͬһĳְֲд
+    struct Group {
+        std::vector<double> entry, leverage, mmr, size, margin, mark;
+        std::vector<uint32_t> index; // Ǽ
+    };
+
+    //  = Լ͡2 + 򣨶01
+    static const int GROUP_COUNT = 4;
+    const Group& group(int g) const { return groups[g]; }
+
+private:
+    Group groups[GROUP_COUNT];
+    size_t count = 0;
+};
+
+// ǰCPUǷ֧AVX2·
+bool riskKernelSimdSupported();
+
+}  // namespace tradecheck
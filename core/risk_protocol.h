@@ -0,0 +1,270 @@
+#pragma once
+
+#include "crypto_risk.h"
+#include "support_resistance.h"
+#include "consistency_score.h"
+#include "latency_stats.h"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tradecheck {
+
+// ػ̶Э飨Unix׽ֽ֣򣬶ͷ+أ
+
+const uint32_t PROTOCOL_MAGIC = 0x32444B52; // "RKD2"
+const char* const DEFAULT_SOCKET_PATH = "/tmp/tradecheck_risk.sock";
+const uint32_t MAX_PAYLOAD_SIZE = 16 * 1024 * 1024;
+
+// 
+enum class MessageType : uint16_t {
+    RISK = 1,       // ǿƽ/֤
+    SR_UPDATE = 2,  // ׷KߵƷִ
+    SR_QUERY = 3,   // ѯƷ֧λ
+    SCORE = 4,      // ۺһ+ìܵ
+    STATS = 5,      // ֽ׶ӳͳ
+    INDICATORS = 6  // ѯƷֳפEMA/RSI/KSTSR_UPDATEK߸£
+};
+
+// Ӧ״̬
+enum class MessageStatus : uint16_t {
+    OK = 0,
+    INVALID_ARGUMENT = 1, // ܾΪϢ
+    UNKNOWN_TYPE = 2,
+    BAD_PAYLOAD = 3,
+    UNKNOWN_SYMBOL = 4    // ƷKߴڣRISKĺԼδ
+};
+
+// ͷ
+struct MessageHeader {
+    uint32_t magic;
+    uint16_t type;
+    uint16_t status;
+    uint32_t requestId;
+    uint32_t length;    // ֽ
+};
+static_assert(sizeof(MessageHeader) == 16, "ͷΪ16ֽ");
+
+// RISK
+struct RiskRequest {
+    char symbol[16];    // \0βĺԼ루Լע
+    uint8_t direction;  // TradeDirection
+    uint8_t reserved[7];
+    double leverage;
+    double positionRatio;
+    double entryPrice;
+    double totalCapital;
+};
+static_assert(sizeof(RiskRequest) == 56, "RiskRequestֱ仯");
+
+// RISKӦ
+struct RiskResponse {
+    double threshold;
+    double riskCoefficient;
+    double initialMargin;
+    double maintenanceMargin;
+    double marginToAdd;
+    double liquidationPrice;
+    uint8_t riskLevel;  // RiskLevel
+    uint8_t reserved[7];
+};
+static_assert(sizeof(RiskResponse) == 56, "RiskResponseֱ仯");
+
+// SR_UPDATE/SR_QUERYͷSR_UPDATEklineCountKlineData
+struct SymbolRequest {
+    char symbol[16];    // \0βƷ
+    uint8_t timeframe;  // TimeFrame
+    uint8_t reserved[3];
+    uint32_t klineCount;
+};
+static_assert(sizeof(SymbolRequest) == 24, "SymbolRequestֱ仯");
+static_assert(sizeof(KlineData) == 40, "KlineDataΪ5double");
+
+// SR_UPDATEӦ
+struct SymbolUpdateResponse {
+    uint32_t windowSize; // K
+    uint32_t reserved;
+};
+
+// SR_QUERYӦSupportResistanceLevels
+
+// INDICATORSΪKߵSymbolRequestӦ£ͬ·
+struct IndicatorResponse {
+    uint8_t emaTrend[3];  // //EMA
+    uint8_t rsiLevel;
+    uint8_t kstCross;     // һKߵKSTԽ
+    uint8_t ready;        // λbit0~2//EMAbit3 RSIbit4 KST
+    uint8_t reserved[2];
+    int32_t emaPeriod[3];
+    uint32_t klineCount;  // ƷۼյK
+    double ema[3];
+    double rsi;
+    double kst;
+    double kstSignal;
+};
+static_assert(sizeof(IndicatorResponse) == 72, "IndicatorResponseֱ仯");
+
+// SCORE󶨳֣patternCountPatternCodeflagsSCORE_FLAG_ATRʱٽһdoubleATR/%
+struct ScoreRequest {
+    uint8_t openDir;        // 0= 1=
+    uint8_t longTrend;      // 0= 1=½ 2=
+    uint8_t midTrend;
+    uint8_t shortTrend;
+    uint8_t rsiLevel;       // 0= 1= 2=
+    uint8_t emaTrend[3];    // 4Сʱ//EMA
+    uint8_t kstCross[3];    // 0=ϴԽ 1=´Խ 2=δԽ
+    uint8_t patternCount;
+    int32_t leverage;
+    int32_t shortTrendLineBreakTimes;
+    int32_t flags;          // ԭֶΣɿͻ˺Ϊ0
+    double openPrice;
+    double stopLoss;
+};
+static_assert(sizeof(ScoreRequest) == 40, "ScoreRequestֱ仯");
+
+// ScoreRequest.flags
+const int32_t SCORE_FLAG_ATR = 1;  // ĩβATR/ۣ%ֹʰATR
+
+// ۸̬
+struct PatternCode {
+    uint8_t pattern;    // PricePatternCodePRICE_PATTERN_NAMES±꣩
+    uint8_t timeframe;  // PatternTimeframe
+    uint8_t breakDir;   // TriangleBreakDir
+    uint8_t reserved;
+};
+
+// SCOREӦ֣contradictionCount[uint16+ı]
+struct ScoreResponse {
+    int32_t totalScore;
+    int32_t emaScore;
+    int32_t kstScore;
+    int32_t dirMatchScore;
+    uint8_t highLeverRisk;
+    uint8_t reserved;
+    uint16_t contradictionCount;
+};
+static_assert(sizeof(ScoreResponse) == 20, "ScoreResponseֱ仯");
+
+// STATSΪգ1ֽڣ0ʾȡ㣩
+// STATSӦΪLatencyStageSummaryֻм¼Ľ׶Σ
+
+// Э
+const char* const DIR_NAMES[2] = {"", ""};
+const char* const TREND_NAMES[3] = {"", "½", ""};
+const char* const RSI_NAMES[3] = {"", "", ""};
+const char* const KST_CROSS_NAMES[3] = {"ϴԽ", "´Խ", "δԽ"};
+
+// ıδҵ-1
+template <size_t N>
+int lookupCode(const char* const (&table)[N], std::string_view value) {
+    for (size_t i = 0; i < N; ++i) {
+        if (value == table[i]) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+// ׷һ֡
+inline void appendFrame(std::vector<char>& out, MessageType type, MessageStatus status, uint32_t requestId,
+                        const void* payload, uint32_t length) {
+    MessageHeader h{PROTOCOL_MAGIC, static_cast<uint16_t>(type), static_cast<uint16_t>(status), requestId, length};
+    const char* hp = reinterpret_cast<const char*>(&h);
+    out.insert(out.end(), hp, hp + sizeof(h));
+    if (length) {
+        const char* p = static_cast<const char*>(payload);
+        out.insert(out.end(), p, p + length);
+    }
+}
+
+// SCOREأ޷ıʱfalse
+inline bool encodeScoreRequest(const TradeAnalysis& ta, std::vector<char>& payload) {
+    ScoreRequest req{};
+    int dir = lookupCode(DIR_NAMES, ta.openDir);
+    int lt = lookupCode(TREND_NAMES, ta.longTrend);
+    int mt = lookupCode(TREND_NAMES, ta.midTrend);
+    int st = lookupCode(TREND_NAMES, ta.shortTrend);
+    int rsi = lookupCode(RSI_NAMES, ta.rsiLevel);
+    if (dir < 0 || lt < 0 || mt < 0 || st < 0 || rsi < 0 || ta.emaList.size() != 3 || ta.kstList.size() != 3) return false;
+    req.openDir = static_cast<uint8_t>(dir);
+    req.longTrend = static_cast<uint8_t>(lt);
+    req.midTrend = static_cast<uint8_t>(mt);
+    req.shortTrend = static_cast<uint8_t>(st);
+    req.rsiLevel = static_cast<uint8_t>(rsi);
+    for (int i = 0; i < 3; ++i) {
+        int e = lookupCode(TREND_NAMES, ta.emaList[i].trend);
+        int k = lookupCode(KST_CROSS_NAMES, ta.kstList[i].cross);
+        if (e < 0 || k < 0) return false;
+        req.emaTrend[i] = static_cast<uint8_t>(e);
+        req.kstCross[i] = static_cast<uint8_t>(k);
+    }
+    req.patternCount = static_cast<uint8_t>(ta.pricePatterns.size());
+    req.leverage = ta.leverage;
+    req.shortTrendLineBreakTimes = ta.shortTrendLineBreakTimes;
+    req.openPrice = ta.openPrice;
+    req.stopLoss = ta.stopLoss;
+    if (ta.atrRate > 0) req.flags |= SCORE_FLAG_ATR;
+
+    size_t patternBytes = req.patternCount * sizeof(PatternCode);
+    payload.resize(sizeof(req) + patternBytes + ((req.flags & SCORE_FLAG_ATR) ? sizeof(double) : 0));
+    std::memcpy(payload.data(), &req, sizeof(req));
+    if (req.flags & SCORE_FLAG_ATR) std::memcpy(payload.data() + sizeof(req) + patternBytes, &ta.atrRate, sizeof(double));
+    for (size_t i = 0; i < req.patternCount; ++i) {
+        int p = lookupCode(PRICE_PATTERN_NAMES, ta.pricePatterns[i].name);
+        if (p < 0) return false;
+        PatternCode pc{static_cast<uint8_t>(p), static_cast<uint8_t>(ta.pricePatterns[i].tf),
+                       static_cast<uint8_t>(ta.pricePatterns[i].breakDir), 0};
+        std::memcpy(payload.data() + sizeof(req) + i * sizeof(pc), &pc, sizeof(pc));
+    }
+    return true;
+}
+
+// SCOREأԪֱtaķй죩
+inline bool decodeScoreRequest(const char* data, uint32_t length, TradeAnalysis& ta) {
+    if (length < sizeof(ScoreRequest)) return false;
+    ScoreRequest req;
+    std::memcpy(&req, data, sizeof(req));
+    if (req.flags & ~SCORE_FLAG_ATR) return false;
+    size_t patternBytes = req.patternCount * sizeof(PatternCode);
+    if (length != sizeof(req) + patternBytes + ((req.flags & SCORE_FLAG_ATR) ? sizeof(double) : 0)) return false;
+    if (req.openDir > 1 || req.longTrend > 2 || req.midTrend > 2 || req.shortTrend > 2 || req.rsiLevel > 2) return false;
+    // ۸ΪNaNκαȽ϶Ϊ٣ʽ飩
+    if (req.leverage < 1 || req.shortTrendLineBreakTimes < 0) return false;
+    if (!std::isfinite(req.openPrice) || req.openPrice <= 0 || !std::isfinite(req.stopLoss) || req.stopLoss <= 0) return false;
+
+    ta.openDir = DIR_NAMES[req.openDir];
+    ta.longTrend = TREND_NAMES[req.longTrend];
+    ta.midTrend = TREND_NAMES[req.midTrend];
+    ta.shortTrend = TREND_NAMES[req.shortTrend];
+    ta.rsiLevel = RSI_NAMES[req.rsiLevel];
+    ta.leverage = req.leverage;
+    ta.shortTrendLineBreakTimes = req.shortTrendLineBreakTimes;
+    ta.openPrice = req.openPrice;
+    ta.stopLoss = req.stopLoss;
+    ta.atrRate = 0;
+    if (req.flags & SCORE_FLAG_ATR) {
+        std::memcpy(&ta.atrRate, data + sizeof(req) + patternBytes, sizeof(double));
+        if (!(ta.atrRate > 0) || !std::isfinite(ta.atrRate)) return false;
+    }
+    ta.emaList.clear();
+    ta.kstList.clear();
+    ta.pricePatterns.clear();
+    const Timeframe tfs[3] = {Timeframe::TF_4H, Timeframe::TF_DAY, Timeframe::TF_WEEK};
+    for (int i = 0; i < 3; ++i) {
+        if (req.emaTrend[i] > 2 || req.kstCross[i] > 2) return false;
+        ta.emaList.emplace_back(tfs[i], 0, TREND_NAMES[req.emaTrend[i]], false);
+        ta.kstList.emplace_back(tfs[i], std::initializer_list<int>(), KST_CROSS_NAMES[req.kstCross[i]]);
+    }
+    for (size_t i = 0; i < req.patternCount; ++i) {
+        PatternCode pc;
+        std::memcpy(&pc, data + sizeof(req) + i * sizeof(pc), sizeof(pc));
+        if (pc.pattern >= PRICE_PATTERN_COUNT || pc.timeframe > 2 || pc.breakDir > 2) return false;
+        ta.pricePatterns.emplace_back(PRICE_PATTERN_NAMES[pc.pattern], static_cast<PatternTimeframe>(pc.timeframe),
+                                      static_cast<TriangleBreakDir>(pc.breakDir));
+    }
+    updateStopLossRates(ta);
+    return true;
+}
+
+}  // namespace tradecheck
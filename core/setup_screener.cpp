@@ -0,0 +1,301 @@
+#include "setup_screener.h"
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+
+namespace tradecheck {
+
+namespace {
+
+// ÿȡ/ͼۡ㡢S1~S3R1~R3ܼ֧/
+const int LEVELS_PER_TIMEFRAME = 11;
+
+// һƷɨKߺ״̬
+struct SymbolScan {
+    IndicatorReading reading;
+    double close;
+    bool invalid;      // ֵ߼۵ͼ۵K
+    int levelCount;
+    double levels[INDICATOR_TIMEFRAME_COUNT * LEVELS_PER_TIMEFRAME];
+    uint8_t levelTimeframe[INDICATOR_TIMEFRAME_COUNT * LEVELS_PER_TIMEFRAME];
+};
+
+// ÿ̸߳õݴ棨ָ״̬ϴ󣬲ջϣ
+struct ScanScratch {
+    TimeframeResampler resampler;
+    MultiTimeframeIndicators indicators;
+    std::vector<KlineData> closed[INDICATOR_TIMEFRAME_COUNT];
+    AnalysisArena arena;
+};
+
+bool validBar(const KlineData& k) {
+    return std::isfinite(k.open) && std::isfinite(k.high) && std::isfinite(k.low) && std::isfinite(k.close) &&
+           k.high >= k.low;
+}
+
+// ز¶ָ꣬windowK֧λ
+// ûκ̻ЧKߣout.invalidʱfalse
+bool scanSymbol(const ScreenerUniverse& u, size_t s, const ScreenerOptions& opt, ScanScratch& scratch, SymbolScan& out) {
+    scratch.resampler.reset(opt.interval);
+    scratch.indicators.reset(opt.atrPeriod);
+    for (auto& c : scratch.closed) c.clear();
+    out.invalid = false;
+    size_t begin = u.offsets[s], end = u.offsets[s + 1];
+    if (begin == end) return false;
+    ResampledBar closed[MAX_RESAMPLED_PER_BAR];
+    for (size_t i = begin; i < end; ++i) {
+        if (!validBar(u.bars[i])) {
+            out.invalid = true;
+            return false;
+        }
+        int n = scratch.resampler.update(u.times[i], u.bars[i], closed);
+        for (int k = 0; k < n; ++k) {
+            scratch.indicators.update(closed[k].tf, closed[k].bar);
+            scratch.closed[static_cast<int>(closed[k].tf)].push_back(closed[k].bar);
+        }
+    }
+    out.reading = scratch.indicators.reading();
+    out.close = u.bars[end - 1].close;
+    out.levelCount = 0;
+    for (int t = 0; t < INDICATOR_TIMEFRAME_COUNT; ++t) {
+        const std::vector<KlineData>& c = scratch.closed[t];
+        if (c.empty()) continue;
+        size_t n = std::min(c.size(), static_cast<size_t>(opt.window));
+        SupportResistanceLevels l = computeSupportResistance(c.data() + c.size() - n, n);
+        const double prices[LEVELS_PER_TIMEFRAME] = {l.highestHigh, l.lowestLow, l.pivotPoint, l.s1, l.s2, l.s3,
+                                                     l.r1, l.r2, l.r3, l.denseSupport, l.denseResist};
+        for (double p : prices) {
+            if (!std::isfinite(p) || !(p > 0)) continue;
+            out.levels[out.levelCount] = p;
+            out.levelTimeframe[out.levelCount] = static_cast<uint8_t>(t);
+            out.levelCount++;
+        }
+    }
+    return out.levelCount > 0;
+}
+
+// ൥ê·ļλյêϷļλֹstopBufferPercent
+// òûмλʱATRֹanchorΪNaNATRδʱfalse
+bool placeStop(const SymbolScan& scan, TradeDirection dir, const ScreenerOptions& opt, double& anchor, double& stop) {
+    double open = scan.close;
+    bool isLong = dir == TradeDirection::LONG;
+    anchor = std::numeric_limits<double>::quiet_NaN();
+    for (int i = 0; i < scan.levelCount; ++i) {
+        double p = scan.levels[i];
+        if (isLong ? p < open && !(p <= anchor) : p > open && !(p >= anchor)) anchor = p;
+    }
+    double buffer = opt.stopBufferPercent / 100;
+    if (!std::isnan(anchor)) {
+        stop = isLong ? anchor * (1 - buffer) : anchor * (1 + buffer);
+        return stop > 0;
+    }
+    double atr = scan.reading.atr;
+    if (!(atr > 0)) return false;
+    stop = isLong ? open - atr * opt.atrStopMultiple : open + atr * opt.atrStopMultiple;
+    return stop > 0;
+}
+
+void countConfluence(const SymbolScan& scan, const ScreenerOptions& opt, ScreenerSetup& setup) {
+    setup.confluence = 0;
+    setup.timeframes = 0;
+    if (std::isnan(setup.anchor)) return;
+    double range = setup.anchor * opt.confluencePercent / 100;
+    unsigned mask = 0;
+    for (int i = 0; i < scan.levelCount; ++i) {
+        if (std::fabs(scan.levels[i] - setup.anchor) > range) continue;
+        setup.confluence++;
+        mask |= 1u << scan.levelTimeframe[i];
+    }
+    for (; mask; mask &= mask - 1) setup.timeframes++;
+}
+
+// ͬһݿָ겿EMA/KSTһԵ÷ֻһ
+void scoreShared(const ScreenerUniverse& u, size_t s, const SymbolScan& scan, const ScreenerOptions& opt,
+                 AnalysisArena& arena, ScreenerSetup* out, char* valid) {
+    {
+        TradeAnalysis ta(arena.allocator());
+        ta.coinType = u.symbols[s];
+        ta.leverage = opt.leverage;
+        ta.openPrice = scan.close;
+        fillIndicatorAnalysis(scan.reading, ta);
+        int emaScore = calculateEMAConsistency(ta.emaList);
+        int kstScore = calculateKSTConsistency(ta.kstList);
+        for (int d = 0; d < 2; ++d) {
+            TradeDirection dir = d == 0 ? TradeDirection::LONG : TradeDirection::SHORT;
+            ScreenerSetup& setup = out[d];
+            if (!placeStop(scan, dir, opt, setup.anchor, ta.stopLoss)) continue;
+            ta.openDir = d == 0 ? "" : "";
+            updateStopLossRates(ta);
+            ScoreFeatures f{emaScore, kstScore, ta.stopLossRate, ta.leverStopLossRisk, calculateDirTrendMatchScore(ta),
+                            ta.atrRate};
+            ScoreRecord& r = setup.score;
+            r = ScoreRecord{};
+            copyRecordSymbol(r.symbol, ta.coinType);
+            r.openDir = static_cast<uint8_t>(d);
+            r.leverage = ta.leverage;
+            r.openPrice = ta.openPrice;
+            r.stopLoss = ta.stopLoss;
+            r.stopLossRate = ta.stopLossRate;
+            r.leverStopLossRisk = ta.leverStopLossRisk;
+            r.emaScore = f.emaScore;
+            r.kstScore = f.kstScore;
+            r.baseStopLossScore = calculateBaseStopLossScore(f.stopLossRate, f.atrRate, opt.weights);
+            bool highRisk = false;
+            r.leverStopLossScore = calculateLeverStopLossScore(f.leverStopLossRisk, opt.weights, highRisk);
+            r.highLeverRisk = highRisk ? 1 : 0;
+            r.dirMatchScore = f.dirMatchScore;
+            r.totalScore = static_cast<int>(calculateWeightedConsistency(f, opt.weights, highRisk));
+            setup.symbolIndex = static_cast<uint32_t>(s);
+            countConfluence(scan, opt, setup);
+            valid[d] = 1;
+        }
+    }
+    arena.reset();
+}
+
+// ·ÿɨKߡmakeScoreRecord/calculateTotalConsistency
+bool scoreIndependent(const ScreenerUniverse& u, size_t s, const ScreenerOptions& opt, ScanScratch& scratch,
+                      SymbolScan& scan, ScreenerSetup* out, char* valid) {
+    bool any = false;
+    for (int d = 0; d < 2; ++d) {
+        if (!scanSymbol(u, s, opt, scratch, scan)) return false;
+        any = true;
+        TradeDirection dir = d == 0 ? TradeDirection::LONG : TradeDirection::SHORT;
+        ScreenerSetup& setup = out[d];
+        double stop;
+        if (!placeStop(scan, dir, opt, setup.anchor, stop)) continue;
+        {
+            TradeAnalysis ta(scratch.arena.allocator());
+            ta.coinType = u.symbols[s];
+            ta.openDir = d == 0 ? "" : "";
+            ta.leverage = opt.leverage;
+            ta.openPrice = scan.close;
+            ta.stopLoss = stop;
+            fillIndicatorAnalysis(scan.reading, ta);
+            updateStopLossRates(ta);
+            ScoreRecord& r = setup.score;
+            r = makeScoreRecord(ta, 0);
+            bool highRisk = false;
+            r.baseStopLossScore = calculateBaseStopLossScore(ta.stopLossRate, ta.atrRate, opt.weights);
+            r.leverStopLossScore = calculateLeverStopLossScore(ta.leverStopLossRisk, opt.weights, highRisk);
+            r.highLeverRisk = highRisk ? 1 : 0;
+            r.totalScore = calculateTotalConsistency(ta, highRisk, opt.weights);
+        }
+        scratch.arena.reset();
+        setup.symbolIndex = static_cast<uint32_t>(s);
+        countConfluence(scan, opt, setup);
+        valid[d] = 1;
+    }
+    return any;
+}
+
+bool rankBefore(const ScreenerSetup& a, const ScreenerSetup& b) {
+    if (a.score.totalScore != b.score.totalScore) return a.score.totalScore > b.score.totalScore;
+    if (a.confluence != b.confluence) return a.confluence > b.confluence;
+    if (a.timeframes != b.timeframes) return a.timeframes > b.timeframes;
+    if (a.symbolIndex != b.symbolIndex) return a.symbolIndex < b.symbolIndex;
+    return a.score.openDir < b.score.openDir;
+}
+
+}  // namespace
+
+ScreenerUniverse buildScreenerUniverse(const std::vector<KlineRow>& rows) {
+    ScreenerUniverse u;
+    std::unordered_map<std::string, uint32_t> ids;
+    std::vector<uint32_t> symbolOf(rows.size());
+    std::vector<size_t> counts;
+    uint32_t lastId = 0;
+    for (size_t i = 0; i < rows.size(); ++i) {
+        // ͬһƷֵвز
+        if (i == 0 || rows[i].symbol != rows[i - 1].symbol) {
+            auto it = ids.find(rows[i].symbol);
+            if (it == ids.end()) {
+                it = ids.emplace(rows[i].symbol, static_cast<uint32_t>(u.symbols.size())).first;
+                u.symbols.push_back(rows[i].symbol);
+                counts.push_back(0);
+            }
+            lastId = it->second;
+        }
+        symbolOf[i] = lastId;
+        counts[lastId]++;
+    }
+    u.offsets.assign(u.symbols.size() + 1, 0);
+    for (size_t s = 0; s < counts.size(); ++s) u.offsets[s + 1] = u.offsets[s] + counts[s];
+    std::vector<size_t> cursor(u.offsets.begin(), u.offsets.end() - 1);
+    u.times.resize(rows.size());
+    u.bars.resize(rows.size());
+    for (size_t i = 0; i < rows.size(); ++i) {
+        size_t at = cursor[symbolOf[i]]++;
+        u.times[at] = rows[i].openTime;
+        u.bars[at] = rows[i].kline;
+    }
+    return u;
+}
+
+ScreenerResult screenSetups(const ScreenerUniverse& u, const ScreenerOptions& opt) {
+    if (opt.window <= 0) throw std::invalid_argument("֧λK0");
+    if (opt.leverage <= 0) throw std::invalid_argument("ܸ˱0");
+    if (opt.stopBufferPercent < 0 || opt.atrStopMultiple < 0 || opt.confluencePercent < 0) {
+        throw std::invalid_argument("ֹ롢ATR빲ΧΪ");
+    }
+    size_t n = u.size();
+    std::vector<ScreenerSetup> slots(2 * n);
+    std::vector<char> valid(2 * n, 0);
+    std::vector<char> ready(n, 0); // 0=K߲ 1= 2=ЧK
+
+    unsigned threadCount = opt.threads ? opt.threads : std::max(1u, std::thread::hardware_concurrency());
+    if (threadCount > n) threadCount = static_cast<unsigned>(std::max<size_t>(n, 1));
+    // ̵߳쳣ص߳׳
+    std::vector<std::exception_ptr> errors(threadCount);
+    auto worker = [&](unsigned t) {
+        try {
+            std::unique_ptr<ScanScratch> scratch(new ScanScratch());
+            SymbolScan scan;
+            for (size_t s = n * t / threadCount; s < n * (t + 1) / threadCount; ++s) {
+                if (opt.shared) {
+                    if (scanSymbol(u, s, opt, *scratch, scan)) {
+                        scoreShared(u, s, scan, opt, scratch->arena, &slots[2 * s], &valid[2 * s]);
+                        ready[s] = 1;
+                    }
+                } else if (scoreIndependent(u, s, opt, *scratch, scan, &slots[2 * s], &valid[2 * s])) {
+                    ready[s] = 1;
+                }
+                if (scan.invalid) ready[s] = 2;
+            }
+        } catch (...) {
+            errors[t] = std::current_exception();
+        }
+    };
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threadCount; ++t) pool.emplace_back(worker, t);
+    worker(0);
+    for (auto& th : pool) th.join();
+    for (const auto& e : errors) {
+        if (e) std::rethrow_exception(e);
+    }
+
+    ScreenerResult result;
+    result.symbols = n;
+    for (size_t s = 0; s < n; ++s) {
+        if (ready[s] == 0) result.skipped++;
+        else if (ready[s] == 2) result.invalid++;
+    }
+    for (size_t i = 0; i < slots.size(); ++i) {
+        if (valid[i]) result.setups.push_back(slots[i]);
+    }
+    result.scored = result.setups.size();
+    if (opt.top > 0 && result.setups.size() > opt.top) {
+        std::partial_sort(result.setups.begin(), result.setups.begin() + opt.top, result.setups.end(), rankBefore);
+        result.setups.resize(opt.top);
+    } else {
+        std::sort(result.setups.begin(), result.setups.end(), rankBefore);
+    }
+    return result;
+}
+
+}  // namespace tradecheck
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "analysis_pipeline.h"
+#include "indicator_analysis.h"
+#include "kline_io.h"
+#include "output_records.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tradecheck {
+
+// ڿɸѡȫƷְ4Сʱ//زָ͸֧λ
+// ̼Ϊ֧ۡţ൥/յΪֹ𣬶򶼰ۺһ֣
+// ÷ֹλĶڹ̶ȸǰN
+// ÿƷֵKֻɨһ飺ָָ겿ֺEMA/KSTһԵ÷ɶã
+// ֻӰֹֹ뷽ƥȣƷ֮以أ̷ֶ߳β
+
+// ƷַKߣͬһƷš˳
+struct ScreenerUniverse {
+    std::vector<std::string> symbols; // ״γ˳
+    std::vector<size_t> offsets;      // iƷֵK[offsets[i], offsets[i+1])
+    std::vector<int64_t> times;
+    std::vector<KlineData> bars;
+
+    size_t size() const { return symbols.size(); }
+};
+
+ScreenerUniverse buildScreenerUniverse(const std::vector<KlineRow>& rows);
+
+struct ScreenerOptions {
+    int64_t interval = 0;           // K߼룩0ʾƷѼСڼ
+    int window = 60;                // ڼ֧λõK
+    int atrPeriod = 14;             // ATR
+    int leverage = 5;               // øܸ
+    double stopBufferPercent = 0.2; // ֹêλľ루ٷֱȣ
+    double atrStopMultiple = 2;     // ֹһûмλʱֹ࿪ATRATRδ÷
+    double confluencePercent = 0.5; // êλðٷֱڵļλ빲
+    size_t top = 20;                // صĿ0ʾȫ
+    unsigned threads = 0;           // 0ʾCPU
+    bool shared = true;             // falseʱÿָλmakeScoreRecord֣Уգ
+    ScoreWeights weights;
+};
+
+struct ScreenerSetup {
+    uint32_t symbolIndex;  // ScreenerUniverseеƷ±
+    ScoreRecord score;     // ۺ֣밴ͬcalculateTotalConsistencyһ£
+    double anchor;         // ֹê֧/λNaNʾATRֹ
+    int confluence;        // êλļλêλڷֱƣ
+    int timeframes;        // ЩλԵ0~3
+};
+
+struct ScreenerResult {
+    std::vector<ScreenerSetup> setups; // ۺϵ÷֡λ
+    size_t symbols = 0;                // ɨƷ
+    size_t scored = 0;                 // ֵĿÿƷոһ
+    size_t skipped = 0;                // K߲κڵƷ
+    size_t invalid = 0;                // ֵ߼۵ͼ۵K߶Ʒ
+};
+
+// windowܸ˷ֹΪʱ׳invalid_argument
+ScreenerResult screenSetups(const ScreenerUniverse& universe, const ScreenerOptions& opt);
+
+}  // namespace tradecheck
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <time.h>
+
+namespace tradecheck {
+
+// ȴԣóCPUʱ޽չʱÿ50΢루ʱռCPU
+class SpinWait {
+public:
+    void wait() {
+        if (spins < 64) {
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#endif
+        } else if (spins < 256) {
+            std::this_thread::yield();
+        } else {
+            timespec ts{0, 50000};
+            nanosleep(&ts, nullptr);
+        }
+        spins++;
+    }
+
+private:
+    unsigned spins = 0;
+};
+
+// н絥/УΪ2ݣ
+// дλøռһУ˸ԻԷλãֻлʾ/ʱŶԷԭӱ
+// λɾ͵ضдclaim()ȡÿղۡдúpublish()front()ȡöסrelease()
+// ʱclaim()ȴߣѹʱfront()ȴߣclose()֮front()ȡʣԪطnullptr
+template <typename T>
+class SpscQueue {
+public:
+    explicit SpscQueue(size_t capacity) {
+        if (capacity < 2 || (capacity & (capacity - 1)) != 0) throw std::invalid_argument("Ϊ2");
+        slots.reset(new T[capacity]);
+        mask = capacity - 1;
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // ----  ----
+
+    // һղۣʱnullptr
+    T* tryClaim() {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - cachedHead > mask) {
+            cachedHead = head.load(std::memory_order_acquire);
+            if (t - cachedHead > mask) return nullptr;
+        }
+        return &slots[t & mask];
+    }
+
+    // һղۣʱȴ
+    T* claim() {
+        T* slot = tryClaim();
+        if (slot) return slot;
+        stalls++;
+        SpinWait w;
+        while (!(slot = tryClaim())) w.wait();
+        return slot;
+    }
+
+    void publish() { tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    void push(const T& value) {
+        *claim() = value;
+        publish();
+    }
+
+    // д루һpublish֮ߵã
+    void close() { closed.store(true, std::memory_order_release); }
+
+    // ----  ----
+
+    // Ԫأпʱnullptr
+    T* tryFront() {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == cachedTail) {
+            cachedTail = tail.load(std::memory_order_acquire);
+            if (h == cachedTail) return nullptr;
+        }
+        return &slots[h & mask];
+    }
+
+    // Ԫأпʱȴѹرȡʱnullptr
+    T* front() {
+        T* slot = tryFront();
+        if (slot) return slot;
+        waits++;
+        SpinWait w;
+        while (true) {
+            // رձ־ʱߵȫдѿɼٲһμжǷȡ
+            if (closed.load(std::memory_order_acquire)) return tryFront();
+            if ((slot = tryFront())) return slot;
+            w.wait();
+        }
+    }
+
+    void release() { head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    bool pop(T& value) {
+        T* slot = front();
+        if (!slot) return false;
+        value = std::move(*slot);
+        release();
+        return true;
+    }
+
+    // ѹرȡգֻߵã
+    bool drained() { return closed.load(std::memory_order_acquire) && !tryFront(); }
+
+    size_t capacity() const { return mask + 1; }
+
+    // ȴĴпնȴĴ߳̽ȡ
+    uint64_t producerStalls() const { return stalls; }
+    uint64_t consumerWaits() const { return waits; }
+
+private:
+    std::unique_ptr<T[]> slots;
+    size_t mask = 0;
+
+    // ߲
+    alignas(64) std::atomic<size_t> head{0};
+    size_t cachedTail = 0;
+    uint64_t waits = 0;
+
+    // ߲
+    alignas(64) std::atomic<size_t> tail{0};
+    size_t cachedHead = 0;
+    uint64_t stalls = 0;
+
+    alignas(64) std::atomic<bool> closed{false};
+};
+
+}  // namespace tradecheck
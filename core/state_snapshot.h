@@ -0,0 +1,401 @@
+#pragma once
+
+#include "crc32c.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace tradecheck {
+
+// ״̬գƷֵĶPOD״̬ڡָȣдֱmmapĿļ
+// ʱӳƷֿأֻطſ֮һС뼴ɽشͷ㼸µK
+// ļṹ4096ֽļͷ | 0 | 1۽д루˫壩ͷźCRC32C
+// ָʱȡУͨҴĲۣдһƻһݿ
+// ·ֻϴοб仯ƷֿݴݴֻԼ¼״̬İ汾
+// ̺msyncɺ̨߳
+
+const uint32_t SNAPSHOT_MAGIC = 0x31534E53; // "SNS1"
+const uint32_t SNAPSHOT_VERSION = 1;
+const size_t SNAPSHOT_HEADER_BYTES = 4096;
+const int SNAPSHOT_SYMBOL_LENGTH = 16;
+
+struct SnapshotFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entrySize;  // ƷĿֽ
+    uint32_t capacity;   // ÿۿɵƷ
+    uint64_t layoutTag;  // ״ֱ̬ʶɵ÷細ڳȣһʱָܻ
+    uint64_t slotBytes;  // ֽҳ룩
+};
+
+struct SnapshotSlotHeader {
+    uint64_t generation; // дţ10ʾղۣ
+    uint64_t position;   // ʱ̵λã黷λãָӴ˴Ŷ
+    int64_t createdNs;   // дʱ䣨CLOCK_REALTIME룩
+    uint32_t count;      // Ʒ
+    uint32_t crc;        // CRC32Cṹcrc֮ǰֶ + countĿ
+    uint8_t reserved[32];
+};
+static_assert(sizeof(SnapshotSlotHeader) == 64, "SnapshotSlotHeaderѱ仯");
+
+template <typename State>
+struct SnapshotEntry {
+    char symbol[SNAPSHOT_SYMBOL_LENGTH];
+    State state;
+};
+
+inline size_t snapshotSlotBytes(size_t entrySize, uint32_t capacity) {
+    size_t bytes = sizeof(SnapshotSlotHeader) + entrySize * capacity;
+    return (bytes + SNAPSHOT_HEADER_BYTES - 1) / SNAPSHOT_HEADER_BYTES * SNAPSHOT_HEADER_BYTES;
+}
+
+inline uint32_t snapshotSlotCrc(const SnapshotSlotHeader& h, const uint8_t* entries, size_t entrySize) {
+    uint32_t crc = crc32c(0, &h, offsetof(SnapshotSlotHeader, crc));
+    return crc32c(crc, entries, entrySize * h.count);
+}
+
+// ӳĿļҳµЧۣļͷƥûЧʱnullptr
+inline const SnapshotSlotHeader* findLatestSnapshotSlot(const uint8_t* base, size_t fileBytes, size_t entrySize,
+                                                        uint64_t layoutTag) {
+    if (fileBytes < SNAPSHOT_HEADER_BYTES) return nullptr;
+    const SnapshotFileHeader* fh = reinterpret_cast<const SnapshotFileHeader*>(base);
+    if (fh->magic != SNAPSHOT_MAGIC || fh->version != SNAPSHOT_VERSION || fh->entrySize != entrySize ||
+        fh->layoutTag != layoutTag || fh->slotBytes != snapshotSlotBytes(entrySize, fh->capacity) ||
+        fileBytes < SNAPSHOT_HEADER_BYTES + 2 * fh->slotBytes) {
+        return nullptr;
+    }
+    const SnapshotSlotHeader* best = nullptr;
+    for (int i = 0; i < 2; ++i) {
+        const uint8_t* slot = base + SNAPSHOT_HEADER_BYTES + i * fh->slotBytes;
+        const SnapshotSlotHeader* h = reinterpret_cast<const SnapshotSlotHeader*>(slot);
+        if (h->generation == 0 || h->count > fh->capacity) continue;
+        if (snapshotSlotCrc(*h, slot + sizeof(SnapshotSlotHeader), entrySize) != h->crc) continue;
+        if (!best || h->generation > best->generation) best = h;
+    }
+    return best;
+}
+
+// ֻ¿գĿֱӳڴϷʣ
+template <typename State>
+class SnapshotReader {
+    static_assert(std::is_trivially_copyable<State>::value, "״̬ΪPOD");
+
+public:
+    using Entry = SnapshotEntry<State>;
+
+    // ļڡʽ/ֲƥûЧʱ׳invalid_argument
+    SnapshotReader(const std::string& path, uint64_t layoutTag) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::invalid_argument("ļڣ" + path);
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < SNAPSHOT_HEADER_BYTES) {
+            ::close(fd);
+            throw std::invalid_argument("ļЧ" + path);
+        }
+        bytes = static_cast<size_t>(st.st_size);
+        void* p = ::mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) throw std::invalid_argument("޷ӳļ" + path);
+        base = static_cast<const uint8_t*>(p);
+        slot = findLatestSnapshotSlot(base, bytes, sizeof(Entry), layoutTag);
+        if (!slot) {
+            ::munmap(p, bytes);
+            throw std::invalid_argument("ļ" + path + "뵱ǰ״ֲ̬ûĿ");
+        }
+        entries = reinterpret_cast<const Entry*>(reinterpret_cast<const uint8_t*>(slot) + sizeof(SnapshotSlotHeader));
+    }
+
+    ~SnapshotReader() {
+        ::munmap(const_cast<uint8_t*>(base), bytes);
+    }
+
+    SnapshotReader(const SnapshotReader&) = delete;
+    SnapshotReader& operator=(const SnapshotReader&) = delete;
+
+    size_t size() const { return slot->count; }
+    const Entry& entry(size_t i) const { return entries[i]; }
+    uint64_t position() const { return slot->position; }
+    uint64_t generation() const { return slot->generation; }
+    int64_t createdNs() const { return slot->createdNs; }
+
+private:
+    const uint8_t* base = nullptr;
+    size_t bytes = 0;
+    const SnapshotSlotHeader* slot = nullptr;
+    const Entry* entries = nullptr;
+};
+
+// ̨д
+template <typename State>
+class SnapshotWriter {
+    static_assert(std::is_trivially_copyable<State>::value, "״̬ΪPOD");
+
+public:
+    using Entry = SnapshotEntry<State>;
+
+    // ݴ±Ϊ÷Ʒֱţupdate()ֻ״̬汾ݴеĲͬʱſ
+    class Staging {
+    public:
+        uint64_t position = 0;
+
+        // version1ʼ״̬ÿα仯
+        void update(uint32_t id, const std::string& symbol, uint64_t version, const State& state) {
+            if (id >= versions.size()) {
+                versions.resize(id + 1, 0);
+                entries.resize(id + 1);
+            }
+            if (versions[id] == version) return;
+            if (!entries[id]) entries[id].reset(new Entry());
+            Entry& e = *entries[id];
+            std::memset(e.symbol, 0, sizeof(e.symbol));
+            std::memcpy(e.symbol, symbol.data(), std::min(symbol.size(), sizeof(e.symbol) - 1));
+            std::memcpy(&e.state, &state, sizeof(State));
+            versions[id] = version;
+            copied++;
+        }
+
+        // ֮Ŀȥñ
+        void erase(uint32_t id) {
+            if (id < versions.size()) versions[id] = 0;
+        }
+
+        size_t copiedCount() const { return copied; } // ʵʿƷ
+
+    private:
+        friend class SnapshotWriter;
+        std::vector<std::unique_ptr<Entry>> entries;
+        std::vector<uint64_t> versions; // 0ʾñ״̬
+        size_t copied = 0;
+    };
+
+    // ļѴҲһʱţдϾɵĲۣµĿһдǰЧؽ
+    SnapshotWriter(const std::string& snapshotPath, uint64_t tag, uint32_t initialCapacity = 64)
+        : path(snapshotPath), layoutTag(tag) {
+        int fd = ::open(path.c_str(), O_RDWR);
+        if (fd >= 0) {
+            struct stat st;
+            if (::fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= SNAPSHOT_HEADER_BYTES) {
+                mapFile(fd, static_cast<size_t>(st.st_size));
+                const SnapshotSlotHeader* latest = findLatestSnapshotSlot(base, bytes, sizeof(Entry), layoutTag);
+                if (latest) generation = latest->generation;
+                else unmapFile(); // ֲûЧգؽ
+            }
+            ::close(fd);
+        }
+        if (!base) createFile(path, std::max<uint32_t>(initialCapacity, 1));
+        worker = std::thread([this] { run(); });
+    }
+
+    ~SnapshotWriter() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        worker.join();
+        unmapFile();
+    }
+
+    SnapshotWriter(const SnapshotWriter&) = delete;
+    SnapshotWriter& operator=(const SnapshotWriter&) = delete;
+
+    // ·ãȡһݿݴݶŶӻдʱnullptrȴ
+    Staging* beginCapture() {
+        for (int i = 0; i < 2; ++i) {
+            int k = (next + i) & 1;
+            if (!busy[k].load(std::memory_order_acquire)) {
+                staging[k].copied = 0;
+                return &staging[k];
+            }
+        }
+        return nullptr;
+    }
+
+    // õݴ̨߳д
+    void commitCapture(Staging* s) {
+        int k = s == &staging[0] ? 0 : 1;
+        busy[k].store(true, std::memory_order_release);
+        next = k ^ 1;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            queue.push_back(k);
+        }
+        wake.notify_one();
+    }
+
+    // ȴύĿȫ
+    void flush() {
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this] { return queue.empty() && !writing; });
+    }
+
+    uint64_t lastGeneration() const { return written.load(std::memory_order_acquire); }
+    uint64_t lastBytes() const { return lastWriteBytes.load(std::memory_order_relaxed); }
+    int64_t lastWriteNs() const { return lastWriteDuration.load(std::memory_order_relaxed); }
+
+    // ̨дʧʱĴϢɹдգ
+    std::string error() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return lastError;
+    }
+
+private:
+    std::string path;
+    uint64_t layoutTag;
+    uint8_t* base = nullptr;
+    size_t bytes = 0;
+    uint64_t generation = 0; // ̨̣߳캯
+
+    Staging staging[2];
+    std::atomic<bool> busy[2] = {{false}, {false}};
+    int next = 0;
+
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    std::deque<int> queue;
+    bool writing = false;
+    bool stopping = false;
+    std::string lastError;
+    std::atomic<uint64_t> written{0};
+    std::atomic<uint64_t> lastWriteBytes{0};
+    std::atomic<int64_t> lastWriteDuration{0};
+    std::thread worker;
+
+    SnapshotFileHeader* header() { return reinterpret_cast<SnapshotFileHeader*>(base); }
+
+    void mapFile(int fd, size_t size) {
+        void* p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) throw std::runtime_error("޷ӳļ" + path);
+        base = static_cast<uint8_t*>(p);
+        bytes = size;
+    }
+
+    void unmapFile() {
+        if (base) ::munmap(base, bytes);
+        base = nullptr;
+        bytes = 0;
+    }
+
+    // ½ļ۾Ϊգ
+    void createFile(const std::string& filePath, uint32_t capacity) {
+        size_t slotBytes = snapshotSlotBytes(sizeof(Entry), capacity);
+        size_t size = SNAPSHOT_HEADER_BYTES + 2 * slotBytes;
+        int fd = ::open(filePath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) throw std::runtime_error("޷ļ" + filePath);
+        if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            ::close(fd);
+            throw std::runtime_error("޷ÿļС" + filePath);
+        }
+        try {
+            mapFile(fd, size);
+        } catch (...) {
+            ::close(fd);
+            throw;
+        }
+        ::close(fd);
+        SnapshotFileHeader* h = header();
+        h->magic = SNAPSHOT_MAGIC;
+        h->version = SNAPSHOT_VERSION;
+        h->entrySize = sizeof(Entry);
+        h->capacity = capacity;
+        h->layoutTag = layoutTag;
+        h->slotBytes = slotBytes;
+    }
+
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            wake.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (queue.empty()) break;
+            int k = queue.front();
+            queue.pop_front();
+            writing = true;
+            lock.unlock();
+            std::string err;
+            try {
+                write(staging[k]);
+            } catch (const std::exception& e) {
+                err = e.what();
+            }
+            busy[k].store(false, std::memory_order_release);
+            lock.lock();
+            writing = false;
+            lastError = err;
+            done.notify_all();
+        }
+    }
+
+    // дϾɵĲۣдĿдͷźCRCmsyncƷʱ廻ɸļ
+    void write(const Staging& s) {
+        if (!base) throw std::runtime_error("ļã" + path);
+        timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        uint32_t count = 0;
+        for (uint64_t v : s.versions) count += v != 0;
+
+        bool grown = false;
+        if (count > header()->capacity) {
+            uint32_t capacity = header()->capacity;
+            while (capacity < count) capacity *= 2;
+            unmapFile();
+            createFile(path + ".tmp", capacity);
+            grown = true;
+        }
+
+        uint64_t gen = generation + 1;
+        size_t slotBytes = header()->slotBytes;
+        uint8_t* slot = base + SNAPSHOT_HEADER_BYTES + (gen & 1) * slotBytes;
+        uint8_t* out = slot + sizeof(SnapshotSlotHeader);
+        for (size_t id = 0; id < s.versions.size(); ++id) {
+            if (s.versions[id] == 0) continue;
+            std::memcpy(out, s.entries[id].get(), sizeof(Entry));
+            out += sizeof(Entry);
+        }
+        SnapshotSlotHeader h{};
+        h.generation = gen;
+        h.position = s.position;
+        timespec now;
+        clock_gettime(CLOCK_REALTIME, &now);
+        h.createdNs = static_cast<int64_t>(now.tv_sec) * 1000000000LL + now.tv_nsec;
+        h.count = count;
+        h.crc = snapshotSlotCrc(h, slot + sizeof(SnapshotSlotHeader), sizeof(Entry));
+        std::memcpy(slot, &h, sizeof(h));
+        size_t used = sizeof(SnapshotSlotHeader) + count * sizeof(Entry);
+        // ۰4096ֽڶ룬ҳϵͳmsyncȡҳ߽
+        static const size_t pageSize = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+        size_t offset = static_cast<size_t>(slot - base);
+        size_t syncOffset = offset / pageSize * pageSize;
+        if (::msync(grown ? base : base + syncOffset, grown ? bytes : used + (offset - syncOffset), MS_SYNC) != 0) {
+            throw std::runtime_error("дʧܣ" + path);
+        }
+        if (grown && std::rename((path + ".tmp").c_str(), path.c_str()) != 0) {
+            throw std::runtime_error("ļ滻ʧܣ" + path);
+        }
+        generation = gen;
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        written.store(gen, std::memory_order_release);
+        lastWriteBytes.store(used, std::memory_order_relaxed);
+        lastWriteDuration.store((end.tv_sec - start.tv_sec) * 1000000000LL + (end.tv_nsec - start.tv_nsec),
+                                std::memory_order_relaxed);
+    }
+};
+
+}  // namespace tradecheck
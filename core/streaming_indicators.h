@@ -0,0 +1,252 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+
+namespace tradecheck {
+
+// ʽָ꣨POD״̬ÿKO(1)£޶ѷ䣩
+// risk_protocol.hеıһ£
+//  0= 1=½ 2=̣RSI 0= 1= 2=KST 0=ϴԽ 1=´Խ 2=δԽ
+
+// ֵڡMAX_SMA_WINDOW
+const int MAX_SMA_WINDOW = 32;
+
+struct StreamingSMA {
+    int window;
+    int count;
+    int head;
+    double sum;
+    double values[MAX_SMA_WINDOW];
+
+    void reset(int w) {
+        if (w <= 0 || w > MAX_SMA_WINDOW) throw std::invalid_argument("ߴ1~32֮");
+        window = w;
+        count = 0;
+        head = 0;
+        sum = 0.0;
+    }
+
+    void update(double v) {
+        if (count == window) sum -= values[head];
+        else count++;
+        values[head] = v;
+        sum += v;
+        head = (head + 1) % window;
+    }
+
+    bool ready() const { return count == window; }
+    double value() const { return count > 0 ? sum / count : 0.0; }
+};
+
+// EMAưEMAбжϣԱ仯СflatToleranceΪ̣
+struct StreamingEMA {
+    int period;
+    int count;
+    double alpha;
+    double value;
+    double previous;
+    int trend;     // ǰƱ
+    bool isTurn;   // KǷת
+
+    void reset(int p) {
+        if (p <= 0) throw std::invalid_argument("EMAڱ0");
+        period = p;
+        count = 0;
+        alpha = 2.0 / (p + 1);
+        value = previous = 0.0;
+        trend = 2;
+        isTurn = false;
+    }
+
+    void update(double close, double flatTolerance = 1e-4) {
+        previous = value;
+        value = count == 0 ? close : value + alpha * (close - value);
+        count++;
+        int t = 2;
+        if (count > 1 && previous != 0.0) {
+            double slope = (value - previous) / previous;
+            if (slope > flatTolerance) t = 0;
+            else if (slope < -flatTolerance) t = 1;
+        }
+        isTurn = count > 2 && t != trend;
+        trend = t;
+    }
+
+    bool ready() const { return count >= period; }
+};
+
+// WilderƽRSI
+struct StreamingRSI {
+    int period;
+    int count;       // յļ۸䶯
+    double lastClose;
+    double avgGain;
+    double avgLoss;
+    bool hasClose;
+
+    void reset(int p = 14) {
+        if (p <= 0) throw std::invalid_argument("RSIڱ0");
+        period = p;
+        count = 0;
+        lastClose = avgGain = avgLoss = 0.0;
+        hasClose = false;
+    }
+
+    void update(double close) {
+        if (!hasClose) {
+            lastClose = close;
+            hasClose = true;
+            return;
+        }
+        double change = close - lastClose;
+        lastClose = close;
+        double gain = change > 0 ? change : 0.0;
+        double loss = change < 0 ? -change : 0.0;
+        count++;
+        if (count <= period) {
+            // ǰperiod䶯ȡƽ
+            avgGain += (gain - avgGain) / count;
+            avgLoss += (loss - avgLoss) / count;
+        } else {
+            avgGain = (avgGain * (period - 1) + gain) / period;
+            avgLoss = (avgLoss * (period - 1) + loss) / period;
+        }
+    }
+
+    bool ready() const { return count >= period; }
+
+    double value() const {
+        if (avgLoss == 0.0) return avgGain == 0.0 ? 50.0 : 100.0;
+        return 100.0 - 100.0 / (1.0 + avgGain / avgLoss);
+    }
+
+    // RSI루70򣬡30
+    int level() const {
+        double v = value();
+        if (v >= 70.0) return 0;
+        if (v <= 30.0) return 1;
+        return 2;
+    }
+};
+
+// WilderƽATRʵֲʣʵ = max(-, |-ǰ|, |-ǰ|)
+// ʵֲΪƽWilderƽֵÿKߣֵ裩ǰperiodȡƽ
+struct StreamingATR {
+    int period;
+    int count;        // յK
+    double prevClose;
+    double atr;
+    double meanSquare; // ƽƽֵ
+
+    void reset(int p = 14) {
+        if (p <= 0) throw std::invalid_argument("ATRڱ0");
+        period = p;
+        count = 0;
+        prevClose = atr = meanSquare = 0.0;
+    }
+
+    void update(double high, double low, double close) {
+        double tr = high - low;
+        if (count > 0) {
+            tr = std::fmax(tr, std::fmax(std::fabs(high - prevClose), std::fabs(low - prevClose)));
+            double r = prevClose > 0 && close > 0 ? std::log(close / prevClose) : 0.0;
+            meanSquare = smooth(meanSquare, r * r, count);
+        }
+        count++;
+        atr = smooth(atr, tr, count);
+        prevClose = close;
+    }
+
+    bool ready() const { return count >= period; }
+    double value() const { return atr; }
+    double realizedVolatility() const { return std::sqrt(meanSquare); }
+
+private:
+    // nƽ
+    double smooth(double mean, double sample, int n) const {
+        if (n <= period) return mean + (sample - mean) / n;
+        return (mean * (period - 1) + sample) / period;
+    }
+};
+
+// KSTROC 10/15/20/30ƽ 10/10/10/15Ȩ 1/2/3/4ź9
+const int KST_ROC_PERIODS[4] = {10, 15, 20, 30};
+const int KST_SMA_PERIODS[4] = {10, 10, 10, 15};
+const int KST_SIGNAL_PERIOD = 9;
+const int KST_CLOSE_HISTORY = 31; // ROC+1
+
+struct StreamingKST {
+    int count;
+    int head;
+    double closes[KST_CLOSE_HISTORY];
+    StreamingSMA rocSma[4];
+    StreamingSMA signal;
+    double kst;
+    double previousKst;
+    double previousSignal;
+    int cross; // KߵĴԽ
+
+    void reset() {
+        count = 0;
+        head = 0;
+        for (int i = 0; i < 4; ++i) rocSma[i].reset(KST_SMA_PERIODS[i]);
+        signal.reset(KST_SIGNAL_PERIOD);
+        kst = previousKst = previousSignal = 0.0;
+        cross = 2;
+    }
+
+    void update(double close) {
+        closes[head] = close;
+        count++;
+        for (int i = 0; i < 4; ++i) {
+            int n = KST_ROC_PERIODS[i];
+            if (count > n) {
+                double past = closes[(head - n + KST_CLOSE_HISTORY) % KST_CLOSE_HISTORY];
+                if (past != 0.0) rocSma[i].update((close - past) / past * 100.0);
+            }
+        }
+        head = (head + 1) % KST_CLOSE_HISTORY;
+
+        cross = 2;
+        if (!rocSma[3].ready()) return;
+        bool hadSignal = signal.ready();
+        previousKst = kst;
+        previousSignal = signal.value();
+        kst = 0.0;
+        for (int i = 0; i < 4; ++i) kst += (i + 1) * rocSma[i].value();
+        signal.update(kst);
+        if (hadSignal) {
+            double sig = signal.value();
+            if (previousKst <= previousSignal && kst > sig) cross = 0;
+            else if (previousKst >= previousSignal && kst < sig) cross = 1;
+        }
+    }
+
+    bool ready() const { return signal.ready(); }
+    double signalValue() const { return signal.value(); }
+};
+
+// ָ飨EMA + RSI + KST
+struct StreamingIndicatorSet {
+    StreamingEMA ema[3];
+    StreamingRSI rsi;
+    StreamingKST kst;
+
+    void reset(int fast = 20, int mid = 50, int slow = 200) {
+        ema[0].reset(fast);
+        ema[1].reset(mid);
+        ema[2].reset(slow);
+        rsi.reset(14);
+        kst.reset();
+    }
+
+    void update(double close) {
+        for (auto& e : ema) e.update(close);
+        rsi.update(close);
+        kst.update(close);
+    }
+};
+
+}  // namespace tradecheck
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "support_resistance.h"
+#include <cstdint>
+#include <stdexcept>
+#include <cmath>
+
+namespace tradecheck {
+
+// ʽ֧λ󳤶
+const int MAX_STREAM_WINDOW = 512;
+
+// ֧λPOD״ֱ̬Ӱֽڱ/ָ
+// SupportResistanceCalculatorͬһϵĽһ£
+// ߵ͵õάܼɽƽƺۼӺάÿһһۻ
+// ÿKߵĸ¾̯O(1)
+struct StreamingSupportResistance {
+    int window;                          // ڳ
+    int count;                           // ǰK
+    uint64_t total;                      // ۼKΪKţ
+    KlineData bars[MAX_STREAM_WINDOW];   // Kߴڣibars[i % MAX_STREAM_WINDOW]
+    uint64_t maxQueue[MAX_STREAM_WINDOW]; // ߼۵ݼУKţ
+    uint64_t minQueue[MAX_STREAM_WINDOW]; // ͼ۵
+    uint64_t maxHead, maxTail, minHead, minTail;
+    double reference;                    // ̼ƽƻ׼
+    double sumDelta;                     // (close - reference)
+    double sumDeltaSq;                   // (close - reference)^2
+    int sinceRebuild;                    // ϴK
+
+    // Ϊմ
+    void reset(int windowSize) {
+        if (windowSize <= 0 || windowSize > MAX_STREAM_WINDOW) throw std::invalid_argument("ʽڳ1~512֮");
+        window = windowSize;
+        count = 0;
+        total = 0;
+        maxHead = maxTail = minHead = minTail = 0;
+        reference = 0.0;
+        sumDelta = sumDeltaSq = 0.0;
+        sinceRebuild = 0;
+    }
+
+    const KlineData& bar(uint64_t seq) const { return bars[seq % MAX_STREAM_WINDOW]; }
+
+    // ǰۼӺ
+    void rebuildSums() {
+        reference = bar(total - 1).close;
+        sumDelta = sumDeltaSq = 0.0;
+        for (uint64_t s = total - count; s < total; ++s) {
+            double d = bar(s).close - reference;
+            sumDelta += d;
+            sumDeltaSq += d * d;
+        }
+        sinceRebuild = 0;
+    }
+
+    // ׷һK
+    void update(const KlineData& kd) {
+        if (kd.high < kd.low) throw std::invalid_argument("߼۵ͼ۵ЧK");
+        uint64_t seq = total;
+        // ƳɵK
+        if (count == window) {
+            double d = bar(seq - window).close - reference;
+            sumDelta -= d;
+            sumDeltaSq -= d * d;
+            count--;
+        }
+        bars[seq % MAX_STREAM_WINDOW] = kd;
+        total++;
+        count++;
+        uint64_t oldest = total - count;
+
+        // ά
+        while (maxHead < maxTail && maxQueue[maxHead % MAX_STREAM_WINDOW] < oldest) maxHead++;
+        while (minHead < minTail && minQueue[minHead % MAX_STREAM_WINDOW] < oldest) minHead++;
+        while (maxTail > maxHead && bar(maxQueue[(maxTail - 1) % MAX_STREAM_WINDOW]).high <= kd.high) maxTail--;
+        maxQueue[maxTail++ % MAX_STREAM_WINDOW] = seq;
+        while (minTail > minHead && bar(minQueue[(minTail - 1) % MAX_STREAM_WINDOW]).low >= kd.low) minTail--;
+        minQueue[minTail++ % MAX_STREAM_WINDOW] = seq;
+
+        // ά̼ۼӺ
+        if (count == 1) {
+            reference = kd.close;
+            sumDelta = sumDeltaSq = 0.0;
+            sinceRebuild = 0;
+        } else {
+            double d = kd.close - reference;
+            sumDelta += d;
+            sumDeltaSq += d * d;
+        }
+        if (++sinceRebuild >= window) rebuildSums();
+    }
+
+    bool empty() const { return count == 0; }
+
+    // ǰڵ֧λ
+    SupportResistanceLevels levels() const {
+        if (count == 0) throw std::invalid_argument("KݲΪ");
+        SupportResistanceLevels l;
+        l.highestHigh = bar(maxQueue[maxHead % MAX_STREAM_WINDOW]).high;
+        l.lowestLow = bar(minQueue[minHead % MAX_STREAM_WINDOW]).low;
+
+        const KlineData& latest = bar(total - 1);
+        l.pivotPoint = (latest.high + latest.low + latest.close) / 3.0;
+        double range = latest.high - latest.low;
+        l.s1 = 2 * l.pivotPoint - latest.high;
+        l.s2 = l.pivotPoint - range;
+        l.s3 = l.pivotPoint - 2 * range;
+        l.r1 = 2 * l.pivotPoint - latest.low;
+        l.r2 = l.pivotPoint + range;
+        l.r3 = l.pivotPoint + 2 * range;
+
+        double mean = sumDelta / count;
+        double var = sumDeltaSq / count - mean * mean;
+        double stdClose = std::sqrt(var > 0 ? var : 0.0);
+        l.denseSupport = reference + mean - stdClose;
+        l.denseResist = reference + mean + stdClose;
+        l.klineCount = count;
+        return l;
+    }
+};
+
+}  // namespace tradecheck
@@ -0,0 +1,67 @@
+#include "support_resistance.h"
+#include <stdexcept>
+#include <cmath>
+#include <algorithm>
+
+namespace tradecheck {
+
+SupportResistanceLevels computeSupportResistance(const KlineData* klines, size_t count) {
+    // УKݺϷ
+    if (count == 0) {
+        throw std::invalid_argument("KݲΪ");
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (klines[i].high < klines[i].low) {
+            throw std::invalid_argument("߼۵ͼ۵ЧK");
+        }
+    }
+
+    SupportResistanceLevels l;
+    l.klineCount = static_cast<int>(count);
+
+    // ׶ʷߵ͵
+    l.highestHigh = klines[0].high;
+    l.lowestLow = klines[0].low;
+    for (size_t i = 0; i < count; ++i) {
+        l.highestHigh = std::max(l.highestHigh, klines[i].high);
+        l.lowestLow = std::min(l.lowestLow, klines[i].low);
+    }
+
+    // Kߵ֧
+    const KlineData& latestKline = klines[count - 1]; // ȡһK
+    l.pivotPoint = (latestKline.high + latestKline.low + latestKline.close) / 3.0;
+    double range = latestKline.high - latestKline.low;
+    // ֧λ
+    l.s1 = 2 * l.pivotPoint - latestKline.high;
+    l.s2 = l.pivotPoint - range;
+    l.s3 = l.pivotPoint - 2 * range;
+    // λ
+    l.r1 = 2 * l.pivotPoint - latestKline.low;
+    l.r2 = l.pivotPoint + range;
+    l.r3 = l.pivotPoint + 2 * range;
+
+    // ܼɽ֧̼۾ֵ׼
+    double sumClose = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        sumClose += klines[i].close;
+    }
+    double avgClose = sumClose / count;
+    double sumVar = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        double d = klines[i].close - avgClose;
+        sumVar += d * d;
+    }
+    double stdClose = std::sqrt(sumVar / count);
+    // ܼɽֵ1׼
+    l.denseSupport = avgClose - stdClose;
+    l.denseResist = avgClose + stdClose;
+    return l;
+}
+
+SupportResistanceCalculator::SupportResistanceCalculator(const std::vector<KlineData>& klList, TimeFrame tf)
+    : SupportResistanceCalculator(klList.data(), klList.size(), tf) {}
+
+SupportResistanceCalculator::SupportResistanceCalculator(const KlineData* klines, size_t count, TimeFrame tf)
+    : timeframe(tf), levels(computeSupportResistance(klines, count)) {}
+
+}  // namespace tradecheck
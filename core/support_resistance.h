@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace tradecheck {
+
+// ʱö
+enum class TimeFrame {
+    DAILY,    // 
+    FOUR_HOUR // 4Сʱ
+};
+
+// Kݽṹ壨KߵĿ////ɽ
+struct KlineData {
+    double open;   // ̼
+    double high;   // ߼
+    double low;    // ͼ
+    double close;  // ̼
+    double volume; // ɽѡܼɽ㣩
+};
+
+// һƷֵKУƷּ룬ݣ
+struct KlineSeries {
+    const KlineData* klines;
+    size_t count;
+};
+
+// ȫ֧λл/̴䣩
+struct SupportResistanceLevels {
+    double highestHigh, lowestLow;
+    double pivotPoint, s1, s2, s3, r1, r2, r3;
+    double denseSupport, denseResist;
+    int klineCount;
+};
+
+// һKߵȫ֧λڴ棬Kݣ
+SupportResistanceLevels computeSupportResistance(const KlineData* klines, size_t count);
+
+// K֧ѹλ
+class SupportResistanceCalculator {
+private:
+    TimeFrame timeframe;              // ʱ
+    SupportResistanceLevels levels;   // 
+
+public:
+    // 캯Kߺʱ
+    SupportResistanceCalculator(const std::vector<KlineData>& klList, TimeFrame tf);
+    SupportResistanceCalculator(const KlineData* klines, size_t count, TimeFrame tf);
+
+    // Getter
+    double getHighestHigh() const { return levels.highestHigh; }
+    double getLowestLow() const { return levels.lowestLow; }
+    double getDenseSupport() const { return levels.denseSupport; }
+    double getDenseResist() const { return levels.denseResist; }
+    TimeFrame getTimeframe() const { return timeframe; }
+
+    // ȡȫ֧λ
+    const SupportResistanceLevels& getLevels() const { return levels; }
+};
+
+}  // namespace tradecheck
@@ -0,0 +1,165 @@
+#include "swing_zones.h"
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <exception>
+#include <stdexcept>
+#include <thread>
+
+namespace tradecheck {
+
+namespace {
+
+// 񲽳Ϊ1/4˽ضڡ3
+const int GRID_PER_BANDWIDTH = 4;
+const int KERNEL_RADIUS = 3 * GRID_PER_BANDWIDTH;
+const size_t MAX_GRID = 1 << 22;
+
+// out[j] = j..j+window-1K߼۵ֵuseHighͼ۵СֵO(n)
+std::vector<double> slidingExtreme(const KlineData* klines, size_t count, size_t window, bool useHigh) {
+    auto value = [&](size_t i) { return useHigh ? klines[i].high : klines[i].low; };
+    auto dominates = [&](double a, double b) { return useHigh ? a >= b : a <= b; };
+    std::vector<double> out;
+    if (count < window) return out;
+    out.reserve(count - window + 1);
+    std::deque<size_t> q;
+    for (size_t i = 0; i < count; ++i) {
+        while (!q.empty() && dominates(value(i), value(q.back()))) q.pop_back();
+        q.push_back(i);
+        if (q.front() + window <= i) q.pop_front();
+        if (i + 1 >= window) out.push_back(value(q.front()));
+    }
+    return out;
+}
+
+// ۸ϵİڶ
+struct WeightedSwing {
+    double x;
+    double weight;
+    size_t index;
+    bool isHigh;
+};
+
+void validate(const SwingZoneOptions& opt) {
+    if (opt.radius < 1 || opt.radius > 1000) throw std::invalid_argument("ڶȽϷΧ1~1000K֮");
+    if (!(opt.bandwidthPercent > 0 && opt.bandwidthPercent < 100)) throw std::invalid_argument("ܶȴ0~100%֮");
+    if (!(opt.recencyHalfLife >= 0)) throw std::invalid_argument("Ȩذ˥ڲΪ");
+    if (opt.minSwings < 1) throw std::invalid_argument("ٰڶС1");
+}
+
+}  // namespace
+
+std::vector<SwingPoint> detectSwingPoints(const KlineData* klines, size_t count, int radius) {
+    if (radius < 1) throw std::invalid_argument("ڶȽϷΧС1");
+    std::vector<SwingPoint> out;
+    size_t r = static_cast<size_t>(radius);
+    if (count < 2 * r + 1) return out;
+    // i෶ΧΪ[i-r, i-1]ҲΪ[i+1, i+r]
+    std::vector<double> maxHigh = slidingExtreme(klines, count, r, true);
+    std::vector<double> minLow = slidingExtreme(klines, count, r, false);
+    for (size_t i = r; i + r < count; ++i) {
+        const KlineData& k = klines[i];
+        if (k.high > maxHigh[i - r] && k.high >= maxHigh[i + 1]) out.push_back({i, k.high, true});
+        if (k.low < minLow[i - r] && k.low <= minLow[i + 1]) out.push_back({i, k.low, false});
+    }
+    return out;
+}
+
+std::vector<SwingZone> computeSwingZones(const KlineData* klines, size_t count, const SwingZoneOptions& opt) {
+    validate(opt);
+    for (size_t i = 0; i < count; ++i) {
+        if (klines[i].high < klines[i].low) throw std::invalid_argument("߼۵ͼ۵ЧK");
+    }
+    std::vector<WeightedSwing> swings;
+    for (const auto& p : detectSwingPoints(klines, count, opt.radius)) {
+        if (!(p.price > 0) || !std::isfinite(p.price)) continue;
+        double age = static_cast<double>(count - 1 - p.index);
+        double w = opt.recencyHalfLife > 0 ? std::exp2(-age / opt.recencyHalfLife) : 1.0;
+        swings.push_back({std::log(p.price), w, p.index, p.isHigh});
+    }
+    std::vector<SwingZone> zones;
+    if (swings.empty()) return zones;
+    std::sort(swings.begin(), swings.end(), [](const WeightedSwing& a, const WeightedSwing& b) { return a.x < b.x; });
+
+    // Է䵽˹˾ֻչǿո
+    double bandwidth = std::log1p(opt.bandwidthPercent / 100.0);
+    double step = bandwidth / GRID_PER_BANDWIDTH;
+    double origin = swings.front().x - (KERNEL_RADIUS + 1) * step;
+    size_t grid = static_cast<size_t>((swings.back().x - origin) / step) + KERNEL_RADIUS + 3;
+    if (grid > MAX_GRID) throw std::invalid_argument("۸Ժܶȴ");
+    std::vector<double> mass(grid, 0.0), density(grid, 0.0);
+    for (const auto& s : swings) {
+        double pos = (s.x - origin) / step;
+        size_t g = static_cast<size_t>(pos);
+        double f = pos - g;
+        mass[g] += s.weight * (1 - f);
+        mass[g + 1] += s.weight * f;
+    }
+    double kernel[2 * KERNEL_RADIUS + 1];
+    for (int k = -KERNEL_RADIUS; k <= KERNEL_RADIUS; ++k) {
+        double u = static_cast<double>(k) / GRID_PER_BANDWIDTH;
+        kernel[k + KERNEL_RADIUS] = std::exp(-0.5 * u * u);
+    }
+    for (size_t g = 0; g < grid; ++g) {
+        if (mass[g] == 0) continue;
+        size_t begin = g >= static_cast<size_t>(KERNEL_RADIUS) ? g - KERNEL_RADIUS : 0;
+        size_t end = std::min(grid, g + KERNEL_RADIUS + 1);
+        for (size_t j = begin; j < end; ++j) density[j] += mass[g] * kernel[j + KERNEL_RADIUS - g];
+    }
+
+    // ÿֲ쵽߻ȵףͳڵİڶ
+    for (size_t g = 1; g + 1 < grid; ++g) {
+        double peak = density[g];
+        if (!(peak > density[g - 1] && peak >= density[g + 1])) continue;
+        double half = peak / 2;
+        size_t left = g, right = g;
+        while (left > 0 && density[left - 1] >= half && density[left - 1] <= density[left]) --left;
+        while (right + 1 < grid && density[right + 1] >= half && density[right + 1] <= density[right]) ++right;
+        double xLow = origin + left * step, xHigh = origin + right * step;
+        auto first = std::lower_bound(swings.begin(), swings.end(), xLow,
+                                      [](const WeightedSwing& s, double x) { return s.x < x; });
+        SwingZone z{std::exp(xLow), std::exp(xHigh), std::exp(origin + g * step), 0, 0, 0.0, 0};
+        for (auto it = first; it != swings.end() && it->x <= xHigh; ++it) {
+            if (it->isHigh) ++z.swingHighs;
+            else ++z.swingLows;
+            z.strength += it->weight;
+            z.lastSwing = std::max(z.lastSwing, it->index);
+        }
+        if (z.swingHighs + z.swingLows >= static_cast<uint32_t>(opt.minSwings)) zones.push_back(z);
+    }
+    std::stable_sort(zones.begin(), zones.end(),
+                     [](const SwingZone& a, const SwingZone& b) { return a.strength > b.strength; });
+    if (opt.maxZones > 0 && zones.size() > opt.maxZones) zones.resize(opt.maxZones);
+    return zones;
+}
+
+std::vector<std::vector<SwingZone>> computeSwingZonesBatch(const std::vector<KlineSeries>& series,
+                                                           const SwingZoneOptions& opt, unsigned threads) {
+    validate(opt);
+    size_t count = series.size();
+    std::vector<std::vector<SwingZone>> out(count);
+    unsigned threadCount = threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+    if (threadCount > count) threadCount = static_cast<unsigned>(std::max<size_t>(count, 1));
+
+    // ̵߳쳣ص߳׳
+    std::vector<std::exception_ptr> errors(threadCount);
+    auto worker = [&](unsigned t) {
+        size_t begin = count * t / threadCount;
+        size_t end = count * (t + 1) / threadCount;
+        try {
+            for (size_t i = begin; i < end; ++i) out[i] = computeSwingZones(series[i].klines, series[i].count, opt);
+        } catch (...) {
+            errors[t] = std::current_exception();
+        }
+    };
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threadCount; ++t) pool.emplace_back(worker, t);
+    worker(0);
+    for (auto& th : pool) th.join();
+    for (const auto& e : errors) {
+        if (e) std::rethrow_exception(e);
+    }
+    return out;
+}
+
+}  // namespace tradecheck
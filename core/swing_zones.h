@@ -0,0 +1,53 @@
+#pragma once
+
+#include "support_resistance.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace tradecheck {
+
+// ڶ֧Ӽ۸ʵת۵λ򣬶ǰʽ
+// 1. ΰڶ㣺߼ϸǰradiusںradiusKΪڶߵ㣨͵ԳƣֵO(n)
+// 2. ڶ۸϶԰ڶһάܶȹƣ˹ˣΪ۸ٷֱȣ
+//    Է䵽ȾضϺ˾ʱO(ڶ + ˿)
+// 3. ܶȵÿֲΪһ쵽ܶȽֵһȵΪֹ
+// ǿΪڵİڶȨ֮ͣɰKָ˥
+
+struct SwingZoneOptions {
+    int radius = 3;                 // ҸȽϵK
+    double bandwidthPercent = 0.5;  // ܶȴ۸ٷֱȣ
+    double recencyHalfLife = 0;     // ڶȨذ˥ڣK0ʾ˥
+    int minSwings = 2;              // ٰİڶ
+    size_t maxZones = 10;           // ǿȱ0ʾޣ
+};
+
+struct SwingZone {
+    double low;     // 
+    double high;    // 
+    double center;  // ܶȷֵ۸
+    uint32_t swingHighs; // ڰڶߵ
+    uint32_t swingLows;  // ڰڶ͵
+    double strength;     // ڰڶȨ֮
+    size_t lastSwing;    // һڶK±
+
+    double width() const { return high - low; }
+};
+
+struct SwingPoint {
+    size_t index;
+    double price;
+    bool isHigh;
+};
+
+// ʱ˳򷵻ذڶ㣨ͬһK߿ͬʱǸߵ͵͵㣩
+std::vector<SwingPoint> detectSwingPoints(const KlineData* klines, size_t count, int radius);
+
+// һKߵ֧ǿȽ
+std::vector<SwingZone> computeSwingZones(const KlineData* klines, size_t count, const SwingZoneOptions& opt);
+
+// Ʒֲм㣨threadsΪ0ʱCPU˳һһӦ
+std::vector<std::vector<SwingZone>> computeSwingZonesBatch(const std::vector<KlineSeries>& series,
+                                                           const SwingZoneOptions& opt, unsigned threads = 0);
+
+}  // namespace tradecheck
@@ -0,0 +1,298 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <stdexcept>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace tradecheck {
+
+// ڴ黷λ壨/dev/shm/ߣ
+// ߴӲȴߣÿλţseqlock߸άλã
+// ȡУţλѱжΪ׷βɵЧλ
+
+const uint32_t TICK_RING_MAGIC = 0x474E5254; // "TRNG"
+const uint32_t TICK_RING_VERSION = 2;
+const int TICK_RING_MAX_SYMBOLS = 4096;
+const int TICK_SYMBOL_LENGTH = 16;
+
+// ¼
+enum class TickKind : uint8_t {
+    TRADE = 0,  // ɽprice/quantity
+    MARK = 1,   // Ǽ۸price
+    CANDLE = 2  // Ḳopen/high/low/price()/quantity(ɽ)
+};
+
+// ¼Уֱӳڴ϶ȡֶΣ
+struct alignas(64) TickRecord {
+    std::atomic<uint64_t> sequence; // дɺΪ(дλ+1)дΪUINT64_MAX
+    int64_t publishNs;              // ߷ʱ̣CLOCK_MONOTONIC룬ڶ˵ӳ٣
+    int64_t eventTime;              // ʱ䣨룩
+    uint32_t symbolId;              // ƷֱţRingHeader::symbols
+    TickKind kind;
+    uint8_t reserved[3];
+    double price;
+    double quantity;
+    double open;
+    double high;
+    double low;
+};
+static_assert(sizeof(TickRecord) == 128, "TickRecordΪ128ֽ");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "ڴеԭӱ");
+
+// ڴͷ
+struct RingHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t capacity;      // λ2ݣ
+    uint64_t recordSize;
+    std::atomic<uint64_t> generation; // ţʼڼΪ0ÿѯȶԣ仯ӳ
+    alignas(64) std::atomic<uint64_t> writePos;    // ѷ¼
+    alignas(64) std::atomic<uint32_t> symbolCount; // ѵǼƷ
+    char symbols[TICK_RING_MAX_SYMBOLS][TICK_SYMBOL_LENGTH];
+};
+
+// ǰʱӣ룩
+inline int64_t monotonicNs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+// ڴӳֽ
+inline size_t tickRingBytes(uint64_t capacity) {
+    return sizeof(RingHeader) + capacity * sizeof(TickRecord);
+}
+
+// ߣÿֻһ
+class TickRingProducer {
+private:
+    std::string name;
+    RingHeader* header = nullptr;
+    TickRecord* slots = nullptr;
+    size_t bytes = 0;
+    uint64_t mask = 0;
+
+public:
+    TickRingProducer(const std::string& shmName, uint64_t capacity) : name(shmName) {
+        if (capacity == 0 || (capacity & (capacity - 1)) != 0) throw std::invalid_argument("λΪ2");
+        bytes = tickRingBytes(capacity);
+        int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0644);
+        if (fd < 0) throw std::runtime_error("޷ڴ棺" + name);
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            close(fd);
+            throw std::runtime_error("޷ȡڴС" + name);
+        }
+        // жֻ԰ɴСӳСβᴥSIGBUS
+        if (static_cast<size_t>(st.st_size) < bytes && ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+            close(fd);
+            throw std::runtime_error("޷ùڴС" + name);
+        }
+        void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (p == MAP_FAILED) throw std::runtime_error("޷ӳ乲ڴ棺" + name);
+        header = static_cast<RingHeader*>(p);
+        slots = reinterpret_cast<TickRecord*>(static_cast<char*>(p) + sizeof(RingHeader));
+        mask = capacity - 1;
+
+        // ʼͷȰѴӳֹͣȡд룬߾ݴжϻѾ
+        header->generation.store(0, std::memory_order_release);
+        header->magic = 0;
+        header->version = TICK_RING_VERSION;
+        header->capacity = capacity;
+        header->recordSize = sizeof(TickRecord);
+        header->writePos.store(0, std::memory_order_relaxed);
+        header->symbolCount.store(0, std::memory_order_relaxed);
+        for (uint64_t i = 0; i < capacity; ++i) slots[i].sequence.store(0, std::memory_order_relaxed);
+        header->magic = TICK_RING_MAGIC;
+        header->generation.store(static_cast<uint64_t>(monotonicNs()), std::memory_order_release);
+    }
+
+    ~TickRingProducer() {
+        if (header) munmap(header, bytes);
+    }
+
+    TickRingProducer(const TickRingProducer&) = delete;
+    TickRingProducer& operator=(const TickRingProducer&) = delete;
+
+    // ɾڴӳ߲Ӱ죩
+    void unlinkShm() {
+        shm_unlink(name.c_str());
+    }
+
+    // ǼƷֲرţƳ15ֽʱܾضϻòͬƷֹһţ
+    uint32_t registerSymbol(const std::string& symbol) {
+        if (symbol.empty() || symbol.size() >= static_cast<size_t>(TICK_SYMBOL_LENGTH)) {
+            throw std::invalid_argument("ƷΪ1~" + std::to_string(TICK_SYMBOL_LENGTH - 1) + "ֽڣ" + symbol);
+        }
+        uint32_t count = header->symbolCount.load(std::memory_order_relaxed);
+        for (uint32_t i = 0; i < count; ++i) {
+            if (std::strncmp(header->symbols[i], symbol.c_str(), TICK_SYMBOL_LENGTH) == 0) return i;
+        }
+        if (count >= static_cast<uint32_t>(TICK_RING_MAX_SYMBOLS)) throw std::invalid_argument("Ʒڴ");
+        std::memset(header->symbols[count], 0, TICK_SYMBOL_LENGTH);
+        std::strncpy(header->symbols[count], symbol.c_str(), TICK_SYMBOL_LENGTH - 1);
+        header->symbolCount.store(count + 1, std::memory_order_release);
+        return count;
+    }
+
+    // һ¼
+    void publish(uint32_t symbolId, TickKind kind, int64_t eventTime, double price, double quantity,
+                 double open = 0.0, double high = 0.0, double low = 0.0) {
+        uint64_t pos = header->writePos.load(std::memory_order_relaxed);
+        TickRecord& r = slots[pos & mask];
+        r.sequence.store(UINT64_MAX, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        r.eventTime = eventTime;
+        r.symbolId = symbolId;
+        r.kind = kind;
+        r.price = price;
+        r.quantity = quantity;
+        r.open = open;
+        r.high = high;
+        r.low = low;
+        r.publishNs = monotonicNs();
+        r.sequence.store(pos + 1, std::memory_order_release);
+        header->writePos.store(pos + 1, std::memory_order_release);
+    }
+
+    uint64_t published() const { return header->writePos.load(std::memory_order_relaxed); }
+};
+
+// ߣֻӳ䣬Ӱ죩
+class TickRingConsumer {
+private:
+    std::string name;
+    const RingHeader* header = nullptr;
+    const TickRecord* slots = nullptr;
+    size_t bytes = 0;
+    uint64_t mask = 0;
+    uint64_t capacity = 0;
+    uint64_t generation = 0;
+    uint64_t readPos = 0;
+    uint64_t lost = 0;  // ׷βʧļ¼
+
+    // ǰСӳ乲ڴ沢Уʽɹ滻ԭӳ䣨ʧʱԭӳ䱣ֲ䣩
+    void attach() {
+        int fd = shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd < 0) throw std::runtime_error("ڴ治ڣδ" + name);
+        struct stat st;
+        if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(RingHeader)) {
+            close(fd);
+            throw std::runtime_error("ڴС쳣" + name);
+        }
+        size_t size = static_cast<size_t>(st.st_size);
+        void* p = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (p == MAP_FAILED) throw std::runtime_error("޷ӳ乲ڴ棺" + name);
+        const RingHeader* h = static_cast<const RingHeader*>(p);
+        uint64_t g = h->generation.load(std::memory_order_acquire);
+        if (g == 0 || h->magic != TICK_RING_MAGIC || h->version != TICK_RING_VERSION ||
+            h->recordSize != sizeof(TickRecord) || tickRingBytes(h->capacity) > size) {
+            munmap(p, size);
+            throw std::runtime_error("ڴʽƥδ" + name);
+        }
+        if (header) munmap(const_cast<RingHeader*>(header), bytes);
+        header = h;
+        bytes = size;
+        generation = g;
+        slots = reinterpret_cast<const TickRecord*>(static_cast<const char*>(p) + sizeof(RingHeader));
+        capacity = h->capacity;
+        mask = capacity - 1;
+    }
+
+    // ű仯ıԭӳĴСλֶʧЧ
+    bool stale() const {
+        return header->generation.load(std::memory_order_acquire) != generation || header->capacity != capacity;
+    }
+
+public:
+    // fromStart=trueʱӻɵЧ¼ʼֻ¼¼
+    explicit TickRingConsumer(const std::string& shmName, bool fromStart = false) : name(shmName) {
+        attach();
+        uint64_t w = header->writePos.load(std::memory_order_acquire);
+        readPos = fromStart ? (w > capacity ? w - capacity : 0) : w;
+    }
+
+    ~TickRingConsumer() {
+        if (header) munmap(const_cast<RingHeader*>(header), bytes);
+    }
+
+    TickRingConsumer(const TickRingConsumer&) = delete;
+    TickRingConsumer& operator=(const TickRingConsumer&) = delete;
+
+    // 㿽ȡһ¼ڹڴеĵַ¼¼nullptr
+    // ʹ÷ֶκcommit()У飬falseʾ¼ڶȡڼ䱻ǣֶ
+    const TickRecord* peek() {
+        if (stale()) {
+            // ´Сӳ䲢ͷ棻ڳʼʱ޼¼´ѯ
+            try {
+                attach();
+            } catch (const std::runtime_error&) {
+                return nullptr;
+            }
+            readPos = 0;
+        }
+        while (true) {
+            uint64_t w = header->writePos.load(std::memory_order_acquire);
+            if (readPos >= w) return nullptr;
+            if (w - readPos > capacity) {
+                lost += w - capacity - readPos;
+                readPos = w - capacity;
+            }
+            const TickRecord& r = slots[readPos & mask];
+            if (r.sequence.load(std::memory_order_acquire) == readPos + 1) return &r;
+            // λдѱ׷ϣ
+            lost++;
+            readPos++;
+        }
+    }
+
+    // У鲢ǰһ¼
+    bool commit(const TickRecord* r) {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        bool valid = r->sequence.load(std::memory_order_relaxed) == readPos + 1 &&
+                     header->generation.load(std::memory_order_relaxed) == generation;
+        if (!valid) lost++;
+        readPos++;
+        return valid;
+    }
+
+    // ָλýŶȡӿջָظλ֮ļ¼Ƿ񶼻ڻ
+    // ѱʱ붪ʧɵЧ¼ʼλóдλãʱͬɵļ¼ʼ
+    bool seek(uint64_t position) {
+        uint64_t w = header->writePos.load(std::memory_order_acquire);
+        uint64_t oldest = w > capacity ? w - capacity : 0;
+        if (position > w) {
+            readPos = oldest;
+            return false;
+        }
+        if (position < oldest) {
+            lost += oldest - position;
+            readPos = oldest;
+            return false;
+        }
+        readPos = position;
+        return true;
+    }
+
+    // Ʒ
+    std::string symbolName(uint32_t id) const {
+        if (id >= header->symbolCount.load(std::memory_order_acquire)) return "";
+        return std::string(header->symbols[id], strnlen(header->symbols[id], TICK_SYMBOL_LENGTH));
+    }
+
+    uint64_t lostRecords() const { return lost; }
+    uint64_t position() const { return readPos; }
+    uint64_t backlog() const { return header->writePos.load(std::memory_order_relaxed) - readPos; }
+    uint64_t writePosition() const { return header->writePos.load(std::memory_order_acquire); }
+};
+
+}  // namespace tradecheck
@@ -0,0 +1,233 @@
+#include "tradecheck_c.h"
+#include "crypto_risk.h"
+#include "support_resistance.h"
+#include "consistency_score.h"
+#include "contract_registry.h"
+#include "risk_protocol.h"
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <algorithm>
+
+using namespace tradecheck;
+
+static_assert(sizeof(tc_kline) == sizeof(KlineData), "tc_klineKlineDataһ");
+static_assert(sizeof(tc_sr_levels) == sizeof(SupportResistanceLevels), "tc_sr_levelsSupportResistanceLevelsһ");
+
+struct tc_registry {
+    ContractRegistry registry;
+    explicit tc_registry(const std::vector<ContractSpec>& specs) : registry(specs) {}
+};
+
+namespace {
+
+thread_local std::string g_lastError;
+
+tc_status fail(tc_status status, const char* message) {
+    g_lastError = message;
+    return status;
+}
+
+// C++쳣תΪ״̬루쳣C߽磩
+template <typename Fn>
+tc_status guarded(Fn fn) {
+    try {
+        return fn();
+    } catch (const std::invalid_argument& e) {
+        return fail(TC_INVALID_ARGUMENT, e.what());
+    } catch (const std::exception& e) {
+        return fail(TC_INTERNAL_ERROR, e.what());
+    } catch (...) {
+        return fail(TC_INTERNAL_ERROR, "δ֪");
+    }
+}
+
+std::vector<ContractSpec> loadSpecs(const char* path) {
+    if (!path) return defaultContracts();
+    return loadContractConfig(path);
+}
+
+}  // namespace
+
+extern "C" {
+
+int tc_abi_version(void) {
+    return TC_ABI_VERSION;
+}
+
+const char* tc_last_error(void) {
+    return g_lastError.c_str();
+}
+
+tc_status tc_registry_create(const char* config_path, tc_registry** out) {
+    if (!out) return fail(TC_INVALID_ARGUMENT, "ָΪ");
+    *out = nullptr;
+    try {
+        *out = new tc_registry(loadSpecs(config_path));
+        return TC_OK;
+    } catch (const std::invalid_argument& e) {
+        return fail(TC_IO_ERROR, e.what());
+    } catch (const std::exception& e) {
+        return fail(TC_INTERNAL_ERROR, e.what());
+    }
+}
+
+tc_status tc_registry_reload(tc_registry* registry, const char* config_path) {
+    if (!registry) return fail(TC_INVALID_ARGUMENT, "עΪ");
+    try {
+        registry->registry.replace(loadSpecs(config_path));
+        return TC_OK;
+    } catch (const std::invalid_argument& e) {
+        return fail(TC_IO_ERROR, e.what());
+    } catch (const std::exception& e) {
+        return fail(TC_INTERNAL_ERROR, e.what());
+    }
+}
+
+tc_status tc_registry_lookup(tc_registry* registry, const char* symbol, tc_contract* out) {
+    if (!registry || !symbol || !out) return fail(TC_INVALID_ARGUMENT, "Ϊָ");
+    return guarded([&]() {
+        ContractRegistry::Reader reader(registry->registry);
+        ContractRegistry::Snapshot table = reader.lock();
+        uint32_t id = table->find(symbol, std::strlen(symbol));
+        if (id == INVALID_CONTRACT_ID) return fail(TC_UNKNOWN_SYMBOL, "δõĺԼ");
+        const ContractSpec& spec = table->spec(id);
+        out->risk_threshold = spec.riskThreshold;
+        out->maintenance_margin_rate = spec.maintenanceMarginRate;
+        out->tick_size = spec.tickSize;
+        out->contract_type = spec.type == ContractType::INVERSE_COIN ? TC_INVERSE_COIN : TC_LINEAR_USDT;
+        out->reserved = 0;
+        return TC_OK;
+    });
+}
+
+void tc_registry_destroy(tc_registry* registry) {
+    delete registry;
+}
+
+tc_status tc_risk_compute(const tc_contract* contract, const tc_position* position, tc_risk_result* out) {
+    if (!contract || !position || !out) return fail(TC_INVALID_ARGUMENT, "Ϊָ");
+    if (position->direction != TC_LONG && position->direction != TC_SHORT) return fail(TC_INVALID_ARGUMENT, "׷Ч");
+    if (contract->contract_type != TC_LINEAR_USDT && contract->contract_type != TC_INVERSE_COIN) {
+        return fail(TC_INVALID_ARGUMENT, "ԼЧ");
+    }
+    // NaN/infƹ < / <= 飬ܾ
+    const tc_contract& c = *contract;
+    const tc_position& p = *position;
+    if (!std::isfinite(c.risk_threshold) || c.risk_threshold <= 0 || !std::isfinite(c.maintenance_margin_rate) ||
+        c.maintenance_margin_rate < 0 || c.maintenance_margin_rate >= 1 || !std::isfinite(c.tick_size) || c.tick_size <= 0) {
+        return fail(TC_INVALID_ARGUMENT, "ԼΪֵֵС۸䶯0άֱ֤0~1֮䣩");
+    }
+    if (!std::isfinite(p.leverage) || p.leverage < 1) return fail(TC_INVALID_ARGUMENT, "ܸ˱Ϊ1ֵ");
+    if (!std::isfinite(p.position_ratio) || p.position_ratio < 0 || p.position_ratio > 100) {
+        return fail(TC_INVALID_ARGUMENT, "λռȱΪ0~100ֵ֮");
+    }
+    if (!std::isfinite(p.entry_price) || p.entry_price <= 0) return fail(TC_INVALID_ARGUMENT, "볡۸Ϊ0ֵ");
+    if (!std::isfinite(p.total_capital) || p.total_capital <= 0) return fail(TC_INVALID_ARGUMENT, "ʽΪ0ֵ");
+    return guarded([&]() {
+        ContractSpec spec{};
+        spec.riskThreshold = contract->risk_threshold;
+        spec.maintenanceMarginRate = contract->maintenance_margin_rate;
+        spec.tickSize = contract->tick_size;
+        spec.type = contract->contract_type == TC_INVERSE_COIN ? ContractType::INVERSE_COIN : ContractType::LINEAR_USDT;
+        spec.enabled = true;
+        CryptoRiskCalculator calc(spec, position->leverage, position->position_ratio, position->entry_price,
+                                  position->direction == TC_LONG ? TradeDirection::LONG : TradeDirection::SHORT,
+                                  position->total_capital);
+        out->threshold = calc.getThreshold();
+        out->risk_coefficient = calc.calculateRiskCoefficient();
+        out->initial_margin = calc.getInitialMargin();
+        out->maintenance_margin = calc.getMaintenanceMargin();
+        out->margin_to_add = calc.calculateMarginToAdd();
+        out->liquidation_price = calc.calculateLiquidationPrice();
+        out->risk_level = static_cast<int32_t>(calc.classifyRiskLevel());
+        out->reserved = 0;
+        return TC_OK;
+    });
+}
+
+tc_status tc_sr_compute(const tc_kline* klines, size_t count, tc_sr_levels* out) {
+    if ((!klines && count > 0) || !out) return fail(TC_INVALID_ARGUMENT, "Ϊָ");
+    return guarded([&]() {
+        SupportResistanceLevels levels = computeSupportResistance(reinterpret_cast<const KlineData*>(klines), count);
+        std::memcpy(out, &levels, sizeof(levels));
+        return TC_OK;
+    });
+}
+
+tc_status tc_score(const tc_trade_analysis* analysis, tc_score_result* out, char* text, size_t text_size,
+                   size_t* text_needed) {
+    if (!analysis || !out || (analysis->pattern_count > 0 && !analysis->patterns)) {
+        return fail(TC_INVALID_ARGUMENT, "Ϊָ");
+    }
+    return guarded([&]() {
+        const tc_trade_analysis& a = *analysis;
+        bool codesValid = a.open_dir < 2 && a.long_trend < 3 && a.mid_trend < 3 && a.short_trend < 3 && a.rsi_level < 3;
+        for (int i = 0; i < 3; ++i) codesValid = codesValid && a.ema_trend[i] < 3 && a.kst_cross[i] < 3;
+        for (size_t i = 0; i < a.pattern_count; ++i) {
+            const tc_pattern& p = a.patterns[i];
+            codesValid = codesValid && p.pattern < PRICE_PATTERN_COUNT && p.timeframe < 3 && p.break_dir < 3;
+        }
+        if (!codesValid) return fail(TC_INVALID_ARGUMENT, "볬Χ");
+        if (a.leverage < 1) return fail(TC_INVALID_ARGUMENT, "ܸ˱1");
+        if (!std::isfinite(a.open_price) || a.open_price <= 0) return fail(TC_INVALID_ARGUMENT, "۱Ϊ0ֵ");
+        if (!std::isfinite(a.stop_loss) || a.stop_loss <= 0) return fail(TC_INVALID_ARGUMENT, "ֹ۱Ϊ0ֵ");
+        if (a.short_trend_line_break_times < 0) return fail(TC_INVALID_ARGUMENT, "ͻƴΪ");
+        if (!std::isfinite(a.atr_rate) || a.atr_rate < 0) return fail(TC_INVALID_ARGUMENT, "ATRΪ޷Ǹ");
+
+        TradeAnalysis ta{};
+        ta.openDir = DIR_NAMES[a.open_dir];
+        ta.leverage = a.leverage;
+        ta.openPrice = a.open_price;
+        ta.stopLoss = a.stop_loss;
+        ta.longTrend = TREND_NAMES[a.long_trend];
+        ta.midTrend = TREND_NAMES[a.mid_trend];
+        ta.shortTrend = TREND_NAMES[a.short_trend];
+        ta.shortTrendLineBreakTimes = a.short_trend_line_break_times;
+        ta.rsiLevel = RSI_NAMES[a.rsi_level];
+        const Timeframe tfs[3] = {Timeframe::TF_4H, Timeframe::TF_DAY, Timeframe::TF_WEEK};
+        for (int i = 0; i < 3; ++i) {
+            ta.emaList.push_back({tfs[i], 0, TREND_NAMES[a.ema_trend[i]], false});
+            ta.kstList.push_back({tfs[i], {}, KST_CROSS_NAMES[a.kst_cross[i]]});
+        }
+        for (size_t i = 0; i < a.pattern_count; ++i) {
+            const tc_pattern& p = a.patterns[i];
+            ta.pricePatterns.push_back({PRICE_PATTERN_NAMES[p.pattern], static_cast<PatternTimeframe>(p.timeframe),
+                                        static_cast<TriangleBreakDir>(p.break_dir)});
+        }
+        ta.atrRate = a.atr_rate;
+        updateStopLossRates(ta);
+
+        bool highRisk = false;
+        out->total_score = calculateTotalConsistency(ta, highRisk);
+        out->ema_score = calculateEMAConsistency(ta.emaList);
+        out->kst_score = calculateKSTConsistency(ta.kstList);
+        out->dir_match_score = calculateDirTrendMatchScore(ta);
+        out->high_lever_risk = highRisk ? 1 : 0;
+        out->stop_loss_rate = ta.stopLossRate;
+        out->lever_stop_loss_risk = ta.leverStopLossRisk;
+        std::vector<std::string> contradictions = analyzeContradictions(ta, highRisk);
+        out->contradiction_count = static_cast<int32_t>(contradictions.size());
+
+        // ƴìܵı
+        size_t needed = 1;
+        for (size_t i = 0; i < contradictions.size(); ++i) needed += contradictions[i].size() + (i > 0 ? 1 : 0);
+        if (text_needed) *text_needed = needed;
+        if (!text) return TC_OK;
+        if (text_size == 0) return fail(TC_BUFFER_TOO_SMALL, "ìܵı岻");
+        size_t pos = 0;
+        for (size_t i = 0; i < contradictions.size() && pos + 1 < text_size; ++i) {
+            if (i > 0) text[pos++] = '\n';
+            size_t n = std::min(contradictions[i].size(), text_size - 1 - pos);
+            std::memcpy(text + pos, contradictions[i].data(), n);
+            pos += n;
+        }
+        text[pos] = '\0';
+        if (needed > text_size) return fail(TC_BUFFER_TOO_SMALL, "ìܵı岻");
+        return TC_OK;
+    });
+}
+
+}  // extern "C"
@@ -0,0 +1,158 @@
+#ifndef TRADECHECK_C_H
+#define TRADECHECK_C_H
+
+/* ļCӿڣǿƽ/֤֧λһ
+ * к׳쳣tc_statusʧʱtc_last_error()ȡ̵߳ĴϢUTF-8
+ * ṹ岼TC_ABI_VERSION̶ֻڰ汾ű仯ʱ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#define TC_API __declspec(dllexport)
+#else
+#define TC_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TC_ABI_VERSION 2
+
+/* ״̬ */
+typedef enum tc_status {
+    TC_OK = 0,
+    TC_INVALID_ARGUMENT = 1,  /* ܾΪָ */
+    TC_UNKNOWN_SYMBOL = 2,    /* Լδ */
+    TC_BUFFER_TOO_SMALL = 3,  /* 岻㣨ಿд룩 */
+    TC_IO_ERROR = 4,          /* ļ޷ȡʽ */
+    TC_INTERNAL_ERROR = 5
+} tc_status;
+
+TC_API int tc_abi_version(void);
+TC_API const char* tc_last_error(void);
+
+/* ===== Լ ===== */
+typedef enum tc_contract_type {
+    TC_LINEAR_USDT = 0,  /* USDTλ */
+    TC_INVERSE_COIN = 1  /* ұλԼ֤ӯ׷ӱ֤ԱҼ */
+} tc_contract_type;
+
+typedef struct tc_contract {
+    double risk_threshold;          /* ϵֵܸˡλռȣ */
+    double maintenance_margin_rate; /* άֱ֤ */
+    double tick_size;               /* С۸䶯 */
+    int32_t contract_type;          /* tc_contract_typeABI汾2 */
+    int32_t reserved;
+} tc_contract;
+
+/* Լעأѯ̰߳ȫҲ */
+typedef struct tc_registry tc_registry;
+
+/* config_pathΪNULLʱʹĬϺԼ */
+TC_API tc_status tc_registry_create(const char* config_path, tc_registry** out);
+TC_API tc_status tc_registry_reload(tc_registry* registry, const char* config_path);
+TC_API tc_status tc_registry_lookup(tc_registry* registry, const char* symbol, tc_contract* out);
+TC_API void tc_registry_destroy(tc_registry* registry);
+
+/* ===== ǿƽ/֤ ===== */
+typedef enum tc_direction {
+    TC_LONG = 0,
+    TC_SHORT = 1
+} tc_direction;
+
+typedef struct tc_position {
+    double leverage;       /* ܸ˱1 */
+    double position_ratio; /* λռʽ0~100 */
+    double entry_price;    /* 볡۸ */
+    double total_capital;  /* ʽ */
+    int32_t direction;     /* tc_direction */
+    int32_t reserved;
+} tc_position;
+
+typedef struct tc_risk_result {
+    double threshold;
+    double risk_coefficient;
+    double initial_margin;
+    double maintenance_margin;
+    double margin_to_add;
+    double liquidation_price;
+    int32_t risk_level;    /* 0=޷ 1=ȫ 2=Ԥ 3= */
+    int32_t reserved;
+} tc_risk_result;
+
+/* һֵ޻򳬳Χܸ<1λռȲ0~100۸/ʽ0ԼͬļУ飩ʱTC_INVALID_ARGUMENT */
+TC_API tc_status tc_risk_compute(const tc_contract* contract, const tc_position* position, tc_risk_result* out);
+
+/* ===== ֧λ ===== */
+typedef struct tc_kline {
+    double open;
+    double high;
+    double low;
+    double close;
+    double volume;
+} tc_kline;
+
+typedef struct tc_sr_levels {
+    double highest_high, lowest_low;
+    double pivot_point, s1, s2, s3, r1, r2, r3;
+    double dense_support, dense_resist;
+    int32_t kline_count;
+} tc_sr_levels;
+
+TC_API tc_status tc_sr_compute(const tc_kline* klines, size_t count, tc_sr_levels* out);
+
+/* ===== һ ===== */
+/* 룺 0= 1=գ 0= 1=½ 2=̣RSI 0= 1= 2=
+ * KST 0=ϴԽ 1=´Խ 2=δԽEMA/KSTΪ4Сʱ//ߣ
+ * ̬ 0=ͷ綥 1=ͷ 2= 3= 4=Σ 5=Σɢ 6=˫ض 7=˫ص 8=ޣ
+ * ̬ 0= 1= 2=ڣͻƷ 0= 1= 2=δͻ */
+typedef struct tc_pattern {
+    uint8_t pattern;
+    uint8_t timeframe;
+    uint8_t break_dir;
+    uint8_t reserved;
+} tc_pattern;
+
+typedef struct tc_trade_analysis {
+    uint8_t open_dir;
+    uint8_t long_trend;
+    uint8_t mid_trend;
+    uint8_t short_trend;
+    uint8_t rsi_level;
+    uint8_t ema_trend[3];
+    uint8_t kst_cross[3];
+    uint8_t reserved;
+    int32_t leverage;                     /* ܸ˱1 */
+    int32_t short_trend_line_break_times; /* 0 */
+    int32_t reserved2;
+    double open_price;
+    double stop_loss;
+    const tc_pattern* patterns;
+    size_t pattern_count;
+    double atr_rate; /* ATR/ۣ%0ʾֹʰ̶֣ABI汾2 */
+} tc_trade_analysis;
+
+typedef struct tc_score_result {
+    int32_t total_score;
+    int32_t ema_score;
+    int32_t kst_score;
+    int32_t dir_match_score;
+    int32_t high_lever_risk;
+    int32_t contradiction_count;
+    double stop_loss_rate;       /* ֹʣ% */
+    double lever_stop_loss_risk; /* ֹܸʣ% */
+} tc_score_result;
+
+/* ܸ<1/ֹ۷޻0볬ΧʱTC_INVALID_ARGUMENToutд롣
+ * ìܵԻзָдtext\0βUTF-8textΪNULL
+ * text_neededǿʱдıֽ\0岻㣨textǿնtext_sizeΪ0ʱTC_BUFFER_TOO_SMALLoutЧ */
+TC_API tc_status tc_score(const tc_trade_analysis* analysis, tc_score_result* out, char* text, size_t text_size,
+                          size_t* text_needed);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TRADECHECK_C_H */
@@ -0,0 +1,75 @@
+#include "volatility.h"
+#include <algorithm>
+#include <cctype>
+#include <exception>
+#include <stdexcept>
+#include <iterator>
+#include <thread>
+
+namespace tradecheck {
+
+VolatilitySnapshot computeVolatility(const KlineData* klines, size_t count, int period) {
+    StreamingATR state;
+    state.reset(period);
+    for (size_t i = 0; i < count; ++i) {
+        if (klines[i].high < klines[i].low) throw std::invalid_argument("߼۵ͼ۵ЧK");
+        state.update(klines[i].high, klines[i].low, klines[i].close);
+    }
+    return makeVolatilitySnapshot(state);
+}
+
+std::vector<VolatilitySnapshot> computeVolatilityBatch(const std::vector<KlineSeries>& series, int period,
+                                                       unsigned threads) {
+    if (period <= 0) throw std::invalid_argument("ATRڱ0");
+    size_t count = series.size();
+    std::vector<VolatilitySnapshot> out(count);
+    unsigned threadCount = threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+    if (threadCount > count) threadCount = static_cast<unsigned>(std::max<size_t>(count, 1));
+
+    std::vector<std::exception_ptr> errors(threadCount);
+    auto worker = [&](unsigned t) {
+        size_t begin = count * t / threadCount;
+        size_t end = count * (t + 1) / threadCount;
+        try {
+            for (size_t i = begin; i < end; ++i) out[i] = computeVolatility(series[i].klines, series[i].count, period);
+        } catch (...) {
+            errors[t] = std::current_exception();
+        }
+    };
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threadCount; ++t) pool.emplace_back(worker, t);
+    worker(0);
+    for (auto& th : pool) th.join();
+    for (const auto& e : errors) {
+        if (e) std::rethrow_exception(e);
+    }
+    return out;
+}
+
+std::vector<StopSuggestion> suggestAtrStops(double entryPrice, TradeDirection direction, double atr,
+                                            const std::vector<double>& multiples) {
+    std::vector<StopSuggestion> out;
+    if (!(entryPrice > 0) || !(atr > 0)) return out;
+    double sign = direction == TradeDirection::LONG ? -1.0 : 1.0;
+    for (double m : multiples) {
+        double distance = atr * m;
+        out.push_back({m, entryPrice + sign * distance, distance / entryPrice * 100});
+    }
+    return out;
+}
+
+std::vector<StopSuggestion> suggestAtrStops(double entryPrice, TradeDirection direction, double atr) {
+    return suggestAtrStops(entryPrice, direction, atr,
+                           std::vector<double>(std::begin(DEFAULT_STOP_ATR_MULTIPLES), std::end(DEFAULT_STOP_ATR_MULTIPLES)));
+}
+
+std::string normalizeSymbol(const std::string& symbol) {
+    std::string out;
+    for (char c : symbol) {
+        if (c == '/' || c == '-' || c == '_') continue;
+        out += static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    }
+    return out;
+}
+
+}  // namespace tradecheck
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "crypto_risk.h"
+#include "support_resistance.h"
+#include "streaming_indicators.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace tradecheck {
+
+// 棺ATRʵֲʣʽ¹StreamingATRλһ£
+// ֹ밴ATRֹ־ݴ˻ΪֹǼATR
+
+struct VolatilitySnapshot {
+    double close = 0;              // ̼
+    double atr = 0;                // ƽʵ۸λ
+    double atrPercent = 0;         // ATR/̼ۣ%
+    double realizedVolatility = 0; // ÿK߶ʱ׼%
+    int bars = 0;                  // K
+    bool ready = false;            // KѴﵽATR
+};
+
+inline VolatilitySnapshot makeVolatilitySnapshot(const StreamingATR& state) {
+    VolatilitySnapshot v;
+    v.close = state.prevClose;
+    v.atr = state.value();
+    v.atrPercent = state.prevClose > 0 ? state.value() / state.prevClose * 100 : 0;
+    v.realizedVolatility = state.realizedVolatility() * 100;
+    v.bars = state.count;
+    v.ready = state.ready();
+    return v;
+}
+
+// һKߣʱ򣩵Ĳ
+VolatilitySnapshot computeVolatility(const KlineData* klines, size_t count, int period = 14);
+
+// ȫƷֲм㣨threadsΪ0ʱCPU˳һһӦ
+std::vector<VolatilitySnapshot> computeVolatilityBatch(const std::vector<KlineSeries>& series, int period = 14,
+                                                       unsigned threads = 0);
+
+// ĬϽֹATR
+const double DEFAULT_STOP_ATR_MULTIPLES[3] = {1.5, 2.0, 3.0};
+
+struct StopSuggestion {
+    double multiple;    // ATR
+    double price;       // ֹ
+    double ratePercent; // ֹ/ۣ%
+};
+
+// ATRֹۣ൥ڿ·յϷ
+std::vector<StopSuggestion> suggestAtrStops(double entryPrice, TradeDirection direction, double atr,
+                                            const std::vector<double>& multiples);
+std::vector<StopSuggestion> suggestAtrStops(double entryPrice, TradeDirection direction, double atr);
+
+// ƷKʱͳһдȥ/-_תдBTC/USDTBTCUSDTΪͬһƷ֣
+std::string normalizeSymbol(const std::string& symbol);
+
+}  // namespace tradecheck
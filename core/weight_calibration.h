@@ -0,0 +1,318 @@
+#pragma once
+
+#include "consistency_score.h"
+#include <vector>
+#include <thread>
+#include <random>
+#include <limits>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+namespace tradecheck {
+
+// Ȩ/ֵ˳weightParamNameһ£
+const int WEIGHT_PARAM_COUNT = 15;
+
+// ƣScoreWeightsԱͬ
+inline const char* weightParamName(int index) {
+    static const char* names[WEIGHT_PARAM_COUNT] = {
+        "emaWeight", "kstWeight", "baseSLWeight", "leverSLWeight", "dirMatchWeight",
+        "slIdealLow", "slIdealHigh", "slAcceptLow", "slAcceptHigh", "leverSafe", "leverWarn",
+        "slIdealLowAtr", "slIdealHighAtr", "slAcceptLowAtr", "slAcceptHighAtr"
+    };
+    return names[index];
+}
+
+// ŷScoreWeightsԱ
+inline double& weightParamRef(ScoreWeights& w, int index) {
+    switch (index) {
+        case 0: return w.emaWeight;
+        case 1: return w.kstWeight;
+        case 2: return w.baseSLWeight;
+        case 3: return w.leverSLWeight;
+        case 4: return w.dirMatchWeight;
+        case 5: return w.slIdealLow;
+        case 6: return w.slIdealHigh;
+        case 7: return w.slAcceptLow;
+        case 8: return w.slAcceptHigh;
+        case 9: return w.leverSafe;
+        case 10: return w.leverWarn;
+        case 11: return w.slIdealLowAtr;
+        case 12: return w.slIdealHighAtr;
+        case 13: return w.slAcceptLowAtr;
+        default: return w.slAcceptHighAtr;
+    }
+}
+
+// ƲҲţδҵ-1
+inline int findWeightParam(const char* name) {
+    for (int i = 0; i < WEIGHT_PARAM_COUNT; ++i) {
+        if (std::strcmp(weightParamName(i), name) == 0) return i;
+    }
+    return -1;
+}
+
+// Χsteps=1ʾ̶ȡminValue
+struct ParamRange {
+    double minValue;
+    double maxValue;
+    int steps;
+};
+
+// У׼ռ
+struct CalibrationSpace {
+    ParamRange ranges[WEIGHT_PARAM_COUNT];
+
+    // kȡֵ
+    double gridValue(int param, int k) const {
+        const ParamRange& r = ranges[param];
+        if (r.steps <= 1) return r.minValue;
+        return r.minValue + (r.maxValue - r.minValue) * k / (r.steps - 1);
+    }
+};
+
+// Ĭռ䣺Ȩز̶ֵΪԭӲֵģ7*7*5*5*5=6125
+inline CalibrationSpace defaultCalibrationSpace() {
+    ScoreWeights d;
+    CalibrationSpace space;
+    space.ranges[0] = {0.0, 0.6, 7};
+    space.ranges[1] = {0.0, 0.6, 7};
+    space.ranges[2] = {0.0, 2.0, 5};
+    space.ranges[3] = {0.0, 2.0, 5};
+    space.ranges[4] = {0.0, 2.0, 5};
+    for (int p = 5; p < WEIGHT_PARAM_COUNT; ++p) {
+        double v = weightParamRef(d, p);
+        space.ranges[p] = {v, v, 1};
+    }
+    return space;
+}
+
+// ֵĽΧ/ʱſֵʹã
+inline void widenThresholdRanges(CalibrationSpace& space) {
+    space.ranges[5] = {1.0, 5.0, 9};
+    space.ranges[6] = {5.0, 12.0, 8};
+    space.ranges[7] = {0.5, 2.0, 4};
+    space.ranges[8] = {8.0, 15.0, 8};
+    space.ranges[9] = {20.0, 60.0, 9};
+    space.ranges[10] = {40.0, 100.0, 7};
+    space.ranges[11] = {1.0, 2.5, 7};
+    space.ranges[12] = {2.0, 5.0, 7};
+    space.ranges[13] = {0.5, 1.5, 5};
+    space.ranges[14] = {3.0, 6.0, 7};
+}
+
+// УȨϺϷԣ̶ٷֱATR䶼Ƕ
+inline bool isValidWeights(const ScoreWeights& w) {
+    return w.slAcceptLow <= w.slIdealLow && w.slIdealLow <= w.slIdealHigh &&
+           w.slIdealHigh <= w.slAcceptHigh && w.leverSafe <= w.leverWarn &&
+           w.slAcceptLowAtr <= w.slIdealLowAtr && w.slIdealLowAtr <= w.slIdealHighAtr &&
+           w.slIdealHighAtr <= w.slAcceptHighAtr;
+}
+
+// ʷд洢ѡʱָ꣩
+struct FeatureMatrix {
+    std::vector<double> emaScore;
+    std::vector<double> kstScore;
+    std::vector<double> stopLossRate;
+    std::vector<double> leverRisk;
+    std::vector<double> dirMatch;
+    std::vector<double> atrRate;   // ATR/ۣ%0ʾ̶
+    std::vector<double> outcome;   // ʷʻR>0Ϊӯ
+    std::vector<double> win;       // ӯǣ1/0
+    size_t winCount = 0;
+
+    size_t size() const { return outcome.size(); }
+
+    void add(const ScoreFeatures& f, double result) {
+        emaScore.push_back(f.emaScore);
+        kstScore.push_back(f.kstScore);
+        stopLossRate.push_back(f.stopLossRate);
+        leverRisk.push_back(f.leverStopLossRisk);
+        dirMatch.push_back(f.dirMatchScore);
+        atrRate.push_back(f.atrRate);
+        outcome.push_back(result);
+        win.push_back(result > 0 ? 1.0 : 0.0);
+        if (result > 0) winCount++;
+    }
+};
+
+// У׼Ŀ
+enum class CalibrationObjective {
+    BALANCED_ACCURACY, // ÷֡ݼΪӯǩƽ׼ȷ
+    EXPECTANCY         // ƽռminCoverage
+};
+
+// У׼ѡ
+struct CalibrationOptions {
+    CalibrationObjective objective = CalibrationObjective::BALANCED_ACCURACY;
+    double passScore = 60.0;      // 
+    double minCoverage = 0.05;    // EXPECTANCYĿ¿ռ
+    unsigned threads = 0;         // ߳0=Ӳ
+    uint64_t seed = 42;           // 
+    int coordRounds = 5;          // 
+};
+
+// ѡ
+struct CandidateResult {
+    ScoreWeights weights;
+    double objective = -std::numeric_limits<double>::infinity();
+    size_t passCount = 0;         // ÷ִﵽߵ
+    double passWinRate = 0.0;     // ʤ
+    double passMeanOutcome = 0.0; // ƽ
+    size_t index = 0;             // ѡţڲнȷ
+};
+
+// һȨ
+inline CandidateResult evaluateWeights(const FeatureMatrix& m, const ScoreWeights& w, const CalibrationOptions& opt) {
+    CandidateResult r;
+    r.weights = w;
+    if (!isValidWeights(w) || m.size() == 0) return r;
+
+    // ѭ޷֧ڱ
+    double passWins = 0.0, passTotal = 0.0, passOutcome = 0.0;
+    const size_t n = m.size();
+    for (size_t i = 0; i < n; ++i) {
+        double rate = m.stopLossRate[i];
+        double atr = m.atrRate[i];
+        bool useAtr = atr > 0;
+        double x = useAtr ? rate / atr : rate;
+        double idealLow = useAtr ? w.slIdealLowAtr : w.slIdealLow, idealHigh = useAtr ? w.slIdealHighAtr : w.slIdealHigh;
+        double acceptLow = useAtr ? w.slAcceptLowAtr : w.slAcceptLow, acceptHigh = useAtr ? w.slAcceptHighAtr : w.slAcceptHigh;
+        double slScore = (x >= idealLow && x <= idealHigh) ? 10.0 : ((x >= acceptLow && x <= acceptHigh) ? 5.0 : 0.0);
+        double risk = m.leverRisk[i];
+        double leverScore = risk <= w.leverSafe ? 10.0 : (risk <= w.leverWarn ? 5.0 : 0.0);
+        double score = m.emaScore[i] * w.emaWeight + m.kstScore[i] * w.kstWeight + slScore * w.baseSLWeight +
+                       leverScore * w.leverSLWeight + m.dirMatch[i] * w.dirMatchWeight;
+        double pass = score >= opt.passScore ? 1.0 : 0.0;
+        passTotal += pass;
+        passWins += pass * m.win[i];
+        passOutcome += pass * m.outcome[i];
+    }
+    size_t tp = static_cast<size_t>(passWins);
+    size_t fp = static_cast<size_t>(passTotal) - tp;
+    size_t fn = m.winCount - tp;
+    size_t tn = n - m.winCount - fp;
+
+    r.passCount = tp + fp;
+    r.passWinRate = r.passCount ? static_cast<double>(tp) / r.passCount : 0.0;
+    r.passMeanOutcome = r.passCount ? passOutcome / r.passCount : 0.0;
+    if (opt.objective == CalibrationObjective::EXPECTANCY) {
+        if (r.passCount >= opt.minCoverage * n && r.passCount > 0) r.objective = r.passMeanOutcome;
+    } else {
+        double tpr = (tp + fn) ? static_cast<double>(tp) / (tp + fn) : 0.5;
+        double tnr = (tn + fp) ? static_cast<double>(tn) / (tn + fp) : 0.5;
+        r.objective = 0.5 * (tpr + tnr);
+    }
+    return r;
+}
+
+// ȽϣĿֵȣͬʱСȣ֤߳̽ȷ
+inline bool isBetterCandidate(const CandidateResult& a, const CandidateResult& b) {
+    if (a.objective != b.objective) return a.objective > b.objective;
+    return a.index < b.index;
+}
+
+// ߳[0, count)źѡcandidateAt(i)ɵiѡȨأŽ
+template <class Generator>
+CandidateResult searchBestParallel(const FeatureMatrix& m, size_t count, Generator candidateAt, const CalibrationOptions& opt) {
+    unsigned threadCount = opt.threads ? opt.threads : std::max(1u, std::thread::hardware_concurrency());
+    if (threadCount > count) threadCount = static_cast<unsigned>(std::max<size_t>(count, 1));
+
+    std::vector<CandidateResult> bests(threadCount);
+    auto worker = [&](unsigned t) {
+        size_t begin = count * t / threadCount;
+        size_t end = count * (t + 1) / threadCount;
+        CandidateResult best;
+        best.index = std::numeric_limits<size_t>::max();
+        for (size_t i = begin; i < end; ++i) {
+            CandidateResult r = evaluateWeights(m, candidateAt(i), opt);
+            r.index = i;
+            if (isBetterCandidate(r, best)) best = r;
+        }
+        bests[t] = best;
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threadCount; ++t) pool.emplace_back(worker, t);
+    worker(0);
+    for (auto& th : pool) th.join();
+
+    CandidateResult best = bests[0];
+    for (const auto& r : bests) {
+        if (isBetterCandidate(r, best)) best = r;
+    }
+    return best;
+}
+
+// ѡ
+inline size_t gridCandidateCount(const CalibrationSpace& space) {
+    size_t count = 1;
+    for (const auto& r : space.ranges) count *= static_cast<size_t>(std::max(r.steps, 1));
+    return count;
+}
+
+// ϽƽѡţԤչȫѡ
+inline CandidateResult gridSearch(const FeatureMatrix& m, const CalibrationSpace& space, const CalibrationOptions& opt) {
+    auto candidateAt = [&space](size_t index) {
+        ScoreWeights w;
+        for (int p = 0; p < WEIGHT_PARAM_COUNT; ++p) {
+            size_t steps = static_cast<size_t>(std::max(space.ranges[p].steps, 1));
+            weightParamRef(w, p) = space.gridValue(p, static_cast<int>(index % steps));
+            index /= steps;
+        }
+        return w;
+    };
+    return searchBestParallel(m, gridCandidateCount(space), candidateAt, opt);
+}
+
+// ÿѡ(, )ɣ߳޹
+inline CandidateResult randomSearch(const FeatureMatrix& m, const CalibrationSpace& space, size_t count,
+                                    const CalibrationOptions& opt) {
+    auto candidateAt = [&space, &opt](size_t index) {
+        std::mt19937_64 rng(opt.seed ^ (0x9E3779B97F4A7C15ULL * (index + 1)));
+        ScoreWeights w;
+        for (int p = 0; p < WEIGHT_PARAM_COUNT; ++p) {
+            const ParamRange& r = space.ranges[p];
+            if (r.steps <= 1) {
+                weightParamRef(w, p) = r.minValue;
+            } else {
+                std::uniform_real_distribution<double> dist(r.minValue, r.maxValue);
+                weightParamRef(w, p) = dist(rng);
+            }
+        }
+        return w;
+    };
+    return searchBestParallel(m, count, candidateAt, opt);
+}
+
+// ĬȨسϲɨ貢ȡţֱһ޸Ľ
+inline CandidateResult coordinateSearch(const FeatureMatrix& m, const CalibrationSpace& space,
+                                        const CalibrationOptions& opt, size_t* evaluated = nullptr) {
+    CandidateResult best = evaluateWeights(m, ScoreWeights(), opt);
+    size_t total = 1;
+    for (int round = 0; round < opt.coordRounds; ++round) {
+        bool improved = false;
+        for (int p = 0; p < WEIGHT_PARAM_COUNT; ++p) {
+            int steps = space.ranges[p].steps;
+            if (steps <= 1) continue;
+            ScoreWeights base = best.weights;
+            auto candidateAt = [&space, &base, p](size_t k) {
+                ScoreWeights w = base;
+                weightParamRef(w, p) = space.gridValue(p, static_cast<int>(k));
+                return w;
+            };
+            CandidateResult r = searchBestParallel(m, static_cast<size_t>(steps), candidateAt, opt);
+            total += steps;
+            if (r.objective > best.objective + 1e-12) {
+                best = r;
+                improved = true;
+            }
+        }
+        if (!improved) break;
+    }
+    if (evaluated) *evaluated = total;
+    return best;
+}
+
+}  // namespace tradecheck
@@ -0,0 +1,205 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <stdexcept>
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include "core/analysis_pipeline.h"
+#include "core/kline_io.h"
+#include "core/latency_stats.h"
+
+using namespace tradecheck;
+
+// ˮߣȡKCSVΪƷֽƷ ز  ָ  ֧λ  ìܵ  
+// ָԶ뿪пƻƷۺ֣׶ڸ߳ͬʱ
+// --sequentialڵִ߳ͬĽ׶Σֽ׶λһ£ڶ
+
+void printUsage() {
+    std::cout << "÷ˮ --input KCSV [--plans ƻļ] [--output NDJSONļ] [--interval ]"
+                 " [--window K] [--atr-period N] [--lanes N] [--queue ] [--sequential]"
+                 " [--latency-report ֽ׶ӳٱļ]"
+              << std::endl;
+    std::cout << "ƻļÿУƷ (/) ܸ  ֹ [ǿƽ]" << std::endl;
+    std::cout << "Kڲ4Сʱʱز4Сʱ//ߣֻ/" << std::endl;
+}
+
+// ÿKһNDJSON
+void writeResultJson(JsonLineWriter& json, const PipelineResult& r) {
+    const PipelineBar& b = r.bar;
+    const IndicatorReading& ind = b.indicators;
+    json.begin();
+    json.string("symbol", b.symbol)
+        .integer("openTime", b.openTime)
+        .number("close", b.bar.close)
+        .integer("closedBars", b.closedCount)
+        .string("shortTrend", readingTrendName(ind, Timeframe::TF_4H))
+        .string("midTrend", readingTrendName(ind, Timeframe::TF_DAY))
+        .string("longTrend", readingTrendName(ind, Timeframe::TF_WEEK))
+        .number("rsi", ind.rsiLevel < 0 ? NAN : ind.rsi)
+        .number("atr", ind.atr > 0 ? ind.atr : NAN)
+        .number("pivotPoint", b.levels.pivotPoint)
+        .number("s1", b.levels.s1)
+        .number("r1", b.levels.r1)
+        .number("denseSupport", b.levels.denseSupport)
+        .number("denseResist", b.levels.denseResist);
+    if (r.scored) {
+        json.integer("emaScore", r.score.emaScore)
+            .integer("kstScore", r.score.kstScore)
+            .integer("baseStopLossScore", r.score.baseStopLossScore)
+            .integer("leverStopLossScore", r.score.leverStopLossScore)
+            .integer("dirMatchScore", r.score.dirMatchScore)
+            .integer("totalScore", r.score.totalScore)
+            .boolean("highLeverRisk", r.score.highLeverRisk != 0);
+        json.beginArray("contradictions");
+        for (int i = 0, offset = 0; i < r.noteCount; ++i) {
+            size_t len = std::strlen(r.notes + offset);
+            json.element(r.notes + offset, len);
+            offset += static_cast<int>(len) + 1;
+        }
+        json.endArray();
+    }
+    json.end();
+}
+
+// ƷһKߵĶ
+void printFinal(const PipelineResult& r) {
+    const PipelineBar& b = r.bar;
+    const IndicatorReading& ind = b.indicators;
+    std::cout << b.symbol << " @" << b.openTime << "" << b.bar.close << "\n   //ڣ"
+              << readingTrendName(ind, Timeframe::TF_WEEK) << "/" << readingTrendName(ind, Timeframe::TF_DAY) << "/"
+              << readingTrendName(ind, Timeframe::TF_4H);
+    if (ind.rsiLevel >= 0) {
+        std::cout << " | RSI=" << ind.rsi << "" << INDICATOR_RSI_NAMES[ind.rsiLevel] << "" << ind.rsiBars << "죩";
+    }
+    if (ind.atr > 0) std::cout << " | ATR=" << ind.atr;
+    std::cout << "\n  ֧" << b.levels.klineCount << "P=" << b.levels.pivotPoint << " S1=" << b.levels.s1
+              << " R1=" << b.levels.r1 << " ܼ[" << b.levels.denseSupport << ", " << b.levels.denseResist << "]";
+    if (r.scored) {
+        std::cout << "\n  ƻ֣" << r.score.totalScore << "EMA " << r.score.emaScore << "KST " << r.score.kstScore
+                  << "ƥ " << r.score.dirMatchScore << "" << (r.score.highLeverRisk ? "ֹܸչ" : "");
+        for (int i = 0, offset = 0; i < r.noteCount; ++i) {
+            std::cout << "\n  ìܵ㣺" << r.notes + offset;
+            offset += static_cast<int>(std::strlen(r.notes + offset)) + 1;
+        }
+    }
+    std::cout << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    std::string input;
+    std::string planFile;
+    std::string output;
+    std::string latencyReport;
+    PipelineOptions opt;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--sequential") {
+            opt.staged = false;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            printUsage();
+            return 1;
+        }
+        std::string value = argv[++i];
+        if (arg == "--input") input = value;
+        else if (arg == "--plans") planFile = value;
+        else if (arg == "--output") output = value;
+        else if (arg == "--interval") opt.interval = std::strtoll(value.c_str(), nullptr, 10);
+        else if (arg == "--window") opt.window = std::atoi(value.c_str());
+        else if (arg == "--atr-period") opt.atrPeriod = std::atoi(value.c_str());
+        else if (arg == "--lanes") opt.lanes = static_cast<unsigned>(std::atoi(value.c_str()));
+        else if (arg == "--queue") opt.queueCapacity = static_cast<size_t>(std::strtoull(value.c_str(), nullptr, 10));
+        else if (arg == "--latency-report") latencyReport = value;
+        else {
+            printUsage();
+            return 1;
+        }
+    }
+    if (input.empty()) {
+        printUsage();
+        return 1;
+    }
+
+    try {
+        std::vector<TradePlan> plans;
+        if (!planFile.empty()) plans = loadTradePlans(planFile);
+        std::unique_ptr<BufferedWriter> out;
+        std::unique_ptr<JsonLineWriter> json;
+        if (!output.empty()) {
+            out.reset(new BufferedWriter(output));
+            json.reset(new JsonLineWriter(*out));
+        }
+        // صֻ߳УƷĽˮ߽ȡ
+        std::vector<std::unique_ptr<PipelineResult>> last;
+        AnalysisPipeline pipeline(opt, plans, [&](const PipelineResult& r) {
+            if (json) writeResultJson(*json, r);
+            if (r.bar.symbolId >= last.size()) last.resize(r.bar.symbolId + 1);
+            if (!last[r.bar.symbolId]) last[r.bar.symbolId].reset(new PipelineResult());
+            *last[r.bar.symbolId] = r;
+        });
+
+        FILE* file = std::fopen(input.c_str(), "rb");
+        if (!file) throw std::invalid_argument("޷Kļ" + input);
+        auto start = std::chrono::steady_clock::now();
+        char line[1024];
+        int lineNo = 0;
+        KlineRow row;
+        std::string lastSymbol;
+        uint32_t lastId = 0;
+        try {
+            while (std::fgets(line, sizeof(line), file)) {
+                lineNo++;
+                if (line[0] == '#' || line[0] == '\n' || line[0] == '\r') continue;
+                TRADECHECK_LATENCY_SCOPE(LatencyStage::INGEST);
+                if (!parseKlineCsvLine(line, lineNo, row)) continue;
+                // ͬһƷֵвز
+                if (lastSymbol.empty() || row.symbol != lastSymbol) {
+                    lastId = pipeline.symbolId(row.symbol);
+                    lastSymbol = row.symbol;
+                }
+                pipeline.push(lastId, row.openTime, row.kline);
+            }
+        } catch (...) {
+            std::fclose(file);
+            throw;
+        }
+        std::fclose(file);
+        pipeline.finish();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        json.reset();
+        out.reset();
+
+        for (const auto& r : last) {
+            if (r) printFinal(*r);
+        }
+        const PipelineStats& s = pipeline.stats();
+        std::printf("K%llu%lluز%llu%lluΣʱ%.3f s%.0f/루%s\n",
+                    static_cast<unsigned long long>(s.bars), static_cast<unsigned long long>(s.dropped),
+                    static_cast<unsigned long long>(s.resampled), static_cast<unsigned long long>(s.scored), seconds,
+                    seconds > 0 ? s.bars / seconds : 0.0,
+                    opt.staged ? ("ֽ׶Σ" + std::to_string(opt.lanes) + "ˮ").c_str() : "˳ִ");
+        if (s.truncatedNotes) {
+            std::printf("%lluìܵ㳬ı壬δ\n", static_cast<unsigned long long>(s.truncatedNotes));
+        }
+        if (opt.staged) {
+            std::printf("                  ѹȴ    еȴ\n");
+            for (int q = 0; q < PIPELINE_QUEUE_COUNT; ++q) {
+                std::printf("%-20s %10llu %10llu\n", PIPELINE_QUEUE_NAMES[q], static_cast<unsigned long long>(s.stalls[q]),
+                            static_cast<unsigned long long>(s.waits[q]));
+            }
+        }
+        std::vector<LatencyStageSummary> stages = summarizeLatency(latencySnapshot());
+        std::fflush(stdout);
+        printLatencyTable(stdout, stages);
+        if (!latencyReport.empty()) writeLatencyReport(latencyReport, stages);
+    } catch (const std::exception& e) {
+        std::cerr << "" << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
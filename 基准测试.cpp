@@ -0,0 +1,1288 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <atomic>
+#include <new>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <memory>
+#include <fstream>
+#include <iomanip>
+#include "core/crypto_risk.h"
+#include "core/support_resistance.h"
+#include "core/consistency_score.h"
+#include "core/risk_protocol.h"
+#include "core/streaming_levels.h"
+#include "core/output_records.h"
+#include "core/candle_store.h"
+#include "core/latency_stats.h"
+#include "core/streaming_indicators.h"
+#include "core/state_snapshot.h"
+#include "core/liquidation_map.h"
+#include "core/level_strength.h"
+#include "core/swing_zones.h"
+#include "core/volatility.h"
+#include "core/data_quality.h"
+#include "core/quantile_sketch.h"
+#include "core/analysis_pipeline.h"
+#include "core/correlation_matrix.h"
+#include "core/funding_carry.h"
+#include "core/risk_kernels.h"
+#include "core/order_book_depth.h"
+#include "core/setup_screener.h"
+#include "core/tradecheck_c.h"
+#include <unistd.h>
+
+using namespace tradecheck;
+
+// ׼ԣǿƽ/֤㡢֧λ㡢һìܵ
+// ÿβʱns/op£/룩ÿβĶѷ--jsonɶڻعȽ
+
+// ===== ѷ滻ȫoperator new =====
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete" // new/deleteΪmalloc/freeһ
+#endif
+static std::atomic<uint64_t> g_allocCount{0};
+static std::atomic<uint64_t> g_allocBytes{0};
+
+void* operator new(std::size_t size) {
+    g_allocCount.fetch_add(1, std::memory_order_relaxed);
+    g_allocBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+// std::pmrĬڴԴ߶汾
+void* operator new(std::size_t size, std::align_val_t align) {
+    g_allocCount.fetch_add(1, std::memory_order_relaxed);
+    g_allocBytes.fetch_add(size, std::memory_order_relaxed);
+    size_t a = static_cast<size_t>(align);
+    if (void* p = std::aligned_alloc(a, std::max(a, (size + a - 1) / a * a))) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t align) {
+    return operator new(size, align);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+// ֹŻ
+template <typename T>
+inline void keepAlive(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// 
+struct BenchResult {
+    std::string name;
+    uint64_t iterations;
+    double nsPerOp;
+    double itemsPerSec;
+    double allocsPerOp;
+    double bytesPerOp;
+};
+
+// ׼ѡ
+struct BenchOptions {
+    double minSeconds = 0.3;  // ÿʱ
+    std::string filter;       // ưӴ
+    bool json = false;
+    bool quick = false;       // ǧK
+};
+
+class BenchRunner {
+private:
+    BenchOptions opt;
+    std::vector<BenchResult> results;
+
+public:
+    explicit BenchRunner(const BenchOptions& o) : opt(o) {}
+
+    bool enabled(const std::string& name) const {
+        return opt.filter.empty() || name.find(opt.filter) != std::string::npos;
+    }
+
+    // һfn(iterations)ִiterationsβÿβitemsPerOp
+    // ԶֱֺʱﵽminSecondsmaxIterationsƴĿ
+    template <typename Fn>
+    void run(const std::string& name, double itemsPerOp, Fn fn, uint64_t maxIterations = UINT64_MAX) {
+        if (!enabled(name)) return;
+        fn(1); // Ԥ
+        uint64_t iterations = 1;
+        while (true) {
+            uint64_t allocs0 = g_allocCount.load(std::memory_order_relaxed);
+            uint64_t bytes0 = g_allocBytes.load(std::memory_order_relaxed);
+            auto start = std::chrono::steady_clock::now();
+            fn(iterations);
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            uint64_t allocs = g_allocCount.load(std::memory_order_relaxed) - allocs0;
+            uint64_t bytes = g_allocBytes.load(std::memory_order_relaxed) - bytes0;
+            if (seconds >= opt.minSeconds || iterations >= maxIterations) {
+                BenchResult r;
+                r.name = name;
+                r.iterations = iterations;
+                r.nsPerOp = seconds * 1e9 / iterations;
+                r.itemsPerSec = itemsPerOp * iterations / seconds;
+                r.allocsPerOp = static_cast<double>(allocs) / iterations;
+                r.bytesPerOp = static_cast<double>(bytes) / iterations;
+                results.push_back(r);
+                if (!opt.json) {
+                    std::printf("%-40s %12llu %14.1f %16.0f %10.2f %12.0f\n", name.c_str(),
+                                static_cast<unsigned long long>(r.iterations), r.nsPerOp, r.itemsPerSec,
+                                r.allocsPerOp, r.bytesPerOp);
+                    std::fflush(stdout);
+                }
+                return;
+            }
+            // ֺʱһִ
+            double scale = seconds > 0 ? opt.minSeconds * 1.2 / seconds : 100.0;
+            uint64_t next = static_cast<uint64_t>(iterations * std::min(100.0, std::max(2.0, scale)));
+            iterations = std::min(next, maxIterations);
+        }
+    }
+
+    void printHeader() const {
+        if (!opt.json) {
+            std::printf("%-40s %12s %14s %16s %10s %12s\n", "Ŀ", "", "ns/op", "/", "/op", "ֽ/op");
+        }
+    }
+
+    void printJson() const {
+        std::printf("[\n");
+        for (size_t i = 0; i < results.size(); ++i) {
+            const BenchResult& r = results[i];
+            std::printf("  {\"name\": \"%s\", \"iterations\": %llu, \"ns_per_op\": %.3f, \"items_per_sec\": %.1f, "
+                        "\"allocs_per_op\": %.3f, \"bytes_per_op\": %.1f}%s\n",
+                        r.name.c_str(), static_cast<unsigned long long>(r.iterations), r.nsPerOp, r.itemsPerSec,
+                        r.allocsPerOp, r.bytesPerOp, i + 1 < results.size() ? "," : "");
+        }
+        std::printf("]\n");
+    }
+};
+
+// ===== ϳ =====
+
+// ֲֲ
+struct PositionSample {
+    const ContractSpec* contract;
+    TradeDirection direction;
+    double leverage;
+    double positionRatio;
+    double entryPrice;
+    double totalCapital;
+};
+
+std::vector<PositionSample> generatePositions(size_t count, const ContractTable& table, std::mt19937_64& rng) {
+    const double basePrice[4] = {60000.0, 3000.0, 150.0, 0.15};
+    std::uniform_int_distribution<int> coin(0, 3), dir(0, 1);
+    std::uniform_int_distribution<int> levChoice(0, 7);
+    const double levels[8] = {1, 2, 3, 5, 10, 20, 50, 100};
+    std::uniform_real_distribution<double> ratio(1.0, 30.0), drift(-0.05, 0.05), cap(1000.0, 200000.0);
+    std::vector<PositionSample> out(count);
+    for (auto& p : out) {
+        int c = coin(rng);
+        p.contract = &table.spec(static_cast<uint32_t>(c));
+        p.direction = dir(rng) ? TradeDirection::SHORT : TradeDirection::LONG;
+        p.leverage = levels[levChoice(rng)];
+        p.positionRatio = ratio(rng);
+        p.entryPrice = basePrice[c] * (1 + drift(rng));
+        p.totalCapital = cap(rng);
+    }
+    return out;
+}
+
+// Kߣʾۼʱֵظߣ
+std::vector<KlineData> generateKlines(size_t count, std::mt19937_64& rng) {
+    std::normal_distribution<double> shock(0.0, 1.0);
+    std::vector<KlineData> out(count);
+    double price = 30000.0;
+    double vol = 0.01;
+    for (auto& k : out) {
+        vol = std::min(0.05, std::max(0.002, vol + 0.05 * (0.01 - vol) + 0.001 * shock(rng)));
+        double close = price * std::exp(vol * shock(rng));
+        k.open = price;
+        k.close = close;
+        k.high = std::max(price, close) * (1 + std::fabs(shock(rng)) * vol * 0.3);
+        k.low = std::min(price, close) * (1 - std::fabs(shock(rng)) * vol * 0.3);
+        k.volume = 1000.0 * std::exp(std::fabs(shock(rng)));
+        price = close;
+    }
+    return out;
+}
+
+// ׷ؿͻʹͬı
+std::vector<TradeAnalysis> generateAnalyses(size_t count, std::mt19937_64& rng) {
+    std::uniform_int_distribution<int> pick3(0, 2), pick2(0, 1), breaks(0, 5), lev(1, 100), patCount(0, 3);
+    std::uniform_int_distribution<int> pattern(0, 8), ptf(0, 2), brk(0, 2);
+    std::uniform_real_distribution<double> slPct(0.5, 12.0);
+    const Timeframe tfs[3] = {Timeframe::TF_4H, Timeframe::TF_DAY, Timeframe::TF_WEEK};
+    std::vector<TradeAnalysis> out(count);
+    for (auto& ta : out) {
+        ta.coinType = "BTCUSDT";
+        ta.openDir = DIR_NAMES[pick2(rng)];
+        ta.leverage = lev(rng);
+        ta.openPrice = 30000.0;
+        double sl = slPct(rng) / 100.0;
+        ta.stopLoss = ta.openDir == "" ? ta.openPrice * (1 - sl) : ta.openPrice * (1 + sl);
+        ta.longTrend = TREND_NAMES[pick3(rng)];
+        ta.midTrend = TREND_NAMES[pick3(rng)];
+        ta.shortTrend = TREND_NAMES[pick3(rng)];
+        ta.shortTrendLineBreakTimes = breaks(rng);
+        ta.rsiLevel = RSI_NAMES[pick3(rng)];
+        for (int i = 0; i < 3; ++i) {
+            ta.emaList.push_back({tfs[i], 26, TREND_NAMES[pick3(rng)], false});
+            ta.kstList.push_back({tfs[i], {10, 15, 20, 30}, KST_CROSS_NAMES[pick3(rng)]});
+        }
+        int n = patCount(rng);
+        for (int i = 0; i < n; ++i) {
+            ta.pricePatterns.push_back({PRICE_PATTERN_NAMES[pattern(rng)], static_cast<PatternTimeframe>(ptf(rng)),
+                                        static_cast<TriangleBreakDir>(brk(rng))});
+        }
+        updateStopLossRates(ta);
+    }
+    return out;
+}
+
+// ===== ׼Ŀ =====
+
+void benchRisk(BenchRunner& runner, std::mt19937_64& rng) {
+    ContractTable table(defaultContracts());
+    std::vector<PositionSample> positions = generatePositions(4096, table, rng);
+    std::vector<CryptoRiskCalculator> calcs;
+    calcs.reserve(positions.size());
+    for (const auto& p : positions) {
+        calcs.emplace_back(*p.contract, p.leverage, p.positionRatio, p.entryPrice, p.direction, p.totalCapital);
+    }
+    const size_t mask = positions.size() - 1;
+
+    runner.run("risk/construct", 1, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            const PositionSample& p = positions[i & mask];
+            CryptoRiskCalculator calc(*p.contract, p.leverage, p.positionRatio, p.entryPrice, p.direction, p.totalCapital);
+            keepAlive(calc);
+        }
+    });
+    runner.run("risk/calculateRiskCoefficient", 1, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) keepAlive(calcs[i & mask].calculateRiskCoefficient());
+    });
+    runner.run("risk/classifyRiskLevel", 1, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) keepAlive(calcs[i & mask].classifyRiskLevel());
+    });
+    runner.run("risk/judgeRiskLevel", 1, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            std::string level = calcs[i & mask].judgeRiskLevel();
+            keepAlive(level.size());
+        }
+    });
+    runner.run("risk/getInitialMargin", 1, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) keepAlive(calcs[i & mask].getInitialMargin());
+    });
+    runner.run("risk/getMaintenanceMargin", 1, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) keepAlive(calcs[i & mask].getMaintenanceMargin());
+    });
+    runner.run("risk/calculateLiquidationPrice", 1, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) keepAlive(calcs[i & mask].calculateLiquidationPrice());
+    });
+    runner.run("risk/calculateMarginToAdd", 1, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) keepAlive(calcs[i & mask].calculateMarginToAdd());
+    });
+    runner.run("risk/contractLookup", 1, [&](uint64_t n) {
+        const std::string symbols[4] = {"BTCUSDT", "ETHUSDT", "SOLUSDT", "DOGEUSDT"};
+        for (uint64_t i = 0; i < n; ++i) keepAlive(table.find(symbols[i & 3]));
+    });
+}
+
+void benchSupportResistance(BenchRunner& runner, std::mt19937_64& rng, bool quick) {
+    struct Size {
+        const char* label;
+        size_t count;
+        uint64_t maxIterations;
+    };
+    std::vector<Size> sizes = {{"1K", 1000, UINT64_MAX}, {"100K", 100000, UINT64_MAX}, {"10M", 10000000, 5}};
+    if (quick) sizes.pop_back();
+    for (const auto& sz : sizes) {
+        std::string name = std::string("sr/construct/") + sz.label;
+        if (!runner.enabled(name)) continue;
+        std::vector<KlineData> klines = generateKlines(sz.count, rng);
+        runner.run(name, static_cast<double>(sz.count), [&](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i) {
+                SupportResistanceCalculator calc(klines, TimeFrame::FOUR_HOUR);
+                keepAlive(calc.getDenseSupport());
+            }
+        }, sz.maxIterations);
+    }
+
+    if (runner.enabled("sr/streamingUpdate")) {
+        std::vector<KlineData> klines = generateKlines(100000, rng);
+        std::unique_ptr<StreamingSupportResistance> stream(new StreamingSupportResistance());
+        stream->reset(200);
+        runner.run("sr/streamingUpdate/window200", 1, [&](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i) stream->update(klines[i % klines.size()]);
+            keepAlive(stream->levels().denseSupport);
+        });
+    }
+}
+
+void benchScore(BenchRunner& runner, std::mt19937_64& rng) {
+    std::vector<TradeAnalysis> analyses = generateAnalyses(1024, rng);
+    const size_t mask = analyses.size() - 1;
+    runner.run("score/calculateTotalConsistency", 1, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            bool highRisk = false;
+            keepAlive(calculateTotalConsistency(analyses[i & mask], highRisk));
+        }
+    });
+    runner.run("score/analyzeContradictions", 1, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            const TradeAnalysis& ta = analyses[i & mask];
+            std::vector<std::string> c = analyzeContradictions(ta, ta.leverStopLossRisk > 60);
+            keepAlive(c.size());
+        }
+    });
+    runner.run("score/total+contradictions", 1, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            bool highRisk = false;
+            const TradeAnalysis& ta = analyses[i & mask];
+            int score = calculateTotalConsistency(ta, highRisk);
+            std::vector<std::string> c = analyzeContradictions(ta, highRisk);
+            keepAlive(score + c.size());
+        }
+    });
+
+    // ÿȸһ루ģTradeAnalysisѷÿһͷŵڴԱ
+    runner.run("score/batch/heap", 1, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            TradeAnalysis ta(analyses[i & mask]);
+            bool highRisk = false;
+            int score = calculateTotalConsistency(ta, highRisk);
+            std::vector<std::string> c = analyzeContradictions(ta, highRisk);
+            keepAlive(score + c.size());
+        }
+    });
+    AnalysisArena arena;
+    runner.run("score/batch/arena", 1, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            if ((i & mask) == 0) arena.reset();
+            TradeAnalysis ta(analyses[i & mask], arena.allocator());
+            bool highRisk = false;
+            int score = calculateTotalConsistency(ta, highRisk);
+            ContradictionList c(arena.allocator());
+            c.reserve(8);
+            analyzeContradictions(ta, highRisk, c);
+            keepAlive(score + c.size());
+        }
+    });
+}
+
+// ʽKߴ洢100Kߣ۸0.01ɽ0.001ıν룬
+// ΪӣҳеģԭʼdoubleļȡͬK
+void benchCandleStore(BenchRunner& runner, std::mt19937_64& rng) {
+    const char* const names[] = {"store/encode/1M", "store/decode/1M/scalar", "store/decode/1M/avx2", "store/rawRead/1M"};
+    if (std::none_of(std::begin(names), std::end(names), [&](const char* name) { return runner.enabled(name); })) return;
+    const size_t count = 1000000;
+    std::vector<KlineData> klines = generateKlines(count, rng);
+    std::vector<int64_t> times(count);
+    for (size_t i = 0; i < count; ++i) {
+        KlineData& k = klines[i];
+        k.open = std::llround(k.open * 100) / 100.0;
+        k.high = std::llround(k.high * 100) / 100.0;
+        k.low = std::llround(k.low * 100) / 100.0;
+        k.close = std::llround(k.close * 100) / 100.0;
+        k.volume = std::llround(k.volume * 1000) / 1000.0;
+        times[i] = 1600000000000LL + static_cast<int64_t>(i) * 60000;
+    }
+    const std::string base = "/tmp/tradecheck_bench_" + std::to_string(getpid());
+    const std::string storePath = base + ".tcs";
+    const std::string rawPath = base + ".raw";
+
+    runner.run("store/encode/1M", static_cast<double>(count), [&](uint64_t n) {
+        for (uint64_t it = 0; it < n; ++it) {
+            CandleStoreWriter writer(storePath, "BENCH", 2, 3);
+            for (size_t i = 0; i < count; ++i) writer.append(times[i], klines[i]);
+            writer.close();
+        }
+    }, 20);
+    {
+        CandleStoreWriter writer(storePath, "BENCH", 2, 3);
+        for (size_t i = 0; i < count; ++i) writer.append(times[i], klines[i]);
+        writer.close();
+        FILE* raw = std::fopen(rawPath.c_str(), "wb");
+        if (!raw) throw std::runtime_error("޷дʱļ" + rawPath);
+        std::fwrite(klines.data(), sizeof(KlineData), count, raw);
+        std::fclose(raw);
+    }
+
+    CandleStoreReader reader(storePath);
+    std::vector<int64_t> outTimes;
+    std::vector<KlineData> outBars;
+    outTimes.reserve(count);
+    outBars.reserve(count);
+    auto decodeAll = [&](uint64_t n) {
+        for (uint64_t it = 0; it < n; ++it) {
+            outTimes.clear();
+            outBars.clear();
+            reader.readRange(INT64_MIN, INT64_MAX, outTimes, outBars);
+            keepAlive(outBars.back().close);
+        }
+    };
+    reader.setSimdEnabled(false);
+    runner.run("store/decode/1M/scalar", static_cast<double>(count), decodeAll);
+    if (candleStoreSimdSupported()) {
+        reader.setSimdEnabled(true);
+        runner.run("store/decode/1M/avx2", static_cast<double>(count), decodeAll);
+    }
+    runner.run("store/rawRead/1M", static_cast<double>(count), [&](uint64_t n) {
+        for (uint64_t it = 0; it < n; ++it) {
+            FILE* raw = std::fopen(rawPath.c_str(), "rb");
+            outBars.resize(count);
+            keepAlive(std::fread(outBars.data(), sizeof(KlineData), count, raw));
+            std::fclose(raw);
+        }
+    });
+    std::remove(storePath.c_str());
+    std::remove(rawPath.c_str());
+}
+
+// д/dev/nullֻȽϸʽ
+void benchOutput(BenchRunner& runner, std::mt19937_64& rng) {
+    ContractTable table(defaultContracts());
+    std::vector<PositionSample> positions = generatePositions(4096, table, rng);
+    std::vector<RiskRecord> records;
+    records.reserve(positions.size());
+    for (const auto& p : positions) {
+        CryptoRiskCalculator calc(*p.contract, p.leverage, p.positionRatio, p.entryPrice, p.direction, p.totalCapital);
+        records.push_back(makeRiskRecord(calc));
+    }
+    const size_t mask = records.size() - 1;
+
+    if (runner.enabled("output/risk")) {
+        BufferedWriter out("/dev/null");
+        JsonLineWriter json(out);
+        runner.run("output/risk/ndjson", 1, [&](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i) writeRiskJson(json, records[i & mask]);
+        });
+        runner.run("output/risk/binary", 1, [&](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i) out.write(&records[i & mask], sizeof(RiskRecord));
+        });
+        std::ofstream stream("/dev/null");
+        runner.run("output/risk/ostreamText", 1, [&](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i) {
+                const RiskRecord& r = records[i & mask];
+                stream << r.symbol << ' ' << std::fixed << std::setprecision(4) << r.leverage << ' ' << r.positionRatio << ' '
+                       << r.entryPrice << ' ' << r.totalCapital << ' ' << r.threshold << ' ' << r.riskCoefficient << ' '
+                       << r.initialMargin << ' ' << r.maintenanceMargin << ' ' << r.marginToAdd << ' ' << r.liquidationPrice
+                       << '\n';
+            }
+        });
+    }
+}
+
+// ֽ׶μʱĿTRADECHECK_INSTRUMENTATION=OFFʱʱΪղ
+void benchLatency(BenchRunner& runner) {
+    if (!runner.enabled("latency")) return;
+    runner.run("latency/scope", 1, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            TRADECHECK_LATENCY_SCOPE(LatencyStage::OUTPUT);
+            keepAlive(i);
+        }
+    });
+    runner.run("latency/record", 1, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            TRADECHECK_LATENCY_RECORD(LatencyStage::OUTPUT, static_cast<int64_t>(i & 0xFFFFF));
+            keepAlive(i);
+        }
+    });
+    HdrHistogram merged;
+    runner.run("latency/snapshot", 1, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            merged.merge(latencySnapshot()[static_cast<int>(LatencyStage::OUTPUT)]);
+            keepAlive(merged.percentile(0.999));
+        }
+    });
+    resetLatencyStats();
+}
+
+// ͬģĵƷ״̬200֧λ + ָ飩
+struct BenchSymbolState {
+    StreamingSupportResistance levels;
+    StreamingIndicatorSet indicators;
+    double lastPrice;
+    uint64_t candles;
+    int64_t lastCandleTime;
+};
+
+void benchSnapshot(BenchRunner& runner, std::mt19937_64& rng) {
+    if (!runner.enabled("snapshot")) return;
+    const uint32_t symbolCount = 64;
+    std::vector<KlineData> klines = generateKlines(1000, rng);
+    std::vector<std::unique_ptr<BenchSymbolState>> states(symbolCount);
+    std::vector<std::string> names(symbolCount);
+    std::vector<uint64_t> versions(symbolCount, 1);
+    for (uint32_t i = 0; i < symbolCount; ++i) {
+        states[i].reset(new BenchSymbolState());
+        states[i]->levels.reset(200);
+        states[i]->indicators.reset();
+        for (const auto& k : klines) {
+            states[i]->levels.update(k);
+            states[i]->indicators.update(k.close);
+        }
+        names[i] = "SYM" + std::to_string(i) + "USDT";
+    }
+
+    // ·һֻֿ1Ʒб仯 / ȫƷб仯
+    SnapshotWriter<BenchSymbolState>::Staging staging;
+    for (uint32_t i = 0; i < symbolCount; ++i) staging.update(i, names[i], versions[i], *states[i]);
+    runner.run("snapshot/capture/1of64dirty", 1, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            uint32_t dirty = static_cast<uint32_t>(i % symbolCount);
+            versions[dirty]++;
+            for (uint32_t id = 0; id < symbolCount; ++id) staging.update(id, names[id], versions[id], *states[id]);
+        }
+        keepAlive(staging.copiedCount());
+    });
+    runner.run("snapshot/capture/64dirty", symbolCount, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            for (uint32_t id = 0; id < symbolCount; ++id) {
+                versions[id]++;
+                staging.update(id, names[id], versions[id], *states[id]);
+            }
+        }
+        keepAlive(staging.copiedCount());
+    });
+
+    // ̨̣߳дmsyncָ
+    std::string path = "/tmp/tradecheck_bench_" + std::to_string(getpid()) + ".snap";
+    {
+        SnapshotWriter<BenchSymbolState> writer(path, 200);
+        runner.run("snapshot/write/64", symbolCount, [&](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i) {
+                SnapshotWriter<BenchSymbolState>::Staging* st = writer.beginCapture();
+                for (uint32_t id = 0; id < symbolCount; ++id) {
+                    versions[id]++;
+                    st->update(id, names[id], versions[id], *states[id]);
+                }
+                writer.commitCapture(st);
+                writer.flush();
+            }
+            keepAlive(writer.lastGeneration());
+        }, 200);
+    }
+    BenchSymbolState restored;
+    runner.run("snapshot/restore/64", symbolCount, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            SnapshotReader<BenchSymbolState> reader(path, 200);
+            for (size_t k = 0; k < reader.size(); ++k) restored = reader.entry(k).state;
+            keepAlive(restored.levels.total);
+        }
+    }, 2000);
+    std::remove(path.c_str());
+}
+
+// ǿƽֲ10Kߡ16ּۡ5ܸˡ = 1600ϳɳֲ
+void benchLiquidationMap(BenchRunner& runner, std::mt19937_64& rng) {
+    const char* const names[] = {"liq/map/16M/scalar/1t", "liq/map/16M/avx2/1t", "liq/map/16M/avx2/mt"};
+    if (std::none_of(std::begin(names), std::end(names), [&](const char* name) { return runner.enabled(name); })) return;
+    std::vector<KlineData> klines = generateKlines(100000, rng);
+    // ǿƽֲֲȫ۸ʹÿֱֲֶͼ
+    LiquidationMapOptions opt;
+    opt.binCount = 200;
+    opt.keepLiquidated = true;
+    opt.rangeLow = 0;
+    opt.rangeHigh = 0;
+    for (const auto& k : klines) opt.rangeHigh = std::max(opt.rangeHigh, k.high * 2);
+    auto compute = [&](uint64_t n) {
+        for (uint64_t it = 0; it < n; ++it) {
+            LiquidationMap map = computeLiquidationMap(klines.data(), klines.size(), 0.005, opt);
+            keepAlive(map.totalNotional);
+        }
+    };
+    const double positions = static_cast<double>(klines.size()) * opt.pricePoints * opt.leverages.size() * 2;
+    opt.threads = 1;
+    opt.simd = false;
+    runner.run("liq/map/16M/scalar/1t", positions, compute, 200);
+    if (!liquidationMapSimdSupported()) return;
+    opt.simd = true;
+    runner.run("liq/map/16M/avx2/1t", positions, compute, 200);
+    opt.threads = 0;
+    runner.run("liq/map/16M/avx2/mt", positions, compute, 200);
+}
+
+// λǿȣԼ2000ѡλ֧λ+ɽ壩ɨλK߶Ա
+void benchLevelStrength(BenchRunner& runner, std::mt19937_64& rng, bool quick) {
+    const char* const names[] = {"levels/strength/100k/naive", "levels/strength/100k/sweep", "levels/strength/1M/sweep"};
+    if (std::none_of(std::begin(names), std::end(names), [&](const char* name) { return runner.enabled(name); })) return;
+    const size_t count = quick ? 100000 : 1000000;
+    std::vector<KlineData> klines = generateKlines(count, rng);
+    SupportResistanceLevels levels = computeSupportResistance(klines.data(), klines.size());
+    std::vector<LevelCandidate> candidates = collectLevelCandidates(levels, klines.data(), klines.size(), 2000, 20000);
+    const size_t small = 100000;
+    std::vector<LevelStrength> a = rankLevelStrength(candidates, klines.data(), small, 0.002);
+    std::vector<LevelStrength> b = rankLevelStrengthNaive(candidates, klines.data(), small, 0.002);
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].price != b[i].price || a[i].touches() != b[i].touches() || a[i].holds() != b[i].holds()) {
+            throw std::runtime_error("λǿɨжϲһ");
+        }
+    }
+    runner.run("levels/strength/100k/naive", static_cast<double>(small), [&](uint64_t n) {
+        for (uint64_t it = 0; it < n; ++it) keepAlive(rankLevelStrengthNaive(candidates, klines.data(), small, 0.002)[0].score);
+    }, 20);
+    runner.run("levels/strength/100k/sweep", static_cast<double>(small), [&](uint64_t n) {
+        for (uint64_t it = 0; it < n; ++it) keepAlive(rankLevelStrength(candidates, klines.data(), small, 0.002)[0].score);
+    });
+    if (quick) return;
+    runner.run("levels/strength/1M/sweep", static_cast<double>(count), [&](uint64_t n) {
+        for (uint64_t it = 0; it < n; ++it) keepAlive(rankLevelStrength(candidates, klines.data(), count, 0.002)[0].score);
+    });
+}
+
+// ڶ200Ʒ֡2000Kȫ㣨ÿ4СʱʱĹ
+void benchSwingZones(BenchRunner& runner, std::mt19937_64& rng) {
+    const char* const names[] = {"zones/200x2000/1t", "zones/200x2000/mt"};
+    if (std::none_of(std::begin(names), std::end(names), [&](const char* name) { return runner.enabled(name); })) return;
+    std::vector<std::vector<KlineData>> universe;
+    std::vector<KlineSeries> series;
+    for (int i = 0; i < 200; ++i) universe.push_back(generateKlines(2000, rng));
+    for (const auto& bars : universe) series.push_back({bars.data(), bars.size()});
+    SwingZoneOptions opt;
+    const double bars = 200.0 * 2000;
+    runner.run("zones/200x2000/1t", bars, [&](uint64_t n) {
+        for (uint64_t it = 0; it < n; ++it) keepAlive(computeSwingZonesBatch(series, opt, 1).size());
+    });
+    runner.run("zones/200x2000/mt", bars, [&](uint64_t n) {
+        for (uint64_t it = 0; it < n; ++it) keepAlive(computeSwingZonesBatch(series, opt).size());
+    });
+}
+
+// ATRȫгʽ
+void benchVolatility(BenchRunner& runner, std::mt19937_64& rng) {
+    const char* const names[] = {"vol/atr/stream", "vol/atr/1000x2000/1t", "vol/atr/1000x2000/mt"};
+    if (std::none_of(std::begin(names), std::end(names), [&](const char* name) { return runner.enabled(name); })) return;
+    std::vector<std::vector<KlineData>> universe;
+    std::vector<KlineSeries> series;
+    for (int i = 0; i < 1000; ++i) universe.push_back(generateKlines(2000, rng));
+    for (const auto& bars : universe) series.push_back({bars.data(), bars.size()});
+    const std::vector<KlineData>& one = universe.front();
+    runner.run("vol/atr/stream", static_cast<double>(one.size()), [&](uint64_t n) {
+        StreamingATR atr;
+        for (uint64_t it = 0; it < n; ++it) {
+            atr.reset(14);
+            for (const auto& k : one) atr.update(k.high, k.low, k.close);
+            keepAlive(atr.value());
+        }
+    });
+    const double bars = 1000.0 * 2000;
+    runner.run("vol/atr/1000x2000/1t", bars, [&](uint64_t n) {
+        for (uint64_t it = 0; it < n; ++it) keepAlive(computeVolatilityBatch(series, 14, 1).size());
+    });
+    runner.run("vol/atr/1000x2000/mt", bars, [&](uint64_t n) {
+        for (uint64_t it = 0; it < n; ++it) keepAlive(computeVolatilityBatch(series, 14).size());
+    });
+}
+
+// ɨ裺Լ1%Kע⣬УAVX2һ
+void benchDataQuality(BenchRunner& runner, std::mt19937_64& rng, bool quick) {
+    const char* const names[] = {"quality/scan/scalar/1t", "quality/scan/avx2/1t", "quality/scan/avx2/mt"};
+    if (std::none_of(std::begin(names), std::end(names), [&](const char* name) { return runner.enabled(name); })) return;
+    const size_t count = quick ? 1000000 : 10000000;
+    std::vector<KlineData> klines = generateKlines(count, rng);
+    std::vector<int64_t> times(count);
+    std::uniform_int_distribution<size_t> pick(1, count - 2);
+    std::uniform_int_distribution<int> skip(0, 599);
+    int64_t t = 0;
+    for (size_t i = 0; i < count; ++i, t += 60000) {
+        if (skip(rng) == 0) t += 60000;
+        times[i] = t;
+    }
+    for (size_t n = 0; n < count / 100; ++n) {
+        size_t i = pick(rng);
+        switch (n % 5) {
+            case 0: times[i] = times[i - 1]; break;
+            case 1: std::swap(klines[i].high, klines[i].low); break;
+            case 2: klines[i].close = klines[i].high * 1.01; break;
+            case 3: klines[i].volume = 0; break;
+            case 4: klines[i].close *= 3; break;
+        }
+    }
+    QualityOptions opt;
+    opt.interval = 60000;
+    opt.threads = 1;
+    opt.simd = false;
+    QualityReport scalar = scanKlineQuality(times.data(), klines.data(), count, opt);
+    opt.simd = true;
+    QualityReport simd = scanKlineQuality(times.data(), klines.data(), count, opt);
+    opt.threads = 0;
+    QualityReport parallel = scanKlineQuality(times.data(), klines.data(), count, opt);
+    for (const QualityReport* r : {&simd, &parallel}) {
+        bool same = r->ranges.size() == scalar.ranges.size();
+        for (size_t i = 0; same && i < scalar.ranges.size(); ++i) {
+            const QualityRange &a = r->ranges[i], &b = scalar.ranges[i];
+            same = a.issue == b.issue && a.first == b.first && a.last == b.last && a.missingBars == b.missingBars;
+        }
+        if (!same) throw std::runtime_error("ɨAVX2/߳̽һ");
+    }
+    auto scan = [&](uint64_t n) {
+        for (uint64_t it = 0; it < n; ++it) keepAlive(scanKlineQuality(times.data(), klines.data(), count, opt).ranges.size());
+    };
+    opt.threads = 1;
+    opt.simd = false;
+    runner.run("quality/scan/scalar/1t", static_cast<double>(count), scan, 100);
+    if (!dataQualitySimdSupported()) return;
+    opt.simd = true;
+    runner.run("quality/scan/avx2/1t", static_cast<double>(count), scan, 100);
+    opt.threads = 0;
+    runner.run("quality/scan/avx2/mt", static_cast<double>(count), scan, 100);
+}
+
+// ˮߣ8Ʒֽ1СʱK߸2ȫƻ˳ִֽ׶еһ
+void benchPipeline(BenchRunner& runner, std::mt19937_64& rng) {
+    const char* const names[] = {"pipeline/sequential", "pipeline/staged", "pipeline/staged/4lanes"};
+    if (std::none_of(std::begin(names), std::end(names), [&](const char* name) { return runner.enabled(name); })) return;
+    const int symbols = 8;
+    const size_t barsPerSymbol = 20000;
+    std::vector<std::vector<KlineData>> universe;
+    std::vector<TradePlan> plans;
+    for (int s = 0; s < symbols; ++s) {
+        universe.push_back(generateKlines(barsPerSymbol, rng));
+        double entry = universe.back().front().close;
+        plans.push_back({"SYM" + std::to_string(s), s % 2 ? TradeDirection::SHORT : TradeDirection::LONG, 10, entry,
+                         s % 2 ? entry * 1.05 : entry * 0.95, 0});
+    }
+    auto runOnce = [&](bool staged, unsigned lanes) {
+        PipelineOptions opt;
+        opt.staged = staged;
+        opt.lanes = lanes;
+        opt.interval = 3600000;
+        int64_t checksum = 0;
+        AnalysisPipeline pipeline(opt, plans, [&](const PipelineResult& r) { checksum += r.score.totalScore; });
+        std::vector<uint32_t> ids;
+        for (const auto& p : plans) ids.push_back(pipeline.symbolId(p.symbol));
+        for (size_t i = 0; i < barsPerSymbol; ++i) {
+            for (int s = 0; s < symbols; ++s) pipeline.push(ids[s], static_cast<int64_t>(i) * 3600000, universe[s][i]);
+        }
+        pipeline.finish();
+        return checksum;
+    };
+    int64_t expected = runOnce(false, 1);
+    if (runOnce(true, 1) != expected || runOnce(true, 4) != expected) {
+        throw std::runtime_error("ֽ׶ˮ˳ִвһ");
+    }
+    const double bars = static_cast<double>(symbols) * barsPerSymbol;
+    runner.run("pipeline/sequential", bars, [&](uint64_t n) {
+        for (uint64_t it = 0; it < n; ++it) keepAlive(runOnce(false, 1));
+    }, 20);
+    runner.run("pipeline/staged", bars, [&](uint64_t n) {
+        for (uint64_t it = 0; it < n; ++it) keepAlive(runOnce(true, 1));
+    }, 20);
+    runner.run("pipeline/staged/4lanes", bars, [&](uint64_t n) {
+        for (uint64_t it = 0; it < n; ++it) keepAlive(runOnce(true, 4));
+    }, 20);
+}
+
+// t-digest롢ƬϲУλ
+void benchQuantileSketch(BenchRunner& runner, std::mt19937_64& rng) {
+    const char* const names[] = {"bands/tdigest/add", "bands/tdigest/merge64", "bands/1M/1t", "bands/1M/mt"};
+    if (std::none_of(std::begin(names), std::end(names), [&](const char* name) { return runner.enabled(name); })) return;
+    std::vector<KlineData> klines = generateKlines(1000000, rng);
+    std::vector<double> typical;
+    for (const auto& k : klines) typical.push_back((k.high + k.low + k.close) / 3.0);
+    QuantileBands bands = computeQuantileBands(klines.data(), klines.size(), 8);
+    std::vector<double> sorted = typical;
+    std::sort(sorted.begin(), sorted.end());
+    for (int i = 0; i < 3; ++i) {
+        double rank = static_cast<double>(std::lower_bound(sorted.begin(), sorted.end(), bands.price[i]) - sorted.begin());
+        if (std::fabs(rank / sorted.size() - QUANTILE_BAND_LEVELS[i]) > 0.01) {
+            throw std::runtime_error("t-digestλ1%");
+        }
+    }
+    auto digest = std::make_unique<TDigest>();
+    runner.run("bands/tdigest/add", static_cast<double>(typical.size()), [&](uint64_t n) {
+        for (uint64_t it = 0; it < n; ++it) {
+            digest->reset();
+            for (double v : typical) digest->add(v);
+            keepAlive(digest->quantile(0.5));
+        }
+    });
+    std::vector<TDigest> shards(64);
+    for (size_t s = 0; s < shards.size(); ++s) {
+        shards[s].reset();
+        for (size_t i = s; i < typical.size(); i += shards.size()) shards[s].add(typical[i]);
+        shards[s].flush();
+    }
+    runner.run("bands/tdigest/merge64", static_cast<double>(shards.size()), [&](uint64_t n) {
+        for (uint64_t it = 0; it < n; ++it) {
+            digest->reset();
+            for (const auto& s : shards) digest->merge(s);
+            keepAlive(digest->quantile(0.5));
+        }
+    });
+    runner.run("bands/1M/1t", static_cast<double>(klines.size()), [&](uint64_t n) {
+        for (uint64_t it = 0; it < n; ++it) keepAlive(computeQuantileBands(klines.data(), klines.size(), 1).price[1]);
+    });
+    runner.run("bands/1M/mt", static_cast<double>(klines.size()), [&](uint64_t n) {
+        for (uint64_t it = 0; it < n; ++it) keepAlive(computeQuantileBands(klines.data(), klines.size()).price[1]);
+    });
+}
+
+void benchCorrelation(BenchRunner& runner, std::mt19937_64& rng) {
+    const char* const names[] = {"corr/rebuild/300x1000/1t", "corr/rebuild/300x1000/mt", "corr/update/300"};
+    if (std::none_of(std::begin(names), std::end(names), [&](const char* name) { return runner.enabled(name); })) return;
+    // ʣƷ = betaг + 
+    const size_t symbols = 300;
+    const int window = 1000;
+    const size_t bars = 2 * window;
+    std::normal_distribution<double> noise(0.0, 0.01);
+    std::uniform_real_distribution<double> betaDist(0.5, 2.0);
+    std::vector<double> betas(symbols);
+    for (auto& b : betas) b = betaDist(rng);
+    std::vector<double> returns(bars * symbols);
+    for (size_t t = 0; t < bars; ++t) {
+        double market = noise(rng);
+        for (size_t i = 0; i < symbols; ++i) returns[t * symbols + i] = betas[i] * market + noise(rng);
+    }
+    // ֿһ£ֱӰЭһ
+    RollingCorrelation rolling(symbols, window, 1);
+    for (size_t t = 0; t < bars - 1; ++t) rolling.update(&returns[t * symbols]);
+    RollingCorrelation full(symbols, window);
+    full.assign(returns.data(), bars - 1);
+    for (size_t i = 0; i < symbols; i += 37) {
+        for (size_t j = i; j < symbols; j += 53) {
+            double si = 0, sj = 0, sij = 0;
+            for (size_t t = bars - 1 - window; t < bars - 1; ++t) {
+                si += returns[t * symbols + i];
+                sj += returns[t * symbols + j];
+                sij += returns[t * symbols + i] * returns[t * symbols + j];
+            }
+            double cov = (sij - si * sj / window) / (window - 1);
+            double tol = 1e-9 * std::sqrt(full.covariance(i, i) * full.covariance(j, j));
+            if (std::fabs(full.covariance(i, j) - cov) > tol || std::fabs(rolling.covariance(i, j) - cov) > tol) {
+                throw std::runtime_error("Ծֿ/ֱӼ㲻һ");
+            }
+        }
+    }
+    RollingCorrelation one(symbols, window, 1);
+    runner.run("corr/rebuild/300x1000/1t", static_cast<double>(symbols * (symbols + 1) / 2), [&](uint64_t n) {
+        for (uint64_t it = 0; it < n; ++it) {
+            one.assign(returns.data(), window);
+            keepAlive(one.covariance(0, 1));
+        }
+    });
+    runner.run("corr/rebuild/300x1000/mt", static_cast<double>(symbols * (symbols + 1) / 2), [&](uint64_t n) {
+        for (uint64_t it = 0; it < n; ++it) {
+            full.assign(returns.data(), window);
+            keepAlive(full.covariance(0, 1));
+        }
+    });
+    size_t t = 0;
+    runner.run("corr/update/300", 1.0, [&](uint64_t n) {
+        for (uint64_t it = 0; it < n; ++it) {
+            rolling.update(&returns[t * symbols]);
+            t = t + 1 == bars ? 0 : t + 1;
+        }
+        keepAlive(rolling.covariance(0, 1));
+    });
+}
+
+void benchCarry(BenchRunner& runner, std::mt19937_64& rng) {
+    const char* const names[] = {"carry/10k/32h/scalar", "carry/10k/32h/avx2", "carry/10k/32h/mt"};
+    if (std::none_of(std::begin(names), std::end(names), [&](const char* name) { return runner.enabled(name); })) return;
+    // 50Ʒ8Сʱʽʣ1ʳֲ֣32ֲʱ
+    FundingTable funding;
+    std::normal_distribution<double> rate(0.0001, 0.0003);
+    for (int s = 0; s < 50; ++s) {
+        FundingSeries fs;
+        fs.symbol = "SYM" + std::to_string(s) + "USDT";
+        for (int k = 1; k <= 3 * 730; ++k) {
+            fs.times.push_back(k * 8 * 3600000LL);
+            fs.rates.push_back(rate(rng));
+        }
+        funding.series.push_back(fs);
+    }
+    std::vector<ContractSpec> specs = defaultContracts();
+    std::uniform_int_distribution<size_t> symbolDist(0, funding.series.size() - 1);
+    std::uniform_real_distribution<double> lev(1, 50), ratio(1, 20), price(10, 1000);
+    std::vector<CarryPosition> book;
+    for (int i = 0; i < 10000; ++i) {
+        TradeDirection dir = (i & 1) ? TradeDirection::LONG : TradeDirection::SHORT;
+        book.push_back(CarryPosition{symbolDist(rng),
+                                     CryptoRiskCalculator(specs[i % specs.size()], lev(rng), ratio(rng), price(rng), dir, 10000)});
+    }
+    CarryOptions opt;
+    for (int h = 1; h <= 32; ++h) opt.horizons.push_back(h * 86400000LL * 22);
+    opt.threads = 1;
+    opt.simd = false;
+    CarrySimulation scalar = simulateCarry(funding, book, opt);
+    if (carrySimdSupported()) {
+        opt.simd = true;
+        CarrySimulation simd = simulateCarry(funding, book, opt);
+        if (simd.liquidationPrice != scalar.liquidationPrice || simd.marginToAdd != scalar.marginToAdd) {
+            throw std::runtime_error("ʽģAVX2·һ");
+        }
+    }
+    double items = static_cast<double>(book.size() * opt.horizons.size());
+    CarrySimulation reuse;
+    opt.simd = false;
+    runner.run("carry/10k/32h/scalar", items, [&](uint64_t n) {
+        for (uint64_t it = 0; it < n; ++it) {
+            simulateCarry(funding, book, opt, reuse);
+            keepAlive(reuse.margin[0]);
+        }
+    });
+    if (carrySimdSupported()) {
+        opt.simd = true;
+        runner.run("carry/10k/32h/avx2", items, [&](uint64_t n) {
+            for (uint64_t it = 0; it < n; ++it) {
+                simulateCarry(funding, book, opt, reuse);
+                keepAlive(reuse.margin[0]);
+            }
+        });
+    }
+    opt.threads = 0;
+    runner.run("carry/10k/32h/mt", items, [&](uint64_t n) {
+        for (uint64_t it = 0; it < n; ++it) {
+            simulateCarry(funding, book, opt, reuse);
+            keepAlive(reuse.margin[0]);
+        }
+    });
+}
+
+void benchRiskKernels(BenchRunner& runner, std::mt19937_64& rng) {
+    const char* const names[] = {"risk/kernel/mixed/scalar", "risk/kernel/mixed/avx2", "risk/calculator/mixed"};
+    if (std::none_of(std::begin(names), std::end(names), [&](const char* name) { return runner.enabled(name); })) return;
+    // 10USDTλұλջϵĳֲּ֣ۡ20%ļ۸ǿƽ貹䱣֤
+    std::vector<ContractSpec> specs = defaultContracts();
+    specs.push_back(makeContractSpec("BTCUSD", 1000, 0.005, 0.1, ContractType::INVERSE_COIN));
+    specs.push_back(makeContractSpec("ETHUSD", 1000, 0.005, 0.01, ContractType::INVERSE_COIN));
+    std::uniform_real_distribution<double> lev(1, 100), ratio(1, 20), price(10, 1000), move(-0.2, 0.2);
+    std::uniform_int_distribution<size_t> specDist(0, specs.size() - 1);
+    std::vector<CryptoRiskCalculator> calcs;
+    std::vector<double> marks;
+    RiskBook book;
+    for (int i = 0; i < 100000; ++i) {
+        TradeDirection dir = (rng() & 1) ? TradeDirection::LONG : TradeDirection::SHORT;
+        double entry = price(rng);
+        calcs.emplace_back(specs[specDist(rng)], lev(rng), ratio(rng), entry, dir, 10000);
+        marks.push_back(entry * (1 + move(rng)));
+        book.add(calcs.back(), marks.back());
+    }
+    std::vector<double> liq, add, liqSimd, addSimd;
+    book.compute(liq, add, false);
+    auto close = [](double a, double b) { return std::fabs(a - b) <= 1e-9 * std::max(1.0, std::fabs(b)); };
+    for (size_t i = 0; i < calcs.size(); ++i) {
+        if (!close(liq[i], calcs[i].calculateLiquidationPrice()) || !close(add[i], calcs[i].calculateMarginToAddAt(marks[i]))) {
+            throw std::runtime_error("ػںCryptoRiskCalculatorһ");
+        }
+    }
+    if (riskKernelSimdSupported()) {
+        book.compute(liqSimd, addSimd, true);
+        if (liqSimd != liq || addSimd != add) throw std::runtime_error("ػںAVX2·һ");
+    }
+    double items = static_cast<double>(calcs.size());
+    runner.run("risk/kernel/mixed/scalar", items, [&](uint64_t n) {
+        for (uint64_t it = 0; it < n; ++it) {
+            book.compute(liq, add, false);
+            keepAlive(add[0]);
+        }
+    });
+    if (riskKernelSimdSupported()) {
+        runner.run("risk/kernel/mixed/avx2", items, [&](uint64_t n) {
+            for (uint64_t it = 0; it < n; ++it) {
+                book.compute(liq, add, true);
+                keepAlive(add[0]);
+            }
+        });
+    }
+    runner.run("risk/calculator/mixed", items, [&](uint64_t n) {
+        for (uint64_t it = 0; it < n; ++it) {
+            for (size_t i = 0; i < calcs.size(); ++i) {
+                liq[i] = calcs[i].calculateLiquidationPrice();
+                add[i] = calcs[i].calculateMarginToAddAt(marks[i]);
+            }
+            keepAlive(add[0]);
+        }
+    });
+}
+
+void benchOrderBookDepth(BenchRunner& runner, std::mt19937_64& rng) {
+    const char* const names[] = {"depth/apply/1m", "depth/walls"};
+    if (std::none_of(std::begin(names), std::end(names), [&](const char* name) { return runner.enabled(name); })) return;
+    // 100̿ڸL2£мߣ¼ż200ÿԼ50
+    // м·0.5%פһǽ
+    struct Update {
+        int64_t time;
+        DepthSide side;
+        double price;
+        double quantity;
+    };
+    const double tick = 0.1;
+    std::vector<Update> updates;
+    std::normal_distribution<double> step(0, 0.3);
+    std::exponential_distribution<double> offset(1.0 / 40);
+    std::exponential_distribution<double> qty(1.0);
+    double mid = 60000;
+    for (int i = 0; i < 1000000; ++i) {
+        if (i % 1000 == 0) mid += step(rng) * 10 * tick;
+        int64_t time = i / 50;
+        DepthSide side = (rng() & 1) ? DepthSide::BID : DepthSide::ASK;
+        double distance = std::min(200.0, std::floor(offset(rng)) + 1) * tick;
+        double price = std::round((side == DepthSide::BID ? mid - distance : mid + distance) / tick) * tick;
+        double quantity = (rng() % 4 == 0) ? 0.0 : qty(rng);
+        updates.push_back({time, side, price, quantity});
+        if (i % 2000 == 0) updates.push_back({time, DepthSide::BID, std::round(mid * 0.995 / tick) * tick, 500.0});
+    }
+    DepthOptions opt;
+    auto replay = [&](DepthAggregator& depth) {
+        for (const Update& u : updates) depth.apply(u.time, u.side, u.price, u.quantity);
+        depth.advance(updates.back().time);
+    };
+    DepthAggregator check(tick, opt);
+    replay(check);
+    std::vector<DepthWall> walls = check.walls();
+    if (walls.empty() || walls[0].side != DepthSide::BID) throw std::runtime_error("δҵפǽ");
+    double items = static_cast<double>(updates.size());
+    runner.run("depth/apply/1m", items, [&](uint64_t n) {
+        for (uint64_t it = 0; it < n; ++it) {
+            DepthAggregator depth(tick, opt);
+            replay(depth);
+            keepAlive(depth.samples());
+        }
+    });
+    runner.run("depth/walls", 1, [&](uint64_t n) {
+        for (uint64_t it = 0; it < n; ++it) keepAlive(check.walls().size());
+    });
+}
+
+// ڿɸѡ2000Ʒָ6004СʱKߣУչָÿĽһ
+void benchScreener(BenchRunner& runner, std::mt19937_64& rng) {
+    const char* const names[] = {"screen/2000/shared", "screen/2000/perdir"};
+    if (std::none_of(std::begin(names), std::end(names), [&](const char* name) { return runner.enabled(name); })) return;
+    const size_t symbols = 2000;
+    const size_t barsPerSymbol = 600;
+    const int64_t interval = 4 * 3600000LL;
+    ScreenerUniverse universe;
+    universe.offsets.push_back(0);
+    for (size_t s = 0; s < symbols; ++s) {
+        universe.symbols.push_back("SYM" + std::to_string(s));
+        std::vector<KlineData> bars = generateKlines(barsPerSymbol, rng);
+        for (size_t i = 0; i < bars.size(); ++i) {
+            universe.times.push_back(static_cast<int64_t>(i) * interval);
+            universe.bars.push_back(bars[i]);
+        }
+        universe.offsets.push_back(universe.bars.size());
+    }
+    ScreenerOptions opt;
+    opt.interval = interval;
+    opt.top = 0;
+    ScreenerResult shared = screenSetups(universe, opt);
+    opt.shared = false;
+    ScreenerResult perDirection = screenSetups(universe, opt);
+    bool same = shared.setups.size() == perDirection.setups.size() && !shared.setups.empty();
+    for (size_t i = 0; same && i < shared.setups.size(); ++i) {
+        const ScreenerSetup& a = shared.setups[i];
+        const ScreenerSetup& b = perDirection.setups[i];
+        same = a.symbolIndex == b.symbolIndex && a.confluence == b.confluence && a.timeframes == b.timeframes &&
+               std::memcmp(&a.score, &b.score, sizeof(ScoreRecord)) == 0;
+    }
+    if (!same) throw std::runtime_error("ɸѡչָĽһ");
+    opt.top = 20;
+    const double items = static_cast<double>(symbols);
+    runner.run("screen/2000/shared", items, [&](uint64_t n) {
+        opt.shared = true;
+        for (uint64_t it = 0; it < n; ++it) keepAlive(screenSetups(universe, opt).scored);
+    }, 5);
+    runner.run("screen/2000/perdir", items, [&](uint64_t n) {
+        opt.shared = false;
+        for (uint64_t it = 0; it < n; ++it) keepAlive(screenSetups(universe, opt).scored);
+    }, 5);
+}
+
+// Cӿڣtradecheck_c.hlibtradecheck.soУ֡ǿƽC++ӿһҷǷ뷵ش
+void benchCApi(BenchRunner& runner, std::mt19937_64& rng) {
+    const char* const names[] = {"capi/tc_score", "capi/tc_risk_compute"};
+    if (std::none_of(std::begin(names), std::end(names), [&](const char* name) { return runner.enabled(name); })) return;
+    if (tc_abi_version() != TC_ABI_VERSION) throw std::runtime_error("libtradecheckABI汾ͷļһ");
+
+    std::vector<TradeAnalysis> analyses = generateAnalyses(1024, rng);
+    std::vector<tc_trade_analysis> inputs(analyses.size());
+    std::vector<std::vector<tc_pattern>> patterns(analyses.size());
+    const size_t mask = analyses.size() - 1;
+    for (size_t i = 0; i < analyses.size(); ++i) {
+        TradeAnalysis& ta = analyses[i];
+        if (i & 1) ta.atrRate = 1.5;
+        tc_trade_analysis& a = inputs[i];
+        a = tc_trade_analysis{};
+        a.open_dir = static_cast<uint8_t>(lookupCode(DIR_NAMES, ta.openDir));
+        a.long_trend = static_cast<uint8_t>(lookupCode(TREND_NAMES, ta.longTrend));
+        a.mid_trend = static_cast<uint8_t>(lookupCode(TREND_NAMES, ta.midTrend));
+        a.short_trend = static_cast<uint8_t>(lookupCode(TREND_NAMES, ta.shortTrend));
+        a.rsi_level = static_cast<uint8_t>(lookupCode(RSI_NAMES, ta.rsiLevel));
+        for (int t = 0; t < 3; ++t) {
+            a.ema_trend[t] = static_cast<uint8_t>(lookupCode(TREND_NAMES, ta.emaList[t].trend));
+            a.kst_cross[t] = static_cast<uint8_t>(lookupCode(KST_CROSS_NAMES, ta.kstList[t].cross));
+        }
+        for (const auto& p : ta.pricePatterns) {
+            patterns[i].push_back({static_cast<uint8_t>(lookupCode(PRICE_PATTERN_NAMES, p.name)), static_cast<uint8_t>(p.tf),
+                                   static_cast<uint8_t>(p.breakDir), 0});
+        }
+        a.leverage = ta.leverage;
+        a.short_trend_line_break_times = ta.shortTrendLineBreakTimes;
+        a.open_price = ta.openPrice;
+        a.stop_loss = ta.stopLoss;
+        a.patterns = patterns[i].data();
+        a.pattern_count = patterns[i].size();
+        a.atr_rate = ta.atrRate;
+
+        bool highRisk = false;
+        int expected = calculateTotalConsistency(ta, highRisk);
+        size_t contradictions = analyzeContradictions(ta, highRisk).size();
+        tc_score_result r;
+        if (tc_score(&a, &r, nullptr, 0, nullptr) != TC_OK || r.total_score != expected ||
+            r.high_lever_risk != (highRisk ? 1 : 0) || static_cast<size_t>(r.contradiction_count) != contradictions) {
+            throw std::runtime_error("CӿֽC++ӿڲһ");
+        }
+    }
+    tc_score_result scratch;
+    tc_trade_analysis bad = inputs[0];
+    bad.leverage = 0;
+    if (tc_score(&bad, &scratch, nullptr, 0, nullptr) != TC_INVALID_ARGUMENT) throw std::runtime_error("Cӿδܾܸ<1");
+    bad = inputs[0];
+    bad.open_price = std::nan("");
+    if (tc_score(&bad, &scratch, nullptr, 0, nullptr) != TC_INVALID_ARGUMENT) throw std::runtime_error("Cӿδܾ޿");
+    char none[1];
+    size_t needed = 0;
+    if (tc_score(&inputs[0], &scratch, none, 0, &needed) != TC_BUFFER_TOO_SMALL || needed == 0) {
+        throw std::runtime_error("CӿڶԳΪ0ıδTC_BUFFER_TOO_SMALL");
+    }
+
+    ContractTable table(defaultContracts());
+    std::vector<PositionSample> positions = generatePositions(1024, table, rng);
+    auto close = [](double a, double b) { return std::fabs(a - b) <= 1e-9 * std::max(1.0, std::fabs(b)); };
+    std::vector<tc_contract> contracts(positions.size());
+    std::vector<tc_position> cpositions(positions.size());
+    for (size_t i = 0; i < positions.size(); ++i) {
+        const PositionSample& p = positions[i];
+        contracts[i] = tc_contract{p.contract->riskThreshold, p.contract->maintenanceMarginRate, p.contract->tickSize,
+                                   p.contract->type == ContractType::INVERSE_COIN ? TC_INVERSE_COIN : TC_LINEAR_USDT, 0};
+        cpositions[i] = tc_position{p.leverage, p.positionRatio, p.entryPrice, p.totalCapital,
+                                    p.direction == TradeDirection::LONG ? TC_LONG : TC_SHORT, 0};
+        CryptoRiskCalculator calc(*p.contract, p.leverage, p.positionRatio, p.entryPrice, p.direction, p.totalCapital);
+        tc_risk_result r;
+        if (tc_risk_compute(&contracts[i], &cpositions[i], &r) != TC_OK ||
+            !close(r.liquidation_price, calc.calculateLiquidationPrice()) || !close(r.margin_to_add, calc.calculateMarginToAdd())) {
+            throw std::runtime_error("Cӿǿƽ۽C++ӿڲһ");
+        }
+    }
+    tc_risk_result riskScratch;
+    tc_position badPosition = cpositions[0];
+    badPosition.leverage = std::nan("");
+    tc_contract badContract = contracts[0];
+    badContract.maintenance_margin_rate = INFINITY;
+    if (tc_risk_compute(&contracts[0], &badPosition, &riskScratch) != TC_INVALID_ARGUMENT ||
+        tc_risk_compute(&badContract, &cpositions[0], &riskScratch) != TC_INVALID_ARGUMENT) {
+        throw std::runtime_error("Cӿδܾ޵ĳֲֻԼ");
+    }
+
+    runner.run("capi/tc_score", 1, [&](uint64_t n) {
+        char text[512];
+        tc_score_result r;
+        for (uint64_t i = 0; i < n; ++i) {
+            tc_score(&inputs[i & mask], &r, text, sizeof(text), nullptr);
+            keepAlive(r.total_score);
+        }
+    });
+    runner.run("capi/tc_risk_compute", 1, [&](uint64_t n) {
+        tc_risk_result r;
+        for (uint64_t i = 0; i < n; ++i) {
+            tc_risk_compute(&contracts[i & mask], &cpositions[i & mask], &r);
+            keepAlive(r.liquidation_price);
+        }
+    });
+}
+
+int main(int argc, char* argv[]) {
+    BenchOptions opt;
+    uint64_t seed = 20240601;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--json") opt.json = true;
+        else if (arg == "--quick") opt.quick = true;
+        else if (arg == "--filter" && i + 1 < argc) opt.filter = argv[++i];
+        else if (arg == "--min-time" && i + 1 < argc) opt.minSeconds = std::atof(argv[++i]);
+        else if (arg == "--seed" && i + 1 < argc) seed = std::strtoull(argv[++i], nullptr, 10);
+        else {
+            std::cout << "÷׼ [--json] [--quick] [--filter Ӵ] [--min-time ÿ] [--seed ]" << std::endl;
+            std::cout << "--quickǧKĿ" << std::endl;
+            return 1;
+        }
+    }
+
+    try {
+        std::mt19937_64 rng(seed);
+        BenchRunner runner(opt);
+        runner.printHeader();
+        benchRisk(runner, rng);
+        benchSupportResistance(runner, rng, opt.quick);
+        benchScore(runner, rng);
+        benchOutput(runner, rng);
+        benchCandleStore(runner, rng);
+        benchLatency(runner);
+        benchSnapshot(runner, rng);
+        benchLiquidationMap(runner, rng);
+        benchLevelStrength(runner, rng, opt.quick);
+        benchSwingZones(runner, rng);
+        benchVolatility(runner, rng);
+        benchDataQuality(runner, rng, opt.quick);
+        benchQuantileSketch(runner, rng);
+        benchPipeline(runner, rng);
+        benchCorrelation(runner, rng);
+        benchCarry(runner, rng);
+        benchRiskKernels(runner, rng);
+        benchOrderBookDepth(runner, rng);
+        benchScreener(runner, rng);
+        benchCApi(runner, rng);
+        if (opt.json) runner.printJson();
+    } catch (const std::exception& e) {
+        std::cerr << "" << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
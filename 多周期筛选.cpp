@@ -0,0 +1,125 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <cmath>
+#include "core/setup_screener.h"
+
+using namespace tradecheck;
+
+// ڿɸѡȡȫƷֵKCSVΪƷֽƷز4Сʱ//ߣ
+// ̼Ϊ֧ۡţ൥/յΪֹ𣬶򶼸ۺ֣
+// ÷ֹλĶڹ̶гǰN
+
+void printUsage() {
+    std::cout << "÷ɸѡ --input KCSV [--top N] [--leverage ܸ] [--window K] [--interval ]"
+                 " [--atr-period N] [--stop-buffer ٷֱ] [--atr-stop ] [--confluence ٷֱ] [--threads N]"
+                 " [--format text|ndjson|binary] [--output ļ] [--per-direction]"
+              << std::endl;
+    std::cout << "--per-direction ÿָλĬϵĶչýһ£ڶպʱ" << std::endl;
+}
+
+void writeSetupJson(JsonLineWriter& json, const ScreenerSetup& s) {
+    const ScoreRecord& r = s.score;
+    json.begin();
+    json.string("symbol", r.symbol)
+        .string("openDir", r.openDir == 0 ? "LONG" : "SHORT")
+        .integer("leverage", r.leverage)
+        .number("openPrice", r.openPrice)
+        .number("stopLoss", r.stopLoss)
+        .number("stopLossRate", r.stopLossRate)
+        .number("anchor", s.anchor)
+        .integer("confluence", s.confluence)
+        .integer("timeframes", s.timeframes)
+        .integer("emaScore", r.emaScore)
+        .integer("kstScore", r.kstScore)
+        .integer("baseStopLossScore", r.baseStopLossScore)
+        .integer("leverStopLossScore", r.leverStopLossScore)
+        .integer("dirMatchScore", r.dirMatchScore)
+        .integer("totalScore", r.totalScore)
+        .boolean("highLeverRisk", r.highLeverRisk != 0);
+    json.end();
+}
+
+void printSetups(BufferedWriter& out, const ScreenerResult& result) {
+    char line[256];
+    std::snprintf(line, sizeof(line), "%-4s %-14s %-4s %12s %12s %8s %12s %6s %6s %6s\n", "", "Ʒ", "", "",
+                  "ֹ", "ֹ%", "êλ", "", "", "ܷ");
+    out.write(line);
+    for (size_t i = 0; i < result.setups.size(); ++i) {
+        const ScreenerSetup& s = result.setups[i];
+        const ScoreRecord& r = s.score;
+        char anchor[32] = "ATR";
+        if (!std::isnan(s.anchor)) std::snprintf(anchor, sizeof(anchor), "%.6g", s.anchor);
+        std::snprintf(line, sizeof(line), "%-4zu %-14s %-4s %12.6g %12.6g %8.2f %12s %6d %6d %6d%s\n", i + 1, r.symbol,
+                      r.openDir == 0 ? "" : "", r.openPrice, r.stopLoss, r.stopLossRate, anchor, s.confluence,
+                      s.timeframes, r.totalScore, r.highLeverRisk ? "  ֹܸչ" : "");
+        out.write(line);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string input;
+    std::string output = "-";
+    OutputFormat format = OutputFormat::TEXT;
+    ScreenerOptions opt;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--per-direction") {
+                opt.shared = false;
+                continue;
+            }
+            if (i + 1 >= argc) throw std::invalid_argument("ȱٲֵ" + arg);
+            std::string value = argv[++i];
+            if (arg == "--input") input = value;
+            else if (arg == "--output") output = value;
+            else if (arg == "--format") format = parseOutputFormat(value);
+            else if (arg == "--top") opt.top = static_cast<size_t>(std::strtoull(value.c_str(), nullptr, 10));
+            else if (arg == "--leverage") opt.leverage = std::atoi(value.c_str());
+            else if (arg == "--window") opt.window = std::atoi(value.c_str());
+            else if (arg == "--interval") opt.interval = std::strtoll(value.c_str(), nullptr, 10);
+            else if (arg == "--atr-period") opt.atrPeriod = std::atoi(value.c_str());
+            else if (arg == "--stop-buffer") opt.stopBufferPercent = std::atof(value.c_str());
+            else if (arg == "--atr-stop") opt.atrStopMultiple = std::atof(value.c_str());
+            else if (arg == "--confluence") opt.confluencePercent = std::atof(value.c_str());
+            else if (arg == "--threads") opt.threads = static_cast<unsigned>(std::atoi(value.c_str()));
+            else throw std::invalid_argument("δ֪" + arg);
+        }
+        if (input.empty()) throw std::invalid_argument("ȱ--input");
+    } catch (const std::invalid_argument& e) {
+        std::cerr << "" << e.what() << std::endl;
+        printUsage();
+        return 1;
+    }
+
+    try {
+        ScreenerUniverse universe = buildScreenerUniverse(loadKlineCsv(input));
+        auto start = std::chrono::steady_clock::now();
+        ScreenerResult result = screenSetups(universe, opt);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        {
+            BufferedWriter out(output);
+            JsonLineWriter json(out);
+            if (format == OutputFormat::TEXT) printSetups(out, result);
+            if (format == OutputFormat::BINARY) writeRecordStreamHeader(out, RecordType::SCORE, sizeof(ScoreRecord));
+            for (const ScreenerSetup& s : result.setups) {
+                if (format == OutputFormat::BINARY) out.write(&s.score, sizeof(s.score));
+                else if (format == OutputFormat::NDJSON) writeSetupJson(json, s);
+            }
+        }
+        // д׼󣬲׼ϵļ¼
+        std::fprintf(output == "-" && format != OutputFormat::TEXT ? stderr : stdout,
+                     "ɨ%zuƷ֣K%zu%zuƷK߲㣬%zuƷֺЧKߣ%zuᣬʱ%.3f s%s\n",
+                     result.symbols, universe.bars.size(), result.skipped, result.invalid, result.scored, seconds,
+                     opt.shared ? "չָ" : "ÿ");
+    } catch (const std::exception& e) {
+        std::cerr << "" << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
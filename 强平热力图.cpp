@@ -0,0 +1,184 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <stdexcept>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <unordered_map>
+#include "core/liquidation_map.h"
+#include "core/support_resistance.h"
+#include "core/contract_registry.h"
+#include "core/kline_io.h"
+#include "core/record_writer.h"
+
+using namespace tradecheck;
+
+// ıֱͼȣַ
+const int BAR_WIDTH = 40;
+
+// ڸ÷ڵ֧λ¼۱
+std::string levelMarks(const LiquidationMap& map, size_t bin, const SupportResistanceLevels& l, double last) {
+    const struct { const char* name; double price; } levels[] = {
+        {"R3", l.r3}, {"R2", l.r2}, {"R1", l.r1}, {"P", l.pivotPoint}, {"S1", l.s1}, {"S2", l.s2}, {"S3", l.s3},
+        {"ܼ", l.denseResist}, {"ܼ֧", l.denseSupport}, {"", l.highestHigh}, {"", l.lowestLow},
+        {"¼", last}};
+    std::string marks;
+    for (const auto& level : levels) {
+        if (map.binOf(level.price) != static_cast<int>(bin)) continue;
+        marks += marks.empty() ? "  " : " ";
+        marks += level.name;
+    }
+    return marks;
+}
+
+void printMap(const std::string& symbol, const LiquidationMap& map, const SupportResistanceLevels& l, double last,
+              double mmr, double elapsedMs) {
+    std::cout << "\n===== " << symbol << " ǿƽֲ" << l.klineCount << "Kߣάֱ֤" << mmr * 100 << "%=====" << std::endl;
+    std::cout << "ϳɳֲ" << map.positions << "δǿƽֵ" << std::fixed << std::setprecision(0)
+              << map.totalNotional << " USDTʱ" << std::setprecision(2) << elapsedMs << "ms" << std::endl;
+    std::cout.unsetf(std::ios::fixed);
+    std::cout << std::setprecision(6);
+    std::cout << "λR1=" << l.r1 << " R2=" << l.r2 << " R3=" << l.r3 << " ܼ=" << l.denseResist << std::endl;
+    std::cout << "֧λS1=" << l.s1 << " S2=" << l.s2 << " S3=" << l.s3 << " ܼ֧=" << l.denseSupport << std::endl;
+
+    double peak = 0;
+    for (size_t i = 0; i < map.longNotional.size(); ++i) {
+        peak = std::max(peak, std::max(map.longNotional[i], map.shortNotional[i]));
+    }
+    std::cout << "\n۸䣨USDT            յǿƽ(+) / ൥ǿƽ(-)" << std::endl;
+    for (size_t i = map.longNotional.size(); i-- > 0;) {
+        double v = map.shortNotional[i] > 0 ? map.shortNotional[i] : map.longNotional[i];
+        int width = peak > 0 ? static_cast<int>(v / peak * BAR_WIDTH + 0.5) : 0;
+        char c = map.shortNotional[i] > 0 ? '+' : '-';
+        // ͬһնʱֿʾ
+        std::string bar(width, c);
+        if (map.shortNotional[i] > 0 && map.longNotional[i] > 0) {
+            bar += '|' + std::string(static_cast<int>(map.longNotional[i] / peak * BAR_WIDTH + 0.5), '-');
+        }
+        std::cout << std::setw(12) << map.binLow(i) << " ~ " << std::setw(12) << map.binHigh(i) << "  " << bar
+                  << levelMarks(map, i, l, last) << std::endl;
+    }
+
+    std::cout << "\nǿƽ" << std::endl;
+    for (const auto& c : topLiquidationClusters(map, 5)) {
+        std::cout << (c.direction == TradeDirection::LONG ? "൥ " : "յ ") << map.binLow(c.bin) << " ~ "
+                  << map.binHigh(c.bin) << "" << std::fixed << std::setprecision(0) << c.notional << " USDT"
+                  << levelMarks(map, c.bin, l, last) << std::endl;
+        std::cout.unsetf(std::ios::fixed);
+        std::cout << std::setprecision(6);
+    }
+}
+
+void writeMapJson(JsonLineWriter& json, const std::string& symbol, int64_t openTime, const LiquidationMap& map,
+                  const SupportResistanceLevels& l, double last, double mmr) {
+    json.begin();
+    json.string("symbol", symbol)
+        .integer("openTime", openTime)
+        .integer("klineCount", l.klineCount)
+        .number("close", last)
+        .number("maintenanceMarginRate", mmr)
+        .integer("positions", static_cast<int64_t>(map.positions))
+        .number("totalNotional", map.totalNotional)
+        .number("binLow", map.low)
+        .number("binWidth", map.binWidth)
+        .number("pivotPoint", l.pivotPoint)
+        .number("s1", l.s1)
+        .number("s2", l.s2)
+        .number("s3", l.s3)
+        .number("r1", l.r1)
+        .number("r2", l.r2)
+        .number("r3", l.r3)
+        .number("denseSupport", l.denseSupport)
+        .number("denseResist", l.denseResist);
+    json.beginArray("longNotional");
+    for (double v : map.longNotional) json.element(v);
+    json.endArray();
+    json.beginArray("shortNotional");
+    for (double v : map.shortNotional) json.element(v);
+    json.endArray();
+    json.end();
+}
+
+int main(int argc, char* argv[]) {
+    std::string inputPath, contractsPath, outputPath = "-";
+    OutputFormat format = OutputFormat::TEXT;
+    LiquidationMapOptions opt;
+    double defaultMmr = -1;
+    int window = 0;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--input" && i + 1 < argc) inputPath = argv[++i];
+            else if (arg == "--contracts" && i + 1 < argc) contractsPath = argv[++i];
+            else if (arg == "--format" && i + 1 < argc) format = parseOutputFormat(argv[++i]);
+            else if (arg == "--output" && i + 1 < argc) outputPath = argv[++i];
+            else if (arg == "--window" && i + 1 < argc) window = std::atoi(argv[++i]);
+            else if (arg == "--leverage" && i + 1 < argc) opt.leverages = parseLeverageBuckets(argv[++i]);
+            else if (arg == "--long-share" && i + 1 < argc) opt.longShare = std::atof(argv[++i]);
+            else if (arg == "--points" && i + 1 < argc) opt.pricePoints = std::atoi(argv[++i]);
+            else if (arg == "--bins" && i + 1 < argc) opt.binCount = std::atoi(argv[++i]);
+            else if (arg == "--range" && i + 1 < argc) opt.rangePercent = std::atof(argv[++i]);
+            else if (arg == "--mmr" && i + 1 < argc) defaultMmr = std::atof(argv[++i]);
+            else if (arg == "--threads" && i + 1 < argc) opt.threads = static_cast<unsigned>(std::atoi(argv[++i]));
+            else if (arg == "--keep-liquidated") opt.keepLiquidated = true;
+            else if (arg == "--no-simd") opt.simd = false;
+            else throw std::invalid_argument("δ֪" + arg);
+        }
+        if (inputPath.empty()) throw std::invalid_argument("Ҫ--inputָKCSVļ");
+        if (format == OutputFormat::BINARY) throw std::invalid_argument("ǿƽֲֻ֧text/ndjson");
+        if (window < 0) throw std::invalid_argument("KߴڳȲΪ");
+        if (!(opt.rangePercent > 0 && opt.rangePercent < 100)) throw std::invalid_argument("۸ٷֱ0~100֮");
+        if (defaultMmr >= 1) throw std::invalid_argument("άֱ֤0~1֮");
+
+        ContractTable contracts(contractsPath.empty() ? defaultContracts() : loadContractConfig(contractsPath));
+        std::vector<KlineRow> rows = loadKlineCsv(inputPath);
+        std::vector<std::string> symbols;
+        std::unordered_map<std::string, size_t> symbolIndex;
+        std::vector<std::vector<KlineData>> series;
+        std::vector<int64_t> lastOpenTime;
+        for (const auto& row : rows) {
+            auto it = symbolIndex.find(row.symbol);
+            if (it == symbolIndex.end()) {
+                it = symbolIndex.emplace(row.symbol, symbols.size()).first;
+                symbols.push_back(row.symbol);
+                series.emplace_back();
+                lastOpenTime.push_back(0);
+            }
+            series[it->second].push_back(row.kline);
+            lastOpenTime[it->second] = row.openTime;
+        }
+
+        std::unique_ptr<BufferedWriter> out;
+        std::unique_ptr<JsonLineWriter> json;
+        if (format == OutputFormat::NDJSON) {
+            out.reset(new BufferedWriter(outputPath));
+            json.reset(new JsonLineWriter(*out));
+        }
+        for (size_t id = 0; id < symbols.size(); ++id) {
+            // δõĺԼʹ--mmrδָʱ
+            const ContractSpec* spec = contracts.lookup(symbols[id]);
+            if (!spec && defaultMmr < 0) throw std::invalid_argument("δõĺԼ" + symbols[id] + "--mmrָάֱ֤ʣ");
+            double mmr = spec ? spec->maintenanceMarginRate : defaultMmr;
+            ContractType type = spec ? spec->type : ContractType::LINEAR_USDT;
+
+            const std::vector<KlineData>& bars = series[id];
+            size_t begin = window > 0 && bars.size() > static_cast<size_t>(window) ? bars.size() - window : 0;
+            SupportResistanceCalculator src(bars.data() + begin, bars.size() - begin, TimeFrame::DAILY);
+            auto start = std::chrono::steady_clock::now();
+            LiquidationMap map = computeLiquidationMap(bars.data() + begin, bars.size() - begin, mmr, opt, type);
+            double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            double last = bars.back().close;
+            if (json) writeMapJson(*json, symbols[id], lastOpenTime[id], map, src.getLevels(), last, mmr);
+            else printMap(symbols[id], map, src.getLevels(), last, mmr, elapsedMs);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "" << e.what() << std::endl;
+        std::cerr << "÷ǿƽͼ --input KCSV [--window K] [--leverage ܸ:Ȩ,...] [--long-share ൥]"
+                     " [--points ÿK߿ּ] [--bins ] [--range ¼°ٷֱ] [--contracts Լ]"
+                     " [--mmr δúԼάֱ֤] [--keep-liquidated] [--threads N] [--no-simd]"
+                     " [--format text|ndjson] [--output ļ]" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -5,138 +5,26 @@
 #include <cmath>
 #include <vector>   // 洢K
 #include <algorithm> // ڲ/Сֵ
+#include <memory>
+#include <iomanip>
+#include <unordered_map>
+#include "core/support_resistance.h"
+#include "core/streaming_levels.h"
+#include "core/kline_io.h"
+#include "core/output_records.h"
+#include "core/input_journal.h"
+#include "core/level_strength.h"
+#include "core/swing_zones.h"
+#include "core/data_quality.h"
+#include "core/quantile_sketch.h"
+#include "core/order_book_depth.h"
 
-// ʱö
-enum class TimeFrame {
-    DAILY,    // 
-    FOUR_HOUR // 4Сʱ
-};
-
-// Kݽṹ壨KߵĿ////ɽ
-struct KlineData {
-    double open;   // ̼
-    double high;   // ߼
-    double low;    // ͼ
-    double close;  // ̼
-    double volume; // ɽѡܼɽ㣩
-};
+using namespace tradecheck;
 
 // ǰ
 double getInputValue(const std::string& prompt);
 std::vector<KlineData> inputMultiKlineData(int klineCount);
 
-// K֧ѹλ
-class SupportResistanceCalculator {
-private:
-    std::vector<KlineData> klineList; // K
-    TimeFrame timeframe;              // ʱ
-    int klineCount;                   // K
-    // ʷߵ͵
-    double highestHigh; // ׶߼
-    double lowestLow;   // ׶ͼ
-    // 㣨ȡһK߼㣩
-    double pivotPoint, s1, s2, s3, r1, r2, r3;
-    // ܼɽ̼۾ֵ׼
-    double avgClose;    // ̼۾ֵ
-    double stdClose;    // ̼۱׼
-    double denseSupport; // ܼɽ֧λ
-    double denseResist;  // ܼɽλ
-
-    // УKݺϷ
-    void validateKlineList() const {
-        if (klineList.empty()) {
-            throw std::invalid_argument("KݲΪ");
-        }
-        for (const auto& kd : klineList) {
-            if (kd.high < kd.low) {
-                throw std::invalid_argument("߼۵ͼ۵ЧK");
-            }
-        }
-    }
-
-    // ׶ʷߵ͵
-    void calculateHistoryHighLow() {
-        highestHigh = klineList[0].high;
-        lowestLow = klineList[0].low;
-        for (const auto& kd : klineList) {
-            highestHigh = std::max(highestHigh, kd.high);
-            lowestLow = std::min(lowestLow, kd.low);
-        }
-    }
-
-    // Kߵ֧
-    void calculatePivotPoint() {
-        const KlineData& latestKline = klineList.back(); // ȡһK
-        pivotPoint = (latestKline.high + latestKline.low + latestKline.close) / 3.0;
-        double range = latestKline.high - latestKline.low;
-        // ֧λ
-        s1 = 2 * pivotPoint - latestKline.high;
-        s2 = pivotPoint - range;
-        s3 = pivotPoint - 2 * range;
-        // λ
-        r1 = 2 * pivotPoint - latestKline.low;
-        r2 = pivotPoint + range;
-        r3 = pivotPoint + 2 * range;
-    }
-
-    // ܼɽ֧̼۾ֵ׼
-    void calculateDenseArea() {
-        // ̼۾ֵ
-        double sumClose = 0.0;
-        for (const auto& kd : klineList) {
-            sumClose += kd.close;
-        }
-        avgClose = sumClose / klineList.size();
-
-        // ̼۱׼
-        double sumVar = 0.0;
-        for (const auto& kd : klineList) {
-            sumVar += pow(kd.close - avgClose, 2);
-        }
-        stdClose = sqrt(sumVar / klineList.size());
-
-        // ܼɽֵ1׼
-        denseSupport = avgClose - stdClose;
-        denseResist = avgClose + stdClose;
-    }
-
-public:
-    // 캯Kߺʱ
-    SupportResistanceCalculator(std::vector<KlineData> klList, TimeFrame tf)
-        : klineList(klList), timeframe(tf), klineCount(klList.size()) {
-        validateKlineList();
-        calculateHistoryHighLow();
-        calculatePivotPoint();
-        calculateDenseArea();
-    }
-
-    // ֧λ
-    void printAllSupportResistance() const {
-        std::string tfName = (timeframe == TimeFrame::DAILY) ? "" : "4Сʱ";
-        std::cout << "\n===== " << tfName << "֧λ" << klineCount << "Kߣ=====" << std::endl;
-
-        std::cout << "\nʷߵ͵֧" << std::endl;
-        std::cout << "׶߼ۣ" << highestHigh << " USDT" << std::endl;
-        std::cout << "׶ͼۣ֧ţ" << lowestLow << " USDT" << std::endl;
-
-        std::cout << "\n֧Kߣ" << std::endl;
-        std::cout << "㣨P" << pivotPoint << std::endl;
-        std::cout << "֧λS1=" << s1 << " | S2=" << s2 << " | S3=" << s3 << std::endl;
-        std::cout << "λR1=" << r1 << " | R2=" << r2 << " | R3=" << r3 << std::endl;
-
-        std::cout << "\nܼɽ֧" << std::endl;
-        std::cout << "ܼɽ֧λ" << denseSupport << " USDT" << std::endl;
-        std::cout << "ܼɽλ" << denseResist << " USDT" << std::endl;
-        std::cout << "===============================================\n" << std::endl;
-    }
-
-    // Getter
-    double getHighestHigh() const { return highestHigh; }
-    double getLowestLow() const { return lowestLow; }
-    double getDenseSupport() const { return denseSupport; }
-    double getDenseResist() const { return denseResist; }
-};
-
 // ѡʱ
 TimeFrame selectTimeframe() {
     int choice;
@@ -170,6 +58,26 @@ std::vector<KlineData> inputMultiKlineData(int klineCount) {
     return klineList;
 }
 
+// ֧λ
+void printAllSupportResistance(const SupportResistanceLevels& l, TimeFrame timeframe) {
+    std::string tfName = (timeframe == TimeFrame::DAILY) ? "" : "4Сʱ";
+    std::cout << "\n===== " << tfName << "֧λ" << l.klineCount << "Kߣ=====" << std::endl;
+
+    std::cout << "\nʷߵ͵֧" << std::endl;
+    std::cout << "׶߼ۣ" << l.highestHigh << " USDT" << std::endl;
+    std::cout << "׶ͼۣ֧ţ" << l.lowestLow << " USDT" << std::endl;
+
+    std::cout << "\n֧Kߣ" << std::endl;
+    std::cout << "㣨P" << l.pivotPoint << std::endl;
+    std::cout << "֧λS1=" << l.s1 << " | S2=" << l.s2 << " | S3=" << l.s3 << std::endl;
+    std::cout << "λR1=" << l.r1 << " | R2=" << l.r2 << " | R3=" << l.r3 << std::endl;
+
+    std::cout << "\nܼɽ֧" << std::endl;
+    std::cout << "ܼɽ֧λ" << l.denseSupport << " USDT" << std::endl;
+    std::cout << "ܼɽλ" << l.denseResist << " USDT" << std::endl;
+    std::cout << "===============================================\n" << std::endl;
+}
+
 // ȡֵ
 double getInputValue(const std::string& prompt) {
     double value;
@@ -184,8 +92,337 @@ double getInputValue(const std::string& prompt) {
     return value;
 }
 
-// 
-int main() {
+// λǿڶδָڵģʽʹãϴģʽЧ
+struct AnalysisOptions {
+    bool strength = false;
+    double tolerance = 0.005;  // ݲ
+    size_t volumeNodes = 10;   // ĳɽ
+    bool zones = false;
+    SwingZoneOptions zone;
+    bool bands = false;        // λ۸
+    unsigned threads = 0;      // /λ߳0ʾCPU
+    CleanMode clean = CleanMode::NONE;
+    QualityOptions quality;
+    std::string depthPath;     // ļǿʱҵǽK߼λϲ
+    std::string contractsPath; // ԼãȶС۸䶯չΪʱúԼ
+    DepthOptions depth;
+};
+
+void printLevelStrength(const std::vector<LevelStrength>& ranked, double tolerance) {
+    std::cout << "λǿݲ" << tolerance * 100 << "%ס/" << std::endl;
+    for (size_t i = 0; i < ranked.size(); ++i) {
+        const LevelStrength& s = ranked[i];
+        std::cout << std::setw(3) << i + 1 << ". " << std::setw(8) << levelSourceName(s.source) << " " << std::setw(12)
+                  << s.price << "  ֧" << s.supportHolds << "/" << s.supportTests << "  " << s.resistHolds << "/"
+                  << s.resistTests << "  ÷" << s.score << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+void writeLevelStrengthJson(JsonLineWriter& json, const std::string& symbol, size_t rank, const LevelStrength& s) {
+    json.begin();
+    json.string("symbol", symbol)
+        .integer("rank", static_cast<int64_t>(rank))
+        .string("level", levelSourceName(s.source))
+        .number("price", s.price)
+        .integer("supportTests", s.supportTests)
+        .integer("supportHolds", s.supportHolds)
+        .integer("resistTests", s.resistTests)
+        .integer("resistHolds", s.resistHolds)
+        .number("score", s.score);
+    json.end();
+}
+
+// ӡڶ֧ǿ
+void printSwingZones(const std::vector<SwingZone>& zones, size_t barCount) {
+    std::cout << "ڶ֧ǿȣ" << std::endl;
+    for (size_t i = 0; i < zones.size(); ++i) {
+        const SwingZone& z = zones[i];
+        std::cout << std::setw(3) << i + 1 << ". " << std::setw(12) << z.low << " ~ " << std::setw(12) << z.high
+                  << "  " << z.center << "  ߵ" << z.swingHighs << " ͵" << z.swingLows << "  ǿ" << z.strength
+                  << "  ڶ" << barCount - 1 - z.lastSwing << "" << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+void writeSwingZoneJson(JsonLineWriter& json, const std::string& symbol, size_t rank, const SwingZone& z) {
+    json.begin();
+    json.string("symbol", symbol)
+        .integer("zone", static_cast<int64_t>(rank))
+        .number("low", z.low)
+        .number("high", z.high)
+        .number("center", z.center)
+        .number("width", z.width())
+        .integer("swingHighs", z.swingHighs)
+        .integer("swingLows", z.swingLows)
+        .number("strength", z.strength)
+        .integer("lastSwing", static_cast<int64_t>(z.lastSwing));
+    json.end();
+}
+
+void printQuantileBands(const QuantileBands& b) {
+    std::cout << "λ۸20/50/80λt-digest" << std::endl;
+    std::cout << "ͼۣ" << b.price[0] << " / " << b.price[1] << " / " << b.price[2] << std::endl;
+    std::cout << "ɽȨ" << b.volumePrice[0] << " / " << b.volumePrice[1] << " / " << b.volumePrice[2] << std::endl;
+    std::cout << std::endl;
+}
+
+void writeQuantileBandsJson(JsonLineWriter& json, const std::string& symbol, const QuantileBands& b) {
+    json.begin();
+    json.string("symbol", symbol)
+        .integer("bars", static_cast<int64_t>(b.bars))
+        .number("p20", b.price[0])
+        .number("p50", b.price[1])
+        .number("p80", b.price[2])
+        .number("vwP20", b.volumePrice[0])
+        .number("vwP50", b.volumePrice[1])
+        .number("vwP80", b.volumePrice[2]);
+    json.end();
+}
+
+void printDepthLevels(const std::vector<DepthWall>& walls, const std::vector<DepthLevel>& merged) {
+    std::cout << "ҵǽǿȣ" << std::endl;
+    for (size_t i = 0; i < walls.size(); ++i) {
+        const DepthWall& w = walls[i];
+        std::cout << std::setw(3) << i + 1 << ". " << (w.side == DepthSide::BID ? "" : "") << " " << std::setw(12)
+                  << w.low << " ~ " << std::setw(12) << w.high << "  " << w.price << "  " << w.persistence * 100
+                  << "%  ƽҵ" << w.averageDepth << "  ǿ" << w.strength << std::endl;
+    }
+    std::cout << "K߼λҵǽϲ" << std::endl;
+    for (const DepthLevel& d : merged) {
+        std::cout << "  " << std::setw(8) << levelSourceName(d.source) << " " << std::setw(12) << d.price;
+        if (d.wall >= 0) std::cout << "  ҵǽ#" << d.wall + 1 << "" << depthSideName(walls[d.wall].side) << "ǿ" << d.strength << "";
+        else std::cout << "  ޹ҵǽ";
+        std::cout << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+void writeDepthLevelJson(JsonLineWriter& json, const std::string& symbol, const std::vector<DepthWall>& walls,
+                         const DepthLevel& d) {
+    json.begin();
+    json.string("symbol", symbol).string("level", levelSourceName(d.source)).number("price", d.price);
+    if (d.wall >= 0) {
+        const DepthWall& w = walls[d.wall];
+        json.string("wallSide", depthSideName(w.side))
+            .number("wallLow", w.low)
+            .number("wallHigh", w.high)
+            .number("persistence", w.persistence)
+            .number("averageDepth", w.averageDepth)
+            .number("wallStrength", w.strength);
+    }
+    json.end();
+}
+
+// KCSVļδָʱÿƷһȫKߣ
+// ָʱÿƷִӵwindowKÿһڽ
+// ָ--strengthʱÿƷֵ֧λɽ尴ȫKϵĴ/ס
+// ָ--zonesʱȫƷֵİڶȲ
+// ָ--bandsʱÿƷֵK̷߰߳ƬͳƷλͼٺϲ
+// ָ--depthʱļ꣬ÿƷֵĹҵǽ֧λɽϲ
+void runBatch(const std::string& inputPath, TimeFrame tf, int window, OutputFormat format, const std::string& outputPath,
+              const AnalysisOptions& analysis, JournalWriter* journal) {
+    std::vector<KlineRow> rows = loadKlineCsv(inputPath);
+    if (analysis.clean != CleanMode::NONE) {
+        CleanStats s = cleanKlineRows(rows, analysis.clean, analysis.quality);
+        std::cerr << "ϴɾ" << s.dropped << "" << s.repaired << "" << s.filled << "" << std::endl;
+    }
+    std::vector<std::string> symbols;
+    std::unordered_map<std::string, size_t> symbolIndex;
+    std::vector<std::vector<KlineData>> series;
+    std::vector<std::unique_ptr<StreamingSupportResistance>> streams;
+    std::vector<int64_t> lastOpenTime;
+    std::vector<SymbolDepth> depths;
+    if (!analysis.depthPath.empty()) {
+        ContractTable contracts(analysis.contractsPath.empty() ? defaultContracts() : loadContractConfig(analysis.contractsPath));
+        depths = loadDepthFile(analysis.depthPath, contracts, analysis.depth);
+    }
+
+    std::unique_ptr<BufferedWriter> out;
+    std::unique_ptr<JsonLineWriter> json;
+    if (format != OutputFormat::TEXT) {
+        out.reset(new BufferedWriter(outputPath));
+        json.reset(new JsonLineWriter(*out));
+        if (format == OutputFormat::BINARY) {
+            writeRecordStreamHeader(*out, RecordType::SUPPORT_RESISTANCE, sizeof(LevelsRecord));
+        }
+    }
+    auto emit = [&](const std::string& symbol, int64_t openTime, const SupportResistanceLevels& l) {
+        if (format == OutputFormat::TEXT) {
+            std::cout << "\nƷ֣" << symbol << "һK߿ʱ" << openTime << "";
+            printAllSupportResistance(l, tf);
+            return;
+        }
+        LevelsRecord record = makeLevelsRecord(symbol, openTime, tf, l);
+        if (format == OutputFormat::BINARY) out->write(&record, sizeof(record));
+        else writeLevelsJson(*json, record);
+    };
+
+    for (const auto& row : rows) {
+        auto it = symbolIndex.find(row.symbol);
+        if (it == symbolIndex.end()) {
+            it = symbolIndex.emplace(row.symbol, symbols.size()).first;
+            symbols.push_back(row.symbol);
+            lastOpenTime.push_back(0);
+            if (window > 0) {
+                streams.emplace_back(new StreamingSupportResistance);
+                streams.back()->reset(window);
+            } else {
+                series.emplace_back();
+            }
+        }
+        size_t id = it->second;
+        lastOpenTime[id] = row.openTime;
+        if (window > 0) {
+            StreamingSupportResistance& state = *streams[id];
+            state.update(row.kline);
+            bool full = state.count == window;
+            SupportResistanceLevels l{};
+            if (full) l = state.levels();
+            // δKҲҪ¼طʱܵõͬĴ״̬
+            if (journal) {
+                LevelsRecord record = makeLevelsRecord(row.symbol, row.openTime, tf, l);
+                journal->appendCandles(record, full, &row.kline, 1, static_cast<uint32_t>(window));
+            }
+            if (full) emit(row.symbol, row.openTime, l);
+        } else {
+            series[id].push_back(row.kline);
+        }
+    }
+    if (window == 0) {
+        std::vector<std::vector<SwingZone>> zones;
+        if (analysis.zones) {
+            std::vector<KlineSeries> inputs;
+            for (const auto& bars : series) inputs.push_back({bars.data(), bars.size()});
+            zones = computeSwingZonesBatch(inputs, analysis.zone, analysis.threads);
+        }
+        for (size_t id = 0; id < symbols.size(); ++id) {
+            SupportResistanceLevels l = computeSupportResistance(series[id].data(), series[id].size());
+            if (journal) {
+                LevelsRecord record = makeLevelsRecord(symbols[id], lastOpenTime[id], tf, l);
+                journal->appendCandles(record, true, series[id].data(), static_cast<uint32_t>(series[id].size()), 0);
+            }
+            emit(symbols[id], lastOpenTime[id], l);
+            const std::vector<KlineData>& bars = series[id];
+            if (analysis.strength) {
+                std::vector<LevelCandidate> candidates =
+                    collectLevelCandidates(l, bars.data(), bars.size(), analysis.volumeNodes);
+                std::vector<LevelStrength> ranked =
+                    rankLevelStrength(candidates, bars.data(), bars.size(), analysis.tolerance);
+                if (format == OutputFormat::TEXT) {
+                    printLevelStrength(ranked, analysis.tolerance);
+                } else {
+                    for (size_t i = 0; i < ranked.size(); ++i) writeLevelStrengthJson(*json, symbols[id], i + 1, ranked[i]);
+                }
+            }
+            if (analysis.bands) {
+                QuantileBands b = computeQuantileBands(bars.data(), bars.size(), analysis.threads);
+                if (format == OutputFormat::TEXT) printQuantileBands(b);
+                else writeQuantileBandsJson(*json, symbols[id], b);
+            }
+            if (analysis.zones) {
+                if (format == OutputFormat::TEXT) {
+                    printSwingZones(zones[id], bars.size());
+                } else {
+                    for (size_t i = 0; i < zones[id].size(); ++i) writeSwingZoneJson(*json, symbols[id], i + 1, zones[id][i]);
+                }
+            }
+            // ҵǽ¸ſһK߼λ
+            if (!analysis.depthPath.empty()) {
+                const SymbolDepth* d = findDepth(depths, symbols[id]);
+                if (!d) {
+                    if (format == OutputFormat::TEXT) std::cout << "ļûиƷ֣\n" << std::endl;
+                    continue;
+                }
+                std::vector<DepthWall> walls = d->depth.walls();
+                std::vector<DepthLevel> merged = mergeDepthLevels(
+                    collectLevelCandidates(l, bars.data(), bars.size(), analysis.volumeNodes), walls,
+                    analysis.depth.bucketPercent / 100);
+                if (format == OutputFormat::TEXT) {
+                    printDepthLevels(walls, merged);
+                } else {
+                    for (const DepthLevel& level : merged) writeDepthLevelJson(*json, symbols[id], walls, level);
+                }
+            }
+        }
+    }
+}
+
+// δָ--inputʱΪģʽ
+int main(int argc, char* argv[]) {
+    OutputFormat format = OutputFormat::TEXT;
+    std::string inputPath;
+    std::string outputPath = "-";
+    std::string journalPath;
+    TimeFrame batchTf = TimeFrame::DAILY;
+    int window = 0;
+    bool batch = false;
+    AnalysisOptions analysis;
+    std::unique_ptr<JournalWriter> journal;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--journal" && i + 1 < argc) {
+                journalPath = argv[++i];
+                continue;
+            }
+            batch = true;
+            if (arg == "--format" && i + 1 < argc) format = parseOutputFormat(argv[++i]);
+            else if (arg == "--input" && i + 1 < argc) inputPath = argv[++i];
+            else if (arg == "--output" && i + 1 < argc) outputPath = argv[++i];
+            else if (arg == "--window" && i + 1 < argc) window = std::atoi(argv[++i]);
+            else if (arg == "--strength") analysis.strength = true;
+            else if (arg == "--tolerance" && i + 1 < argc) analysis.tolerance = std::atof(argv[++i]) / 100.0;
+            else if (arg == "--volume-nodes" && i + 1 < argc) analysis.volumeNodes = static_cast<size_t>(std::atoi(argv[++i]));
+            else if (arg == "--zones") analysis.zones = true;
+            else if (arg == "--bands") analysis.bands = true;
+            else if (arg == "--swing-radius" && i + 1 < argc) analysis.zone.radius = std::atoi(argv[++i]);
+            else if (arg == "--zone-bandwidth" && i + 1 < argc) analysis.zone.bandwidthPercent = std::atof(argv[++i]);
+            else if (arg == "--zone-half-life" && i + 1 < argc) analysis.zone.recencyHalfLife = std::atof(argv[++i]);
+            else if (arg == "--threads" && i + 1 < argc) analysis.threads = static_cast<unsigned>(std::atoi(argv[++i]));
+            else if (arg == "--clean" && i + 1 < argc) analysis.clean = parseCleanMode(argv[++i]);
+            else if (arg == "--spike-sigma" && i + 1 < argc) analysis.quality.spikeSigma = std::atof(argv[++i]);
+            else if (arg == "--depth" && i + 1 < argc) analysis.depthPath = argv[++i];
+            else if (arg == "--contracts" && i + 1 < argc) analysis.contractsPath = argv[++i];
+            else if (arg == "--depth-bucket" && i + 1 < argc) analysis.depth.bucketPercent = std::atof(argv[++i]);
+            else if (arg == "--depth-range" && i + 1 < argc) analysis.depth.rangePercent = std::atof(argv[++i]);
+            else if (arg == "--wall-multiple" && i + 1 < argc) analysis.depth.wallMultiple = std::atof(argv[++i]);
+            else if (arg == "--wall-persistence" && i + 1 < argc) analysis.depth.minPersistence = std::atof(argv[++i]) / 100.0;
+            else if (arg == "--sample-ms" && i + 1 < argc) analysis.depth.sampleInterval = std::atoll(argv[++i]);
+            else if (arg == "--timeframe" && i + 1 < argc) {
+                std::string name = argv[++i];
+                if (name == "daily") batchTf = TimeFrame::DAILY;
+                else if (name == "4h") batchTf = TimeFrame::FOUR_HOUR;
+                else throw std::invalid_argument("ʱΪdaily4h");
+            } else throw std::invalid_argument("δ֪" + arg);
+        }
+        if (batch && inputPath.empty()) throw std::invalid_argument("ģʽҪ--inputָKCSVļ");
+        if (window < 0 || window > MAX_STREAM_WINDOW) throw std::invalid_argument("ڳ1~512֮");
+        bool analyses = analysis.strength || analysis.zones || analysis.bands || !analysis.depthPath.empty();
+        if (analyses && (window > 0 || format == OutputFormat::BINARY)) {
+            throw std::invalid_argument("--strength/--zones/--bands/--depth--windowͬʱʹ");
+        }
+        if (!journalPath.empty()) {
+            journal.reset(new JournalWriter(journalPath));
+            journal->appendSession(journalCommandLine(argc, argv));
+        }
+        if (batch) {
+            runBatch(inputPath, batchTf, window, format, outputPath, analysis, journal.get());
+            return 0;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "" << e.what() << std::endl;
+        std::cerr << "÷֧λ --input KCSV [--format text|ndjson|binary] [--output ļ]"
+                     " [--window K] [--timeframe daily|4h] [--journal ־]"
+                     " [--strength [--tolerance ݲٷֱ] [--volume-nodes ɽ]]"
+                     " [--zones [--swing-radius N] [--zone-bandwidth ٷֱ] [--zone-half-life K] [--threads N]]"
+                     " [--bands] [--clean mask|repair [--spike-sigma ]]"
+                     " [--depth ļ [--contracts Լ] [--depth-bucket ٷֱ] [--depth-range Χٷֱ]"
+                     " [--wall-multiple ] [--wall-persistence ٷֱ] [--sample-ms ]]"
+                  << std::endl;
+        return 1;
+    }
+
     char continueFlag;
     do {
         try {
@@ -200,7 +437,11 @@ int main() {
             std::vector<KlineData> klineList = inputMultiKlineData(klineCount);
             // 4. 
             SupportResistanceCalculator src(klineList, tf);
-            src.printAllSupportResistance();
+            if (journal) {
+                LevelsRecord record = makeLevelsRecord("", 0, tf, src.getLevels());
+                journal->appendCandles(record, true, klineList.data(), static_cast<uint32_t>(klineList.size()), 0);
+            }
+            printAllSupportResistance(src.getLevels(), src.getTimeframe());
 
         } catch (const std::invalid_argument& e) {
             std::cerr << "" << e.what() << "\n" << std::endl;
@@ -0,0 +1,336 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <stdexcept>
+#include <cstdlib>
+#include <chrono>
+#include <cstring>
+#include "core/input_journal.h"
+#include "core/streaming_levels.h"
+#include "core/risk_protocol.h"
+
+using namespace tradecheck;
+
+// ־طţ¼˳棬־еĽλȶԣͳƻط
+
+void printUsage() {
+    std::cout << "÷־ط <־> [--repeat ] [--no-verify] [--list] [--max-report ]" << std::endl;
+    std::cout << "  --repeat      ־ظطŵĴڲ£Ĭ1" << std::endl;
+    std::cout << "  --no-verify   ֻ¼㣬ȶԽ" << std::endl;
+    std::cout << "  --list        г¼ժҪط" << std::endl;
+    std::cout << "  --max-report  ౨Ĳһ¼¼Ĭ10" << std::endl;
+}
+
+const char* entryTypeName(uint16_t type) {
+    switch (static_cast<JournalEntryType>(type)) {
+        case JournalEntryType::SESSION: return "SESSION";
+        case JournalEntryType::CONTRACTS: return "CONTRACTS";
+        case JournalEntryType::POSITION: return "POSITION";
+        case JournalEntryType::CANDLES: return "CANDLES";
+        case JournalEntryType::ANALYSIS: return "ANALYSIS";
+        default: return "UNKNOWN";
+    }
+}
+
+const int ENTRY_TYPE_SLOTS = 6; // ±꼴JournalEntryType0ΧͼUNKNOWN
+
+struct ReplayOptions {
+    int repeat = 1;
+    bool verify = true;
+    int maxReport = 10;
+};
+
+class Replayer {
+public:
+    explicit Replayer(const ReplayOptions& opts)
+        : options(opts), contracts(new ContractTable(defaultContracts())), out(stderr), json(out) {}
+
+    uint64_t counts[ENTRY_TYPE_SLOTS] = {};
+    uint64_t mismatches = 0;
+
+    // طһ¼һʱfalse
+    bool replay(const JournalReader::Entry& e) {
+        uint16_t type = e.header->type;
+        counts[type < ENTRY_TYPE_SLOTS ? type : 0]++;
+        switch (static_cast<JournalEntryType>(type)) {
+            case JournalEntryType::SESSION: resetSession(); return true;
+            case JournalEntryType::CONTRACTS: return replayContracts(e);
+            case JournalEntryType::POSITION: return replayPosition(e);
+            case JournalEntryType::CANDLES: return replayCandles(e);
+            case JournalEntryType::ANALYSIS: return replayAnalysis(e);
+            default: return true; // °汾дļ¼ͣ
+        }
+    }
+
+    void resetSession() {
+        contracts.reset(new ContractTable(defaultContracts()));
+        streams.clear();
+    }
+
+private:
+    ReplayOptions options;
+    std::unique_ptr<ContractTable> contracts;
+    std::unordered_map<std::string, std::unique_ptr<StreamingSupportResistance>> streams;
+    AnalysisArena arena;
+    BufferedWriter out;
+    JsonLineWriter json;
+
+    bool report(const JournalReader::Entry& e, const std::string& reason) {
+        mismatches++;
+        if (mismatches <= static_cast<uint64_t>(options.maxReport)) {
+            out.flush();
+            std::cerr << "" << e.header->sequence << "" << entryTypeName(e.header->type) << "" << reason
+                      << std::endl;
+        }
+        return false;
+    }
+
+    bool showDetail() const { return mismatches <= static_cast<uint64_t>(options.maxReport); }
+
+    bool replayContracts(const JournalReader::Entry& e) {
+        uint32_t length = e.header->length;
+        if (length % sizeof(ContractSpec) != 0) return report(e, "ԼóЧ");
+        std::vector<ContractSpec> specs(length / sizeof(ContractSpec));
+        std::memcpy(specs.data(), e.payload, length);
+        contracts.reset(new ContractTable(specs));
+        return true;
+    }
+
+    bool replayPosition(const JournalReader::Entry& e) {
+        if (e.header->length != sizeof(RiskRecord)) return report(e, "ֲּ¼Ч");
+        RiskRecord expected;
+        std::memcpy(&expected, e.payload, sizeof(expected));
+        RiskRecord actual;
+        try {
+            TradeDirection dir = expected.direction == 0 ? TradeDirection::LONG : TradeDirection::SHORT;
+            CryptoRiskCalculator calc(contracts->at(expected.symbol), expected.leverage, expected.positionRatio,
+                                      expected.entryPrice, dir, expected.totalCapital);
+            actual = makeRiskRecord(calc);
+        } catch (const std::invalid_argument& ex) {
+            return report(e, std::string("¼ʧܣ") + ex.what());
+        }
+        if (!options.verify || std::memcmp(&expected, &actual, sizeof(actual)) == 0) return true;
+        report(e, "ǿƽ/֤һ£Ϊ¼ֵطֵ");
+        if (showDetail()) {
+            writeRiskJson(json, expected);
+            writeRiskJson(json, actual);
+            out.flush();
+        }
+        return false;
+    }
+
+    bool replayCandles(const JournalReader::Entry& e) {
+        if (e.header->length < sizeof(JournalCandles)) return report(e, "K߼¼Ч");
+        JournalCandles c;
+        std::memcpy(&c, e.payload, sizeof(c));
+        if (e.header->length != sizeof(c) + static_cast<uint64_t>(c.barCount) * sizeof(KlineData)) {
+            return report(e, "K߼¼Ч");
+        }
+        // ذ8ֽڶ룬KlineDataֱӳڴ϶ȡ
+        const KlineData* bars = reinterpret_cast<const KlineData*>(e.payload + sizeof(c));
+        TimeFrame tf = c.result.timeframe == 0 ? TimeFrame::DAILY : TimeFrame::FOUR_HOUR;
+        LevelsRecord actual;
+        try {
+            if (c.window == 0) {
+                actual = makeLevelsRecord(c.result.symbol, c.result.openTime, tf, computeSupportResistance(bars, c.barCount));
+            } else {
+                std::unique_ptr<StreamingSupportResistance>& state = streams[c.result.symbol];
+                if (!state || state->window != static_cast<int>(c.window)) {
+                    state.reset(new StreamingSupportResistance);
+                    state->reset(static_cast<int>(c.window));
+                }
+                for (uint32_t i = 0; i < c.barCount; ++i) state->update(bars[i]);
+                bool full = state->count == state->window;
+                if (full != (c.hasResult != 0)) return report(e, "״̬¼һ");
+                if (!full) return true;
+                actual = makeLevelsRecord(c.result.symbol, c.result.openTime, tf, state->levels());
+            }
+        } catch (const std::invalid_argument& ex) {
+            return report(e, std::string("¼ʧܣ") + ex.what());
+        }
+        if (!options.verify || std::memcmp(&c.result, &actual, sizeof(actual)) == 0) return true;
+        report(e, "֧λһ£Ϊ¼ֵطֵ");
+        if (showDetail()) {
+            writeLevelsJson(json, c.result);
+            writeLevelsJson(json, actual);
+            out.flush();
+        }
+        return false;
+    }
+
+    bool replayAnalysis(const JournalReader::Entry& e) {
+        if (e.header->length < sizeof(JournalAnalysis)) return report(e, "ּ¼Ч");
+        JournalAnalysis a;
+        std::memcpy(&a, e.payload, sizeof(a));
+        if (e.header->length != sizeof(a) + static_cast<uint64_t>(a.requestLength) + a.textLength) {
+            return report(e, "ּ¼Ч");
+        }
+        const char* request = reinterpret_cast<const char*>(e.payload + sizeof(a));
+        const char* text = request + a.requestLength;
+
+        arena.reset();
+        TradeAnalysis ta(arena.allocator());
+        if (!decodeScoreRequest(request, a.requestLength, ta)) return report(e, "޷");
+        ta.coinType = a.result.symbol;
+        ta.liquidPrice = a.result.liquidPrice;
+        bool highRisk = false;
+        calculateTotalConsistency(ta, highRisk);
+        ContradictionList contradictions(arena.allocator());
+        analyzeContradictions(ta, highRisk, contradictions);
+        ScoreRecord actual = makeScoreRecord(ta, contradictions.size());
+        if (!options.verify) return true;
+
+        bool same = std::memcmp(&a.result, &actual, sizeof(actual)) == 0;
+        // ìܵıȶ
+        uint32_t pos = 0;
+        for (size_t i = 0; same && i < contradictions.size(); ++i) {
+            uint16_t len;
+            if (a.textLength - pos < sizeof(len)) {
+                same = false;
+                break;
+            }
+            std::memcpy(&len, text + pos, sizeof(len));
+            pos += sizeof(len);
+            same = a.textLength - pos >= len && contradictions[i] == std::string_view(text + pos, len);
+            pos += len;
+        }
+        if (same && pos == a.textLength) return true;
+        report(e, "ۺֻìܵ㲻һ£Ϊ¼ֵطֵ");
+        if (showDetail()) {
+            std::vector<std::string> recorded;
+            for (uint32_t p = 0; p + sizeof(uint16_t) <= a.textLength;) {
+                uint16_t len;
+                std::memcpy(&len, text + p, sizeof(len));
+                p += sizeof(len);
+                recorded.emplace_back(text + p, std::min<uint32_t>(len, a.textLength - p));
+                p += len;
+            }
+            std::vector<std::string> replayed(contradictions.begin(), contradictions.end());
+            writeScoreJson(json, a.result, recorded);
+            writeScoreJson(json, actual, replayed);
+            out.flush();
+        }
+        return false;
+    }
+};
+
+int runList(JournalReader& reader) {
+    JournalReader::Entry e;
+    while (reader.next(e)) {
+        std::cout << std::setw(8) << e.header->sequence << "  " << std::setw(9) << std::left
+                  << entryTypeName(e.header->type) << std::right << "  " << std::setw(8) << e.header->length << "ֽ  ";
+        switch (static_cast<JournalEntryType>(e.header->type)) {
+            case JournalEntryType::SESSION:
+                std::cout << std::string(reinterpret_cast<const char*>(e.payload), e.header->length);
+                break;
+            case JournalEntryType::CONTRACTS:
+                std::cout << e.header->length / sizeof(ContractSpec) << "Լ";
+                break;
+            case JournalEntryType::POSITION: {
+                RiskRecord r;
+                std::memcpy(&r, e.payload, sizeof(r));
+                std::cout << r.symbol << " " << directionName(r.direction == 0 ? TradeDirection::LONG : TradeDirection::SHORT)
+                          << " ǿƽ" << r.liquidationPrice;
+                break;
+            }
+            case JournalEntryType::CANDLES: {
+                JournalCandles c;
+                std::memcpy(&c, e.payload, sizeof(c));
+                std::cout << (c.result.symbol[0] ? c.result.symbol : "-") << " " << c.barCount << "K";
+                if (c.window > 0) std::cout << "" << c.window << (c.hasResult ? "" : "δ") << "";
+                break;
+            }
+            case JournalEntryType::ANALYSIS: {
+                JournalAnalysis a;
+                std::memcpy(&a, e.payload, sizeof(a));
+                std::cout << a.result.symbol << " ܷ" << a.result.totalScore << " ìܵ" << a.result.contradictionCount
+                          << "";
+                break;
+            }
+            default:
+                break;
+        }
+        std::cout << std::endl;
+    }
+    if (!reader.error().empty()) {
+        std::cerr << "" << reader.error() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+int runReplay(JournalReader& reader, const ReplayOptions& options) {
+    Replayer replayer(options);
+    uint64_t entries = 0;
+    uint64_t bytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < options.repeat; ++round) {
+        reader.rewind();
+        replayer.resetSession();
+        JournalReader::Entry e;
+        while (reader.next(e)) {
+            replayer.replay(e);
+            entries++;
+        }
+        bytes += reader.validBytes();
+        if (!reader.error().empty()) break;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "===== ־ط =====" << std::endl;
+    std::cout << "ļС" << reader.fileSize() << " ֽڣ¼" << entries / options.repeat << std::endl;
+    for (int t = 1; t < ENTRY_TYPE_SLOTS; ++t) {
+        std::cout << std::setw(10) << std::left << entryTypeName(static_cast<uint16_t>(t)) << std::right
+                  << std::setw(10) << replayer.counts[t] / options.repeat << " " << std::endl;
+    }
+    if (replayer.counts[0]) std::cout << "δ֪ͣ" << replayer.counts[0] / options.repeat << " " << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "ط" << options.repeat << "飬" << entries << "ʱ" << seconds * 1e3 << " ms"
+              << (entries ? seconds * 1e9 / entries : 0.0) << " ns/" << (seconds > 0 ? entries / seconds : 0.0)
+              << " /룬" << (seconds > 0 ? bytes / seconds / 1e6 : 0.0) << " MB/" << std::endl;
+    std::cout << std::defaultfloat;
+
+    int status = 0;
+    if (options.verify) {
+        if (replayer.mismatches == 0) std::cout << "ȶԣȫһ" << std::endl;
+        else {
+            std::cout << "ȶԣ" << replayer.mismatches << " һ" << std::endl;
+            status = 1;
+        }
+    }
+    if (!reader.error().empty()) {
+        std::cerr << "" << reader.error() << "֮" << reader.fileSize() - reader.validBytes()
+                  << "ֽδطţ" << std::endl;
+        status = 1;
+    }
+    return status;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        printUsage();
+        return 1;
+    }
+    ReplayOptions options;
+    bool list = false;
+    try {
+        for (int i = 2; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--repeat" && i + 1 < argc) options.repeat = std::atoi(argv[++i]);
+            else if (arg == "--no-verify") options.verify = false;
+            else if (arg == "--list") list = true;
+            else if (arg == "--max-report" && i + 1 < argc) options.maxReport = std::atoi(argv[++i]);
+            else throw std::invalid_argument("δ֪" + arg);
+        }
+        if (options.repeat <= 0) throw std::invalid_argument("طŴ0");
+        JournalReader reader(argv[1]);
+        return list ? runList(reader) : runReplay(reader, options);
+    } catch (const std::exception& e) {
+        std::cerr << "" << e.what() << std::endl;
+        printUsage();
+        return 1;
+    }
+}
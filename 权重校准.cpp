@@ -0,0 +1,176 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <chrono>
+#include <iomanip>
+#include <cstdlib>
+#include <cmath>
+#include "core/weight_calibration.h"
+
+using namespace tradecheck;
+
+// ļʽÿһʷףհ׷ָ#ͷΪעͣ
+// (/) ܸ  ֹ    ͻƴ
+// 4СʱEMA EMA EMA 4СʱKSTԽ KSTԽ KSTԽ  [ʱATR]
+// ATR۸λʡԣʡԻΪ0ʱֹʰ̶֣ATR
+//  10 150 142    0    ϴԽ ϴԽ δԽ 2.5 4.2
+
+// Ϊ׷ṹ
+TradeAnalysis parseSampleLine(const std::string& line, int lineNo, double& outcome) {
+    std::istringstream in(line);
+    TradeAnalysis ta{};
+    std::string ema[3], kst[3];
+    if (!(in >> ta.openDir >> ta.leverage >> ta.openPrice >> ta.stopLoss
+             >> ta.longTrend >> ta.midTrend >> ta.shortTrend >> ta.shortTrendLineBreakTimes
+             >> ema[0] >> ema[1] >> ema[2] >> kst[0] >> kst[1] >> kst[2] >> outcome)) {
+        throw std::invalid_argument("" + std::to_string(lineNo) + "ֶβʽ");
+    }
+    if (ta.openDir != "" && ta.openDir != "") {
+        throw std::invalid_argument("" + std::to_string(lineNo) + "пֶ֧/");
+    }
+    if (ta.leverage < 1 || ta.openPrice <= 0 || ta.stopLoss <= 0) {
+        throw std::invalid_argument("" + std::to_string(lineNo) + "иܸ˻۸񲻺Ϸ");
+    }
+    double atr = 0.0;
+    if (in >> atr) {
+        if (!std::isfinite(atr) || atr < 0) {
+            throw std::invalid_argument("" + std::to_string(lineNo) + "ATRϷ");
+        }
+        ta.atrRate = atr / ta.openPrice * 100;
+    } else if (!in.eof()) {
+        throw std::invalid_argument("" + std::to_string(lineNo) + "ATRʽ");
+    }
+    const Timeframe tfs[3] = {Timeframe::TF_4H, Timeframe::TF_DAY, Timeframe::TF_WEEK};
+    for (int i = 0; i < 3; ++i) {
+        ta.emaList.push_back({tfs[i], 0, ema[i], false});
+        ta.kstList.push_back({tfs[i], {}, kst[i]});
+    }
+    updateStopLossRates(ta);
+    return ta;
+}
+
+// ȡļԤ
+FeatureMatrix loadFeatureMatrix(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) throw std::invalid_argument("޷ļ" + path);
+    FeatureMatrix m;
+    std::string line;
+    int lineNo = 0;
+    while (std::getline(file, line)) {
+        lineNo++;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.find_first_not_of(" \t") == std::string::npos || line[line.find_first_not_of(" \t")] == '#') continue;
+        double outcome = 0.0;
+        TradeAnalysis ta = parseSampleLine(line, lineNo, outcome);
+        m.add(extractScoreFeatures(ta), outcome);
+    }
+    if (m.size() == 0) throw std::invalid_argument("ļûЧ");
+    return m;
+}
+
+//  name=min:max:steps ʽΧ
+void parseRangeArg(const std::string& arg, CalibrationSpace& space) {
+    size_t eq = arg.find('=');
+    if (eq == std::string::npos) throw std::invalid_argument("ΧʽӦΪ =Сֵ:ֵ:");
+    int p = findWeightParam(arg.substr(0, eq).c_str());
+    if (p < 0) throw std::invalid_argument("δ֪" + arg.substr(0, eq));
+    ParamRange r;
+    char c1 = 0, c2 = 0;
+    std::istringstream in(arg.substr(eq + 1));
+    if (!(in >> r.minValue >> c1 >> r.maxValue >> c2 >> r.steps) || c1 != ':' || c2 != ':' || r.steps < 1) {
+        throw std::invalid_argument("ΧʽӦΪ =Сֵ:ֵ:");
+    }
+    space.ranges[p] = r;
+}
+
+// ѡ
+void printCandidate(const std::string& title, const CandidateResult& r) {
+    std::cout << "\n" << title << "" << std::endl;
+    std::cout << "Ŀֵ" << std::fixed << std::setprecision(4) << r.objective << std::endl;
+    std::cout << "" << r.passCount << "ʤʣ" << std::setprecision(2) << r.passWinRate * 100
+              << "%ƽ" << std::setprecision(4) << r.passMeanOutcome << std::endl;
+    ScoreWeights w = r.weights;
+    for (int p = 0; p < WEIGHT_PARAM_COUNT; ++p) {
+        std::cout << weightParamName(p) << " = " << std::setprecision(4) << weightParamRef(w, p) << std::endl;
+    }
+}
+
+void printUsage() {
+    std::cout << "÷ȨУ׼ <ļ> [ѡ]" << std::endl;
+    std::cout << "  --mode grid|random|coord   ʽĬgrid" << std::endl;
+    std::cout << "  --samples N                ѡĬ20000" << std::endl;
+    std::cout << "  --objective balanced|expectancy  У׼Ŀ꣨Ĭbalanced" << std::endl;
+    std::cout << "  --pass                 ߣĬ60" << std::endl;
+    std::cout << "  --threads N                ߳ĬӲ" << std::endl;
+    std::cout << "  --seed N                   ӣĬ42" << std::endl;
+    std::cout << "  --wide                     ֵͬʱ" << std::endl;
+    std::cout << "  --range =С::  ԶΧظ" << std::endl;
+}
+
+// 
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        printUsage();
+        return 1;
+    }
+    try {
+        std::string samplePath = argv[1];
+        std::string mode = "grid";
+        size_t samples = 20000;
+        CalibrationOptions opt;
+        CalibrationSpace space = defaultCalibrationSpace();
+        for (int i = 2; i < argc; ++i) {
+            std::string arg = argv[i];
+            auto next = [&]() -> std::string {
+                if (i + 1 >= argc) throw std::invalid_argument("ȱȡֵ" + arg);
+                return argv[++i];
+            };
+            if (arg == "--mode") mode = next();
+            else if (arg == "--samples") samples = std::strtoull(next().c_str(), nullptr, 10);
+            else if (arg == "--objective") {
+                std::string o = next();
+                if (o == "balanced") opt.objective = CalibrationObjective::BALANCED_ACCURACY;
+                else if (o == "expectancy") opt.objective = CalibrationObjective::EXPECTANCY;
+                else throw std::invalid_argument("δ֪У׼Ŀ꣺" + o);
+            }
+            else if (arg == "--pass") opt.passScore = std::atof(next().c_str());
+            else if (arg == "--threads") opt.threads = static_cast<unsigned>(std::atoi(next().c_str()));
+            else if (arg == "--seed") opt.seed = std::strtoull(next().c_str(), nullptr, 10);
+            else if (arg == "--wide") widenThresholdRanges(space);
+            else if (arg == "--range") parseRangeArg(next(), space);
+            else throw std::invalid_argument("δ֪" + arg);
+        }
+
+        FeatureMatrix m = loadFeatureMatrix(samplePath);
+        std::cout << "Ѽ" << m.size() << "" << std::endl;
+
+        CandidateResult baseline = evaluateWeights(m, ScoreWeights(), opt);
+        auto start = std::chrono::steady_clock::now();
+        CandidateResult best;
+        size_t evaluated = 0;
+        if (mode == "grid") {
+            evaluated = gridCandidateCount(space);
+            if (evaluated > 100000000) throw std::invalid_argument("ѡ1ڸٵrandom/coord");
+            best = gridSearch(m, space, opt);
+        } else if (mode == "random") {
+            evaluated = samples;
+            best = randomSearch(m, space, samples, opt);
+        } else if (mode == "coord") {
+            best = coordinateSearch(m, space, opt, &evaluated);
+        } else {
+            throw std::invalid_argument("δ֪ʽ" + mode);
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        printCandidate("ĬȨ", baseline);
+        printCandidate("Ȩ", best);
+        std::cout << "\nѡ" << evaluated << "ʱ" << std::setprecision(3) << seconds << "" << std::endl;
+    } catch (const std::invalid_argument& e) {
+        std::cerr << "" << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
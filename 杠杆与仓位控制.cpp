@@ -3,164 +3,43 @@
 #include <stdexcept>
 #include <limits>
 #include <cmath>
+#include <cctype>
+#include <vector>
+#include <fstream>
+#include <algorithm>
+#include <sstream>
+#include <memory>
+#include <cstdlib>
+#include "core/crypto_risk.h"
+#include "core/output_records.h"
+#include "core/input_journal.h"
+#include "core/correlation_matrix.h"
+#include "core/funding_carry.h"
+
+using namespace tradecheck;
+
+// ԼļǰĿ¼´ʱأʹĬϺԼ
+const char* const CONTRACT_CONFIG_FILE = "contracts.conf";
+
+// غԼ
+std::vector<ContractSpec> loadContracts() {
+    std::ifstream probe(CONTRACT_CONFIG_FILE);
+    if (!probe) return defaultContracts();
+    return loadContractConfig(CONTRACT_CONFIG_FILE);
+}
 
-// ܻұö
-enum class CryptoCurrency {
-    BTC,
-    ETH,
-    SOL,
-    DOGE,
-    UNKNOWN
-};
-
-// 彻׷ö
-enum class TradeDirection {
-    LONG,  // ൥
-    SHORT  // յ
-};
-
-// ϵ+ǿƽ+֤
-class CryptoRiskCalculator {
-private:
-    CryptoCurrency currency;    // ױ
-    double leverage;            // ܸ˱
-    double positionRatio;       // Ҳλռʽ0~100ٷֱȣ
-    double entryPrice;          // 볡۸USDT
-    TradeDirection direction;   // ׷򣨶/գ
-    double totalCapital;        // ʽUSDT
-    // ֱֵַͳһΪ1000
-    const double BTC_THRESHOLD = 1000.0;
-    const double ETH_THRESHOLD = 1000.0;
-    const double SOL_THRESHOLD = 1000.0;
-    const double DOGE_THRESHOLD = 1000.0;
-    // ԼĲοҰUSDTλԼ
-    const double MAINTENANCE_MARGIN_RATE = 0.005; // άֱ֤0.5%ɰ
-
-    // ȡֵַ
-    double getRiskThreshold() const {
-        switch (currency) {
-            case CryptoCurrency::BTC: return BTC_THRESHOLD;
-            case CryptoCurrency::ETH: return ETH_THRESHOLD;
-            case CryptoCurrency::SOL: return SOL_THRESHOLD;
-            case CryptoCurrency::DOGE: return DOGE_THRESHOLD;
-            default: throw std::invalid_argument("δ֪֣޷ֵ");
-        }
-    }
-
-    // ֲֵּUSDT= ռñ֤  ܸ
-    double getPositionValue() const {
-        return getInitialMargin() * leverage;
-    }
-
-    // ֲң= ֲֵּ / 볡۸
-    double getPositionAmount() const {
-        return getPositionValue() / entryPrice;
-    }
-
-public:
-    // 캯
-    CryptoRiskCalculator(CryptoCurrency cc, double lev, double posRatio, double entryP, TradeDirection dir, double totalCap)
-        : currency(cc), leverage(lev), positionRatio(posRatio), entryPrice(entryP), direction(dir), totalCapital(totalCap) {
-        if (leverage < 1) throw std::invalid_argument("ܸ˱С11x");
-        if (positionRatio < 0 || positionRatio > 100) throw std::invalid_argument("λռ0~100֮䣨ٷֱȣ");
-        if (entryPrice <= 0) throw std::invalid_argument("볡۸0");
-        if (totalCapital <= 0) throw std::invalid_argument("ʽ0");
-    }
-
-    // ϵܸ  λռ
-    double calculateRiskCoefficient() const {
-        return leverage * positionRatio;
-    }
-
-    // жյȼ
-    std::string judgeRiskLevel() const {
-        double riskCoeff = calculateRiskCoefficient();
-        double threshold = getRiskThreshold();
-
-        if (riskCoeff == 0) return "޷գδ/޸ܸˣ";
-        else if (riskCoeff <= threshold * 0.8) return "ȫϵֵ80%ڣ";
-        else if (riskCoeff <= threshold) return "Ԥϵӽֵ";
-        else return "꣨ϵֵֹף";
-    }
-
-    // ʼ֤ռñ֤= ʽ  λռ
-    double getInitialMargin() const {
-        return totalCapital * (positionRatio / 100.0);
-    }
-
-    // άֱ֤ = ֲֵּ  άֱ֤
-    double getMaintenanceMargin() const {
-        return getPositionValue() * MAINTENANCE_MARGIN_RATE;
-    }
-
-    // 貹䱣֤ = άֱ֤ - ʣౣ֤ʣౣ֤򷵻زֵ0
-    double calculateMarginToAdd() const {
-        double surplusMargin = getInitialMargin() - getUnrealizedLoss(); // ʣౣ֤=ʼ֤-δʵֿ
-        double needAdd = getMaintenanceMargin() - surplusMargin;
-        return needAdd > 0 ? needAdd : 0.0;
-    }
-
-    // δʵֿǿƽۺͱ֤㣬򻯰棺ǰ۸=ǿƽʱĿ
-    double getUnrealizedLoss() const {
-        double liqPrice = calculateLiquidationPrice();
-        double amount = getPositionAmount();
-        if (direction == TradeDirection::LONG) {
-            // ൥۸볡 = (볡 - ǿƽ)  ֲ
-            return (entryPrice - liqPrice) * amount;
-        } else {
-            // յ۸볡 = (ǿƽ - 볡)  ֲ
-            return (liqPrice - entryPrice) * amount;
-        }
-    }
-
-    // ǿƽۣUSDTλԼģʽͨùʽ
-    double calculateLiquidationPrice() const {
-        double im = getInitialMargin(); // ʼ֤
-        double pv = getPositionValue();  // ֲֵּ
-        double mmr = MAINTENANCE_MARGIN_RATE; // άֱ֤
-        double amount = getPositionAmount(); // ֲ
-
-        if (direction == TradeDirection::LONG) {
-            // ൥ǿƽ = (entryPrice * (im + pv * mmr) - im * entryPrice) / (im + pv * mmr)
-            // 򻯺
-            return entryPrice - (im - pv * mmr) / amount;
-        } else {
-            // յǿƽ = (entryPrice * (im + pv * mmr) + im * entryPrice) / (im + pv * mmr)
-            // 򻯺
-            return entryPrice + (im - pv * mmr) / amount;
-        }
-    }
-
-    // ȡǰֵ
-    double getThreshold() const {
-        return getRiskThreshold();
-    }
-};
-
-// ѡ
-CryptoCurrency selectCurrency() {
-    int choice;
-    std::cout << "ѡױ֣" << std::endl;
-    std::cout << "1. BTC" << std::endl;
-    std::cout << "2. ETH" << std::endl;
-    std::cout << "3. SOL" << std::endl;
-    std::cout << "4. DOGE" << std::endl;
-    std::cout << "֣1-4";
-    std::cin >> choice;
-
-    if (std::cin.fail()) {
-        std::cin.clear();
-        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-        throw std::invalid_argument("벻Ч֣ѡ");
-    }
-
-    switch (choice) {
-        case 1: return CryptoCurrency::BTC;
-        case 2: return CryptoCurrency::ETH;
-        case 3: return CryptoCurrency::SOL;
-        case 4: return CryptoCurrency::DOGE;
-        default: throw std::invalid_argument("Чıѡ񣬽֧1-4");
+// ѡԼ
+const ContractSpec& selectContract(const ContractTable& contracts) {
+    std::string symbol;
+    std::cout << "ѡԼ";
+    for (size_t i = 0; i < contracts.size(); ++i) {
+        if (contracts.spec(static_cast<uint32_t>(i)).enabled) std::cout << contracts.spec(static_cast<uint32_t>(i)).symbol << " ";
     }
+    std::cout << std::endl;
+    std::cout << "뽻׺Լ루BTCUSDT";
+    std::cin >> symbol;
+    std::transform(symbol.begin(), symbol.end(), symbol.begin(), [](unsigned char c) { return std::toupper(c); });
+    return contracts.at(symbol);
 }
 
 // ѡ׷
@@ -199,31 +78,427 @@ double getInputValue(const std::string& prompt) {
     return value;
 }
 
-// 
-int main() {
+// һгֲ֣Ʒ (/) ܸ λռ(%) ּ ʽ
+CryptoRiskCalculator parsePosition(const ContractTable& contracts, std::istream& ss, std::string& symbol) {
+    std::string dir;
+    double lev, ratio, entry, capital;
+    if (!(ss >> symbol >> dir >> lev >> ratio >> entry >> capital)) throw std::invalid_argument("ʽ");
+    if (dir != "" && dir != "") throw std::invalid_argument("Ϊ/");
+    TradeDirection td = dir == "" ? TradeDirection::LONG : TradeDirection::SHORT;
+    return CryptoRiskCalculator(contracts.at(symbol), lev, ratio, entry, td, capital);
+}
+
+// 㣺ÿ Ʒ (/) ܸ λռ(%) ּ ʽ#ͷΪעͣ
+// ÿһ¼ʽб浽׼
+int runBatch(const ContractTable& contracts, std::istream& in, OutputFormat format, const std::string& outputPath,
+             JournalWriter* journal) {
+    BufferedWriter out(outputPath);
+    JsonLineWriter json(out);
+    if (format == OutputFormat::BINARY) writeRecordStreamHeader(out, RecordType::RISK, sizeof(RiskRecord));
+    std::string line, symbol;
+    std::istringstream ss;
+    int lineNo = 0;
+    int failed = 0;
+    while (std::getline(in, line)) {
+        lineNo++;
+        if (line.empty() || line[0] == '#' || line[0] == '\r') continue;
+        try {
+            ss.clear();
+            ss.str(line);
+            CryptoRiskCalculator calc = parsePosition(contracts, ss, symbol);
+            RiskRecord record = makeRiskRecord(calc);
+            if (journal) journal->appendPosition(record);
+            if (format == OutputFormat::BINARY) out.write(&record, sizeof(record));
+            else writeRiskJson(json, record);
+        } catch (const std::invalid_argument& e) {
+            std::cerr << "" << lineNo << "У" << e.what() << std::endl;
+            failed++;
+        }
+    }
+    return failed == 0 ? 0 : 1;
+}
+
+// ֲļеһʳֲ
+struct PositionLine {
+    int lineNo;
+    std::string symbol;
+    CryptoRiskCalculator risk;
+};
+
+// ȡֲļʽͬ㣩ʽб浽׼󲢼failed
+std::vector<PositionLine> readPositions(const ContractTable& contracts, std::istream& in, int& failed) {
+    std::vector<PositionLine> positions;
+    std::string line, symbol;
+    std::istringstream ss;
+    int lineNo = 0;
+    while (std::getline(in, line)) {
+        lineNo++;
+        if (line.empty() || line[0] == '#' || line[0] == '\r') continue;
+        try {
+            ss.clear();
+            ss.str(line);
+            CryptoRiskCalculator calc = parsePosition(contracts, ss, symbol);
+            positions.push_back(PositionLine{lineNo, symbol, calc});
+        } catch (const std::invalid_argument& e) {
+            std::cerr << "" << lineNo << "У" << e.what() << std::endl;
+            failed++;
+        }
+    }
+    return positions;
+}
+
+// ѹԲ
+struct StressOptions {
+    std::string klinePath;                       // KCSVƷ֣
+    std::string reference = "BTCUSDT";           // ׼Ʒ
+    std::vector<double> shocks{-10, -20, -30};   // ׼Ʒּ۸䶯%
+    double correlationFloor = -1;                // ϵޣ-1ʷbeta
+    int window = 90;                             // ԴڣK߸
+    unsigned threads = 0;
+};
+
+// ŷֵָб
+std::vector<double> parseNumberList(const std::string& text) {
+    std::vector<double> values;
+    std::istringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        char* end = nullptr;
+        double v = std::strtod(item.c_str(), &end);
+        if (item.empty() || *end != '\0') throw std::invalid_argument("ֵбʽ" + text);
+        values.push_back(v);
+    }
+    if (values.empty()) throw std::invalid_argument("ֵбΪ");
+    return values;
+}
+
+// ѹԣֲļʽͬ㣬KߵóƷֶԻ׼Ʒֵbeta
+// ׼ƷְǷȫְֲbetaͬ䶯貹ı֤
+int runStress(const ContractTable& contracts, std::istream& in, OutputFormat format, const std::string& outputPath,
+              const StressOptions& opt) {
+    if (format == OutputFormat::BINARY) throw std::invalid_argument("ѹֻ֧text/ndjson");
+    ReturnMatrix returns = buildReturnMatrix(loadKlineCsv(opt.klinePath));
+    int reference = returns.find(opt.reference);
+    if (reference < 0) throw std::invalid_argument("Kļûл׼Ʒ֣" + opt.reference);
+    RollingCorrelation corr(returns.symbols.size(), opt.window, opt.threads);
+    corr.assign(returns.returns.data(), returns.bars());
+    if (corr.count() < 2) throw std::invalid_argument("K߲㣬޷");
+
+    int failed = 0;
+    std::vector<BookPosition> book;
+    std::vector<std::string> labels;
+    for (const auto& p : readPositions(contracts, in, failed)) {
+        int index = returns.find(p.symbol);
+        if (index < 0) {
+            std::cerr << "" << p.lineNo << "УKļû" << p.symbol << std::endl;
+            failed++;
+            continue;
+        }
+        book.push_back(BookPosition{static_cast<size_t>(index), returns.lastClose[index], p.risk});
+        labels.push_back(returns.symbols[index] + (p.risk.getDirection() == TradeDirection::LONG ? " " : " "));
+    }
+
+    BufferedWriter out(outputPath);
+    JsonLineWriter json(out);
+    std::ostringstream text;
+    size_t ref = static_cast<size_t>(reference);
+    if (format == OutputFormat::TEXT) {
+        text << "Դڣ" << corr.count() << "Kߣ" << returns.symbols.size() << "Ʒ֣׼"
+             << returns.symbols[ref] << "" << corr.volatility(ref) * 100 << "%\n";
+        for (size_t i = 0; i < book.size(); ++i) {
+            size_t s = book[i].symbolIndex;
+            text << "  " << labels[i] << "beta=" << corr.beta(s, ref) << " ϵ=" << corr.correlation(s, ref)
+                 << " =" << corr.volatility(s) * 100 << "% ǰ=" << book[i].markPrice << "\n";
+        }
+    }
+    for (double shock : opt.shocks) {
+        StressResult r = stressBook(corr, ref, book, StressScenario{shock / 100.0, opt.correlationFloor});
+        if (format == OutputFormat::TEXT) {
+            text << "\n龰" << returns.symbols[ref] << (shock >= 0 ? "+" : "") << shock << "%";
+            if (opt.correlationFloor > -1) text << "ϵ" << opt.correlationFloor << "";
+            text << "\n";
+            for (size_t i = 0; i < book.size(); ++i) {
+                const StressPositionResult& p = r.positions[i];
+                text << "  " << labels[i] << "۸䶯" << p.move * 100 << "%  " << p.markPrice
+                     << "貹䱣֤" << p.marginToAdd << " USDT\n";
+            }
+            text << "  貹䱣֤" << r.marginToAdd << " USDT" << r.marginCalls << "ʣʵֻ׼Ʒֲֳ֣"
+                 << r.isolatedMarginToAdd << " USDT\n";
+            continue;
+        }
+        for (size_t i = 0; i < book.size(); ++i) {
+            const StressPositionResult& p = r.positions[i];
+            json.begin();
+            json.string("record", "position")
+                .number("referenceShock", shock / 100.0)
+                .number("correlationFloor", opt.correlationFloor)
+                .string("symbol", returns.symbols[book[i].symbolIndex])
+                .string("direction", book[i].risk.getDirection() == TradeDirection::LONG ? "LONG" : "SHORT")
+                .number("beta", corr.beta(book[i].symbolIndex, ref))
+                .number("move", p.move)
+                .number("markPrice", p.markPrice)
+                .number("marginToAdd", p.marginToAdd);
+            json.end();
+        }
+        json.begin();
+        json.string("record", "book")
+            .number("referenceShock", shock / 100.0)
+            .number("correlationFloor", opt.correlationFloor)
+            .number("marginToAdd", r.marginToAdd)
+            .number("isolatedMarginToAdd", r.isolatedMarginToAdd)
+            .integer("marginCalls", r.marginCalls)
+            .integer("positions", static_cast<int64_t>(book.size()));
+        json.end();
+    }
+    if (format == OutputFormat::TEXT) {
+        std::string s = text.str();
+        out.write(s.data(), s.size());
+    }
+    return failed == 0 ? 0 : 1;
+}
+
+// ʽѳɱģ
+struct CarryCliOptions {
+    std::string fundingPath;                   // ʽCSV
+    std::string horizons = "1d,7d,30d,90d";    // ֲʱб
+    CarryOptions carry;
+};
+
+// ֲʱб"8h,1d,30d"λm/h/dλΪ룩
+std::vector<int64_t> parseDurationList(const std::string& text) {
+    std::vector<int64_t> values;
+    std::istringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        char* end = nullptr;
+        double v = std::strtod(item.c_str(), &end);
+        if (end == item.c_str()) throw std::invalid_argument("ֲʱʽ" + text);
+        int64_t unit = 1;
+        if (*end == 'm') unit = 60000LL;
+        else if (*end == 'h') unit = 3600000LL;
+        else if (*end == 'd') unit = 86400000LL;
+        if (unit != 1) ++end;
+        if (*end != '\0') throw std::invalid_argument("ֲʱʽ" + text);
+        values.push_back(static_cast<int64_t>(v * unit));
+    }
+    if (values.empty()) throw std::invalid_argument("ֲʱбΪ");
+    return values;
+}
+
+// ֲʱʾд
+std::string durationLabel(int64_t ms) {
+    std::ostringstream ss;
+    if (ms % 86400000LL == 0) ss << ms / 86400000LL << "";
+    else if (ms % 3600000LL == 0) ss << ms / 3600000LL << "Сʱ";
+    else ss << ms / 60000.0 << "";
+    return ss.str();
+}
+
+// ʽѳɱģ⣺ֲļʽͬ㣬ʷʽѿۼֱ֤
+// ֲʱǿƽ貹䱣֤
+int runCarry(const ContractTable& contracts, std::istream& in, OutputFormat format, const std::string& outputPath,
+             CarryCliOptions& opt) {
+    if (format == OutputFormat::BINARY) throw std::invalid_argument("ʽģֻ֧text/ndjson");
+    FundingTable funding = loadFundingCsv(opt.fundingPath);
+    opt.carry.horizons = parseDurationList(opt.horizons);
+
+    int failed = 0;
+    std::vector<CarryPosition> book;
+    std::vector<std::string> labels;
+    for (const auto& p : readPositions(contracts, in, failed)) {
+        if (p.risk.getContract().type == ContractType::INVERSE_COIN) {
+            std::cerr << "" << p.lineNo << "У" << p.symbol << "ΪұλԼʽģֻ֧USDTλԼ" << std::endl;
+            failed++;
+            continue;
+        }
+        int index = funding.find(p.symbol);
+        if (index < 0) {
+            std::cerr << "" << p.lineNo << "Уʽļû" << p.symbol << std::endl;
+            failed++;
+            continue;
+        }
+        book.push_back(CarryPosition{static_cast<size_t>(index), p.risk});
+        labels.push_back(funding.series[index].symbol + (p.risk.getDirection() == TradeDirection::LONG ? " " : " "));
+    }
+    CarrySimulation sim = simulateCarry(funding, book, opt.carry);
+
+    BufferedWriter out(outputPath);
+    JsonLineWriter json(out);
+    std::ostringstream text;
+    if (format == OutputFormat::TEXT) {
+        text << "ʱ̣" << sim.start << "" << opt.carry.fees.openFeeRate * 100 << "%ƽ"
+             << opt.carry.fees.closeFeeRate * 100 << "%\n";
+    }
+    for (size_t i = 0; i < book.size(); ++i) {
+        const CryptoRiskCalculator& r = book[i].risk;
+        double liq = r.calculateLiquidationPrice();
+        if (format == OutputFormat::TEXT) {
+            text << "\n" << labels[i] << " " << r.getLeverage() << "xּ" << r.getEntryPrice() << "ʼ֤"
+                 << r.getInitialMargin() << " USDTƳɱǿƽ" << liq << "" << sim.feesPaid[i] << " USDT\n";
+        }
+        for (size_t h = 0; h < sim.horizons.size(); ++h) {
+            double newLiq = sim.at(sim.liquidationPrice, h, i);
+            int events = sim.events(h, book[i].fundingIndex);
+            if (format == OutputFormat::TEXT) {
+                text << "  ֲ" << durationLabel(sim.horizons[h]) << "ʽ" << events << "ڣۼʽ"
+                     << sim.at(sim.fundingPaid, h, i) << " USDTʣౣ֤" << sim.at(sim.margin, h, i) << " USDTǿƽ"
+                     << newLiq << "򿪲ּƶ" << (newLiq - liq) / r.getEntryPrice() * 100 * (r.getDirection() == TradeDirection::LONG ? 1 : -1)
+                     << "%貹䱣֤" << sim.at(sim.marginToAdd, h, i) << " USDT\n";
+                continue;
+            }
+            json.begin();
+            json.string("symbol", funding.series[book[i].fundingIndex].symbol)
+                .string("direction", r.getDirection() == TradeDirection::LONG ? "LONG" : "SHORT")
+                .number("leverage", r.getLeverage())
+                .integer("start", sim.start)
+                .integer("horizonMs", sim.horizons[h])
+                .integer("fundingEvents", events)
+                .number("feesPaid", sim.feesPaid[i])
+                .number("fundingPaid", sim.at(sim.fundingPaid, h, i))
+                .number("margin", sim.at(sim.margin, h, i))
+                .number("baseLiquidationPrice", liq)
+                .number("liquidationPrice", newLiq)
+                .number("marginToAdd", sim.at(sim.marginToAdd, h, i));
+            json.end();
+        }
+    }
+    if (format == OutputFormat::TEXT) {
+        std::string s = text.str();
+        out.write(s.data(), s.size());
+    }
+    return failed == 0 ? 0 : 1;
+}
+
+// ʱΪģʽ
+int main(int argc, char* argv[]) {
+    OutputFormat format = OutputFormat::TEXT;
+    std::string inputPath = "-";
+    std::string outputPath = "-";
+    std::string contractFile;
+    std::string journalPath;
+    StressOptions stress;
+    CarryCliOptions carry;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--format" && i + 1 < argc) format = parseOutputFormat(argv[++i]);
+            else if (arg == "--input" && i + 1 < argc) inputPath = argv[++i];
+            else if (arg == "--output" && i + 1 < argc) outputPath = argv[++i];
+            else if (arg == "--contracts" && i + 1 < argc) contractFile = argv[++i];
+            else if (arg == "--journal" && i + 1 < argc) journalPath = argv[++i];
+            else if (arg == "--stress" && i + 1 < argc) stress.klinePath = argv[++i];
+            else if (arg == "--reference" && i + 1 < argc) stress.reference = argv[++i];
+            else if (arg == "--shocks" && i + 1 < argc) stress.shocks = parseNumberList(argv[++i]);
+            else if (arg == "--corr-floor" && i + 1 < argc) stress.correlationFloor = std::atof(argv[++i]);
+            else if (arg == "--corr-window" && i + 1 < argc) stress.window = std::atoi(argv[++i]);
+            else if (arg == "--threads" && i + 1 < argc) stress.threads = carry.carry.threads = static_cast<unsigned>(std::atoi(argv[++i]));
+            else if (arg == "--carry" && i + 1 < argc) carry.fundingPath = argv[++i];
+            else if (arg == "--horizons" && i + 1 < argc) carry.horizons = argv[++i];
+            else if (arg == "--start" && i + 1 < argc) carry.carry.start = std::strtoll(argv[++i], nullptr, 10);
+            else if (arg == "--open-fee" && i + 1 < argc) carry.carry.fees.openFeeRate = std::atof(argv[++i]) / 100.0;
+            else if (arg == "--close-fee" && i + 1 < argc) carry.carry.fees.closeFeeRate = std::atof(argv[++i]) / 100.0;
+            else throw std::invalid_argument("δ֪" + arg);
+        }
+    } catch (const std::invalid_argument& e) {
+        std::cerr << "" << e.what() << std::endl;
+        std::cerr << "÷ܸλ [--format text|ndjson|binary] [--input ֲļ] [--output ļ]"
+                     " [--contracts Լļ] [--journal ־]" << std::endl;
+        std::cerr << "ѹԣܸλ --stress KCSV [--input ֲļ] [--reference BTCUSDT] [--shocks -10,-20,-30]"
+                     " [--corr-window 90] [--corr-floor -1] [--threads N] [--format text|ndjson]" << std::endl;
+        std::cerr << "ʽѳɱģ⣺ܸλ --carry ʽCSV [--input ֲļ] [--horizons 1d,7d,30d,90d]"
+                     " [--start ʱ̺] [--open-fee 0.05] [--close-fee 0.05] [--threads N] [--format text|ndjson]"
+                  << std::endl;
+        std::cerr << "ndjson/binaryģʽӳֲļĬϱ׼룩ȡÿУƷ (/) ܸ λռ(%) ּ ʽ"
+                  << std::endl;
+        return 1;
+    }
+
     char continueFlag;
+    std::vector<ContractSpec> specs;
+    try {
+        specs = contractFile.empty() ? loadContracts() : loadContractConfig(contractFile);
+    } catch (const std::invalid_argument& e) {
+        std::cerr << "" << e.what() << std::endl;
+        return 1;
+    }
+    ContractTable contracts(specs);
+
+    // ־еԼã֮ÿʳֲһ
+    std::unique_ptr<JournalWriter> journal;
+    if (!journalPath.empty()) {
+        try {
+            journal.reset(new JournalWriter(journalPath));
+            journal->appendSession(journalCommandLine(argc, argv));
+            journal->appendContracts(specs);
+        } catch (const std::exception& e) {
+            std::cerr << "" << e.what() << std::endl;
+            return 1;
+        }
+    }
+
+    if (!carry.fundingPath.empty()) {
+        try {
+            if (inputPath == "-") return runCarry(contracts, std::cin, format, outputPath, carry);
+            std::ifstream in(inputPath);
+            if (!in) throw std::invalid_argument("޷򿪳ֲļ" + inputPath);
+            return runCarry(contracts, in, format, outputPath, carry);
+        } catch (const std::exception& e) {
+            std::cerr << "" << e.what() << std::endl;
+            return 1;
+        }
+    }
+
+    if (!stress.klinePath.empty()) {
+        try {
+            if (inputPath == "-") return runStress(contracts, std::cin, format, outputPath, stress);
+            std::ifstream in(inputPath);
+            if (!in) throw std::invalid_argument("޷򿪳ֲļ" + inputPath);
+            return runStress(contracts, in, format, outputPath, stress);
+        } catch (const std::exception& e) {
+            std::cerr << "" << e.what() << std::endl;
+            return 1;
+        }
+    }
+
+    if (format != OutputFormat::TEXT) {
+        try {
+            if (inputPath == "-") return runBatch(contracts, std::cin, format, outputPath, journal.get());
+            std::ifstream in(inputPath);
+            if (!in) throw std::invalid_argument("޷򿪳ֲļ" + inputPath);
+            return runBatch(contracts, in, format, outputPath, journal.get());
+        } catch (const std::exception& e) {
+            std::cerr << "" << e.what() << std::endl;
+            return 1;
+        }
+    }
+
     do {
         try {
             // 1. 
-            CryptoCurrency currency = selectCurrency();
+            const ContractSpec& contract = selectContract(contracts);
             TradeDirection direction = selectTradeDirection();
-            double totalCapital = getInputValue("ʽUSDT");
+            // ұλԼʽ뱣֤ԱҼƣ۸USD
+            std::string asset = marginAsset(contract);
+            std::string quote = contract.type == ContractType::INVERSE_COIN ? "USD" : "USDT";
+            double totalCapital = getInputValue("ʽ" + asset + "");
             double leverage = getInputValue("ܸ˱С1x");
             double positionRatio = getInputValue("λռȣ0-100ٷֱȣ");
-            double entryPrice = getInputValue("볡۸USDT");
+            double entryPrice = getInputValue("볡۸" + quote + "");
 
             // 2. 
-            CryptoRiskCalculator riskCalc(currency, leverage, positionRatio, entryPrice, direction, totalCapital);
+            CryptoRiskCalculator riskCalc(contract, leverage, positionRatio, entryPrice, direction, totalCapital);
+            if (journal) journal->appendPosition(makeRiskRecord(riskCalc));
 
             // 3. 㲢
             std::cout << "\n===== ܻҽ׷ռ =====" << std::endl;
+            std::cout << "Լ" << contract.symbol << "άֱ֤" << contract.maintenanceMarginRate * 100 << "%" << std::endl;
             std::cout << "ֵ" << riskCalc.getThreshold() << std::endl;
             std::cout << "ϵ" << riskCalc.calculateRiskCoefficient() << std::endl;
             std::cout << "յȼ" << riskCalc.judgeRiskLevel() << std::endl;
-            std::cout << "ʼ֤ռã" << riskCalc.getInitialMargin() << " USDT" << std::endl;
-            std::cout << "άֱ֤Ҫ" << riskCalc.getMaintenanceMargin() << " USDT" << std::endl;
-            std::cout << "貹䱣֤" << riskCalc.calculateMarginToAdd() << " USDT" << std::endl;
-            std::cout << "ǿƽ۸" << riskCalc.calculateLiquidationPrice() << " USDT" << std::endl;
+            std::cout << "ʼ֤ռã" << riskCalc.getInitialMargin() << " " << asset << std::endl;
+            std::cout << "άֱ֤Ҫ" << riskCalc.getMaintenanceMargin() << " " << asset << std::endl;
+            std::cout << "貹䱣֤" << riskCalc.calculateMarginToAdd() << " " << asset << std::endl;
+            std::cout << "ǿƽ۸" << riskCalc.calculateLiquidationPrice() << " " << quote << std::endl;
             std::cout << "=====================================\n" << std::endl;
 
         } catch (const std::invalid_argument& e) {
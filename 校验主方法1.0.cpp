@@ -1,118 +1,22 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <string_view>
 #include <iomanip>
 #include <algorithm>
-#include <map>
 #include <cmath>
+#include "core/consistency_score.h"
+#include "core/output_records.h"
+#include "core/input_journal.h"
+#include "core/kline_io.h"
+#include "core/volatility.h"
+#include <memory>
 using namespace std;
-
-// ʱö٣Kڣ
-enum class Timeframe {
-    TF_4H,
-    TF_DAY,
-    TF_WEEK,
-};
-
-// ۸̬ʱö٣̬ڣ
-enum class PatternTimeframe {
-    SHORT,  // ڣ1ܣ
-    MEDIUM, // ڣ1-4ܣ
-    LONG,   // ڣ4ܣ
-};
-
-// ͻƷö
-enum class TriangleBreakDir {
-    UP,    // ͻ
-    DOWN,  // ͻ
-    NONE   // δͻ
-};
-
-// תKΪַ
-string timeframeToString(Timeframe tf) {
-    switch (tf) {
-        case Timeframe::TF_4H: return "4Сʱ";
-        case Timeframe::TF_DAY: return "";
-        case Timeframe::TF_WEEK: return "";
-        default: return "δ֪";
-    }
-}
-
-// ת̬ʱΪַ
-string patternTfToString(PatternTimeframe ptf) {
-    switch (ptf) {
-        case PatternTimeframe::SHORT: return "ڣ1ܣ";
-        case PatternTimeframe::MEDIUM: return "ڣ1-4ܣ";
-        case PatternTimeframe::LONG: return "ڣ4ܣ";
-        default: return "δ֪";
-    }
-}
-
-// תͻƷΪַ
-string triangleBreakDirToString(TriangleBreakDir dir) {
-    switch (dir) {
-        case TriangleBreakDir::UP: return "ͻ";
-        case TriangleBreakDir::DOWN: return "ͻ";
-        case TriangleBreakDir::NONE: return "δͻ";
-        default: return "δ֪ͻƷ";
-    }
-}
-
-// EMAʱ
-struct EMAData {
-    Timeframe tf;
-    int period;
-    string trend;
-    bool isTurn;
-};
-
-// KSTʱ
-struct KSTData {
-    Timeframe tf;
-    vector<int> periods;
-    string cross;
-};
-
-// ۸̬ṹ壨+ͻƷ
-struct PricePattern {
-    string name;                  // ̬ƣ"Σ"
-    PatternTimeframe tf;          // ̬ʱ
-    TriangleBreakDir breakDir;    // ͻƷ򣨷̬ĬNONE
-};
-
-// Ľ׷ṹ
-struct TradeAnalysis {
-    string coinType;        // ױ
-    string openDir;         // 򣨶/գ
-    int leverage;           // ܸ˱
-    double openPrice;       // Ŀ꿪
-    double liquidPrice;     // ǿƽ
-    double stopLoss;        // ֹ
-    double stopLossRate;    // ֹ
-    double leverStopLossRisk; // ֹܸ
-
-    // 
-    string longTrend;
-    string midTrend;
-    string shortTrend;
-    int shortTrendLineBreakTimes; // ͻƴ0
-
-    // RSIָ
-    string rsiLevel;
-    int rsiDuration;
-    string rsiUnit;
-
-    // ۸̬
-    vector<PricePattern> pricePatterns;
-
-    // EMA/KSTʱ
-    vector<EMAData> emaList;
-    vector<KSTData> kstList;
-};
+using namespace tradecheck;
 
 // ߺУ
-bool checkTrend(string& trend) {
-    vector<string> valid = {"", "½", ""};
+bool checkTrend(string_view trend) {
+    vector<string_view> valid = {"", "½", ""};
     if (find(valid.begin(), valid.end(), trend) != valid.end()) return true;
     cout << " 󣺽֧֡/½/̡룡" << endl;
     return false;
@@ -127,7 +31,7 @@ bool checkYesNo(string& input, bool& result) {
 }
 
 // ߺУ
-bool checkOpenDir(string& dir) {
+bool checkOpenDir(string_view dir) {
     if (dir == "" || dir == "") return true;
     cout << " 󣺽֧֡ࡹ򡸿ա룡" << endl;
     return false;
@@ -185,8 +89,24 @@ bool checkShortBreakTimes(int& times) {
     return false;
 }
 
+// --klinesṩKߣȫƷ֣¼ֺƷּATR
+struct VolatilityInput {
+    vector<KlineRow> rows;
+    int period = 14;
+};
+
+// ȡK߼㲨ʣδṩK߻ҲƷʱbarsΪ0
+VolatilitySnapshot lookupVolatility(const VolatilityInput& input, const string& coinType) {
+    string symbol = normalizeSymbol(coinType);
+    vector<KlineData> klines;
+    for (const auto& row : input.rows) {
+        if (normalizeSymbol(row.symbol) == symbol) klines.push_back(row.kline);
+    }
+    return computeVolatility(klines.data(), klines.size(), input.period);
+}
+
 // һ¼뿪
-void inputTradeParams(TradeAnalysis& ta) {
+void inputTradeParams(TradeAnalysis& ta, const VolatilityInput* volInput) {
     cout << "===== һ¼뿪 =====" << endl;
     cout << " ʾм۸֧֡/ա" << endl;
     cout << "뽻ױ֣SOL/USDTBTC/USDT";
@@ -214,18 +134,40 @@ void inputTradeParams(TradeAnalysis& ta) {
     };
     checkPrice(ta.openPrice, "Ŀ꿪");
     checkPrice(ta.liquidPrice, "ǿƽ");
+
+    // KʱATRֹοָֹİATR
+    ta.atrRate = 0;
+    if (volInput) {
+        VolatilitySnapshot vol = lookupVolatility(*volInput, string(ta.coinType));
+        if (!vol.ready) {
+            cout << " ʾKļ" << ta.coinType << "" << volInput->period << "ֹʰ̶" << endl;
+        } else {
+            ta.atrRate = vol.atrPercent;
+            TradeDirection dir = ta.openDir == "" ? TradeDirection::LONG : TradeDirection::SHORT;
+            cout << " ATR(" << volInput->period << ")" << fixed << setprecision(2) << vol.atrPercent
+                 << "%Kʵֲʣ" << vol.realizedVolatility << "%" << endl;
+            cout << " ֹۣ";
+            auto stops = suggestAtrStops(ta.openPrice, dir, ta.openPrice * vol.atrPercent / 100);
+            for (size_t i = 0; i < stops.size(); ++i) {
+                if (i > 0) cout << "";
+                cout << setprecision(1) << stops[i].multiple << "ATR=" << setprecision(4) << stops[i].price
+                     << "" << setprecision(2) << stops[i].ratePercent << "%";
+            }
+            cout << endl;
+        }
+    }
     checkPrice(ta.stopLoss, "ֹ");
 
     // ֹ
     if (ta.openDir == "") {
         if (ta.stopLoss >= ta.openPrice) cout << "  棺൥ֹӦڿۣǰÿܲ" << endl;
-        ta.stopLossRate = fabs((ta.openPrice - ta.stopLoss) / ta.openPrice) * 100;
     } else {
         if (ta.stopLoss <= ta.openPrice) cout << " 棺յֹӦڿۣǰÿܲ" << endl;
-        ta.stopLossRate = fabs((ta.stopLoss - ta.openPrice) / ta.openPrice) * 100;
     }
-    ta.leverStopLossRisk = ta.stopLossRate * ta.leverage;
-    cout << " ֹʣ" << fixed << setprecision(2) << ta.stopLossRate << "%" << endl;
+    updateStopLossRates(ta);
+    cout << " ֹʣ" << fixed << setprecision(2) << ta.stopLossRate << "%";
+    if (ta.atrRate > 0) cout << "" << ta.stopLossRate / ta.atrRate << "ATR";
+    cout << endl;
     cout << "ֹܸʣֹʡܸˣ" << fixed << setprecision(2) << ta.leverStopLossRisk << "%" << endl;
     cout << endl;
 }
@@ -260,7 +202,7 @@ void inputDowTrend(TradeAnalysis& ta) {
 void inputRSI(TradeAnalysis& ta) {
     cout << "===== ¼RSIָ =====" << endl;
     cout << " ʾRSIˮƽ֧֡//ʱΪ" << endl;
-    vector<string> validRSI = {"", "", ""};
+    vector<string_view> validRSI = {"", "", ""};
     while (true) {
         cout << "ǰRSIʲôˮƽ//";
         cin >> ta.rsiLevel;
@@ -288,14 +230,10 @@ void inputPricePatterns(TradeAnalysis& ta) {
     cout << "4. ʱɺԿո롸ڡ̡ɣ" << endl;
     cout << endl;
 
-    // Żѡ̬ͱע
-    vector<string> patterns = {
-        "ͷ綥", "ͷףǣ", "Σǣ", "Σ",
-        "Σƣ", "Σɢתƣ", "˫ض", "˫صףǣ", ""
-    };
+    // ѡ̬-1̬룬ʾƴͱע
     cout << "ѡ۸̬б++ͣ" << endl;
-    for (int i = 0; i < patterns.size(); ++i) {
-        cout << i + 1 << ". " << patterns[i] << endl;
+    for (int i = 0; i < PRICE_PATTERN_COUNT; ++i) {
+        cout << i + 1 << ". " << PRICE_PATTERN_LABELS[i] << endl;
     }
     cout << endl;
     cout << "̬Ӧţɶѡոָ0";
@@ -305,17 +243,18 @@ void inputPricePatterns(TradeAnalysis& ta) {
             cout << "ѽ̬ѡ񣬵ǰѡ" << ta.pricePatterns.size() << "̬" << endl;
             break;
         }
-        if (choice >= 1 && choice <= patterns.size()) {
-            string patName = patterns[choice - 1];
-            if (patName == "") {
+        if (choice >= 1 && choice <= PRICE_PATTERN_COUNT) {
+            int code = choice - 1;
+            string patName = PRICE_PATTERN_NAMES[code];
+            if (code == PATTERN_NONE) {
                 // ѡ""ղ
                 ta.pricePatterns.clear();
-                PricePattern pat = {"", PatternTimeframe::SHORT, TriangleBreakDir::NONE};
+                PricePattern pat = {PRICE_PATTERN_NAMES[PATTERN_NONE], PatternTimeframe::SHORT, TriangleBreakDir::NONE};
                 ta.pricePatterns.push_back(pat);
                 cout << " ѡޡ̬" << endl;
                 break;
             }
-            cout << endl << "¼룺" << patName << endl;
+            cout << endl << "¼룺" << PRICE_PATTERN_LABELS[code] << endl;
 
             // һ̬ʱȣǿ
             string tfInput;
@@ -330,7 +269,8 @@ void inputPricePatterns(TradeAnalysis& ta) {
 
             // ڶ̬ͻƷǿ
             TriangleBreakDir breakDir = TriangleBreakDir::NONE;
-            if (patName.find("") != string::npos) {
+            bool triangle = code == PATTERN_TRIANGLE_CONVERGING || code == PATTERN_TRIANGLE_DIVERGING;
+            if (triangle) {
                 string breakInput;
                 cout << "ͻƷ=ͻ/=ͻ/δͻ=ޣɼдΪ//ޣ";
                 cin >> breakInput;
@@ -341,19 +281,13 @@ void inputPricePatterns(TradeAnalysis& ta) {
                 cout << "ѡͻƷ" << triangleBreakDirToString(breakDir) << endl;
             }
 
-            // ̬ƣȥڵ˵ƣ
-            size_t pos = patName.find("");
-            if (pos != string::npos) {
-                patName = patName.substr(0, pos);
-            }
-
-            // ӵ̬б
+            // ӵ̬бȡеĹ淶ƣЭ붼ƥ䣩
             ta.pricePatterns.push_back({patName, ptf, breakDir});
             cout << "ɹ̬" << patternTfToString(ptf) << "" << patName << ""
-                 << (patName.find("") != string::npos ? "" + triangleBreakDirToString(breakDir) + "" : "") << endl;
+                 << (triangle ? "" + triangleBreakDirToString(breakDir) + "" : "") << endl;
             cout << endl << "ѡ̬ţոָ0";
         } else {
-            cout << "Чѡ1-" << patterns.size() << "֮ıţ0";
+            cout << "Чѡ1-" << PRICE_PATTERN_COUNT << "֮ıţ0";
         }
     }
     cin.ignore();
@@ -399,7 +333,7 @@ void inputKSTData(TradeAnalysis& ta) {
     cout << "===== ¼ʱKST =====" << endl;
     cout << "ʾKSTΪ4ŷָĬ10,15,20,306,9,12,15" << endl;
     vector<Timeframe> tfs = {Timeframe::TF_4H, Timeframe::TF_DAY, Timeframe::TF_WEEK};
-    vector<string> validKSTCross = {"ϴԽ", "´Խ", "δԽ"};
+    vector<string_view> validKSTCross = {"ϴԽ", "´Խ", "δԽ"};
     for (auto tf : tfs) {
         KSTData kst;
         kst.tf = tf;
@@ -493,181 +427,6 @@ void inputKSTData(TradeAnalysis& ta) {
     cout << endl;
 }
 
-// EMAźһԵ÷
-int calculateEMAConsistency(const vector<EMAData>& emaList) {
-    if (emaList.empty()) return 0;
-    map<string, int> trendCount;
-    for (const auto& ema : emaList) trendCount[ema.trend]++;
-    int maxCount = 0;
-    for (const auto& pair : trendCount) maxCount = max(maxCount, pair.second);
-    return (maxCount * 100) / emaList.size();
-}
-
-// KSTźһԵ÷
-int calculateKSTConsistency(const vector<KSTData>& kstList) {
-    if (kstList.empty()) return 0;
-    map<string, int> crossCount;
-    for (const auto& kst : kstList) crossCount[kst.cross]++;
-    int maxCount = 0;
-    for (const auto& pair : crossCount) maxCount = max(maxCount, pair.second);
-    return (maxCount * 100) / kstList.size();
-}
-
-// ֹʺԵ÷
-int calculateBaseStopLossScore(const TradeAnalysis& ta) {
-    double rate = ta.stopLossRate;
-    if (rate >= 3.0 && rate <= 8.0) return 10;
-    else if ((rate >= 1.0 && rate < 3.0) || (rate > 8.0 && rate <= 10.0)) return 5;
-    else return 0;
-}
-
-// ֹܸյ÷
-int calculateLeverStopLossScore(const TradeAnalysis& ta, bool& isHighRisk) {
-    double leverRisk = ta.leverStopLossRisk;
-    isHighRisk = false;
-    if (leverRisk <= 40.0) return 10;
-    else if (leverRisk > 40.0 && leverRisk <= 60.0) return 5;
-    else {
-        isHighRisk = true;
-        return 0;
-    }
-}
-
-// 㿪ƥȵ÷֣ͻƴӰ죩
-int calculateDirTrendMatchScore(const TradeAnalysis& ta) {
-    int matchCount = 0;
-    if (ta.openDir == "") {
-        if (ta.longTrend == "") matchCount++;
-        if (ta.midTrend == "") matchCount++;
-        if (ta.shortTrend == "") matchCount++;
-    } else {
-        if (ta.longTrend == "½") matchCount++;
-        if (ta.midTrend == "½") matchCount++;
-        if (ta.shortTrend == "½") matchCount++;
-    }
-    int baseScore = 0;
-    if (matchCount == 3) baseScore = 20;
-    else if (matchCount == 2) baseScore = 15;
-    else if (matchCount == 1) baseScore = 5;
-    else baseScore = 0;
-
-    // ͻƴ۷
-    int breakTimes = ta.shortTrendLineBreakTimes;
-    int penalty = 0;
-    if (breakTimes == 3) penalty = 3;
-    else if (breakTimes == 5) penalty = 8;
-    else if (breakTimes >= 7) penalty = 15;
-
-    return max(baseScore - penalty, 0);
-}
-
-// ۺһ
-int calculateTotalConsistency(const TradeAnalysis& ta, bool& isHighLeverRisk) {
-    int emaScore = calculateEMAConsistency(ta.emaList);
-    int kstScore = calculateKSTConsistency(ta.kstList);
-    int baseSLScore = calculateBaseStopLossScore(ta);
-    int leverSLScore = calculateLeverStopLossScore(ta, isHighLeverRisk);
-    int dirMatchScore = calculateDirTrendMatchScore(ta);
-    return (emaScore * 0.3) + (kstScore * 0.3) + baseSLScore + leverSLScore + dirMatchScore;
-}
-
-// ָìܵ
-vector<string> analyzeContradictions(const TradeAnalysis& ta, bool isHighLeverRisk) {
-    vector<string> contradictions;
-    int emaScore = calculateEMAConsistency(ta.emaList);
-    int kstScore = calculateKSTConsistency(ta.kstList);
-    double baseSLRate = ta.stopLossRate;
-    double leverSLRisk = ta.leverStopLossRisk;
-    int shortBreakTimes = ta.shortTrendLineBreakTimes;
-
-    // RSIì
-    if ((ta.longTrend == "" || ta.midTrend == "") && ta.rsiLevel == "") {
-        contradictions.push_back("/ϣRSIԴ");
-    }
-    if ((ta.longTrend == "½" || ta.midTrend == "½") && ta.rsiLevel == "") {
-        contradictions.push_back("/£RSIԴ");
-    }
-
-    // ͻƴì
-    if (shortBreakTimes >= 2) {
-        contradictions.push_back("ͻƴ2ΣЧԼ߼һ½");
-    }
-    if (shortBreakTimes >= 3) {
-        contradictions.push_back("߷ѡͻƴ3ΣʧЧ߼ȱ֧");
-    }
-
-    // ۸̬ìܣͻƷ
-    for (const auto& pat : ta.pricePatterns) {
-        if (pat.name == "") continue;
-        string patTf = patternTfToString(pat.tf);
-
-        // ̬µì
-        if ((pat.name == "ͷ" || pat.name == "" || pat.name == "˫ص") &&
-            ((pat.tf == PatternTimeframe::LONG && ta.longTrend == "½") ||
-             (pat.tf == PatternTimeframe::MEDIUM && ta.midTrend == "½") ||
-             (pat.tf == PatternTimeframe::SHORT && ta.shortTrend == "½"))) {
-            contradictions.push_back(patTf + "" + pat.name + "̬Ӧ" +
-                                  (pat.tf == PatternTimeframe::LONG ? "" : (pat.tf == PatternTimeframe::MEDIUM ? "" : "")) +
-                                  "½Ƴͻ");
-        }
-
-        // ̬ì
-        if ((pat.name == "ͷ綥" || pat.name == "" || pat.name == "˫ض") &&
-            ((pat.tf == PatternTimeframe::LONG && ta.longTrend == "") ||
-             (pat.tf == PatternTimeframe::MEDIUM && ta.midTrend == "") ||
-             (pat.tf == PatternTimeframe::SHORT && ta.shortTrend == ""))) {
-            contradictions.push_back(patTf + "" + pat.name + "̬Ӧ" +
-                                  (pat.tf == PatternTimeframe::LONG ? "" : (pat.tf == PatternTimeframe::MEDIUM ? "" : "")) +
-                                  "Ƴͻ");
-        }
-
-        // ̬ì
-        if (pat.name == "Σ") {
-            if (ta.longTrend == "") {
-                contradictions.push_back(patTf + "Ρȷƣں̬ЧԴ");
-            }
-            if (ta.shortTrend == "" && pat.breakDir == TriangleBreakDir::DOWN) {
-                contradictions.push_back(patTf + "Ρϣͻأì");
-            }
-            if (ta.shortTrend == "½" && pat.breakDir == TriangleBreakDir::UP) {
-                contradictions.push_back(patTf + "Ρ£ͻأì");
-            }
-        }
-        if (pat.name == "Σɢ") {
-            if (ta.longTrend != "" && pat.breakDir == TriangleBreakDir::NONE) {
-                contradictions.push_back(patTf + "ɢΡԤʾƷתδͻƣ̬źЧ");
-            }
-            if (pat.breakDir == TriangleBreakDir::UP && ta.openDir == "") {
-                contradictions.push_back(patTf + "ɢΡͻƣյͻ");
-            }
-            if (pat.breakDir == TriangleBreakDir::DOWN && ta.openDir == "") {
-                contradictions.push_back(patTf + "ɢΡͻƣ൥ͻ");
-            }
-        }
-    }
-
-    // EMA/KSTһԵì
-    if (emaScore < 60) contradictions.push_back("EMAʱźһԵͣ<60֣жϻ");
-    if (kstScore < 60) contradictions.push_back("KSTʱźһԵͣ<60֣ԽźŻ");
-
-    // ֹì
-    if (baseSLRate > 10.0) contradictions.push_back("ֹʳ10%޸ܸʱƫ");
-    if (baseSLRate < 1.0) contradictions.push_back("ֹʵ1%ױСɨ");
-
-    // ֹܸì
-    if (leverSLRisk > 60.0) {
-        contradictions.push_back("߷ѡֹܸʣ60%ֹ𽫿60%֤𣬼˷գ");
-    } else if (leverSLRisk > 40.0) {
-        contradictions.push_back("ֹܸ40%-60%ֹƫߣ");
-    }
-
-    // ì
-    int dirMatch = calculateDirTrendMatchScore(ta);
-    if (dirMatch == 0) contradictions.push_back("ƥΪ0ҶͻƵ߼Ч");
-
-    return contradictions;
-}
-
 // ۺϷ
 void outputAnalysis(const TradeAnalysis& ta) {
     cout << "==============================================" << endl;
@@ -682,7 +441,9 @@ void outputAnalysis(const TradeAnalysis& ta) {
     cout << "Ŀ꿪ۣ" << fixed << setprecision(4) << ta.openPrice << endl;
     cout << "ǿƽۣ" << fixed << setprecision(4) << ta.liquidPrice << endl;
     cout << "ֹۣ" << fixed << setprecision(4) << ta.stopLoss << endl;
-    cout << "ֹʣ" << fixed << setprecision(2) << ta.stopLossRate << "%" << endl;
+    cout << "ֹʣ" << fixed << setprecision(2) << ta.stopLossRate << "%";
+    if (ta.atrRate > 0) cout << "ATR " << ta.atrRate << "%" << ta.stopLossRate / ta.atrRate << "ATR";
+    cout << endl;
     cout << "ֹܸʣ" << fixed << setprecision(2) << ta.leverStopLossRisk << "%" << endl;
 
     // 2. +RSI+۸̬
@@ -691,7 +452,7 @@ void outputAnalysis(const TradeAnalysis& ta) {
     cout << "ͻƴ" << ta.shortTrendLineBreakTimes << "ΣԽԽ" << endl;
     cout << "RSIָ꣺" << ta.rsiLevel << "" << ta.rsiDuration << ta.rsiUnit << "" << endl;
     cout << "۸̬";
-    if (ta.pricePatterns.empty() || ta.pricePatterns[0].name == "") {
+    if (ta.pricePatterns.empty() || ta.pricePatterns[0].name == PRICE_PATTERN_NAMES[PATTERN_NONE]) {
         cout << "";
     } else {
         for (size_t i = 0; i < ta.pricePatterns.size(); ++i) {
@@ -731,7 +492,14 @@ void outputAnalysis(const TradeAnalysis& ta) {
     bool isHighLeverRisk = false;
     int leverSLScore = calculateLeverStopLossScore(ta, isHighLeverRisk);
     int dirMatchScore = calculateDirTrendMatchScore(ta);
-    cout << "ֹʺԵ÷֣" << baseSLScore << "/10" << "3%-8%" << endl;
+    cout << "ֹʺԵ÷֣" << baseSLScore << "/10";
+    if (ta.atrRate > 0) {
+        ScoreWeights w;
+        cout << "" << setprecision(1) << w.slIdealLowAtr << "-" << w.slIdealHighAtr << "ATR"
+             << setprecision(2) << w.slIdealLowAtr * ta.atrRate << "%-" << w.slIdealHighAtr * ta.atrRate << "%" << endl;
+    } else {
+        cout << "3%-8%" << endl;
+    }
     cout << "ֹܸյ÷֣" << leverSLScore << "/10" << "40%֣40%-60%5֣60%0֣" << endl;
     if (isHighLeverRisk) {
         cout << "\033[31mѡֹܸʣ60%ֹ𽫵´𣬽ܸ/ֹۣ\033[0m" << endl;
@@ -752,7 +520,7 @@ void outputAnalysis(const TradeAnalysis& ta) {
     vector<string> contradictions = analyzeContradictions(ta, isHighLeverRisk);
     if (contradictions.empty()) cout << "δʶָìܵ";
     else {
-        for (int i = 0; i < contradictions.size(); ++i) {
+        for (size_t i = 0; i < contradictions.size(); ++i) {
             cout << i + 1 << ". " << contradictions[i] << endl;
         }
     }
@@ -760,7 +528,64 @@ void outputAnalysis(const TradeAnalysis& ta) {
     cout << "\n==============================================" << endl;
 }
 
-int main() {
+// ṹndjson/binary
+void outputRecord(const TradeAnalysis& ta, OutputFormat format, const string& outputPath) {
+    bool isHighLeverRisk = false;
+    calculateTotalConsistency(ta, isHighLeverRisk);
+    vector<string> contradictions = analyzeContradictions(ta, isHighLeverRisk);
+    ScoreRecord record = makeScoreRecord(ta, contradictions);
+    BufferedWriter out(outputPath);
+    if (format == OutputFormat::BINARY) {
+        writeRecordStreamHeader(out, RecordType::SCORE, sizeof(record));
+        out.write(&record, sizeof(record));
+    } else {
+        JsonLineWriter json(out);
+        writeScoreJson(json, record, contradictions);
+    }
+}
+
+// ֽд־
+void journalAnalysis(JournalWriter& journal, const TradeAnalysis& ta) {
+    bool isHighLeverRisk = false;
+    calculateTotalConsistency(ta, isHighLeverRisk);
+    vector<string> contradictions = analyzeContradictions(ta, isHighLeverRisk);
+    journal.appendAnalysis(ta, makeScoreRecord(ta, contradictions), contradictions);
+}
+
+int main(int argc, char* argv[]) {
+    OutputFormat format = OutputFormat::TEXT;
+    string outputPath = "-";
+    string journalPath;
+    string klinePath;
+    unique_ptr<JournalWriter> journal;
+    unique_ptr<VolatilityInput> volInput(new VolatilityInput);
+    try {
+        for (int i = 1; i < argc; ++i) {
+            string arg = argv[i];
+            if (arg == "--format" && i + 1 < argc) format = parseOutputFormat(argv[++i]);
+            else if (arg == "--output" && i + 1 < argc) outputPath = argv[++i];
+            else if (arg == "--journal" && i + 1 < argc) journalPath = argv[++i];
+            else if (arg == "--klines" && i + 1 < argc) klinePath = argv[++i];
+            else if (arg == "--atr-period" && i + 1 < argc) volInput->period = stoi(argv[++i]);
+            else throw invalid_argument("δ֪" + arg);
+        }
+        if (volInput->period < 1) throw invalid_argument("ATRڱ0");
+        if (klinePath.empty()) volInput.reset();
+        else volInput->rows = loadKlineCsv(klinePath);
+        if (!journalPath.empty()) {
+            journal.reset(new JournalWriter(journalPath));
+            journal->appendSession(journalCommandLine(argc, argv));
+        }
+    } catch (const exception& e) {
+        cerr << "" << e.what() << endl;
+        cerr << "÷У [--format text|ndjson|binary] [--output ļ] [--journal ־]"
+                " [--klines KCSV [--atr-period N]]" << endl;
+        return 1;
+    }
+    // ṹʱʾϢ߱׼󣬱׼ֻ
+    streambuf* coutBuf = cout.rdbuf();
+    if (format != OutputFormat::TEXT) cout.rdbuf(cerr.rdbuf());
+
     TradeAnalysis ta;
     cout << "===== ׿߼Ż棩=====\n" << endl;
     cout << " ˵" << endl;
@@ -771,15 +596,33 @@ int main() {
     cout << endl;
 
     // ֲ¼
-    inputTradeParams(ta);
+    inputTradeParams(ta, volInput.get());
     inputDowTrend(ta);
     inputRSI(ta);
     inputPricePatterns(ta);
     inputEMAData(ta);
     inputKSTData(ta);
 
+    if (journal) {
+        try {
+            journalAnalysis(*journal, ta);
+        } catch (const exception& e) {
+            cerr << "棺" << e.what() << endl;
+        }
+    }
+
     // 
-    outputAnalysis(ta);
+    if (format == OutputFormat::TEXT) {
+        outputAnalysis(ta);
+    } else {
+        cout.rdbuf(coutBuf);
+        try {
+            outputRecord(ta, format, outputPath);
+        } catch (const exception& e) {
+            cerr << "" << e.what() << endl;
+            return 1;
+        }
+    }
 
     return 0;
 }
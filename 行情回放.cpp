@@ -0,0 +1,149 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+#include <stdexcept>
+#include <cstdlib>
+#include <csignal>
+#include <time.h>
+#include "core/kline_io.h"
+#include "core/tick_ring.h"
+
+using namespace tradecheck;
+
+// طţKCSVļָٶд빲ڴ黷ʵأͶ˵ӳٲ
+// ÿK߰ ͡ߡգߣ ߡ͡գߣ·ɱʳɽʱǼ۸K̼¼
+
+static volatile sig_atomic_t g_running = 1;
+
+void handleStopSignal(int) {
+    g_running = 0;
+}
+
+// ȴָʱ̣ϳ˯ߣһԱ֤ȣ
+void waitUntil(int64_t targetNs) {
+    while (g_running) {
+        int64_t remain = targetNs - monotonicNs();
+        if (remain <= 0) return;
+        if (remain > 200000) {
+            timespec ts{0, static_cast<long>(remain - 100000)};
+            if (ts.tv_nsec >= 1000000000L) {
+                ts.tv_sec = ts.tv_nsec / 1000000000L;
+                ts.tv_nsec %= 1000000000L;
+            }
+            nanosleep(&ts, nullptr);
+        }
+    }
+}
+
+// Kڵjn·۸
+double pathPrice(const KlineData& k, int j, int n) {
+    if (n <= 1) return k.close;
+    bool bullish = k.close >= k.open;
+    double p[4] = {k.open, bullish ? k.low : k.high, bullish ? k.high : k.low, k.close};
+    double pos = 3.0 * j / (n - 1);
+    int seg = std::min(2, static_cast<int>(pos));
+    double frac = pos - seg;
+    return p[seg] + (p[seg + 1] - p[seg]) * frac;
+}
+
+// ƶKڣͬһƷKߵС
+int64_t detectInterval(const std::vector<KlineRow>& rows) {
+    std::unordered_map<std::string, int64_t> lastTime;
+    int64_t best = 0;
+    for (const auto& r : rows) {
+        auto it = lastTime.find(r.symbol);
+        if (it != lastTime.end()) {
+            int64_t gap = r.openTime - it->second;
+            if (gap > 0 && (best == 0 || gap < best)) best = gap;
+        }
+        lastTime[r.symbol] = r.openTime;
+    }
+    return best > 0 ? best : 60000;
+}
+
+int main(int argc, char* argv[]) {
+    std::string file;
+    std::string shmName = "/tradecheck_ticks";
+    uint64_t capacity = 65536;
+    double speed = 0.0;   // ʱٱ0=ʱ䣩
+    double rate = 0.0;    // ̶ʣ/룬0=٣
+    int ticksPerCandle = 4;
+    int loops = 1;
+    bool keep = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--shm" && i + 1 < argc) shmName = argv[++i];
+        else if (arg == "--capacity" && i + 1 < argc) capacity = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--speed" && i + 1 < argc) speed = std::atof(argv[++i]);
+        else if (arg == "--rate" && i + 1 < argc) rate = std::atof(argv[++i]);
+        else if (arg == "--ticks" && i + 1 < argc) ticksPerCandle = std::max(0, std::atoi(argv[++i]));
+        else if (arg == "--loop" && i + 1 < argc) loops = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--keep") keep = true;
+        else if (file.empty() && arg[0] != '-') file = arg;
+        else {
+            file.clear();
+            break;
+        }
+    }
+    if (file.empty()) {
+        std::cout << "÷ط <KCSVļ> [--shm ] [--capacity λ] [--speed ʱ䱶] [--rate /]"
+                     " [--ticks ÿK߳ɽ] [--loop ] [--keep]" << std::endl;
+        std::cout << "CSVʽsymbol,openTime,open,high,low,close,volumeopenTimeΪʱ" << std::endl;
+        return 1;
+    }
+
+    std::signal(SIGINT, handleStopSignal);
+    std::signal(SIGTERM, handleStopSignal);
+    try {
+        std::vector<KlineRow> rows = loadKlineCsv(file);
+        if (rows.empty()) throw std::invalid_argument("Kļû");
+        std::stable_sort(rows.begin(), rows.end(), [](const KlineRow& a, const KlineRow& b) {
+            return a.openTime < b.openTime;
+        });
+        int64_t interval = detectInterval(rows);
+
+        TickRingProducer producer(shmName, capacity);
+        std::vector<uint32_t> ids(rows.size());
+        for (size_t i = 0; i < rows.size(); ++i) ids[i] = producer.registerSymbol(rows[i].symbol);
+        std::cout << "ڴ棺" << shmName << "" << capacity << "ۣK" << rows.size()
+                  << "" << interval / 1000 << "" << std::endl;
+
+        int64_t startNs = monotonicNs();
+        int64_t baseEvent = rows.front().openTime;
+        uint64_t sent = 0;
+        for (int loop = 0; loop < loops && g_running; ++loop) {
+            int64_t loopOffset = static_cast<int64_t>(loop) * (rows.back().openTime - baseEvent + interval);
+            for (size_t i = 0; i < rows.size() && g_running; ++i) {
+                const KlineData& k = rows[i].kline;
+                int points = ticksPerCandle;
+                for (int j = 0; j <= points && g_running; ++j) {
+                    bool isClose = j == points;
+                    int64_t eventTime = rows[i].openTime + loopOffset + interval * (j + 1) / (points + 1);
+                    if (isClose) eventTime = rows[i].openTime + loopOffset + interval;
+                    // 
+                    if (rate > 0) waitUntil(startNs + static_cast<int64_t>(sent * 1e9 / rate));
+                    else if (speed > 0) waitUntil(startNs + static_cast<int64_t>((eventTime - baseEvent) * 1e6 / speed));
+                    if (!isClose) {
+                        producer.publish(ids[i], TickKind::TRADE, eventTime, pathPrice(k, j, points), k.volume / points);
+                        sent++;
+                    } else {
+                        producer.publish(ids[i], TickKind::MARK, eventTime, k.close, 0.0);
+                        producer.publish(ids[i], TickKind::CANDLE, eventTime, k.close, k.volume, k.open, k.high, k.low);
+                        sent += 2;
+                    }
+                }
+            }
+        }
+        double seconds = (monotonicNs() - startNs) / 1e9;
+        std::cout << "ѷ" << sent << "¼ʱ" << seconds << "루" << static_cast<uint64_t>(sent / seconds)
+                  << "/룩" << std::endl;
+        // ˳ʱɾڴӳ߿ɼ꣩--keepʱԺͷȡ
+        if (!keep) producer.unlinkShm();
+    } catch (const std::exception& e) {
+        std::cerr << "" << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,453 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdlib>
+#include <cstdio>
+#include <cmath>
+#include <csignal>
+#include <time.h>
+#include "core/tick_ring.h"
+#include "core/streaming_levels.h"
+#include "core/streaming_indicators.h"
+#include "core/crypto_risk.h"
+#include "core/latency_stats.h"
+#include "core/state_snapshot.h"
+
+using namespace tradecheck;
+
+// ߣӹڴ黷ȡɽ/Ǽ۸/K̼¼
+// Kʱʽ֧λָ꣬ɽ/Ǽ۸񵽴ʱֲǿƽ룬ͳƶ˵ӳ
+// ·ֱӶȡӳڴеĶ¼¼ıڴ
+// ָ--snapshotʱڰѸƷ״̬дļӿջָӿʱĻλýŶֻطβ
+
+static volatile sig_atomic_t g_running = 1;
+
+void handleStopSignal(int) {
+    g_running = 0;
+}
+
+// Ʒ״̬PODдգ
+struct SymbolState {
+    StreamingSupportResistance levels;
+    StreamingIndicatorSet indicators;
+    double lastPrice = 0.0;
+    uint64_t candles = 0;
+    int64_t lastCandleTime = INT64_MIN; // һѴKߵʱ䣬طβʱݴѼK
+};
+
+// KΪֵ߼۲ͼۡɽǸ
+bool validCandle(const KlineData& k) {
+    return std::isfinite(k.open) && std::isfinite(k.high) && std::isfinite(k.low) && std::isfinite(k.close) &&
+           std::isfinite(k.volume) && k.high >= k.low && k.volume >= 0;
+}
+
+using StateSnapshotReader = SnapshotReader<SymbolState>;
+using StateSnapshotWriter = SnapshotWriter<SymbolState>;
+
+// еĳֲ
+struct WatchedPosition {
+    std::string symbol;
+    uint32_t symbolId = UINT32_MAX; // ڻеǼǺ
+    TradeDirection direction;
+    double entryPrice;
+    double liquidationPrice;
+    int state = 0; // 0= 1=ӽǿƽ 2=Ѵǿƽ
+};
+
+// ȡֲļÿ Ʒ (/) ܸ λռ(%) ּ ʽ#ͷΪע
+std::vector<WatchedPosition> loadPositions(const std::string& path, const ContractTable& contracts) {
+    std::ifstream in(path);
+    if (!in) throw std::invalid_argument("޷򿪳ֲļ" + path);
+    std::vector<WatchedPosition> positions;
+    std::string line;
+    int lineNo = 0;
+    while (std::getline(in, line)) {
+        lineNo++;
+        if (line.empty() || line[0] == '#' || line[0] == '\r') continue;
+        std::istringstream ss(line);
+        std::string symbol, dir;
+        double lev, ratio, entry, capital;
+        if (!(ss >> symbol >> dir >> lev >> ratio >> entry >> capital)) {
+            throw std::invalid_argument("ֲļ" + std::to_string(lineNo) + "иʽ");
+        }
+        if (dir != "" && dir != "") throw std::invalid_argument("ֲļ" + std::to_string(lineNo) + "зΪ/");
+        TradeDirection td = dir == "" ? TradeDirection::LONG : TradeDirection::SHORT;
+        CryptoRiskCalculator calc(contracts.at(symbol), lev, ratio, entry, td, capital);
+        WatchedPosition p;
+        p.symbol = symbol;
+        p.direction = td;
+        p.entryPrice = entry;
+        p.liquidationPrice = calc.calculateLiquidationPrice();
+        positions.push_back(p);
+    }
+    return positions;
+}
+
+class TickConsumerApp {
+private:
+    TickRingConsumer ring;
+    int window;
+    double warnDistance; // ǿƽ۵Ԥ
+    std::vector<std::unique_ptr<SymbolState>> symbols; // Ʒֱ
+    std::vector<std::string> names;
+    std::vector<uint64_t> versions; // ״̬汾K߸ºֻ汾仯Ʒ
+    std::vector<WatchedPosition> positions;
+    std::vector<std::vector<size_t>> positionsBySymbol;
+    HdrHistogram latency;
+    HdrHistogram intervalLatency;
+    uint64_t counts[3] = {0, 0, 0};
+    uint64_t torn = 0;
+    uint64_t duplicateCandles = 0;
+    uint64_t badRecords = 0; // ۸ֵ/߼۵ͼ۵ļ¼״̬
+
+    // ӿջָ״̬Ʒ״γʱأδֵƷԭ֮Ŀ
+    std::unique_ptr<StateSnapshotReader> restored;
+    std::unordered_map<std::string, size_t> restoredIndex;
+    std::vector<bool> restoredClaimed;
+    uint64_t catchUpTarget = 0;
+    int64_t restoreStartNs = 0;
+    int64_t maxCaptureNs = 0;
+
+    SymbolState& stateOf(uint32_t id) {
+        if (id >= symbols.size()) {
+            symbols.resize(id + 1);
+            names.resize(id + 1);
+            versions.resize(id + 1, 0);
+            positionsBySymbol.resize(id + 1);
+        }
+        if (!symbols[id]) {
+            // ״γֵƷ֣״̬򿽻أسֲ
+            symbols[id].reset(new SymbolState());
+            std::string name = ring.symbolName(id);
+            auto it = restoredIndex.find(name);
+            if (it != restoredIndex.end()) {
+                *symbols[id] = restored->entry(it->second).state;
+                restoredClaimed[it->second] = true;
+            } else {
+                symbols[id]->levels.reset(window);
+                symbols[id]->indicators.reset();
+            }
+            names[id] = name;
+            versions[id] = 1;
+            for (size_t i = 0; i < positions.size(); ++i) {
+                if (positions[i].symbol == name) {
+                    positions[i].symbolId = id;
+                    positionsBySymbol[id].push_back(i);
+                }
+            }
+        }
+        return *symbols[id];
+    }
+
+    void checkPositions(uint32_t id, double price, int64_t eventTime) {
+        for (size_t idx : positionsBySymbol[id]) {
+            WatchedPosition& p = positions[idx];
+            bool isLong = p.direction == TradeDirection::LONG;
+            double distance = isLong ? (price - p.liquidationPrice) / price : (p.liquidationPrice - price) / price;
+            int state = distance <= 0 ? 2 : (distance <= warnDistance ? 1 : 0);
+            if (state != p.state) {
+                const char* names[3] = {"ָ", "ӽǿƽ", "ǿƽ"};
+                std::printf("[%lld] %s %s %s۸%.6g ǿƽ%.6g %.2f%%\n", static_cast<long long>(eventTime),
+                            p.symbol.c_str(), isLong ? "" : "", names[state], price, p.liquidationPrice, distance * 100);
+                p.state = state;
+            }
+        }
+    }
+
+public:
+    TickConsumerApp(const std::string& shmName, bool fromStart, int windowSize, double warn,
+                    const std::vector<WatchedPosition>& pos)
+        : ring(shmName, fromStart), window(windowSize), warnDistance(warn), positions(pos) {
+        if (window <= 0 || window > MAX_STREAM_WINDOW) throw std::invalid_argument("ʽڳ1~512֮");
+    }
+
+    // м¼ش
+    size_t poll() {
+        size_t n = 0;
+        while (const TickRecord* r = ring.peek()) {
+            TRADECHECK_LATENCY_SCOPE(LatencyStage::INGEST);
+            // ֱӶȡڴеֶ
+            int64_t publishNs = r->publishNs;
+            int64_t eventTime = r->eventTime;
+            uint32_t id = r->symbolId;
+            TickKind kind = r->kind;
+            KlineData k{r->open, r->high, r->low, r->price, r->quantity};
+            if (!ring.commit(r) || id >= static_cast<uint32_t>(TICK_RING_MAX_SYMBOLS)) {
+                torn++;
+                continue;
+            }
+            SymbolState& s = stateOf(id);
+            switch (kind) {
+                case TickKind::TRADE:
+                case TickKind::MARK:
+                    if (!(std::isfinite(k.close) && k.close > 0)) {
+                        badRecords++;
+                        break;
+                    }
+                    // ¼Ҳڿ۸仯ͬҪһο¿Ʒ
+                    if (s.lastPrice != k.close) {
+                        s.lastPrice = k.close;
+                        versions[id]++;
+                    }
+                    if (!positionsBySymbol[id].empty()) checkPositions(id, k.close, eventTime);
+                    break;
+                case TickKind::CANDLE: {
+                    if (eventTime <= s.lastCandleTime) {
+                        duplicateCandles++;
+                        break;
+                    }
+                    // һK߲ʽ״̬׳쳣˳ͬһ¼Ϸ˳
+                    if (!validCandle(k)) {
+                        badRecords++;
+                        break;
+                    }
+                    {
+                        TRADECHECK_LATENCY_SCOPE(LatencyStage::LEVELS);
+                        s.levels.update(k);
+                    }
+                    TRADECHECK_LATENCY_SCOPE(LatencyStage::INDICATORS);
+                    s.indicators.update(k.close);
+                    s.candles++;
+                    s.lastCandleTime = eventTime;
+                    versions[id]++;
+                    break;
+                }
+            }
+            int64_t lat = monotonicNs() - publishNs;
+            latency.record(lat);
+            intervalLatency.record(lat);
+            counts[static_cast<int>(kind) < 3 ? static_cast<int>(kind) : 0]++;
+            n++;
+        }
+        return n;
+    }
+
+    // ӿջָ¸Ʒ״̬ӿʱĻλýŶؿ֮ļ¼Ƿ񶼻ڻ
+    bool restore(std::unique_ptr<StateSnapshotReader> snapshot) {
+        restored = std::move(snapshot);
+        restoredClaimed.assign(restored->size(), false);
+        for (size_t i = 0; i < restored->size(); ++i) {
+            const char* symbol = restored->entry(i).symbol;
+            restoredIndex[std::string(symbol, strnlen(symbol, SNAPSHOT_SYMBOL_LENGTH))] = i;
+        }
+        restoreStartNs = monotonicNs();
+        bool complete = ring.seek(restored->position());
+        catchUpTarget = ring.writePosition();
+        return complete;
+    }
+
+    // ָָʱ̵дλüΪ׷ƽӡһβطʱ
+    void checkCatchUp() {
+        if (catchUpTarget == 0 || ring.position() < catchUpTarget) return;
+        std::printf("ѻطſ֮飨λ%lluʱ%.1f msѼK%llu\n",
+                    static_cast<unsigned long long>(catchUpTarget), (monotonicNs() - restoreStartNs) / 1e6,
+                    static_cast<unsigned long long>(duplicateCandles));
+        catchUpTarget = 0;
+    }
+
+    // ·߳ϰб仯Ʒֿݴ̨߳д̨æʱ
+    bool captureSnapshot(StateSnapshotWriter& writer) {
+        int64_t start = monotonicNs();
+        StateSnapshotWriter::Staging* staging = writer.beginCapture();
+        if (!staging) return false;
+        for (size_t id = 0; id < symbols.size(); ++id) {
+            if (symbols[id]) staging->update(static_cast<uint32_t>(id), names[id], versions[id], *symbols[id]);
+        }
+        // δڻֵƷַڻƷֱ֮󣬳ֺʽŽ
+        for (size_t i = 0; i < restoredClaimed.size(); ++i) {
+            uint32_t slot = static_cast<uint32_t>(TICK_RING_MAX_SYMBOLS + i);
+            const auto& e = restored->entry(i);
+            if (restoredClaimed[i]) staging->erase(slot);
+            else staging->update(slot, std::string(e.symbol, strnlen(e.symbol, SNAPSHOT_SYMBOL_LENGTH)), 1, e.state);
+        }
+        staging->position = ring.position();
+        writer.commitCapture(staging);
+        maxCaptureNs = std::max(maxCaptureNs, monotonicNs() - start);
+        return true;
+    }
+
+    int64_t maxCaptureTime() const { return maxCaptureNs; }
+
+    void printInterval() {
+        if (intervalLatency.count() == 0) return;
+        std::printf("¼%lluɽ%llu %llu K%lluʧ%llu Ч%llu ѹ%llu | ӳp50=%.1fus p99=%.1fus max=%.1fus\n",
+                    static_cast<unsigned long long>(latency.count()), static_cast<unsigned long long>(counts[0]),
+                    static_cast<unsigned long long>(counts[1]), static_cast<unsigned long long>(counts[2]),
+                    static_cast<unsigned long long>(ring.lostRecords() + torn), static_cast<unsigned long long>(badRecords),
+                    static_cast<unsigned long long>(ring.backlog()), intervalLatency.percentile(0.5) / 1000.0,
+                    intervalLatency.percentile(0.99) / 1000.0, intervalLatency.max() / 1000.0);
+        intervalLatency.clear();
+    }
+
+    void printSummary() {
+        const char* trendNames[3] = {"", "½", ""};
+        const char* rsiNames[3] = {"", "", ""};
+        const char* crossNames[3] = {"ϴԽ", "´Խ", "δԽ"};
+        std::cout << "\n===== Ʒ״̬ =====" << std::endl;
+        for (size_t id = 0; id < symbols.size(); ++id) {
+            if (!symbols[id]) continue;
+            const SymbolState& s = *symbols[id];
+            std::cout << ring.symbolName(static_cast<uint32_t>(id)) << "¼" << s.lastPrice << "K" << s.candles;
+            if (!s.levels.empty()) {
+                SupportResistanceLevels l = s.levels.levels();
+                std::cout << "\n  ֧" << l.klineCount << "" << l.highestHigh << " " << l.lowestLow
+                          << " P=" << l.pivotPoint << " S1=" << l.s1 << " R1=" << l.r1
+                          << " ܼ[" << l.denseSupport << ", " << l.denseResist << "]";
+                const StreamingIndicatorSet& ind = s.indicators;
+                std::cout << "\n  EMA" << ind.ema[0].period << "/" << ind.ema[1].period << "/" << ind.ema[2].period << ""
+                          << trendNames[ind.ema[0].trend] << "/" << trendNames[ind.ema[1].trend] << "/"
+                          << trendNames[ind.ema[2].trend];
+                if (ind.rsi.ready()) std::cout << " | RSI=" << ind.rsi.value() << "" << rsiNames[ind.rsi.level()] << "";
+                if (ind.kst.ready()) {
+                    std::cout << " | KST=" << ind.kst.kst << " ź=" << ind.kst.signalValue() << ""
+                              << crossNames[ind.kst.cross] << "";
+                }
+            }
+            std::cout << std::endl;
+        }
+        for (const auto& p : positions) {
+            std::cout << "ֲ " << p.symbol << (p.direction == TradeDirection::LONG ? " " : " ") << "ּ"
+                      << p.entryPrice << " ǿƽ" << p.liquidationPrice
+                      << (p.symbolId == UINT32_MAX ? "δյ飩" : "") << std::endl;
+        }
+        std::printf("ܼƣ¼%lluʧ%lluЧ%llu˵ӳ p50=%.1fus p99=%.1fus p99.9=%.1fus max=%.1fus\n",
+                    static_cast<unsigned long long>(latency.count()),
+                    static_cast<unsigned long long>(ring.lostRecords() + torn), static_cast<unsigned long long>(badRecords),
+                    latency.percentile(0.5) / 1000.0,
+                    latency.percentile(0.99) / 1000.0, latency.percentile(0.999) / 1000.0, latency.max() / 1000.0);
+    }
+};
+
+int main(int argc, char* argv[]) {
+    std::string shmName = "/tradecheck_ticks";
+    std::string positionFile;
+    std::string contractFile;
+    bool fromStart = false;
+    int window = 200;
+    double warn = 0.05;
+    double reportSeconds = 1.0;
+    double idleExit = 0.0;
+    double attachSeconds = 5.0;
+    bool busyPoll = false;
+    std::string latencyReport;
+    std::string snapshotPath;
+    double snapshotSeconds = 10.0;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--shm" && i + 1 < argc) shmName = argv[++i];
+        else if (arg == "--positions" && i + 1 < argc) positionFile = argv[++i];
+        else if (arg == "--contracts" && i + 1 < argc) contractFile = argv[++i];
+        else if (arg == "--from-start") fromStart = true;
+        else if (arg == "--window" && i + 1 < argc) window = std::atoi(argv[++i]);
+        else if (arg == "--warn" && i + 1 < argc) warn = std::atof(argv[++i]) / 100.0;
+        else if (arg == "--report" && i + 1 < argc) reportSeconds = std::atof(argv[++i]);
+        else if (arg == "--idle-exit" && i + 1 < argc) idleExit = std::atof(argv[++i]);
+        else if (arg == "--attach-wait" && i + 1 < argc) attachSeconds = std::atof(argv[++i]);
+        else if (arg == "--busy") busyPoll = true;
+        else if (arg == "--latency-report" && i + 1 < argc) latencyReport = argv[++i];
+        else if (arg == "--snapshot" && i + 1 < argc) snapshotPath = argv[++i];
+        else if (arg == "--snapshot-interval" && i + 1 < argc) snapshotSeconds = std::atof(argv[++i]);
+        else {
+            std::cout << "÷ [--shm ] [--positions ֲļ] [--contracts Լļ] [--from-start]"
+                         " [--window K] [--warn Ԥ%] [--report ] [--idle-exit ] [--attach-wait ] [--busy]"
+                         " [--latency-report ֽ׶ӳٱļ] [--snapshot ״̬ļ] [--snapshot-interval ]"
+                      << std::endl;
+            std::cout << "ֲļÿУƷ (/) ܸ λռ(%) ּ ʽ" << std::endl;
+            return 1;
+        }
+    }
+
+    std::signal(SIGINT, handleStopSignal);
+    std::signal(SIGTERM, handleStopSignal);
+    try {
+        std::vector<WatchedPosition> positions;
+        ContractTable contracts(contractFile.empty() ? defaultContracts() : loadContractConfig(contractFile));
+        if (!positionFile.empty()) positions = loadPositions(positionFile, contracts);
+        // ߿Ժڴǰÿ100һ
+        std::unique_ptr<TickConsumerApp> appPtr;
+        int64_t attachDeadline = monotonicNs() + static_cast<int64_t>(attachSeconds * 1e9);
+        while (!appPtr) {
+            try {
+                appPtr.reset(new TickConsumerApp(shmName, fromStart, window, warn, positions));
+            } catch (const std::runtime_error&) {
+                if (!g_running || monotonicNs() > attachDeadline) throw;
+                timespec ts{0, 100000000};
+                nanosleep(&ts, nullptr);
+            }
+        }
+        TickConsumerApp& app = *appPtr;
+
+        // ״̬գȳԻֲָûʱ֮д
+        std::unique_ptr<StateSnapshotWriter> snapshot;
+        if (!snapshotPath.empty()) {
+            struct stat st;
+            if (::stat(snapshotPath.c_str(), &st) == 0) {
+                try {
+                    int64_t start = monotonicNs();
+                    std::unique_ptr<StateSnapshotReader> reader(new StateSnapshotReader(snapshotPath, window));
+                    size_t count = reader->size();
+                    uint64_t generation = reader->generation();
+                    uint64_t position = reader->position();
+                    bool complete = app.restore(std::move(reader));
+                    std::printf("Ѵӿջָ%zuƷ֣%lluλ%lluʱ%.1f ms%s\n", count,
+                                static_cast<unsigned long long>(generation), static_cast<unsigned long long>(position),
+                                (monotonicNs() - start) / 1e6,
+                                complete ? "" : "֮ĲѲڻڣ״̬ȱ");
+                } catch (const std::invalid_argument& e) {
+                    std::printf("δʹÿգ%s\n", e.what());
+                }
+            }
+            snapshot.reset(new StateSnapshotWriter(snapshotPath, window));
+        }
+
+        int64_t lastReport = monotonicNs();
+        int64_t lastSnapshot = lastReport;
+        int64_t lastActivity = lastReport;
+        while (g_running) {
+            size_t n = app.poll();
+            int64_t now = monotonicNs();
+            if (n > 0) lastActivity = now;
+            else if (idleExit > 0 && now - lastActivity > idleExit * 1e9) break;
+            app.checkCatchUp();
+            if (reportSeconds > 0 && now - lastReport > reportSeconds * 1e9) {
+                app.printInterval();
+                lastReport = now;
+            }
+            if (snapshot && snapshotSeconds > 0 && now - lastSnapshot > snapshotSeconds * 1e9) {
+                if (app.captureSnapshot(*snapshot)) lastSnapshot = now;
+            }
+            // ¼¼ʱóCPU--busyʱԻӳ
+            if (n == 0 && !busyPoll) {
+                timespec ts{0, 20000};
+                nanosleep(&ts, nullptr);
+            }
+        }
+        app.printSummary();
+        if (snapshot) {
+            // ˳ǰдտ
+            snapshot->flush();
+            app.captureSnapshot(*snapshot);
+            snapshot->flush();
+            if (!snapshot->error().empty()) std::printf("дʧܣ%s\n", snapshot->error().c_str());
+            else {
+                std::printf("գ%llu%.1f KBһ%.2f ms·%.1f us\n",
+                            static_cast<unsigned long long>(snapshot->lastGeneration()), snapshot->lastBytes() / 1024.0,
+                            snapshot->lastWriteNs() / 1e6, app.maxCaptureTime() / 1e3);
+            }
+        }
+        std::vector<LatencyStageSummary> stages = summarizeLatency(latencySnapshot());
+        std::fflush(stdout);
+        printLatencyTable(stdout, stages);
+        if (!latencyReport.empty()) writeLatencyReport(latencyReport, stages);
+    } catch (const std::exception& e) {
+        std::cerr << "" << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,535 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <stdexcept>
+#include <chrono>
+#include <cstring>
+#include <cmath>
+#include <cstdlib>
+#include <csignal>
+#include <ctime>
+#include <cerrno>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "core/risk_protocol.h"
+#include "core/streaming_levels.h"
+#include "core/streaming_indicators.h"
+
+using namespace tradecheck;
+
+// ػ̣Unix׽ṩǿƽ/֤֧λһַ
+// ׸󵽴ȴbatchWindowUs΢루MAX_BATCH_REQUESTSռͬͳһлд
+
+// һദٵȴ
+const size_t MAX_BATCH_REQUESTS = 1024;
+
+// δޣͻ˲ӦʱϿ
+const size_t MAX_PENDING_OUTPUT = 64 * 1024 * 1024;
+
+static volatile sig_atomic_t g_running = 1;
+static volatile sig_atomic_t g_reload = 0;
+
+void handleStopSignal(int) {
+    g_running = 0;
+}
+
+// SIGHUP¼غԼ
+void handleReloadSignal(int) {
+    g_reload = 1;
+}
+
+// Ʒֳפ״̬֧λEMA/RSI/KSTÿ׷ӵK߾̯O(1)£ѯʱɨʷ
+struct SymbolWindow {
+    TimeFrame timeframe = TimeFrame::FOUR_HOUR;
+    StreamingSupportResistance levels;
+    StreamingIndicatorSet indicators;
+    uint64_t candles = 0;
+};
+
+// ͻ
+struct Connection {
+    int fd;
+    std::vector<char> in;   // δ
+    std::vector<char> out;  // ͵
+    size_t outOffset = 0;
+    bool closed = false;
+};
+
+// һеĵ뻺еĸأ
+struct PendingRequest {
+    size_t conn;
+    MessageHeader header;
+    size_t payloadOffset;
+};
+
+class RiskDaemon {
+private:
+    std::string socketPath;
+    int listenFd = -1;
+    long batchWindowUs;
+    size_t maxWindow;
+    size_t maxSymbols;
+    std::vector<Connection> connections;
+    std::unordered_map<std::string, std::unique_ptr<SymbolWindow>> symbols;
+    ContractRegistry& contracts;
+    ContractRegistry::Reader contractReader;
+    std::string contractPath; // ԼļΪʱʹĬϺԼ
+    uint64_t handledRequests = 0;
+    uint64_t handledBatches = 0;
+    AnalysisArena scoreArena; // SCOREķṹìܵ㣬ÿһͷ
+
+    // ÷
+    static void setNonBlocking(int fd) {
+        int flags = fcntl(fd, F_GETFL, 0);
+        fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+    }
+
+    // еȴе
+    void acceptClients() {
+        while (true) {
+            int fd = accept(listenFd, nullptr, nullptr);
+            if (fd < 0) break;
+            setNonBlocking(fd);
+            connections.push_back({fd, {}, {}, 0, false});
+        }
+    }
+
+    // ȡȫɶ
+    void readConnection(Connection& c) {
+        char buf[65536];
+        while (true) {
+            ssize_t n = recv(c.fd, buf, sizeof(buf), 0);
+            if (n > 0) {
+                c.in.insert(c.in.end(), buf, buf + n);
+            } else if (n == 0) {
+                c.closed = true;
+                return;
+            } else {
+                if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) c.closed = true;
+                return;
+            }
+        }
+    }
+
+    // Ӹ뻺зļ
+    void collectFrames(std::vector<PendingRequest>& batch, std::vector<size_t>& parsed) {
+        for (size_t i = 0; i < connections.size(); ++i) {
+            Connection& c = connections[i];
+            size_t pos = parsed[i];
+            while (c.in.size() - pos >= sizeof(MessageHeader)) {
+                MessageHeader h;
+                std::memcpy(&h, c.in.data() + pos, sizeof(h));
+                if (h.magic != PROTOCOL_MAGIC || h.length > MAX_PAYLOAD_SIZE) {
+                    c.closed = true;
+                    break;
+                }
+                if (c.in.size() - pos - sizeof(h) < h.length) break;
+                batch.push_back({i, h, pos + sizeof(h)});
+                pos += sizeof(h) + h.length;
+            }
+            parsed[i] = pos;
+        }
+    }
+
+    // RISK
+    void handleRisk(const MessageHeader& h, const char* payload, const ContractTable& table, std::vector<char>& out) {
+        TRADECHECK_LATENCY_SCOPE(LatencyStage::RISK);
+        if (h.length != sizeof(RiskRequest)) {
+            appendFrame(out, MessageType::RISK, MessageStatus::BAD_PAYLOAD, h.requestId, nullptr, 0);
+            return;
+        }
+        RiskRequest req;
+        std::memcpy(&req, payload, sizeof(req));
+        // ֵƹ < / <= 飬ʱȾܾ
+        bool finite = std::isfinite(req.leverage) && std::isfinite(req.positionRatio) && std::isfinite(req.entryPrice) &&
+                      std::isfinite(req.totalCapital);
+        if (req.direction > 1 || !finite || req.leverage < 1 || req.positionRatio < 0 || req.entryPrice <= 0 ||
+            req.totalCapital <= 0) {
+            appendFrame(out, MessageType::RISK, MessageStatus::BAD_PAYLOAD, h.requestId, nullptr, 0);
+            return;
+        }
+        uint32_t contractId = table.find(req.symbol, strnlen(req.symbol, sizeof(req.symbol)));
+        if (contractId == INVALID_CONTRACT_ID) {
+            appendFrame(out, MessageType::RISK, MessageStatus::UNKNOWN_SYMBOL, h.requestId, nullptr, 0);
+            return;
+        }
+        CryptoRiskCalculator calc(table.spec(contractId), req.leverage, req.positionRatio,
+                                  req.entryPrice, static_cast<TradeDirection>(req.direction), req.totalCapital);
+        RiskResponse resp{};
+        resp.threshold = calc.getThreshold();
+        resp.riskCoefficient = calc.calculateRiskCoefficient();
+        resp.initialMargin = calc.getInitialMargin();
+        resp.maintenanceMargin = calc.getMaintenanceMargin();
+        resp.marginToAdd = calc.calculateMarginToAdd();
+        resp.liquidationPrice = calc.calculateLiquidationPrice();
+        resp.riskLevel = static_cast<uint8_t>(calc.classifyRiskLevel());
+        appendFrame(out, MessageType::RISK, MessageStatus::OK, h.requestId, &resp, sizeof(resp));
+    }
+
+    // פָ
+    static IndicatorResponse indicatorResponse(const SymbolWindow& w) {
+        const StreamingIndicatorSet& ind = w.indicators;
+        IndicatorResponse r{};
+        for (int i = 0; i < 3; ++i) {
+            r.emaTrend[i] = static_cast<uint8_t>(ind.ema[i].trend);
+            r.emaPeriod[i] = ind.ema[i].period;
+            r.ema[i] = ind.ema[i].value;
+            if (ind.ema[i].ready()) r.ready |= 1 << i;
+        }
+        r.rsiLevel = static_cast<uint8_t>(ind.rsi.level());
+        r.kstCross = static_cast<uint8_t>(ind.kst.cross);
+        if (ind.rsi.ready()) r.ready |= 1 << 3;
+        if (ind.kst.ready()) r.ready |= 1 << 4;
+        r.klineCount = static_cast<uint32_t>(w.candles);
+        r.rsi = ind.rsi.value();
+        r.kst = ind.kst.kst;
+        r.kstSignal = ind.kst.signalValue();
+        return r;
+    }
+
+    // SR_UPDATE/SR_QUERY/INDICATORS
+    void handleSymbol(const MessageHeader& h, const char* payload, std::vector<char>& out) {
+        MessageType type = static_cast<MessageType>(h.type);
+        SymbolRequest req;
+        if (h.length < sizeof(req)) {
+            appendFrame(out, type, MessageStatus::BAD_PAYLOAD, h.requestId, nullptr, 0);
+            return;
+        }
+        std::memcpy(&req, payload, sizeof(req));
+        req.symbol[sizeof(req.symbol) - 1] = '\0';
+        std::string symbol(req.symbol);
+
+        if (type == MessageType::SR_UPDATE) {
+            if (h.length != sizeof(req) + static_cast<uint64_t>(req.klineCount) * sizeof(KlineData) || req.timeframe > 1) {
+                appendFrame(out, type, MessageStatus::BAD_PAYLOAD, h.requestId, nullptr, 0);
+                return;
+            }
+            TRADECHECK_LATENCY_SCOPE(LatencyStage::INGEST);
+            std::vector<KlineData> incoming(req.klineCount);
+            if (req.klineCount) std::memcpy(incoming.data(), payload + sizeof(req), req.klineCount * sizeof(KlineData));
+            // Уͨд봰ڣܾĸ²ıƷ״̬
+            for (const auto& kd : incoming) {
+                if (!std::isfinite(kd.open) || !std::isfinite(kd.high) || !std::isfinite(kd.low) ||
+                    !std::isfinite(kd.close) || !std::isfinite(kd.volume) || kd.volume < 0) {
+                    throw std::invalid_argument("Kߺֵ򸺳ɽ");
+                }
+                if (kd.high < kd.low) throw std::invalid_argument("߼۵ͼ۵ЧK");
+            }
+            TimeFrame timeframe = static_cast<TimeFrame>(req.timeframe);
+            auto it = symbols.find(symbol);
+            if (it != symbols.end() && it->second->timeframe != timeframe) {
+                throw std::invalid_argument("KƷִKߵڲһ");
+            }
+            if (it == symbols.end() && symbols.size() >= maxSymbols) {
+                throw std::invalid_argument("ƷѴ" + std::to_string(maxSymbols) + "ٴƷִ");
+            }
+            std::unique_ptr<SymbolWindow>& slot = it != symbols.end() ? it->second : symbols[symbol];
+            if (!slot) {
+                slot.reset(new SymbolWindow());
+                slot->timeframe = timeframe;
+                slot->levels.reset(static_cast<int>(maxWindow));
+                slot->indicators.reset();
+            }
+            SymbolWindow& w = *slot;
+            {
+                TRADECHECK_LATENCY_SCOPE(LatencyStage::LEVELS);
+                for (const auto& kd : incoming) w.levels.update(kd);
+            }
+            {
+                TRADECHECK_LATENCY_SCOPE(LatencyStage::INDICATORS);
+                for (const auto& kd : incoming) w.indicators.update(kd.close);
+            }
+            w.candles += incoming.size();
+            SymbolUpdateResponse resp{static_cast<uint32_t>(w.levels.count), 0};
+            appendFrame(out, type, MessageStatus::OK, h.requestId, &resp, sizeof(resp));
+        } else {
+            auto it = symbols.find(symbol);
+            if (it == symbols.end() || it->second->levels.empty()) {
+                appendFrame(out, type, MessageStatus::UNKNOWN_SYMBOL, h.requestId, nullptr, 0);
+                return;
+            }
+            if (type == MessageType::INDICATORS) {
+                if (h.length != sizeof(req)) {
+                    appendFrame(out, type, MessageStatus::BAD_PAYLOAD, h.requestId, nullptr, 0);
+                    return;
+                }
+                IndicatorResponse resp = indicatorResponse(*it->second);
+                appendFrame(out, type, MessageStatus::OK, h.requestId, &resp, sizeof(resp));
+                return;
+            }
+            SupportResistanceLevels levels;
+            {
+                TRADECHECK_LATENCY_SCOPE(LatencyStage::LEVELS);
+                levels = it->second->levels.levels();
+            }
+            appendFrame(out, type, MessageStatus::OK, h.requestId, &levels, sizeof(levels));
+        }
+    }
+
+    // SCORE
+    void handleScore(const MessageHeader& h, const char* payload, std::vector<char>& out) {
+        TradeAnalysis ta(scoreArena.allocator());
+        if (!decodeScoreRequest(payload, h.length, ta)) {
+            appendFrame(out, MessageType::SCORE, MessageStatus::BAD_PAYLOAD, h.requestId, nullptr, 0);
+            return;
+        }
+        bool highRisk = false;
+        ScoreResponse resp{};
+        {
+            TRADECHECK_LATENCY_SCOPE(LatencyStage::SCORING);
+            resp.totalScore = calculateTotalConsistency(ta, highRisk);
+            resp.emaScore = calculateEMAConsistency(ta.emaList);
+            resp.kstScore = calculateKSTConsistency(ta.kstList);
+            resp.dirMatchScore = calculateDirTrendMatchScore(ta);
+            resp.highLeverRisk = highRisk ? 1 : 0;
+        }
+        ContradictionList contradictions(scoreArena.allocator());
+        {
+            TRADECHECK_LATENCY_SCOPE(LatencyStage::CONTRADICTIONS);
+            analyzeContradictions(ta, highRisk, contradictions);
+        }
+        resp.contradictionCount = static_cast<uint16_t>(contradictions.size());
+
+        TRADECHECK_LATENCY_SCOPE(LatencyStage::OUTPUT);
+        std::pmr::vector<char> body(reinterpret_cast<const char*>(&resp), reinterpret_cast<const char*>(&resp) + sizeof(resp),
+                                    scoreArena.allocator());
+        for (const auto& text : contradictions) {
+            uint16_t len = static_cast<uint16_t>(text.size());
+            body.insert(body.end(), reinterpret_cast<const char*>(&len), reinterpret_cast<const char*>(&len) + sizeof(len));
+            body.insert(body.end(), text.begin(), text.end());
+        }
+        appendFrame(out, MessageType::SCORE, MessageStatus::OK, h.requestId, body.data(), static_cast<uint32_t>(body.size()));
+    }
+
+    // STATS󣺷ظ׶ӳٻܣط0ʱ
+    void handleStats(const MessageHeader& h, const char* payload, std::vector<char>& out) {
+        if (h.length > 1) {
+            appendFrame(out, MessageType::STATS, MessageStatus::BAD_PAYLOAD, h.requestId, nullptr, 0);
+            return;
+        }
+        std::vector<LatencyStageSummary> stages = summarizeLatency(latencySnapshot());
+        if (h.length == 1 && payload[0] != 0) resetLatencyStats();
+        appendFrame(out, MessageType::STATS, MessageStatus::OK, h.requestId, stages.data(),
+                    static_cast<uint32_t>(stages.size() * sizeof(LatencyStageSummary)));
+    }
+
+    // ˳һӦ׷ӵ
+    void processBatch(const std::vector<PendingRequest>& batch) {
+        // ͬһݺԼգز
+        ContractRegistry::Snapshot table = contractReader.lock();
+        for (const auto& req : batch) {
+            Connection& c = connections[req.conn];
+            const char* payload = c.in.data() + req.payloadOffset;
+            const MessageHeader& h = req.header;
+            try {
+                switch (static_cast<MessageType>(h.type)) {
+                    case MessageType::RISK: handleRisk(h, payload, *table, c.out); break;
+                    case MessageType::SR_UPDATE:
+                    case MessageType::SR_QUERY:
+                    case MessageType::INDICATORS: handleSymbol(h, payload, c.out); break;
+                    case MessageType::SCORE: handleScore(h, payload, c.out); break;
+                    case MessageType::STATS: handleStats(h, payload, c.out); break;
+                    default:
+                        appendFrame(c.out, static_cast<MessageType>(h.type), MessageStatus::UNKNOWN_TYPE, h.requestId, nullptr, 0);
+                }
+            } catch (const std::invalid_argument& e) {
+                appendFrame(c.out, static_cast<MessageType>(h.type), MessageStatus::INVALID_ARGUMENT, h.requestId,
+                            e.what(), static_cast<uint32_t>(std::strlen(e.what())));
+            }
+        }
+        scoreArena.reset();
+        handledRequests += batch.size();
+        handledBatches++;
+    }
+
+    // ͸
+    void flushConnection(Connection& c) {
+        TRADECHECK_LATENCY_SCOPE(LatencyStage::OUTPUT);
+        while (c.outOffset < c.out.size()) {
+            ssize_t n = send(c.fd, c.out.data() + c.outOffset, c.out.size() - c.outOffset, MSG_NOSIGNAL);
+            if (n > 0) {
+                c.outOffset += n;
+            } else {
+                if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) c.closed = true;
+                break;
+            }
+        }
+        if (c.outOffset == c.out.size()) {
+            c.out.clear();
+            c.outOffset = 0;
+        }
+    }
+
+    // رղƳѶϿ
+    void dropClosed() {
+        size_t kept = 0;
+        for (size_t i = 0; i < connections.size(); ++i) {
+            if (connections[i].closed) {
+                close(connections[i].fd);
+            } else {
+                if (kept != i) connections[kept] = std::move(connections[i]);
+                kept++;
+            }
+        }
+        connections.resize(kept);
+    }
+
+    // ѯ׽֣timeoutUsΪȴʱ΢룬ҪǺ뾫ȣ
+    void pollOnce(long timeoutUs) {
+        std::vector<pollfd> fds;
+        fds.push_back({listenFd, POLLIN, 0});
+        for (const auto& c : connections) {
+            short events = POLLIN;
+            if (!c.out.empty()) events |= POLLOUT;
+            // ѶϿӲѯPOLLHUPڵĵȴءתڽ
+            fds.push_back({c.closed ? -1 : c.fd, events, 0});
+        }
+        timespec timeout{static_cast<time_t>(timeoutUs / 1000000), static_cast<long>(timeoutUs % 1000000) * 1000};
+        int ready = ppoll(fds.data(), fds.size(), &timeout, nullptr);
+        if (ready <= 0) return;
+        if (fds[0].revents & POLLIN) acceptClients();
+        for (size_t i = 1; i < fds.size(); ++i) {
+            Connection& c = connections[i - 1];
+            if (fds[i].revents & (POLLIN | POLLHUP | POLLERR)) readConnection(c);
+            if (fds[i].revents & POLLOUT) flushConnection(c);
+        }
+    }
+
+public:
+    RiskDaemon(const std::string& path, long batchUs, size_t window, size_t symbolLimit, ContractRegistry& registry,
+               const std::string& configPath)
+        : socketPath(path), batchWindowUs(batchUs), maxWindow(window), maxSymbols(symbolLimit), contracts(registry),
+          contractReader(registry), contractPath(configPath) {
+        if (path.size() >= sizeof(sockaddr_un::sun_path)) throw std::invalid_argument("׽·");
+        if (window == 0 || window > static_cast<size_t>(MAX_STREAM_WINDOW)) {
+            throw std::invalid_argument("Kߴڳ1~" + std::to_string(MAX_STREAM_WINDOW) + "֮");
+        }
+        if (symbolLimit == 0) throw std::invalid_argument("Ʒޱ0");
+    }
+
+    ~RiskDaemon() {
+        for (auto& c : connections) close(c.fd);
+        if (listenFd >= 0) {
+            close(listenFd);
+            unlink(socketPath.c_str());
+        }
+    }
+
+    // ׽
+    void listenSocket() {
+        listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listenFd < 0) throw std::runtime_error("׽ʧ");
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, socketPath.c_str(), sizeof(addr.sun_path) - 1);
+        unlink(socketPath.c_str());
+        if (bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) throw std::runtime_error("׽ʧܣ" + socketPath);
+        if (listen(listenFd, 128) < 0) throw std::runtime_error("׽ʧ");
+        setNonBlocking(listenFd);
+    }
+
+    // ¼غԼãʧʱԭã
+    void reloadContracts() {
+        if (contractPath.empty()) {
+            std::cout << "δָԼļ" << std::endl;
+            return;
+        }
+        try {
+            contracts.reloadFromFile(contractPath);
+            std::cout << "Լأ" << contractPath << std::endl;
+        } catch (const std::invalid_argument& e) {
+            std::cerr << "Լʧܣԭã" << e.what() << std::endl;
+        }
+    }
+
+    // ѭ
+    void run() {
+        std::vector<PendingRequest> batch;
+        while (g_running) {
+            if (g_reload) {
+                g_reload = 0;
+                reloadContracts();
+            }
+            pollOnce(200000);
+            std::vector<size_t> parsed(connections.size(), 0);
+            batch.clear();
+            collectFrames(batch, parsed);
+
+            // ڣʣʱȴռֱڽһ
+            if (!batch.empty() && batchWindowUs > 0) {
+                auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(batchWindowUs);
+                while (g_running && batch.size() < MAX_BATCH_REQUESTS) {
+                    long remainingUs = static_cast<long>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                                             deadline - std::chrono::steady_clock::now()).count());
+                    if (remainingUs <= 0) break;
+                    pollOnce(remainingUs);
+                    parsed.resize(connections.size(), 0);
+                    collectFrames(batch, parsed);
+                }
+            }
+
+            if (!batch.empty()) processBatch(batch);
+            for (size_t i = 0; i < connections.size(); ++i) {
+                Connection& c = connections[i];
+                if (parsed[i] > 0) c.in.erase(c.in.begin(), c.in.begin() + parsed[i]);
+                if (!c.out.empty()) flushConnection(c);
+                if (c.out.size() - c.outOffset > MAX_PENDING_OUTPUT) {
+                    std::cerr << "δȡӦ" << MAX_PENDING_OUTPUT / (1024 * 1024) << " MBϿ" << std::endl;
+                    c.closed = true;
+                }
+            }
+            dropClosed();
+        }
+    }
+
+    uint64_t getHandledRequests() const { return handledRequests; }
+    uint64_t getHandledBatches() const { return handledBatches; }
+};
+
+// 
+int main(int argc, char* argv[]) {
+    std::string path = DEFAULT_SOCKET_PATH;
+    long batchUs = 50;
+    size_t window = 500;
+    size_t maxSymbols = 4096;
+    std::string contractFile;
+    std::string statsFile;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--socket" && i + 1 < argc) path = argv[++i];
+        else if (arg == "--batch-us" && i + 1 < argc) batchUs = std::atol(argv[++i]);
+        else if (arg == "--window" && i + 1 < argc) window = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--max-symbols" && i + 1 < argc) maxSymbols = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--contracts" && i + 1 < argc) contractFile = argv[++i];
+        else if (arg == "--stats-file" && i + 1 < argc) statsFile = argv[++i];
+        else {
+            std::cout << "÷ػ [--socket ·] [--batch-us ȴ΢] [--window ÿƷKߴڣ1~512] [--max-symbols Ʒ]"
+                         " [--contracts Լļ] [--stats-file ˳ʱдӳٱ]" << std::endl;
+            std::cout << "յSIGHUPʱ¼غԼãӳٱļչΪ.json/.ndjsonʱдNDJSONдı" << std::endl;
+            return 1;
+        }
+    }
+
+    std::signal(SIGINT, handleStopSignal);
+    std::signal(SIGTERM, handleStopSignal);
+    std::signal(SIGHUP, handleReloadSignal);
+    try {
+        ContractRegistry registry(contractFile.empty() ? defaultContracts() : loadContractConfig(contractFile));
+        RiskDaemon daemon(path, batchUs, window, maxSymbols, registry, contractFile);
+        daemon.listenSocket();
+        std::cout << "ػ" << path << "" << batchUs << "΢룬Kߴ" << window << "" << std::endl;
+        daemon.run();
+        std::cout << "Ѵ" << daemon.getHandledRequests() << "Σ" << daemon.getHandledBatches() << "" << std::endl;
+        if (!statsFile.empty()) writeLatencyReport(statsFile, summarizeLatency(latencySnapshot()));
+    } catch (const std::exception& e) {
+        std::cerr << "" << e.what() << std::endl;
+        return 1;
+    }
+    std::cout << "" << std::endl;
+    return 0;
+}
@@ -0,0 +1,356 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <stdexcept>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "core/risk_protocol.h"
+
+using namespace tradecheck;
+
+// ػ̿ͻˣ + ˮѹ
+
+// ʽ
+class RiskClient {
+private:
+    int fd = -1;
+
+    void sendAll(const char* data, size_t size) {
+        while (size > 0) {
+            ssize_t n = send(fd, data, size, MSG_NOSIGNAL);
+            if (n <= 0) throw std::runtime_error("ʧܣػ̿˳");
+            data += n;
+            size -= n;
+        }
+    }
+
+    void recvAll(char* data, size_t size) {
+        while (size > 0) {
+            ssize_t n = recv(fd, data, size, 0);
+            if (n <= 0) throw std::runtime_error("ʧܣػ̿˳");
+            data += n;
+            size -= n;
+        }
+    }
+
+public:
+    explicit RiskClient(const std::string& path) {
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) throw std::runtime_error("׽ʧ");
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+        if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+            close(fd);
+            throw std::runtime_error("޷ػ̣" + path);
+        }
+    }
+
+    ~RiskClient() {
+        if (fd >= 0) close(fd);
+    }
+
+    RiskClient(const RiskClient&) = delete;
+    RiskClient& operator=(const RiskClient&) = delete;
+
+    // ѱı
+    void sendFrames(const std::vector<char>& frames) {
+        sendAll(frames.data(), frames.size());
+    }
+
+    // һ֡Ӧ
+    MessageHeader receive(std::vector<char>& payload) {
+        MessageHeader h;
+        recvAll(reinterpret_cast<char*>(&h), sizeof(h));
+        if (h.magic != PROTOCOL_MAGIC || h.length > MAX_PAYLOAD_SIZE) throw std::runtime_error("Ӧĸʽ");
+        payload.resize(h.length);
+        if (h.length) recvAll(payload.data(), h.length);
+        return h;
+    }
+};
+
+// ʾ
+void appendRiskRequest(std::vector<char>& out, uint32_t id, std::mt19937_64& rng) {
+    static const char* const symbols[4] = {"BTCUSDT", "ETHUSDT", "SOLUSDT", "DOGEUSDT"};
+    std::uniform_int_distribution<int> coin(0, 3), dir(0, 1);
+    std::uniform_real_distribution<double> lev(1, 50), ratio(1, 30), price(0.1, 60000), cap(1000, 100000);
+    RiskRequest req{};
+    std::strncpy(req.symbol, symbols[coin(rng)], sizeof(req.symbol) - 1);
+    req.direction = static_cast<uint8_t>(dir(rng));
+    req.leverage = lev(rng);
+    req.positionRatio = ratio(rng);
+    req.entryPrice = price(rng);
+    req.totalCapital = cap(rng);
+    appendFrame(out, MessageType::RISK, MessageStatus::OK, id, &req, sizeof(req));
+}
+
+void appendSymbolUpdate(std::vector<char>& out, uint32_t id, const std::string& symbol, int bars, std::mt19937_64& rng,
+                        double& lastClose) {
+    std::normal_distribution<double> ret(0.0, 0.01);
+    std::vector<char> payload(sizeof(SymbolRequest) + bars * sizeof(KlineData));
+    SymbolRequest req{};
+    std::strncpy(req.symbol, symbol.c_str(), sizeof(req.symbol) - 1);
+    req.timeframe = static_cast<uint8_t>(TimeFrame::FOUR_HOUR);
+    req.klineCount = static_cast<uint32_t>(bars);
+    std::memcpy(payload.data(), &req, sizeof(req));
+    for (int i = 0; i < bars; ++i) {
+        KlineData kd;
+        kd.open = lastClose;
+        kd.close = lastClose * (1 + ret(rng));
+        kd.high = std::max(kd.open, kd.close) * (1 + std::fabs(ret(rng)) / 2);
+        kd.low = std::min(kd.open, kd.close) * (1 - std::fabs(ret(rng)) / 2);
+        kd.volume = 1000 * (1 + std::fabs(ret(rng)) * 50);
+        lastClose = kd.close;
+        std::memcpy(payload.data() + sizeof(req) + i * sizeof(KlineData), &kd, sizeof(kd));
+    }
+    appendFrame(out, MessageType::SR_UPDATE, MessageStatus::OK, id, payload.data(), static_cast<uint32_t>(payload.size()));
+}
+
+void appendSymbolQuery(std::vector<char>& out, uint32_t id, const std::string& symbol) {
+    SymbolRequest req{};
+    std::strncpy(req.symbol, symbol.c_str(), sizeof(req.symbol) - 1);
+    appendFrame(out, MessageType::SR_QUERY, MessageStatus::OK, id, &req, sizeof(req));
+}
+
+void appendIndicatorQuery(std::vector<char>& out, uint32_t id, const std::string& symbol) {
+    SymbolRequest req{};
+    std::strncpy(req.symbol, symbol.c_str(), sizeof(req.symbol) - 1);
+    appendFrame(out, MessageType::INDICATORS, MessageStatus::OK, id, &req, sizeof(req));
+}
+
+void appendScoreRequest(std::vector<char>& out, uint32_t id, std::mt19937_64& rng) {
+    std::uniform_int_distribution<int> pick3(0, 2), pick2(0, 1), breaks(0, 7), lev(1, 25);
+    TradeAnalysis ta{};
+    ta.openDir = DIR_NAMES[pick2(rng)];
+    ta.leverage = lev(rng);
+    ta.openPrice = 100;
+    ta.stopLoss = ta.openDir == "" ? 95 : 105;
+    ta.longTrend = TREND_NAMES[pick3(rng)];
+    ta.midTrend = TREND_NAMES[pick3(rng)];
+    ta.shortTrend = TREND_NAMES[pick3(rng)];
+    ta.shortTrendLineBreakTimes = breaks(rng);
+    ta.rsiLevel = RSI_NAMES[pick3(rng)];
+    const Timeframe tfs[3] = {Timeframe::TF_4H, Timeframe::TF_DAY, Timeframe::TF_WEEK};
+    for (int i = 0; i < 3; ++i) {
+        ta.emaList.push_back({tfs[i], 26, TREND_NAMES[pick3(rng)], false});
+        ta.kstList.push_back({tfs[i], {10, 15, 20, 30}, KST_CROSS_NAMES[pick3(rng)]});
+    }
+    ta.pricePatterns.push_back({PRICE_PATTERN_NAMES[PATTERN_TRIANGLE_DIVERGING], PatternTimeframe::MEDIUM, TriangleBreakDir::UP});
+    std::vector<char> payload;
+    encodeScoreRequest(ta, payload);
+    appendFrame(out, MessageType::SCORE, MessageStatus::OK, id, payload.data(), static_cast<uint32_t>(payload.size()));
+}
+
+// ӡӦ
+void printResponse(const MessageHeader& h, const std::vector<char>& payload) {
+    if (h.status != static_cast<uint16_t>(MessageStatus::OK)) {
+        std::cout << "" << h.requestId << "ʧܣ״̬" << h.status;
+        if (!payload.empty()) std::cout << "" << std::string(payload.begin(), payload.end());
+        std::cout << std::endl;
+        return;
+    }
+    switch (static_cast<MessageType>(h.type)) {
+        case MessageType::RISK: {
+            RiskResponse r;
+            std::memcpy(&r, payload.data(), sizeof(r));
+            std::cout << "ֵ" << r.threshold << "ϵ" << r.riskCoefficient << "յȼ" << int(r.riskLevel)
+                      << "\nʼ֤" << r.initialMargin << "άֱ֤" << r.maintenanceMargin
+                      << "貹䱣֤" << r.marginToAdd << "ǿƽۣ" << r.liquidationPrice << std::endl;
+            break;
+        }
+        case MessageType::SR_UPDATE: {
+            SymbolUpdateResponse r;
+            std::memcpy(&r, payload.data(), sizeof(r));
+            std::cout << "K" << r.windowSize << std::endl;
+            break;
+        }
+        case MessageType::SR_QUERY: {
+            SupportResistanceLevels l;
+            std::memcpy(&l, payload.data(), sizeof(l));
+            std::cout << "߼ۣ" << l.highestHigh << "ͼۣ" << l.lowestLow << "㣺" << l.pivotPoint
+                      << "\nS1=" << l.s1 << " S2=" << l.s2 << " S3=" << l.s3 << " | R1=" << l.r1 << " R2=" << l.r2 << " R3=" << l.r3
+                      << "\nܼɽ" << l.denseSupport << " ~ " << l.denseResist << "" << l.klineCount << "Kߣ" << std::endl;
+            break;
+        }
+        case MessageType::INDICATORS: {
+            IndicatorResponse r;
+            std::memcpy(&r, payload.data(), sizeof(r));
+            std::cout << "EMA" << r.emaPeriod[0] << "/" << r.emaPeriod[1] << "/" << r.emaPeriod[2] << "";
+            for (int i = 0; i < 3; ++i) {
+                std::cout << (i ? "/" : "") << r.ema[i] << TREND_NAMES[r.emaTrend[i]] << ((r.ready >> i) & 1 ? "" : "δ");
+            }
+            std::cout << "\nRSI" << r.rsi << RSI_NAMES[r.rsiLevel] << "KST" << r.kst << "ź" << r.kstSignal << ""
+                      << KST_CROSS_NAMES[r.kstCross] << "ۼ" << r.klineCount << "K" << std::endl;
+            break;
+        }
+        case MessageType::SCORE: {
+            ScoreResponse r;
+            std::memcpy(&r, payload.data(), sizeof(r));
+            std::cout << "ۺһܷ֣" << r.totalScore << "/100EMA " << r.emaScore << "KST " << r.kstScore
+                      << "ƥ " << r.dirMatchScore << "" << std::endl;
+            size_t pos = sizeof(r);
+            for (int i = 0; i < r.contradictionCount; ++i) {
+                uint16_t len;
+                std::memcpy(&len, payload.data() + pos, sizeof(len));
+                pos += sizeof(len);
+                std::cout << i + 1 << ". " << std::string(payload.data() + pos, len) << std::endl;
+                pos += len;
+            }
+            break;
+        }
+        case MessageType::STATS: {
+            std::vector<LatencyStageSummary> stages(payload.size() / sizeof(LatencyStageSummary));
+            if (!stages.empty()) std::memcpy(stages.data(), payload.data(), stages.size() * sizeof(LatencyStageSummary));
+            std::cout << std::flush;
+            printLatencyTable(stdout, stages);
+            std::fflush(stdout);
+            break;
+        }
+        default:
+            std::cout << "δ֪Ӧͣ" << h.type << std::endl;
+    }
+}
+
+// ʾһӡ
+void runDemo(const std::string& path) {
+    RiskClient client(path);
+    std::mt19937_64 rng(7);
+    std::vector<char> frames;
+    double lastClose = 100.0;
+    appendRiskRequest(frames, 1, rng);
+    appendSymbolUpdate(frames, 2, "SOLUSDT", 50, rng, lastClose);
+    appendSymbolQuery(frames, 3, "SOLUSDT");
+    appendScoreRequest(frames, 4, rng);
+    appendIndicatorQuery(frames, 5, "SOLUSDT");
+    client.sendFrames(frames);
+    std::vector<char> payload;
+    for (int i = 0; i < 5; ++i) {
+        MessageHeader h = client.receive(payload);
+        std::cout << "\n--- Ӧ" << h.requestId << " ---" << std::endl;
+        printResponse(h, payload);
+    }
+}
+
+// ȡػ̵ķֽ׶ӳͳƣresetΪtrueʱȡ㣻outputǿʱдļ
+void runStats(const std::string& path, bool reset, const std::string& output) {
+    RiskClient client(path);
+    std::vector<char> frames;
+    char flag = reset ? 1 : 0;
+    appendFrame(frames, MessageType::STATS, MessageStatus::OK, 1, &flag, 1);
+    client.sendFrames(frames);
+    std::vector<char> payload;
+    MessageHeader h = client.receive(payload);
+    if (output.empty() || h.status != static_cast<uint16_t>(MessageStatus::OK)) {
+        printResponse(h, payload);
+        return;
+    }
+    std::vector<LatencyStageSummary> stages(payload.size() / sizeof(LatencyStageSummary));
+    if (!stages.empty()) std::memcpy(stages.data(), payload.data(), stages.size() * sizeof(LatencyStageSummary));
+    writeLatencyReport(output, stages);
+}
+
+// ѹ⣺ÿһ̣߳pipeline;
+void runBench(const std::string& path, int connCount, int requestsPerConn, int pipeline, const std::string& mix) {
+    std::vector<std::vector<double>> latencies(connCount);
+    std::atomic<int> failures{0};
+    auto start = std::chrono::steady_clock::now();
+
+    auto worker = [&](int id) {
+        try {
+            RiskClient client(path);
+            std::mt19937_64 rng(1000 + id);
+            std::string symbol = "SYM" + std::to_string(id % 64);
+            double lastClose = 100.0;
+            std::vector<std::chrono::steady_clock::time_point> sentAt(requestsPerConn);
+            std::vector<char> frames, payload;
+            latencies[id].reserve(requestsPerConn);
+            int sent = 0, received = 0;
+            while (received < requestsPerConn) {
+                frames.clear();
+                while (sent < requestsPerConn && sent - received < pipeline) {
+                    int kind = mix == "risk" ? 0 : mix == "sr" ? 1 + (sent % 2) : mix == "score" ? 3 : sent % 4;
+                    uint32_t rid = static_cast<uint32_t>(sent);
+                    if (kind == 0) appendRiskRequest(frames, rid, rng);
+                    else if (kind == 1) appendSymbolUpdate(frames, rid, symbol, 1, rng, lastClose);
+                    else if (kind == 2) appendSymbolQuery(frames, rid, symbol);
+                    else appendScoreRequest(frames, rid, rng);
+                    sentAt[sent] = std::chrono::steady_clock::now();
+                    sent++;
+                }
+                if (!frames.empty()) client.sendFrames(frames);
+                MessageHeader h = client.receive(payload);
+                auto now = std::chrono::steady_clock::now();
+                if (h.status != static_cast<uint16_t>(MessageStatus::OK) && h.type != static_cast<uint16_t>(MessageType::SR_QUERY)) failures++;
+                latencies[id].push_back(std::chrono::duration<double, std::micro>(now - sentAt[h.requestId]).count());
+                received++;
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "" << id << "" << e.what() << std::endl;
+            failures++;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < connCount; ++i) threads.emplace_back(worker, i);
+    for (auto& t : threads) t.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<double> all;
+    for (const auto& l : latencies) all.insert(all.end(), l.begin(), l.end());
+    if (all.empty()) {
+        std::cout << "ûɵ" << std::endl;
+        return;
+    }
+    std::sort(all.begin(), all.end());
+    auto pct = [&all](double p) { return all[std::min(all.size() - 1, static_cast<size_t>(p * all.size()))]; };
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "" << all.size() << "ʧܣ" << failures.load() << "ʱ" << seconds << "" << std::endl;
+    std::cout << "£" << all.size() / seconds << " /" << std::endl;
+    std::cout << "ӳ٣΢룩p50=" << pct(0.50) << " p99=" << pct(0.99) << " p99.9=" << pct(0.999) << " =" << all.back() << std::endl;
+}
+
+// 
+int main(int argc, char* argv[]) {
+    std::string path = DEFAULT_SOCKET_PATH;
+    std::string mode = "demo";
+    std::string mix = "all";
+    std::string output;
+    bool reset = false;
+    int connCount = 4, requests = 10000, pipeline = 16;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "demo" || arg == "bench" || arg == "stats") mode = arg;
+        else if (arg == "--socket" && i + 1 < argc) path = argv[++i];
+        else if (arg == "--connections" && i + 1 < argc) connCount = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--requests" && i + 1 < argc) requests = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--pipeline" && i + 1 < argc) pipeline = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--mix" && i + 1 < argc) mix = argv[++i];
+        else if (arg == "--reset") reset = true;
+        else if (arg == "--output" && i + 1 < argc) output = argv[++i];
+        else {
+            std::cout << "÷ؿͻ [demo|bench|stats] [--socket ·] [--connections N] [--requests ÿ]"
+                         " [--pipeline ;] [--mix all|risk|sr|score] [--reset] [--output ӳٱļ]" << std::endl;
+            std::cout << "statsȡػ̷ֽ׶ӳ٣--resetȡ㣬--outputдļ.json/.ndjsonΪNDJSON" << std::endl;
+            return 1;
+        }
+    }
+    try {
+        if (mode == "demo") runDemo(path);
+        else if (mode == "stats") runStats(path, reset, output);
+        else runBench(path, connCount, requests, pipeline, mix);
+    } catch (const std::exception& e) {
+        std::cerr << "" << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}